@@ -0,0 +1,94 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwBenchmarkRunner.h"
+#include "cwTask.h"
+
+//Qt includes
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+
+//Std includes
+#include <algorithm>
+
+cwBenchmarkRunner::cwBenchmarkRunner(int iterations) :
+    Iterations(qMax(1, iterations))
+{
+}
+
+/**
+ * @brief cwBenchmarkRunner::run
+ * @param name - The name of the benchmark, this is used to track regressions and should be stable
+ * @param benchmark - The code that's timed
+ * @param setup - Run before each iteration of benchmark, but isn't timed
+ * @param metadata - Extra information that's stored with the results, like the size of the input
+ * @return True if the benchmark was run, and false if it was filtered out
+ */
+bool cwBenchmarkRunner::run(QString name,
+                            std::function<void ()> benchmark,
+                            std::function<void ()> setup,
+                            QJsonObject metadata)
+{
+    if(!Filter.isEmpty() && Filter.indexIn(name) < 0) {
+        return false;
+    }
+
+    QTextStream(stderr) << "Running " << name << endl;
+
+    QList<double> times;
+    for(int i = 0; i < Iterations; i++) {
+        if(setup) {
+            setup();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        benchmark();
+        times.append(timer.nsecsElapsed() / 1.0e6);
+    }
+
+    std::sort(times.begin(), times.end());
+
+    double sum = 0.0;
+    foreach(double time, times) {
+        sum += time;
+    }
+
+    int middle = times.size() / 2;
+    double median = times.size() % 2 == 1 ? times.at(middle) : (times.at(middle - 1) + times.at(middle)) / 2.0;
+
+    QJsonObject result;
+    result.insert("name", name);
+    result.insert("iterations", Iterations);
+    result.insert("minMs", times.first());
+    result.insert("medianMs", median);
+    result.insert("meanMs", sum / times.size());
+    result.insert("maxMs", times.last());
+    if(!metadata.isEmpty()) {
+        result.insert("metadata", metadata);
+    }
+
+    Results.append(result);
+    return true;
+}
+
+/**
+ * @brief cwBenchmarkRunner::runTask
+ * @param task - The task to run
+ * @param thread - The thread the task runs on
+ *
+ * Runs the task on thread, like the managers do in the application, and blocks until
+ * the task has finished. The task lives on thread afterwards, so delete it with deleteLater().
+ */
+void cwBenchmarkRunner::runTask(cwTask *task, QThread *thread) const
+{
+    task->setThread(thread);
+    task->start();
+    task->waitToFinish();
+}
@@ -0,0 +1,70 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWBENCHMARKRUNNER_H
+#define CWBENCHMARKRUNNER_H
+
+//Qt includes
+#include <QString>
+#include <QList>
+#include <QRegExp>
+#include <QJsonObject>
+#include <QJsonArray>
+class QThread;
+class cwTask;
+
+//Std includes
+#include <functional>
+
+/**
+ * @brief The cwBenchmarkRunner class
+ *
+ * Times benchmarks and collects the results as json. Each benchmark is run
+ * a fixed number of times, and the min, median, mean, and max wall time is reported in
+ * milliseconds. Benchmarks whose name doesn't match the filter are skipped.
+ */
+class cwBenchmarkRunner
+{
+public:
+    cwBenchmarkRunner(int iterations = 3);
+
+    void setFilter(QRegExp filter);
+
+    bool run(QString name,
+             std::function<void()> benchmark,
+             std::function<void()> setup = std::function<void()>(),
+             QJsonObject metadata = QJsonObject());
+
+    void runTask(cwTask* task, QThread* thread) const;
+
+    QJsonArray results() const;
+
+private:
+    int Iterations;
+    QRegExp Filter;
+    QJsonArray Results;
+};
+
+/**
+ * @brief cwBenchmarkRunner::setFilter
+ * @param filter - Only benchmarks with names that match the filter are run
+ */
+inline void cwBenchmarkRunner::setFilter(QRegExp filter)
+{
+    Filter = filter;
+}
+
+/**
+ * @brief cwBenchmarkRunner::results
+ * @return An array with one json object for each benchmark that has been run
+ */
+inline QJsonArray cwBenchmarkRunner::results() const
+{
+    return Results;
+}
+
+#endif // CWBENCHMARKRUNNER_H
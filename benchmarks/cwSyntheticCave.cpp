@@ -0,0 +1,309 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwSyntheticCave.h"
+#include "cwProject.h"
+#include "cwCavingRegion.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyChunk.h"
+#include "cwSurveyNoteModel.h"
+#include "cwNote.h"
+#include "cwScrap.h"
+#include "cwNoteStation.h"
+#include "cwNoteTranformation.h"
+#include "cwTriangulateStation.h"
+#include "cwAddImageTask.h"
+
+//Qt includes
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+
+const double cwSyntheticCave::NoteScale = 1.0 / 500.0;
+const double cwSyntheticCave::ImageDotsPerMeter = 300.0 / 0.0254;
+
+cwSyntheticCave::cwSyntheticCave(Options options) :
+    Opts(options),
+    RandomEngine(options.Seed),
+    ShotCount(0)
+{
+}
+
+/**
+ * @brief cwSyntheticCave::generate
+ * @param project - The project that the cave is generated into
+ *
+ * Adds one cave to the project's region. The note images are added to the project's database.
+ * This should only be called once per cwSyntheticCave.
+ */
+void cwSyntheticCave::generate(cwProject *project)
+{
+    Q_ASSERT(StationNames.isEmpty());
+
+    generateSurvey(project->cavingRegion());
+    generateNoteImages(project);
+    generateScraps();
+}
+
+/**
+ * @brief cwSyntheticCave::generateSurvey
+ *
+ * Creates a random walk survey, with loops, in the region
+ */
+void cwSyntheticCave::generateSurvey(cwCavingRegion *region)
+{
+    cwCave* cave = new cwCave();
+    cave->setName("Synthetic Cave");
+    region->addCave(cave);
+
+    double remainingLength = Opts.SurveyLengthKm * 1000.0;
+    double compass = random(0.0, 360.0);
+
+    QString fromName = QString("a%1").arg(StationNames.size() + 1);
+    QVector3D fromPosition;
+    StationNames.append(fromName);
+    StationPositions.insert(fromName, fromPosition);
+
+    cwTrip* trip = nullptr;
+    cwSurveyChunk* chunk = nullptr;
+    int chunkCount = 0;
+
+    while(remainingLength > 0.0) {
+        if(chunk == nullptr || chunk->shotCount() >= Opts.ShotsPerChunk) {
+            if(trip == nullptr || chunkCount >= Opts.ChunksPerTrip) {
+                trip = new cwTrip();
+                trip->setName(QString("Trip %1").arg(cave->tripCount() + 1));
+                cave->addTrip(trip);
+                chunkCount = 0;
+            }
+
+            chunk = new cwSurveyChunk();
+            trip->addChunk(chunk);
+            chunkCount++;
+        }
+
+        //Wander, like a real passage
+        compass = fmod(compass + random(-30.0, 30.0) + 360.0, 360.0);
+        double clino = random(-20.0, 20.0);
+        double distance = qMin(random(3.0, 15.0), remainingLength);
+        remainingLength -= distance;
+
+        double horizontal = distance * qCos(qDegreesToRadians(clino));
+        QVector3D toPosition = fromPosition + QVector3D(horizontal * qSin(qDegreesToRadians(compass)),
+                                                        horizontal * qCos(qDegreesToRadians(compass)),
+                                                        distance * qSin(qDegreesToRadians(clino)));
+
+        QString toName = QString("a%1").arg(StationNames.size() + 1);
+        StationNames.append(toName);
+        StationPositions.insert(toName, toPosition);
+        StationTrips.insert(toName, trip);
+
+        cwStation from(fromName);
+        cwStation to(toName);
+        to.setLeft(random(0.5, 5.0));
+        to.setRight(random(0.5, 5.0));
+        to.setUp(random(0.5, 3.0));
+        to.setDown(random(0.5, 3.0));
+
+        cwShot shot;
+        shot.setDistance(distance);
+        shot.setCompass(compass);
+        shot.setClino(clino);
+
+        chunk->appendShot(from, to, shot);
+        ShotCount++;
+
+        fromName = toName;
+        fromPosition = toPosition;
+    }
+
+    //Tie random stations back to earlier stations. The shot's data is calculated from the
+    //generated positions, so the loops close without any error
+    if(Opts.Loops > 0 && StationNames.size() > 2) {
+        cwTrip* loopTrip = new cwTrip();
+        loopTrip->setName("Loops");
+        cave->addTrip(loopTrip);
+
+        std::uniform_int_distribution<int> stationDistribution(0, StationNames.size() - 1);
+        for(int i = 0; i < Opts.Loops; i++) {
+            QString loopFrom = StationNames.at(stationDistribution(RandomEngine));
+            QString loopTo = StationNames.at(stationDistribution(RandomEngine));
+            if(loopFrom == loopTo) { continue; }
+
+            QVector3D delta = StationPositions.value(loopTo) - StationPositions.value(loopFrom);
+            double horizontal = qSqrt(delta.x() * delta.x() + delta.y() * delta.y());
+
+            cwShot shot;
+            shot.setDistance(delta.length());
+            shot.setCompass(fmod(qRadiansToDegrees(qAtan2(delta.x(), delta.y())) + 360.0, 360.0));
+            shot.setClino(qRadiansToDegrees(qAtan2(delta.z(), horizontal)));
+
+            cwSurveyChunk* loopChunk = new cwSurveyChunk();
+            loopChunk->appendShot(cwStation(loopFrom), cwStation(loopTo), shot);
+            loopTrip->addChunk(loopChunk);
+            ShotCount++;
+        }
+    }
+}
+
+/**
+ * @brief cwSyntheticCave::generateNoteImages
+ *
+ * Draws noisy, note like, images and adds them to the project's database
+ */
+void cwSyntheticCave::generateNoteImages(cwProject *project)
+{
+    if(Opts.Images <= 0 || Opts.Scraps <= 0) { return; }
+
+    QList<QImage> images;
+    for(int i = 0; i < Opts.Images; i++) {
+        QImage image(Opts.ImageSize, Opts.ImageSize, QImage::Format_RGB32);
+        image.fill(Qt::white);
+        image.setDotsPerMeterX(qRound(ImageDotsPerMeter));
+        image.setDotsPerMeterY(qRound(ImageDotsPerMeter));
+
+        QPainter painter(&image);
+        painter.setPen(QPen(Qt::black, 2.0));
+        for(int line = 0; line < 500; line++) {
+            painter.drawLine(QPointF(random(0.0, Opts.ImageSize), random(0.0, Opts.ImageSize)),
+                             QPointF(random(0.0, Opts.ImageSize), random(0.0, Opts.ImageSize)));
+        }
+        painter.end();
+
+        images.append(image);
+    }
+
+    cwAddImageTask addImageTask;
+    addImageTask.setDatabaseFilename(project->filename());
+    addImageTask.setNewImages(images);
+    addImageTask.start();
+    addImageTask.waitToFinish();
+
+    NoteImages = addImageTask.images();
+}
+
+/**
+ * @brief cwSyntheticCave::generateScraps
+ *
+ * Creates scraps around pairs of neighboring stations. Each scrap has a noisy, roughly
+ * elliptical, outline.
+ */
+void cwSyntheticCave::generateScraps()
+{
+    if(NoteImages.isEmpty() || StationNames.size() < 2) { return; }
+
+    //Normalized note coordinates per meter in the cave
+    double noteUnitsPerMeter = NoteScale * ImageDotsPerMeter / (double)Opts.ImageSize;
+    const int outlinePoints = 48;
+
+    QHash< QPair<cwTrip*, int>, cwNote* > notes;
+
+    for(int i = 0; i < Opts.Scraps; i++) {
+        int imageIndex = i % NoteImages.size();
+        int stationIndex = (int)((i / (double)Opts.Scraps) * (StationNames.size() - 1));
+
+        QString nameA = StationNames.at(stationIndex);
+        QString nameB = StationNames.at(stationIndex + 1);
+        QVector3D positionA = StationPositions.value(nameA);
+        QVector3D positionB = StationPositions.value(nameB);
+
+        //The y is flipped, because north is up on the note
+        QPointF delta = QPointF(positionB.x() - positionA.x(), -(positionB.y() - positionA.y())) * noteUnitsPerMeter;
+        QPointF center(random(0.25, 0.75), random(0.25, 0.75));
+        QPointF noteA = center - delta * 0.5;
+        QPointF noteB = center + delta * 0.5;
+
+        double radius = qMax(0.03, qSqrt(QPointF::dotProduct(delta, delta)) * 0.75);
+        QVector<QPointF> outline;
+        outline.reserve(outlinePoints);
+        for(int p = 0; p < outlinePoints; p++) {
+            double angle = 2.0 * M_PI * p / (double)outlinePoints;
+            double noisyRadius = radius * random(0.85, 1.15);
+            QPointF point = center + QPointF(qCos(angle) * noisyRadius, qSin(angle) * noisyRadius * 0.6);
+            outline.append(QPointF(qBound(0.0, point.x(), 1.0), qBound(0.0, point.y(), 1.0)));
+        }
+
+        //Add the scrap to the region
+        cwTrip* trip = StationTrips.value(nameB);
+
+        QPair<cwTrip*, int> noteKey(trip, imageIndex);
+        if(!notes.contains(noteKey)) {
+            cwNote* note = new cwNote();
+            note->setImage(NoteImages.at(imageIndex));
+            trip->notes()->addNotes(QList<cwNote*>() << note);
+            notes.insert(noteKey, note);
+        }
+
+        cwNoteStation noteStationA;
+        noteStationA.setName(nameA);
+        noteStationA.setPositionOnNote(noteA);
+
+        cwNoteStation noteStationB;
+        noteStationB.setName(nameB);
+        noteStationB.setPositionOnNote(noteB);
+
+        cwScrap* scrap = new cwScrap();
+        scrap->setPoints(outline);
+        scrap->addStation(noteStationA);
+        scrap->addStation(noteStationB);
+        notes.value(noteKey)->addScrap(scrap);
+        Scraps.append(scrap);
+
+        //Create the triangulation input directly, so it doesn't depend on the line plot
+        cwTriangulateStation stationA;
+        stationA.setName(nameA);
+        stationA.setNotePosition(noteA);
+        stationA.setPosition(positionA);
+
+        cwTriangulateStation stationB;
+        stationB.setName(nameB);
+        stationB.setNotePosition(noteB);
+        stationB.setPosition(positionB);
+
+        cwNoteTranformation noteTransform;
+        noteTransform.setScale(NoteScale);
+        noteTransform.setNorthUp(0.0);
+
+        cwTriangulateInData inData;
+        inData.setNoteImage(NoteImages.at(imageIndex));
+        inData.setOutline(QPolygonF(outline));
+        inData.setStations(QList<cwTriangulateStation>() << stationA << stationB);
+        inData.setNoteTransform(noteTransform);
+        inData.setNoteImageResolution(ImageDotsPerMeter);
+        TriangulateInData.append(inData);
+    }
+}
+
+/**
+ * @brief cwSyntheticCave::random
+ * @return A uniformly distributed random number between min and max
+ */
+double cwSyntheticCave::random(double min, double max)
+{
+    std::uniform_real_distribution<double> distribution(min, max);
+    return distribution(RandomEngine);
+}
+
+/**
+ * @brief cwSyntheticCave::Options::toJson
+ * @return The options as a json object, so benchmark results can be compared
+ */
+QJsonObject cwSyntheticCave::Options::toJson() const
+{
+    QJsonObject object;
+    object.insert("surveyLengthKm", SurveyLengthKm);
+    object.insert("loops", Loops);
+    object.insert("scraps", Scraps);
+    object.insert("images", Images);
+    object.insert("imageSize", ImageSize);
+    object.insert("shotsPerChunk", ShotsPerChunk);
+    object.insert("chunksPerTrip", ChunksPerTrip);
+    object.insert("seed", (int)Seed);
+    return object;
+}
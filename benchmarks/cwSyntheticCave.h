@@ -0,0 +1,146 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWSYNTHETICCAVE_H
+#define CWSYNTHETICCAVE_H
+
+//Our includes
+#include "cwImage.h"
+#include "cwTriangulateInData.h"
+class cwProject;
+class cwCavingRegion;
+class cwScrap;
+class cwTrip;
+
+//Qt includes
+#include <QHash>
+#include <QVector3D>
+#include <QStringList>
+#include <QJsonObject>
+
+//Std includes
+#include <random>
+
+/**
+ * @brief The cwSyntheticCave class
+ *
+ * Generates a reproducible cave for benchmarking. The survey is a random walk of
+ * shots, split into chunks and trips, with extra loop closing shots tied back to earlier
+ * stations. Scraps are drawn on generated note images that are added to the project's
+ * database, so they can be cropped and triangulated like real notes.
+ *
+ * The same Options and seed always generate the same cave.
+ */
+class cwSyntheticCave
+{
+public:
+    class Options {
+    public:
+        Options() :
+            SurveyLengthKm(1.0),
+            Loops(10),
+            Scraps(20),
+            Images(2),
+            ImageSize(2048),
+            ShotsPerChunk(50),
+            ChunksPerTrip(10),
+            Seed(1)
+        {}
+
+        double SurveyLengthKm; //!< Total length of the survey, not including the loop shots
+        int Loops; //!< Number of loop closing shots
+        int Scraps; //!< Number of scraps spread over all the note images
+        int Images; //!< Number of note images
+        int ImageSize; //!< Width and height of each note image in pixels
+        int ShotsPerChunk;
+        int ChunksPerTrip;
+        unsigned int Seed;
+
+        QJsonObject toJson() const;
+    };
+
+    cwSyntheticCave(Options options = Options());
+
+    void generate(cwProject* project);
+
+    Options options() const;
+
+    int stationCount() const;
+    int shotCount() const;
+
+    QList<cwTriangulateInData> triangulateInData() const;
+    QList<cwScrap*> scraps() const;
+
+private:
+    static const double NoteScale; //!< The scale of the notes, 1:500
+    static const double ImageDotsPerMeter; //!< 300 dpi
+
+    Options Opts;
+    std::mt19937 RandomEngine;
+
+    QStringList StationNames;
+    QHash<QString, QVector3D> StationPositions;
+    QHash<QString, cwTrip*> StationTrips; //!< The trip that surveyed the station
+    int ShotCount;
+
+    QList<cwImage> NoteImages;
+    QList<cwTriangulateInData> TriangulateInData;
+    QList<cwScrap*> Scraps;
+
+    void generateSurvey(cwCavingRegion* region);
+    void generateNoteImages(cwProject* project);
+    void generateScraps();
+
+    double random(double min, double max);
+};
+
+/**
+ * @brief cwSyntheticCave::options
+ * @return The options the cave was generated with
+ */
+inline cwSyntheticCave::Options cwSyntheticCave::options() const
+{
+    return Opts;
+}
+
+/**
+ * @brief cwSyntheticCave::stationCount
+ * @return The number of stations generated
+ */
+inline int cwSyntheticCave::stationCount() const
+{
+    return StationNames.size();
+}
+
+/**
+ * @brief cwSyntheticCave::shotCount
+ * @return The number of shots generated, including the loop closing shots
+ */
+inline int cwSyntheticCave::shotCount() const
+{
+    return ShotCount;
+}
+
+/**
+ * @brief cwSyntheticCave::triangulateInData
+ * @return The input for cwTriangulateTask for all the generated scraps
+ */
+inline QList<cwTriangulateInData> cwSyntheticCave::triangulateInData() const
+{
+    return TriangulateInData;
+}
+
+/**
+ * @brief cwSyntheticCave::scraps
+ * @return The generated scraps, in the same order as triangulateInData()
+ */
+inline QList<cwScrap*> cwSyntheticCave::scraps() const
+{
+    return Scraps;
+}
+
+#endif // CWSYNTHETICCAVE_H
@@ -0,0 +1,449 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwBenchmarkRunner.h"
+#include "cwSyntheticCave.h"
+
+//Cavewhere includes
+#include "cwProject.h"
+#include "cwCavingRegion.h"
+#include "cwCave.h"
+#include "cwLinePlotTask.h"
+#include "cwTriangulateTask.h"
+#include "cwTriangulatedData.h"
+#include "cwRegionSaveTask.h"
+#include "cwRegionLoadTask.h"
+#include "cwSurvexExporterRegionTask.h"
+#include "cwSurvexImporter.h"
+#include "cwCompassExporterCaveTask.h"
+#include "cwCompassImporter.h"
+#include "cwGeometryItersecter.h"
+#include "cwScrap.h"
+#include "cwSQLManager.h"
+#include "cwVertexWelder.h"
+#include "cwTriangulate.h"
+
+//Qt includes
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QThread>
+#include <QTextStream>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QAtomicInt>
+#include <QtMath>
+
+//Std includes
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+  Runs function with a connection to databaseName that's only used by the calling thread
+  */
+static void withConnection(QString databaseName, QString connectionName, std::function<void(QSqlDatabase&)> function)
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(databaseName);
+        if(database.open()) {
+            cwSQLManager::instance()->configureConnection(database);
+            function(database);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+static void insertRow(const QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO Data (value) VALUES (?)");
+    query.bindValue(0, QByteArray(4096, 'x'));
+    query.exec();
+}
+
+/**
+  Creates a WAL database with a 100 rows in the Data table
+  */
+static void createContentionDatabase(QString databaseName)
+{
+    QFile::remove(databaseName);
+    QFile::remove(databaseName + "-wal");
+    QFile::remove(databaseName + "-shm");
+
+    withConnection(databaseName, "BenchmarkSetup", [](QSqlDatabase& database) {
+        QSqlQuery query(database);
+        query.exec("CREATE TABLE Data (id INTEGER PRIMARY KEY AUTOINCREMENT, value BLOB)");
+        cwSQLManager::instance()->enableWriteAheadLog(database);
+
+        cwSQLManager::Transaction transaction(&database);
+        for(int i = 0; i < 100; i++) {
+            insertRow(database);
+        }
+    });
+}
+
+/**
+  A grid of points, like the full quads of a triangulated scrap, and points on and around the
+  grid, like the partial quads. Some of the points are within the tolerance of the grid and
+  each other.
+  */
+static void createWeldPoints(int gridSize, int numberOfPoints, float tolerance, QVector<QVector3D>* grid, QVector<QPointF>* points)
+{
+    double delta = 1.0 / gridSize;
+    for(int y = 0; y < gridSize; y++) {
+        for(int x = 0; x < gridSize; x++) {
+            grid->append(QVector3D(x * delta, y * delta, 0.0));
+        }
+    }
+
+    std::mt19937 generator(43);
+    std::uniform_int_distribution<int> gridIndex(0, gridSize * gridSize - 1);
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    std::uniform_real_distribution<double> jitter(-2.0 * tolerance, 2.0 * tolerance);
+
+    for(int i = 0; i < numberOfPoints; i++) {
+        switch(i % 3) {
+        case 0: {
+            //Near a grid point
+            QVector3D gridPoint = grid->at(gridIndex(generator));
+            points->append(QPointF(gridPoint.x() + jitter(generator), gridPoint.y() + jitter(generator)));
+            break;
+        }
+        case 1:
+            points->append(QPointF(position(generator), position(generator)));
+            break;
+        case 2:
+            //Near a point that was already added
+            points->append(points->at(i / 2) + QPointF(jitter(generator), jitter(generator)));
+            break;
+        }
+    }
+}
+
+/**
+  A star shaped polygon, with a random radius at each point
+  */
+static QVector<QPointF> randomStar(std::mt19937& generator, int numberOfPoints, double minRadius, double maxRadius)
+{
+    std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+    QVector<QPointF> polygon;
+    for(int i = 0; i < numberOfPoints; i++) {
+        double angle = 2.0 * M_PI * i / numberOfPoints;
+        double r = radius(generator);
+        polygon.append(QPointF(r * cos(angle), r * sin(angle)));
+    }
+    return polygon;
+}
+
+/**
+  The benchmark application times the core survey and geometry pipelines on a synthetic cave,
+  and writes the results as json, so regressions can be tracked from commit to commit.
+
+  Run with --help to see all the options.
+  */
+int main(int argc, char* argv[])
+{
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("cavewhere-benchmark");
+
+    cwSyntheticCave::Options defaults;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times cavewhere's survey and geometry pipelines on a synthetic cave");
+    parser.addHelpOption();
+
+    QCommandLineOption kmOption("km", "Length of the survey in kilometers", "km", QString::number(defaults.SurveyLengthKm));
+    QCommandLineOption loopsOption("loops", "Number of loop closing shots", "count", QString::number(defaults.Loops));
+    QCommandLineOption scrapsOption("scraps", "Number of scraps", "count", QString::number(defaults.Scraps));
+    QCommandLineOption imagesOption("images", "Number of note images", "count", QString::number(defaults.Images));
+    QCommandLineOption imageSizeOption("image-size", "Width and height of the note images in pixels", "pixels", QString::number(defaults.ImageSize));
+    QCommandLineOption seedOption("seed", "Seed for the synthetic cave", "seed", QString::number(defaults.Seed));
+    QCommandLineOption iterationsOption("iterations", "Number of times each benchmark is run", "count", "3");
+    QCommandLineOption rayOption("rays", "Number of rays for the intersection benchmark", "count", "1000");
+    QCommandLineOption filterOption("filter", "Only run benchmarks with names that match the regular expression", "regexp");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write the json results to file, instead of stdout", "file");
+
+    parser.addOptions(QList<QCommandLineOption>()
+                      << kmOption
+                      << loopsOption
+                      << scrapsOption
+                      << imagesOption
+                      << imageSizeOption
+                      << seedOption
+                      << iterationsOption
+                      << rayOption
+                      << filterOption
+                      << outputOption);
+    parser.process(app);
+
+    cwSyntheticCave::Options options;
+    options.SurveyLengthKm = parser.value(kmOption).toDouble();
+    options.Loops = parser.value(loopsOption).toInt();
+    options.Scraps = parser.value(scrapsOption).toInt();
+    options.Images = parser.value(imagesOption).toInt();
+    options.ImageSize = parser.value(imageSizeOption).toInt();
+    options.Seed = parser.value(seedOption).toUInt();
+
+    //Generate the cave, into a temporary project
+    cwProject* project = new cwProject();
+    cwSyntheticCave syntheticCave(options);
+    syntheticCave.generate(project);
+    cwCavingRegion* region = project->cavingRegion();
+
+    QThread* taskThread = new QThread();
+    taskThread->start();
+
+    cwBenchmarkRunner runner(parser.value(iterationsOption).toInt());
+    if(parser.isSet(filterOption)) {
+        runner.setFilter(QRegExp(parser.value(filterOption)));
+    }
+
+    QJsonObject caveSize;
+    caveSize.insert("stations", syntheticCave.stationCount());
+    caveSize.insert("shots", syntheticCave.shotCount());
+
+    //Line plot, survex export -> cavern -> plotsauce -> geometry
+    runner.run("linePlotTask", [&]() {
+        cwLinePlotTask* task = new cwLinePlotTask();
+        task->setData(*region);
+        runner.runTask(task, taskThread);
+        task->deleteLater();
+    }, std::function<void()>(), caveSize);
+
+    //Crop and triangulate all the scraps
+    QList<cwTriangulatedData> triangulatedData;
+    QJsonObject scrapSize;
+    scrapSize.insert("scraps", syntheticCave.triangulateInData().size());
+    runner.run("triangulateTask", [&]() {
+        cwTriangulateTask* task = new cwTriangulateTask();
+        task->setProjectFilename(project->filename());
+        task->setScrapData(syntheticCave.triangulateInData());
+        runner.runTask(task, taskThread);
+        triangulatedData = task->triangulatedScrapData();
+        task->deleteLater();
+    }, std::function<void()>(), scrapSize);
+
+    //Save the triangulated data with the region, like the scrap manager would
+    for(int i = 0; i < triangulatedData.size() && i < syntheticCave.scraps().size(); i++) {
+        syntheticCave.scraps().at(i)->setTriangulationData(triangulatedData.at(i));
+    }
+
+    runner.run("regionSaveTask", [&]() {
+        cwRegionSaveTask* task = new cwRegionSaveTask();
+        task->setCavingRegion(*region);
+        task->setDatabaseFilename(project->filename());
+        runner.runTask(task, taskThread);
+        task->deleteLater();
+    }, std::function<void()>(), caveSize);
+
+    runner.run("regionLoadTask", [&]() {
+        cwRegionLoadTask* task = new cwRegionLoadTask();
+        task->setDatabaseFilename(project->filename());
+        runner.runTask(task, taskThread);
+        task->deleteLater();
+    }, std::function<void()>(), caveSize);
+
+    //Importers, the files are created with the exporters
+    QString survexFile = QDir::tempPath() + "/cavewhere-benchmark.svx";
+    cwSurvexExporterRegionTask* survexExporter = new cwSurvexExporterRegionTask();
+    survexExporter->setData(*region);
+    survexExporter->setOutputFile(survexFile);
+    runner.runTask(survexExporter, taskThread);
+    survexExporter->deleteLater();
+
+    runner.run("survexImporter", [&]() {
+        cwSurvexImporter* importer = new cwSurvexImporter();
+        importer->setInputFiles(QStringList() << survexFile);
+        runner.runTask(importer, taskThread);
+        importer->deleteLater();
+    }, std::function<void()>(), caveSize);
+
+    QString compassFile = QDir::tempPath() + "/cavewhere-benchmark.dat";
+    cwCompassExportCaveTask* compassExporter = new cwCompassExportCaveTask();
+    compassExporter->setData(*region->cave(0));
+    compassExporter->setOutputFile(compassFile);
+    runner.runTask(compassExporter, taskThread);
+    compassExporter->deleteLater();
+
+    runner.run("compassImporter", [&]() {
+        cwCompassImporter* importer = new cwCompassImporter();
+        importer->setCompassDataFiles(QStringList() << compassFile);
+        runner.runTask(importer, taskThread);
+        importer->deleteLater();
+    }, std::function<void()>(), caveSize);
+
+    //Geometry intersection, on the triangulated scraps
+    int numberOfTriangles = 0;
+    QBox3D sceneBounds;
+    foreach(const cwTriangulatedData& data, triangulatedData) {
+        numberOfTriangles += data.indices().size() / 3;
+        foreach(const QVector3D& point, data.points()) {
+            sceneBounds.unite(point);
+        }
+    }
+
+    QJsonObject geometrySize;
+    geometrySize.insert("triangles", numberOfTriangles);
+
+    cwGeometryItersecter intersecter;
+    auto addTriangulatedData = [&]() {
+        for(int i = 0; i < triangulatedData.size(); i++) {
+            const cwTriangulatedData& data = triangulatedData.at(i);
+            intersecter.addObject(cwGeometryItersecter::Object(nullptr,
+                                                               i,
+                                                               data.points(),
+                                                               data.indices(),
+                                                               cwGeometryItersecter::Triangles));
+        }
+    };
+
+    runner.run("geometryItersecterAdd", addTriangulatedData, [&]() { intersecter.clear(); }, geometrySize);
+
+    //The spatial index is built by the first query after objects are added
+    runner.run("geometryItersecterIndex", [&]() {
+        intersecter.closestHit(QRay3D(sceneBounds.center(), QVector3D(0.0, 0.0, -1.0)));
+    }, [&]() {
+        intersecter.clear();
+        addTriangulatedData();
+    }, geometrySize);
+
+    //Rays straight down, spread over the scene
+    int numberOfRays = parser.value(rayOption).toInt();
+    QList<QRay3D> rays;
+    std::mt19937 rayEngine(options.Seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for(int i = 0; i < numberOfRays && !sceneBounds.isNull(); i++) {
+        QVector3D size = sceneBounds.size();
+        QVector3D origin = sceneBounds.minimum() + QVector3D(size.x() * unit(rayEngine),
+                                                             size.y() * unit(rayEngine),
+                                                             size.z() + 10.0);
+        rays.append(QRay3D(origin, QVector3D(0.0, 0.0, -1.0)));
+    }
+
+    geometrySize.insert("rays", rays.size());
+    runner.run("geometryItersecterRays", [&]() {
+        foreach(const QRay3D& ray, rays) {
+            intersecter.intersects(ray);
+        }
+    }, std::function<void()>(), geometrySize);
+
+    //Only the triangles, without falling back to the nearest station
+    runner.run("geometryItersecterClosestHit", [&]() {
+        foreach(const QRay3D& ray, rays) {
+            intersecter.closestHit(ray);
+        }
+    }, std::function<void()>(), geometrySize);
+
+    //Welding the partial quad points into the full quad grid, like cwTriangulateTask
+    const float weldTolerance = 0.000001f;
+    QVector<QVector3D> weldGrid;
+    QVector<QPointF> weldPoints;
+    createWeldPoints(400, 150000, weldTolerance, &weldGrid, &weldPoints);
+
+    QVector<QVector3D> weldedPoints;
+    QJsonObject weldSize;
+    weldSize.insert("gridPoints", weldGrid.size());
+    weldSize.insert("points", weldPoints.size());
+
+    runner.run("vertexWelder", [&]() {
+        cwVertexWelder welder(&weldedPoints, weldTolerance);
+        foreach(QPointF point, weldPoints) {
+            welder.weld(point);
+        }
+    }, [&]() { weldedPoints = weldGrid; }, weldSize);
+
+    //Polygon triangulation, like the scrap outlines in cwSGPolygonNode
+    std::mt19937 polygonEngine(1986);
+    for(int numberOfPoints = 1000; numberOfPoints <= 100000; numberOfPoints *= 10) {
+        QVector<QPointF> polygon = randomStar(polygonEngine, numberOfPoints, 1.0, 10.0);
+
+        QJsonObject polygonSize;
+        polygonSize.insert("points", numberOfPoints);
+
+        runner.run(QString("triangulatePolygon%1").arg(numberOfPoints), [&]() {
+            QVector<QPointF> triangles;
+            cwTriangulate::Process(polygon, triangles);
+        }, std::function<void()>(), polygonSize);
+    }
+
+    //One writer and a reader on every core, sharing a WAL database
+    QTemporaryDir databaseDir;
+    QString contentionDatabase = databaseDir.path() + "/contention.cw";
+    const int numberOfReaders = QThread::idealThreadCount();
+    const int numberOfWrites = 50;
+    const int readsPerReader = 200;
+
+    QJsonObject contentionSize;
+    contentionSize.insert("readers", numberOfReaders);
+    contentionSize.insert("reads", numberOfReaders * readsPerReader);
+    contentionSize.insert("writes", numberOfWrites);
+
+    runner.run("sqlReadersWithWriter", [&]() {
+        std::thread writer([&]() {
+            withConnection(contentionDatabase, "BenchmarkWriter", [&](QSqlDatabase& database) {
+                for(int i = 0; i < numberOfWrites; i++) {
+                    cwSQLManager::Transaction transaction(&database);
+                    for(int j = 0; j < 10; j++) {
+                        insertRow(database);
+                    }
+                }
+            });
+        });
+
+        std::vector<std::thread> readers;
+        for(int i = 0; i < numberOfReaders; i++) {
+            readers.emplace_back([&, i]() {
+                withConnection(contentionDatabase, QString("BenchmarkReader%1").arg(i), [&](QSqlDatabase& database) {
+                    for(int j = 0; j < readsPerReader; j++) {
+                        cwSQLManager::Transaction transaction(&database, cwSQLManager::ReadOnly);
+                        QSqlQuery query("SELECT count(*) FROM Data", database);
+                        query.next();
+                    }
+                });
+            });
+        }
+
+        for(auto& reader : readers) {
+            reader.join();
+        }
+        writer.join();
+    }, [&]() { createContentionDatabase(contentionDatabase); }, contentionSize);
+
+    //Write the results
+    QJsonObject results;
+    results.insert("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    results.insert("cave", options.toJson());
+    results.insert("benchmarks", runner.results());
+
+    QByteArray json = QJsonDocument(results).toJson();
+    if(parser.isSet(outputOption)) {
+        QFile outputFile(parser.value(outputOption));
+        if(!outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+            QTextStream(stderr) << "Couldn't open " << outputFile.fileName() << " for writing" << endl;
+            return 1;
+        }
+        outputFile.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    QFile::remove(survexFile);
+    QFile::remove(compassFile);
+
+    taskThread->quit();
+    taskThread->wait();
+
+    return 0;
+}
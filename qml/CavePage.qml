@@ -172,8 +172,8 @@ Rectangle {
                         }
                     }
 
-                    TripLengthTask {
-                        id: tripLengthTask
+                    TripStatistics {
+                        id: tripStatistics
                         trip: styleData.value
                     }
 
@@ -244,7 +244,7 @@ Rectangle {
                                 break;
                             }
 
-                            return Utils.fixed(tripLengthTask.length, 2) + " " + unit;
+                            return Utils.fixed(tripStatistics.length, 2) + " " + unit;
                         }
                     }
 
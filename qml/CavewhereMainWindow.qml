@@ -41,12 +41,25 @@ ApplicationWindow {
         onOpenAboutWindow:  {
             loadAboutWindowId.setSource("AboutWindow.qml")
         }
+
+        onOpenTaskTraceWindow: {
+            if(loadTaskTraceWindowId.item) {
+                //Reopen the window after it's been closed
+                loadTaskTraceWindowId.item.visible = true
+            } else {
+                loadTaskTraceWindowId.setSource("TaskTraceWindow.qml")
+            }
+        }
     }
 
     Loader {
         id: loadAboutWindowId
     }
 
+    Loader {
+        id: loadTaskTraceWindowId
+    }
+
     Loader {
         id: loadMainContentsId
         source: "MainContent.qml"
@@ -95,6 +108,20 @@ ApplicationWindow {
         }
     }
 
+    MessageDialog {
+        id: saveAsErrorDialogId
+        title: "Couldn't Save Cavewhere Project"
+        icon: StandardIcon.Critical
+    }
+
+    Connections {
+        target: project
+        onSaveAsFailed: {
+            saveAsErrorDialogId.text = errorMessage
+            saveAsErrorDialogId.open()
+        }
+    }
+
     FileDialog {
         id: loadFileDialogId
         nameFilters: ["Cavewhere File (*.cw)"]
@@ -19,6 +19,7 @@ MenuBar {
     property FileDialog saveAsFileDialog;
 
     signal openAboutWindow;
+    signal openTaskTraceWindow;
 
     Menu {
         title: "File"
@@ -125,6 +126,11 @@ MenuBar {
             }
         }
 
+        MenuItem {
+            text: "Recent Tasks"
+            onTriggered: openTaskTraceWindow();
+        }
+
         Menu {
             title: "Event Recording"
 
@@ -23,8 +23,8 @@ Item {
     width: scrollAreaId.width
     height: 100
 
-    TripLengthTask {
-        id: tripLengthTask
+    TripStatistics {
+        id: tripStatistics
         trip: currentTrip
     }
 
@@ -168,7 +168,7 @@ Item {
                             break;
                         }
 
-                        return "Total Length: " + Utils.fixed(tripLengthTask.length, 2) + " " + unit;
+                        return "Total Length: " + Utils.fixed(tripStatistics.length, 2) + " " + unit;
                     }
                 }
 
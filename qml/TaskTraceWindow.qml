@@ -0,0 +1,81 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+import QtQuick 2.0
+import QtQuick.Controls 1.0
+import QtQuick.Window 2.0
+import QtQuick.Dialogs 1.2
+
+Window {
+    id: taskTraceWindow
+    width: 500
+    height: 400
+    title: "Recent Tasks"
+    color: "#E8E8E8"
+    visible: true
+
+    property var recentTasks: rootData.taskManagerModel.recentTasks
+
+    //The model is only refreshed while the window is open, instead of for every task
+    Timer {
+        interval: 1000
+        repeat: true
+        triggeredOnStart: true
+        running: taskTraceWindow.visible
+        onTriggered: recentTasks.refresh()
+    }
+
+    Row {
+        id: buttonRowId
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.margins: 5
+        spacing: 5
+
+        Button {
+            text: "Refresh"
+            onClicked: recentTasks.refresh()
+        }
+
+        Button {
+            text: "Save Trace"
+            onClicked: saveTraceDialogId.open()
+        }
+    }
+
+    ListView {
+        anchors.top: buttonRowId.bottom
+        anchors.bottom: parent.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 5
+        clip: true
+
+        model: recentTasks
+
+        delegate: Text {
+            text: nameRole
+                  + (parentNameRole !== "" ? " (" + parentNameRole + ")" : "")
+                  + " " + statusRole
+                  + " on " + threadNameRole
+                  + " waited: " + queueWaitRole.toFixed(2) + "ms"
+                  + " ran: " + runTimeRole.toFixed(2) + "ms"
+        }
+    }
+
+    FileDialog {
+        id: saveTraceDialogId
+        nameFilters: ["Chrome Trace (*.json)"]
+        title: "Save Task Trace"
+        selectExisting: false
+        folder: rootData.lastDirectory
+        onAccepted: {
+            rootData.lastDirectory = fileUrl
+            rootData.taskManagerModel.saveTrace(fileUrl)
+        }
+    }
+}
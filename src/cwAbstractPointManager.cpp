@@ -10,6 +10,7 @@
 #include "cwTransformUpdater.h"
 #include "cwDebug.h"
 #include "cwSelectionManager.h"
+#include "cwPointLayerItem.h"
 
 //Qt includes
 #include <QQmlEngine>
@@ -20,7 +21,10 @@ cwAbstractPointManager::cwAbstractPointManager(QQuickItem *parent) :
     TransformUpdater(nullptr),
     ItemComponent(nullptr),
     SelectionManager(nullptr),
-    SelectedItemIndex(-1)
+    SelectedItemIndex(-1),
+    PointLayer(nullptr),
+    SelectedPointItem(nullptr),
+    NumberOfPoints(0)
 {
 
 }
@@ -34,17 +38,21 @@ void cwAbstractPointManager::setTransformUpdater(cwTransformUpdater* updater) {
     if(TransformUpdater != updater) {
         if(TransformUpdater != nullptr) {
             //Remove all previous stations
-            foreach(QQuickItem* item, Items) {
+            foreach(QQuickItem* item, items()) {
                 TransformUpdater->removePointItem(item);
             }
         }
 
         TransformUpdater = updater;
 
+        if(PointLayer != nullptr) {
+            PointLayer->setTransformUpdater(TransformUpdater);
+        }
+
         if(TransformUpdater != nullptr) {
             //Add station to the new transformUpdater
 
-            foreach(QQuickItem* item, Items) {
+            foreach(QQuickItem* item, items()) {
                 TransformUpdater->addPointItem(item);
             }
         }
@@ -106,7 +114,7 @@ QQuickItem* cwAbstractPointManager::createItem() {
   Called when a point has been added
   */
 void cwAbstractPointManager::pointAdded() {
-    int lastIndex = Items.size();
+    int lastIndex = numberOfPoints();
     pointsInserted(lastIndex, lastIndex);
 }
 
@@ -126,6 +134,16 @@ void cwAbstractPointManager::pointRemoved(int index) {
  */
 void cwAbstractPointManager::pointsInserted(int begin, int end)
 {
+    if(PointLayer != nullptr) {
+        NumberOfPoints += end - begin + 1;
+        PointLayer->insertPoints(begin, pointPositions(begin, end));
+
+        if(SelectedItemIndex >= begin) {
+            moveSelectedIndex(SelectedItemIndex + end - begin + 1);
+        }
+        return;
+    }
+
     createComponent();
 
     for(int i = begin; i <= end; i++) {
@@ -155,10 +173,22 @@ void cwAbstractPointManager::pointsInserted(int begin, int end)
  */
 void cwAbstractPointManager::pointsRemoved(int begin, int end)
 {
-    if(Items.isEmpty()) { return; }
+    if(numberOfPoints() == 0) { return; }
     if(begin > end) { return; }
     if(begin < 0) { return; }
-    if(end >= Items.size()) { return; }
+    if(end >= numberOfPoints()) { return; }
+
+    if(PointLayer != nullptr) {
+        if(SelectedItemIndex >= begin && SelectedItemIndex <= end) {
+            clearSelection();
+        } else if(SelectedItemIndex > end) {
+            moveSelectedIndex(SelectedItemIndex - (end - begin + 1));
+        }
+
+        NumberOfPoints -= end - begin + 1;
+        PointLayer->removePoints(begin, end);
+        return;
+    }
 
     for(int index = end; index >= begin; index--) {
         //Unselect the item that's going to be deleted
@@ -182,6 +212,9 @@ void cwAbstractPointManager::pointsRemoved(int begin, int end)
 void cwAbstractPointManager::updateItemsPositions(int begin, int end)
 {
     for(int i = begin; i <= end; i++) {
+        if(PointLayer != nullptr) {
+            PointLayer->setPoint(i, pointPosition(i));
+        }
         privateUpdateItemPosition(i);
     }
 }
@@ -208,6 +241,17 @@ void cwAbstractPointManager::updateSelection()
  */
 void cwAbstractPointManager::resizeNumberOfItems(int numberOfPoints)
 {
+    if(PointLayer != nullptr) {
+        if(SelectedItemIndex >= numberOfPoints) {
+            clearSelection();
+        }
+
+        NumberOfPoints = numberOfPoints;
+        PointLayer->setPoints(pointPositions(0, numberOfPoints - 1));
+        updateAllItemData();
+        return;
+    }
+
     //Make sure we have a note component so we can create it
     createComponent();
 
@@ -240,6 +284,13 @@ void cwAbstractPointManager::resizeNumberOfItems(int numberOfPoints)
   */
 void cwAbstractPointManager::updateAllItemData()
 {
+    if(PointLayer != nullptr) {
+        if(SelectedPointItem != nullptr && SelectedItemIndex >= 0) {
+            privateUpdateItemData(SelectedPointItem, SelectedItemIndex);
+        }
+        return;
+    }
+
     //Update all the station data
     for(int i = 0; i < Items.size(); i++) {
         privateUpdateItemData(Items.at(i), i);
@@ -252,16 +303,20 @@ void cwAbstractPointManager::updateAllItemData()
  */
 void cwAbstractPointManager::setSelectedItemIndex(int selectedIndex) {
     if(SelectedItemIndex != selectedIndex) {
-        if(selectedIndex >= Items.size()) {
+        if(selectedIndex >= numberOfPoints()) {
             qDebug() << "Selected station index invalid" << selectedIndex << LOCATION;
             return;
         }
 
         SelectedItemIndex = selectedIndex;
 
+        if(PointLayer != nullptr) {
+            setSelectedPointItem(selectedIndex);
+        }
+
         //Select the new station item
         if(selectedIndex >= 0) {
-            QQuickItem* newItem = Items.at(selectedIndex);
+            QQuickItem* newItem = PointLayer != nullptr ? SelectedPointItem : Items.at(selectedIndex);
             if(selectionManager() != nullptr) {
                 selectionManager()->setSelectedItem(newItem);
             } else {
@@ -269,6 +324,11 @@ void cwAbstractPointManager::setSelectedItemIndex(int selectedIndex) {
             }
         } else {
             selectionManager()->setSelectedItem(nullptr); //deselect the current item
+
+            if(SelectedPointItem != nullptr) {
+                SelectedPointItem->deleteLater();
+                SelectedPointItem = nullptr;
+            }
         }
 
         emit selectedItemIndexChanged();
@@ -281,8 +341,12 @@ void cwAbstractPointManager::setSelectedItemIndex(int selectedIndex) {
   If there's no select station item, this will return null
   */
 QQuickItem* cwAbstractPointManager::selectedItem() const {
-    if(SelectedItemIndex >= 0 && SelectedItemIndex < Items.size()) {
-        QQuickItem* item = Items.at(SelectedItemIndex);
+    if(SelectedItemIndex >= 0 && SelectedItemIndex < numberOfPoints()) {
+        QQuickItem* item = PointLayer != nullptr ? SelectedPointItem : Items.at(SelectedItemIndex);
+        if(item == nullptr) {
+            return nullptr;
+        }
+
         if(selectionManager() != nullptr) {
             if(selectionManager()->isSelected(item)) {
                 return item;
@@ -298,6 +362,13 @@ QQuickItem* cwAbstractPointManager::selectedItem() const {
  */
 QList<QQuickItem *> cwAbstractPointManager::items() const
 {
+    if(PointLayer != nullptr) {
+        QList<QQuickItem*> items;
+        if(SelectedPointItem != nullptr) {
+            items.append(SelectedPointItem);
+        }
+        return items;
+    }
     return Items;
 }
 
@@ -306,6 +377,13 @@ QList<QQuickItem *> cwAbstractPointManager::items() const
      * @param index - The index that needs to be updated
      */
 void cwAbstractPointManager::privateUpdateItemPosition(int index) {
+    if(PointLayer != nullptr) {
+        if(SelectedPointItem != nullptr && index == SelectedItemIndex) {
+            updateItemPosition(SelectedPointItem, index);
+        }
+        return;
+    }
+
     if(index >= 0 && index < Items.size()) {
         updateItemPosition(Items.at(index), index);
     }
@@ -356,3 +434,145 @@ void cwAbstractPointManager::setSelectionManager(cwSelectionManager* selectionMa
     }
 }
 
+
+/**
+ * @brief cwAbstractPointManager::enablePointLayer
+ *
+ * Draws all the points with a single cwPointLayerItem, instead of creating a QML item for every
+ * point. A QML item is only created for the selected point. This should be called in the
+ * subclass's constructor.
+ */
+void cwAbstractPointManager::enablePointLayer()
+{
+    if(PointLayer != nullptr) { return; }
+
+    PointLayer = new cwPointLayerItem(this);
+    PointLayer->setTransformUpdater(TransformUpdater);
+    updatePointLayerSize();
+
+    connect(this, &QQuickItem::widthChanged, this, &cwAbstractPointManager::updatePointLayerSize);
+    connect(this, &QQuickItem::heightChanged, this, &cwAbstractPointManager::updatePointLayerSize);
+    connect(PointLayer, &cwPointLayerItem::pointPressed, this, &cwAbstractPointManager::selectFromPointLayer);
+    connect(PointLayer, &cwPointLayerItem::pointMoved, this, &cwAbstractPointManager::pointLayerMoved);
+
+    NumberOfPoints = Items.size();
+}
+
+/**
+ * @brief cwAbstractPointManager::pointPosition
+ * @return The position of the point at pointIndex, in model coordinates
+ *
+ * Subclasses that use enablePointLayer() need to implement this
+ */
+QVector3D cwAbstractPointManager::pointPosition(int pointIndex) const
+{
+    Q_UNUSED(pointIndex);
+    return QVector3D();
+}
+
+/**
+ * @brief cwAbstractPointManager::pointLayerPressed
+ * @param pointIndex - The point that was pressed in the point layer
+ *
+ * Called after the point has been selected. The default does nothing.
+ */
+void cwAbstractPointManager::pointLayerPressed(int pointIndex)
+{
+    Q_UNUSED(pointIndex);
+}
+
+/**
+ * @brief cwAbstractPointManager::pointLayerMoved
+ * @param pointIndex - The point that's being dragged in the point layer
+ * @param modelPoint - Where the point was dragged to, in model coordinates
+ *
+ * The default does nothing.
+ */
+void cwAbstractPointManager::pointLayerMoved(int pointIndex, QVector3D modelPoint)
+{
+    Q_UNUSED(pointIndex);
+    Q_UNUSED(modelPoint);
+}
+
+/**
+ * @brief cwAbstractPointManager::selectFromPointLayer
+ *
+ * Selects the point that was pressed in the point layer
+ */
+void cwAbstractPointManager::selectFromPointLayer(int pointIndex)
+{
+    setSelectedItemIndex(pointIndex);
+    pointLayerPressed(pointIndex);
+}
+
+/**
+ * @brief cwAbstractPointManager::updatePointLayerSize
+ *
+ * The point layer covers this item, so it uses the same coordinates as the point items
+ */
+void cwAbstractPointManager::updatePointLayerSize()
+{
+    PointLayer->setPosition(QPointF(0.0, 0.0));
+    PointLayer->setSize(QSizeF(width(), height()));
+}
+
+/**
+ * @brief cwAbstractPointManager::numberOfPoints
+ * @return The number of points that this manager has
+ */
+int cwAbstractPointManager::numberOfPoints() const
+{
+    return PointLayer != nullptr ? NumberOfPoints : Items.size();
+}
+
+/**
+ * @brief cwAbstractPointManager::pointPositions
+ * @return The positions of the points between begin and end, for the point layer
+ */
+QVector<QVector3D> cwAbstractPointManager::pointPositions(int begin, int end) const
+{
+    QVector<QVector3D> positions;
+    positions.reserve(qMax(0, end - begin + 1));
+    for(int i = begin; i <= end; i++) {
+        positions.append(pointPosition(i));
+    }
+    return positions;
+}
+
+/**
+ * @brief cwAbstractPointManager::setSelectedPointItem
+ * @param index - The selected point
+ *
+ * Creates the point item for the selected point, and hides the point in the point layer
+ */
+void cwAbstractPointManager::setSelectedPointItem(int index)
+{
+    PointLayer->setHiddenIndex(index);
+
+    if(index < 0) {
+        return;
+    }
+
+    if(SelectedPointItem == nullptr) {
+        createComponent();
+        SelectedPointItem = createItem();
+    }
+
+    privateUpdateItemData(SelectedPointItem, index);
+}
+
+/**
+ * @brief cwAbstractPointManager::moveSelectedIndex
+ * @param index - The new index of the selected point
+ *
+ * Keeps the same point selected after points have been inserted or removed before it
+ */
+void cwAbstractPointManager::moveSelectedIndex(int index)
+{
+    SelectedItemIndex = index;
+    PointLayer->setHiddenIndex(index);
+    if(SelectedPointItem != nullptr) {
+        privateUpdateItemData(SelectedPointItem, index);
+    }
+    emit selectedItemIndexChanged();
+}
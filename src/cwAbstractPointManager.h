@@ -12,10 +12,13 @@
 #include <QObject>
 #include <QUrl>
 #include <QQuickItem>
+#include <QVector>
+#include <QVector3D>
 
 //Our includes
 class cwTransformUpdater;
 class cwSelectionManager;
+class cwPointLayerItem;
 
 /**
  * @brief The cwAbsrtactPointManager class
@@ -23,6 +26,9 @@ class cwSelectionManager;
  * This is an abstarct base class that provides methods to create points or label in 3d area, using
  * a transformUpdate.  This class also support simple selection.
  *
+ * By default, a QML item is created for every point. Subclasses with lots of points can call
+ * enablePointLayer(). Then all the points are drawn by a single cwPointLayerItem, and a QML item is
+ * only created for the selected point. The subclass must implement pointPosition() for the layer.
  */
 class cwAbstractPointManager : public QQuickItem
 {
@@ -62,6 +68,12 @@ protected:
     void resizeNumberOfItems(int numberOfStations);
     void updateAllItemData();
 
+    void enablePointLayer();
+    cwPointLayerItem* pointLayer() const;
+    virtual QVector3D pointPosition(int pointIndex) const;
+    virtual void pointLayerPressed(int pointIndex);
+    virtual void pointLayerMoved(int pointIndex, QVector3D modelPoint);
+
 protected slots:
     void pointAdded();
     void pointRemoved(int index);
@@ -71,6 +83,8 @@ protected slots:
 
 private slots:
     void updateSelection();
+    void selectFromPointLayer(int pointIndex);
+    void updatePointLayerSize();
 
 private:
     //Will keep the note stations at the correct location
@@ -84,12 +98,22 @@ private:
 
     int SelectedItemIndex; //!< The currently selected index
 
+    //Only used with enablePointLayer()
+    cwPointLayerItem* PointLayer; //!< Draws all the points
+    QQuickItem* SelectedPointItem; //!< The only point item, created for the selected point
+    int NumberOfPoints;
+
     void createComponent();
     QQuickItem* createItem();
     void removeItem(int index);
 
     void privateUpdateItemPosition(int index);
     void privateUpdateItemData(QQuickItem* item, int index);
+
+    int numberOfPoints() const;
+    QVector<QVector3D> pointPositions(int begin, int end) const;
+    void setSelectedPointItem(int index);
+    void moveSelectedIndex(int index);
 };
 
 Q_DECLARE_METATYPE(cwAbstractPointManager*)
@@ -115,6 +139,14 @@ inline void cwAbstractPointManager::clearSelection() {
     setSelectedItemIndex(-1);
 }
 
+/**
+ * @brief cwAbstractPointManager::pointLayer
+ * @return The layer that draws all the points, or nullptr if enablePointLayer() hasn't been called
+ */
+inline cwPointLayerItem* cwAbstractPointManager::pointLayer() const {
+    return PointLayer;
+}
+
 /**
 Gets selectionManager
 */
@@ -33,6 +33,7 @@
 #include <QBuffer>
 #include <QtConcurrentMap>
 #include <QOpenGLContext>
+#include <QCryptographicHash>
 
 //TODO: REMOVE for testing only
 #include <QFile>
@@ -179,14 +180,15 @@ void cwAddImageTask::tryAddingImagesToDatabase() {
 
         //Copy the original image to the database
         QImage originalImage;
+        QByteArray sourceHash;
         //        if(MipmapOnly) {
         //            originalImage = QImage(imagePath);
         //        } else {
-        originalImage = copyOriginalImage(imagePath, &imageIds);
+        originalImage = copyOriginalImage(imagePath, &imageIds, &sourceHash);
         //        }
 
         if(!originalImage.isNull()) {
-            images.append(PrivateImageData(imageIds, originalImage, imagePath));
+            images.append(PrivateImageData(imageIds, originalImage, sourceHash, imagePath));
         }
     }
 
@@ -197,12 +199,14 @@ void cwAddImageTask::tryAddingImagesToDatabase() {
         //Where the database image ideas are stored
         cwImage imageIds;
 
+        QByteArray sourceHash;
+
         //FIXME: This !Mipmap break carpeting, becaus cwImage.isValid() fails???
         //        if(!MipmapOnly) {
-        copyOriginalImage(originalImage, &imageIds);
+        copyOriginalImage(originalImage, &imageIds, &sourceHash);
         //        }
 
-        images.append(PrivateImageData(imageIds, originalImage));
+        images.append(PrivateImageData(imageIds, originalImage, sourceHash));
     }
 
     //Go through all the images
@@ -210,14 +214,15 @@ void cwAddImageTask::tryAddingImagesToDatabase() {
         cwImage& imageIds = images[i].Id;
         const QImage& originalImage = images[i].OriginalImage;
         const QString name = images[i].Name;
+        const QByteArray& sourceHash = images[i].SourceHash;
 
         //Create a icon image
         if(!MipmapOnly) {
-            createIcon(originalImage, name, &imageIds);
+            createIcon(originalImage, name, &imageIds, sourceHash);
         }
 
         //Create mipmaps
-        createMipmaps(originalImage, name, &imageIds);
+        createMipmaps(originalImage, name, &imageIds, sourceHash);
 
         //Add image ids to the list of images that are returned
         Images.append(imageIds);
@@ -233,7 +238,7 @@ void cwAddImageTask::tryAddingImagesToDatabase() {
         QImage originalImage = imageProvider.image(RegenerateImage.original());
 
         if(!originalImage.isNull()) {
-            createMipmaps(originalImage, "", &RegenerateImage);
+            createMipmaps(originalImage, "", &RegenerateImage, QByteArray());
         }
     }
 
@@ -243,8 +248,10 @@ void cwAddImageTask::tryAddingImagesToDatabase() {
 
 /**
   \brief This copies the original image to the new place
+
+  sourceHash is set to the hash that identifies the original, see addImageToDatabase()
   */
-QImage cwAddImageTask::copyOriginalImage(QString imagePath, cwImage* imageIdContainer) {
+QImage cwAddImageTask::copyOriginalImage(QString imagePath, cwImage* imageIdContainer, QByteArray* sourceHash) {
 
     emit statusMessage(QString("Copying %1").arg(QFileInfo(imagePath).fileName()));
 
@@ -277,7 +284,7 @@ QImage cwAddImageTask::copyOriginalImage(QString imagePath, cwImage* imageIdCont
         originalImageByteData = QByteArray();
     }
 
-    *imageIdContainer = addImageToDatabase(image, format, originalImageByteData);
+    *imageIdContainer = addImageToDatabase(image, format, originalImageByteData, sourceHash);
 
     return image;
 }
@@ -285,7 +292,7 @@ QImage cwAddImageTask::copyOriginalImage(QString imagePath, cwImage* imageIdCont
 /**
     \brief this adds the image to the database
   */
-void cwAddImageTask::copyOriginalImage(const QImage &image, cwImage *imageIds)
+void cwAddImageTask::copyOriginalImage(const QImage &image, cwImage *imageIds, QByteArray* sourceHash)
 {
     QByteArray format = "jpg";
     QByteArray imageData;
@@ -296,15 +303,19 @@ void cwAddImageTask::copyOriginalImage(const QImage &image, cwImage *imageIds)
         writer.write(image);
     }
 
-    *imageIds = addImageToDatabase(image, format, imageData);
+    *imageIds = addImageToDatabase(image, format, imageData, sourceHash);
 }
 
 /**
   \brief Adds the image to the database
+
+  If the same image is already in the database, it's reused. sourceHash is set to the content hash
+  of the image. When there's no imageData (mipmaps only), sourceHash is the hash of the pixels.
   */
 cwImage cwAddImageTask::addImageToDatabase(const QImage &image,
                                            const QByteArray &format,
-                                           const QByteArray &imageData)
+                                           const QByteArray &imageData,
+                                           QByteArray* sourceHash)
 {
     int dotsPerMeter = 0;
     if(image.dotsPerMeterX() == image.dotsPerMeterY()) {
@@ -313,7 +324,10 @@ cwImage cwAddImageTask::addImageToDatabase(const QImage &image,
 
     //Write the image to the database
     cwImageData originalImageData(image.size(), dotsPerMeter, format, imageData);
-    int imageId = cwProject::addImage(Database, originalImageData);
+    QByteArray contentHash = cwProject::imageHash(originalImageData);
+    int imageId = cwProject::addImage(Database, originalImageData, contentHash);
+
+    *sourceHash = contentHash.isEmpty() ? pixelHash(image) : contentHash;
 
     cwImage imageIdContainer;
     imageIdContainer.setOriginal(imageId);
@@ -326,9 +340,10 @@ cwImage cwAddImageTask::addImageToDatabase(const QImage &image,
 /**
   \brief Creates an icon of the original image
 
-  If the originalImage is less than 512x512, this just save the full image as a icon
+  If the originalImage is less than 512x512, this just save the full image as a icon. If the icon
+  for sourceHash is already in the database, it's reused.
   */
-void cwAddImageTask::createIcon(QImage originalImage, QString imageFilename, cwImage* imageIds) {
+void cwAddImageTask::createIcon(QImage originalImage, QString imageFilename, cwImage* imageIds, const QByteArray& sourceHash) {
     emit statusMessage(QString("Generating icon for %1").arg(QFileInfo(imageFilename).fileName()));
 
     QSize scaledSize = QSize(512, 512);
@@ -340,6 +355,13 @@ void cwAddImageTask::createIcon(QImage originalImage, QString imageFilename, cwI
         return;
     }
 
+    QByteArray iconHash = cwProject::derivedImageHash(sourceHash, "icon", scaledSize);
+    int existingId = cwProject::reuseImage(Database, iconHash);
+    if(existingId != -1) {
+        imageIds->setIcon(existingId);
+        return;
+    }
+
     QImage scaledImage = originalImage.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
 
     //Convert the image into a jpg
@@ -354,7 +376,7 @@ void cwAddImageTask::createIcon(QImage originalImage, QString imageFilename, cwI
 
     //Write the data to database
     cwImageData iconImageData(scaledSize, dotMeter, format, jpgData);
-    int imageId = cwProject::addImage(Database, iconImageData);
+    int imageId = cwProject::addImage(Database, iconImageData, iconHash);
     imageIds->setIcon(imageId);
 }
 
@@ -363,10 +385,14 @@ void cwAddImageTask::createIcon(QImage originalImage, QString imageFilename, cwI
 
   The return stringList is a list of all the mipmaps, starting with level 0 going to level
   size-1 of the list.
+
+  Mipmap levels that are already in the database for sourceHash are reused, without scaling or
+  compressing them. This makes re-importing an image nearly instant.
   */
 void cwAddImageTask::createMipmaps(QImage originalImage,
                                    QString imageFilename,
-                                   cwImage* imageIds) {
+                                   cwImage* imageIds,
+                                   const QByteArray& sourceHash) {
 
     QSizeF clipArea;
     QImage scaledImage = ensureImageDivisibleBy4(originalImage, &clipArea);
@@ -381,16 +407,26 @@ void cwAddImageTask::createMipmaps(QImage originalImage,
     for(int i = 0; i < numberOfLevels && isRunning(); i++) {
         emit statusMessage(QString("Compressing %1 of %2 bold flavors of %3").arg(i + 1).arg(numberOfLevels).arg(QFileInfo(imageFilename).fileName()));
 
-        //Rescaled the image
-        scaledImage = scaledImage.scaled(scaledImageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-
         int mipmapId = -1;
+        QByteArray mipmapHash;
         if(regeneratingMipmaps) {
             mipmapId = imageIds->mipmaps().at(i);
+        } else {
+            mipmapHash = cwProject::derivedImageHash(sourceHash, cwImageProvider::Dxt1_GZ_Extension, scaledImageSize);
+            int existingId = cwProject::reuseImage(Database, mipmapHash);
+            if(existingId != -1) {
+                mipmapIds.append(existingId);
+                IncreaseProgress((scaledImageSize.width() / 4 + 1) * (scaledImageSize.height() / 4 + 1));
+                scaledImageSize = halfSize(scaledImageSize);
+                continue;
+            }
         }
 
+        //Rescaled the image, from the last level that was scaled
+        scaledImage = scaledImage.scaled(scaledImageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
         //Export the image to DXT1 format
-        mipmapId = saveToDXT1Format(scaledImage, mipmapId);
+        mipmapId = saveToDXT1Format(scaledImage, mipmapId, mipmapHash);
 
         //Add the path to the mipmapPath
         if(!regeneratingMipmaps) {
@@ -425,8 +461,9 @@ int cwAddImageTask::numberOfMipmapLevels(QSize imageSize) const {
 
   \param image - The image that'll be converted
   \param id - The id that'll be overwritten by the task
+  \param contentHash - Identifies the mipmap when it's added, see cwProject::derivedImageHash()
   */
-int cwAddImageTask::saveToDXT1Format(QImage image, int id) {
+int cwAddImageTask::saveToDXT1Format(QImage image, int id, const QByteArray& contentHash) {
     //Convert and compress using dxt1
     //20 times slower on my computer
 //#ifdef Q_OS_WIN
@@ -451,7 +488,7 @@ int cwAddImageTask::saveToDXT1Format(QImage image, int id) {
     int imageId;
     if(id == -1) {
         //Add the image
-        imageId = cwProject::addImage(Database, iconImageData);
+        imageId = cwProject::addImage(Database, iconImageData, contentHash);
     } else {
         imageId = id;
         cwProject::updateImage(Database, iconImageData, id);
@@ -788,8 +825,8 @@ QImage cwAddImageTask::ensureImageDivisibleBy4(QImage originalImage, QSizeF *cli
 
   This uses an atomic integer that's thread safe
   */
-void cwAddImageTask::IncreaseProgress() {
-    int originalValue = Progress.fetchAndAddRelaxed(1);
+void cwAddImageTask::IncreaseProgress(int steps) {
+    int originalValue = Progress.fetchAndAddRelaxed(steps);
 
     //Normalize to progress
     double percent = 100.0 * (originalValue / (double)numberOfSteps());
@@ -800,4 +837,20 @@ void cwAddImageTask::IncreaseProgress() {
     setProgress(wholeProgress);
 }
 
-
+/**
+ * @brief cwAddImageTask::pixelHash
+ * @param image
+ * @return The hash of the image's pixels, this identifies images that don't have file data
+ */
+QByteArray cwAddImageTask::pixelHash(const QImage &image)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(QByteArray::number(image.format()));
+    hash.addData(QByteArray::number(image.width()));
+    hash.addData("x");
+    hash.addData(QByteArray::number(image.height()));
+    for(int y = 0; y < image.height(); y++) {
+        hash.addData(reinterpret_cast<const char*>(image.constScanLine(y)), image.bytesPerLine());
+    }
+    return hash.result();
+}
@@ -65,9 +65,10 @@ private:
     class PrivateImageData {
     public:
         PrivateImageData() { }
-        PrivateImageData(cwImage id, QImage original, QString name = QString("default image")) :
+        PrivateImageData(cwImage id, QImage original, QByteArray sourceHash, QString name = QString("default image")) :
             Id(id),
             OriginalImage(original),
+            SourceHash(sourceHash),
             Name(name)
         {
 
@@ -76,6 +77,7 @@ private:
 
         cwImage Id;
         QImage OriginalImage;
+        QByteArray SourceHash; //Identifies the original, the icon and mipmaps are derived from it
         QString Name;
     };
 
@@ -94,13 +96,13 @@ private:
     QWindow* Window;
     GLuint Texture;
 
-    QImage copyOriginalImage(QString image, cwImage* imageIds);
-    void copyOriginalImage(const QImage& image, cwImage* imageIds);
-    cwImage addImageToDatabase(const QImage& image, const QByteArray& format, const QByteArray& imageData);
+    QImage copyOriginalImage(QString image, cwImage* imageIds, QByteArray* sourceHash);
+    void copyOriginalImage(const QImage& image, cwImage* imageIds, QByteArray* sourceHash);
+    cwImage addImageToDatabase(const QImage& image, const QByteArray& format, const QByteArray& imageData, QByteArray* sourceHash);
 
-    void createIcon(QImage originalImage, QString imageFilename, cwImage* imageIds);
-    void createMipmaps(QImage originalImage, QString imageFilename, cwImage* imageIds);
-    int saveToDXT1Format(QImage image, int id = -1);
+    void createIcon(QImage originalImage, QString imageFilename, cwImage* imageIds, const QByteArray& sourceHash);
+    void createMipmaps(QImage originalImage, QString imageFilename, cwImage* imageIds, const QByteArray& sourceHash);
+    int saveToDXT1Format(QImage image, int id = -1, const QByteArray& contentHash = QByteArray());
     QByteArray squishCompressImageThreaded(QImage image, int flags, float* metric = 0);
     QByteArray openglDxt1Compression(QImage image);
     QImage ensureImageDivisibleBy4(QImage originalImage, QSizeF* clipArea);
@@ -109,10 +111,11 @@ private:
     int numberOfMipmapLevels(QSize imageSize) const;
     QSize halfSize(QSize size) const;
     int dotsPerMeter(QImage image) const;
+    static QByteArray pixelHash(const QImage& image);
 
     void regenerateMipmaps();
 
-    void IncreaseProgress();
+    void IncreaseProgress(int steps = 1);
 
 private slots:
     void tryAddingImagesToDatabase();
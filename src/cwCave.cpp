@@ -11,11 +11,13 @@
 #include "cwStation.h"
 #include "cwLength.h"
 #include "cwErrorModel.h"
+#include "cwCaveStatistics.h"
 
 cwCave::cwCave(QObject* parent) :
     QAbstractListModel(parent),
     Length(new cwLength(this)),
     Depth(new cwLength(this)),
+    Statistics(new cwCaveStatistics(this)),
     ErrorModel(new cwErrorModel(this)),
     StationPositionModelStale(false)
 {
@@ -25,6 +27,9 @@ cwCave::cwCave(QObject* parent) :
     Length->setUpdateValue(true);
     Depth->setUpdateValue(true);
 
+    connect(Statistics, SIGNAL(statisticsChanged()), SLOT(updateLengthAndDepth()));
+    Statistics->setCave(this);
+
 //    ErrorModel->addParent(this);
 }
 
@@ -36,9 +41,11 @@ cwCave::cwCave(const cwCave& object) :
     cwUndoer(),
     Length(new cwLength(this)),
     Depth(new cwLength(this)),
+    Statistics(new cwCaveStatistics(this)),
     ErrorModel(new cwErrorModel(this)),
     StationPositionModelStale(false)
 {
+    connect(Statistics, SIGNAL(statisticsChanged()), SLOT(updateLengthAndDepth()));
     Copy(object);
 }
 
@@ -50,6 +57,8 @@ cwCave& cwCave::operator=(const cwCave& object) {
 }
 
 cwCave::~cwCave() {
+    //The statistics still emit while QObject destroys the cave
+    disconnect(Statistics, nullptr, this, nullptr);
 }
 
 /**
@@ -60,6 +69,9 @@ cwCave& cwCave::Copy(const cwCave& object) {
         return *this;
     }
 
+    //The trips are counted once they're all copied
+    Statistics->setCave(nullptr);
+
     //Set the name of the cave
     setName(object.name());
 
@@ -93,6 +105,8 @@ cwCave& cwCave::Copy(const cwCave& object) {
 
     StationPositionModelStale = object.StationPositionModelStale;
 
+    Statistics->setCave(this);
+
     return *this;
 }
 
@@ -389,6 +403,17 @@ void cwCave::setStationPositionLookup(const cwStationPositionLookup &model) {
     emit stationPositionPositionChanged();
 }
 
+/**
+ * @brief cwCave::updateLengthAndDepth
+ *
+ * Copies the length and depth from the statistics, which are in meters, into the cave's units
+ */
+void cwCave::updateLengthAndDepth()
+{
+    Length->setValue(cwUnits::convert(Statistics->length(), cwUnits::Meters, (cwUnits::LengthUnit)Length->unit()));
+    Depth->setValue(cwUnits::convert(Statistics->depth(), cwUnits::Meters, (cwUnits::LengthUnit)Depth->unit()));
+}
+
 /**
  * @brief cwCave::setStationPositionLookupStale
  * @param isStale
@@ -12,6 +12,7 @@
 class cwTrip;
 class cwLength;
 class cwErrorModel;
+class cwCaveStatistics;
 #include "cwStation.h"
 #include "cwUndoer.h"
 #include "cwStationPositionLookup.h"
@@ -33,6 +34,7 @@ class CAVEWHERE_LIB_EXPORT cwCave : public QAbstractListModel, public cwUndoer
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
     Q_PROPERTY(cwLength* length READ length CONSTANT)
     Q_PROPERTY(cwLength* depth READ depth CONSTANT)
+    Q_PROPERTY(cwCaveStatistics* statistics READ statistics CONSTANT)
     Q_PROPERTY(cwErrorModel* errorModel READ errorModel CONSTANT)
 
 
@@ -52,6 +54,7 @@ public:
 
     cwLength* length() const;
     cwLength* depth() const;
+    cwCaveStatistics* statistics() const;
 
     cwErrorModel* errorModel() const;
 
@@ -89,12 +92,16 @@ signals:
 
     void stationPositionPositionChanged();
 
+private slots:
+    void updateLengthAndDepth();
+
 private:
     QList<cwTrip*> Trips;
     QString Name;
 
     cwLength* Length;
     cwLength* Depth;
+    cwCaveStatistics* Statistics; //!< Keeps Length and Depth up to date
 
     cwErrorModel* ErrorModel; //!<
 
@@ -203,6 +210,15 @@ inline cwLength *cwCave::depth() const
     return Depth;
 }
 
+/**
+ * @brief cwCave::statistics
+ * @return The running totals of the cave's survey data
+ */
+inline cwCaveStatistics *cwCave::statistics() const
+{
+    return Statistics;
+}
+
 /**
   \brief Gets the index of the trip inside of the cave
   */
@@ -0,0 +1,233 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwCaveStatistics.h"
+#include "cwTripStatistics.h"
+#include "cwTripCalibration.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwUnits.h"
+
+//Qt includes
+#include <QSet>
+
+//Std includes
+#include <limits>
+
+cwCaveStatistics::cwCaveStatistics(QObject *parent) :
+    QObject(parent),
+    LowestElevation(0.0),
+    HighestElevation(0.0)
+{
+}
+
+/**
+ * @brief cwCaveStatistics::setCave
+ * @param cave - The cave that statistics are kept for
+ */
+void cwCaveStatistics::setCave(cwCave *cave)
+{
+    if(Cave != cave) {
+        if(!Cave.isNull()) {
+            disconnect(Cave, nullptr, this, nullptr);
+        }
+
+        clear();
+
+        Cave = cave;
+
+        if(!Cave.isNull()) {
+            connect(Cave, SIGNAL(destroyed()), SLOT(caveDestroyed()));
+            connect(Cave, SIGNAL(insertedTrips(int,int)), SLOT(tripsInserted(int,int)));
+            connect(Cave, SIGNAL(removedTrips(int,int)), SLOT(tripsRemoved()));
+            connect(Cave, SIGNAL(stationPositionPositionChanged()), SLOT(stationPositionsChanged()));
+
+            foreach(cwTrip* trip, Cave->trips()) {
+                addTrip(trip);
+            }
+        }
+
+        updateElevations();
+
+        emit caveChanged();
+        emit statisticsChanged();
+    }
+}
+
+/**
+ * @brief cwCaveStatistics::tripStatistics
+ * @return The statistics for trip, or nullptr if the trip isn't in the cave
+ */
+cwTripStatistics *cwCaveStatistics::tripStatistics(cwTrip *trip) const
+{
+    return Trips.value(trip, nullptr);
+}
+
+void cwCaveStatistics::tripsInserted(int begin, int end)
+{
+    for(int i = begin; i <= end; i++) {
+        addTrip(Cave->trip(i));
+    }
+    emit statisticsChanged();
+}
+
+/**
+ * @brief cwCaveStatistics::tripsRemoved
+ *
+ * Removes the statistics for all the trips that are no longer in the cave
+ */
+void cwCaveStatistics::tripsRemoved()
+{
+    QSet<cwTrip*> caveTrips = Cave->trips().toSet();
+    foreach(cwTrip* trip, Trips.keys()) {
+        if(!caveTrips.contains(trip)) {
+            removeTrip(trip);
+        }
+    }
+    emit statisticsChanged();
+}
+
+/**
+ * @brief cwCaveStatistics::tripStatisticsChanged
+ *
+ * Applies the difference of the trip that changed to the cave's totals
+ */
+void cwCaveStatistics::tripStatisticsChanged()
+{
+    cwTripStatistics* tripStatistics = qobject_cast<cwTripStatistics*>(sender());
+    if(tripStatistics == nullptr || !TripTotals.contains(tripStatistics)) { return; }
+
+    updateTotals(tripStatistics);
+    emit statisticsChanged();
+}
+
+/**
+ * @brief cwCaveStatistics::distanceUnitChanged
+ *
+ * The trip's length is the same, but it's a different length in meters
+ */
+void cwCaveStatistics::distanceUnitChanged()
+{
+    foreach(cwTripStatistics* tripStatistics, Trips) {
+        if(tripStatistics->trip() != nullptr && tripStatistics->trip()->calibrations() == sender()) {
+            updateTotals(tripStatistics);
+        }
+    }
+    emit statisticsChanged();
+}
+
+void cwCaveStatistics::stationPositionsChanged()
+{
+    updateElevations();
+    emit statisticsChanged();
+}
+
+void cwCaveStatistics::caveDestroyed()
+{
+    clear();
+    updateElevations();
+    emit caveChanged();
+    emit statisticsChanged();
+}
+
+void cwCaveStatistics::addTrip(cwTrip *trip)
+{
+    if(trip == nullptr || Trips.contains(trip)) { return; }
+
+    cwTripStatistics* tripStatistics = new cwTripStatistics(this);
+    tripStatistics->setTrip(trip);
+    connect(tripStatistics, SIGNAL(statisticsChanged()), SLOT(tripStatisticsChanged()));
+    connect(trip->calibrations(), SIGNAL(distanceUnitChanged(cwUnits::LengthUnit)), SLOT(distanceUnitChanged()));
+
+    Trips.insert(trip, tripStatistics);
+    TripTotals.insert(tripStatistics, Totals());
+    updateTotals(tripStatistics);
+}
+
+void cwCaveStatistics::removeTrip(cwTrip *trip)
+{
+    cwTripStatistics* tripStatistics = Trips.take(trip);
+    if(tripStatistics == nullptr) { return; }
+
+    Totals totals = TripTotals.take(tripStatistics);
+    CaveTotals.Length -= totals.Length;
+    CaveTotals.ShotCount -= totals.ShotCount;
+    CaveTotals.StationCount -= totals.StationCount;
+
+    if(tripStatistics->trip() != nullptr) {
+        disconnect(tripStatistics->trip()->calibrations(), nullptr, this, nullptr);
+    }
+    disconnect(tripStatistics, nullptr, this, nullptr);
+    delete tripStatistics;
+}
+
+/**
+ * @brief cwCaveStatistics::clear
+ *
+ * Removes all the trips and zeros the totals, without emitting
+ */
+void cwCaveStatistics::clear()
+{
+    foreach(cwTrip* trip, Trips.keys()) {
+        removeTrip(trip);
+    }
+    CaveTotals = Totals();
+}
+
+/**
+ * @brief cwCaveStatistics::updateTotals
+ *
+ * Replaces the trip's old totals with it's current totals
+ */
+void cwCaveStatistics::updateTotals(cwTripStatistics *tripStatistics)
+{
+    Totals& totals = TripTotals[tripStatistics];
+
+    Totals newTotals;
+    if(tripStatistics->trip() != nullptr) {
+        cwUnits::LengthUnit unit = tripStatistics->trip()->calibrations()->distanceUnit();
+        double meters = cwUnits::convert(tripStatistics->length(), unit, cwUnits::Meters);
+        newTotals.Length = qRound64(meters * 1e6);
+    }
+    newTotals.ShotCount = tripStatistics->shotCount();
+    newTotals.StationCount = tripStatistics->stationCount();
+
+    CaveTotals.Length += newTotals.Length - totals.Length;
+    CaveTotals.ShotCount += newTotals.ShotCount - totals.ShotCount;
+    CaveTotals.StationCount += newTotals.StationCount - totals.StationCount;
+
+    totals = newTotals;
+}
+
+/**
+ * @brief cwCaveStatistics::updateElevations
+ *
+ * Finds the lowest and highest station in the cave's station positions
+ */
+void cwCaveStatistics::updateElevations()
+{
+    LowestElevation = 0.0;
+    HighestElevation = 0.0;
+
+    if(Cave.isNull()) {
+        return;
+    }
+
+    QMap<QString, QVector3D> positions = Cave->stationPositionLookup().positions();
+    if(positions.isEmpty()) {
+        return;
+    }
+
+    LowestElevation = std::numeric_limits<double>::max();
+    HighestElevation = -std::numeric_limits<double>::max();
+
+    foreach(const QVector3D& position, positions) {
+        LowestElevation = qMin(LowestElevation, (double)position.z());
+        HighestElevation = qMax(HighestElevation, (double)position.z());
+    }
+}
@@ -0,0 +1,156 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWCAVESTATISTICS_H
+#define CWCAVESTATISTICS_H
+
+//Our includes
+#include "cwGlobals.h"
+class cwCave;
+class cwTrip;
+class cwTripStatistics;
+
+//Qt includes
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+
+/**
+ * @brief The cwCaveStatistics class
+ *
+ * Keeps running totals of a cave's length, shot count and station count by adding up a
+ * cwTripStatistics for each trip. When one trip changes, only the difference is applied to the
+ * cave's totals. The length is kept as integer micrometers, so the totals are exact and trips
+ * with different distance units can be added up.
+ *
+ * The elevation extremes and the depth come from the cave's station positions. They're updated
+ * when the line plot gives the cave new positions, since a single edit can move every station
+ * through the loop closure.
+ */
+class CAVEWHERE_LIB_EXPORT cwCaveStatistics : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(cwCave* cave READ cave WRITE setCave NOTIFY caveChanged)
+    Q_PROPERTY(double length READ length NOTIFY statisticsChanged)
+    Q_PROPERTY(double depth READ depth NOTIFY statisticsChanged)
+    Q_PROPERTY(double lowestElevation READ lowestElevation NOTIFY statisticsChanged)
+    Q_PROPERTY(double highestElevation READ highestElevation NOTIFY statisticsChanged)
+    Q_PROPERTY(int shotCount READ shotCount NOTIFY statisticsChanged)
+    Q_PROPERTY(int stationCount READ stationCount NOTIFY statisticsChanged)
+
+public:
+    explicit cwCaveStatistics(QObject *parent = 0);
+
+    cwCave* cave() const;
+    void setCave(cwCave* cave);
+
+    double length() const;
+    double depth() const;
+    double lowestElevation() const;
+    double highestElevation() const;
+    int shotCount() const;
+    int stationCount() const;
+
+    Q_INVOKABLE cwTripStatistics* tripStatistics(cwTrip* trip) const;
+
+signals:
+    void caveChanged();
+    void statisticsChanged();
+
+private slots:
+    void tripsInserted(int begin, int end);
+    void tripsRemoved();
+    void tripStatisticsChanged();
+    void distanceUnitChanged();
+    void stationPositionsChanged();
+    void caveDestroyed();
+
+private:
+    class Totals {
+    public:
+        Totals() : Length(0), ShotCount(0), StationCount(0) {}
+
+        qint64 Length; //!< In micrometers
+        int ShotCount;
+        int StationCount;
+    };
+
+    QPointer<cwCave> Cave;
+    QHash<cwTrip*, cwTripStatistics*> Trips;
+    QHash<cwTripStatistics*, Totals> TripTotals; //!< The trip's totals that are in CaveTotals
+
+    Totals CaveTotals;
+    double LowestElevation;
+    double HighestElevation;
+
+    void addTrip(cwTrip* trip);
+    void removeTrip(cwTrip* trip);
+    void clear();
+    void updateTotals(cwTripStatistics* tripStatistics);
+    void updateElevations();
+};
+
+/**
+ * @brief cwCaveStatistics::cave
+ * @return The cave that the statistics are computed for
+ */
+inline cwCave* cwCaveStatistics::cave() const {
+    return Cave;
+}
+
+/**
+ * @brief cwCaveStatistics::length
+ * @return The sum of all the trip lengths in meters, including each trip's tape calibration
+ */
+inline double cwCaveStatistics::length() const {
+    return CaveTotals.Length / 1e6;
+}
+
+/**
+ * @brief cwCaveStatistics::depth
+ * @return The difference between the highest and lowest station, in meters
+ */
+inline double cwCaveStatistics::depth() const {
+    return HighestElevation - LowestElevation;
+}
+
+/**
+ * @brief cwCaveStatistics::lowestElevation
+ * @return The elevation of the lowest station in meters, or 0.0 if the cave doesn't have station
+ * positions
+ */
+inline double cwCaveStatistics::lowestElevation() const {
+    return LowestElevation;
+}
+
+/**
+ * @brief cwCaveStatistics::highestElevation
+ * @return The elevation of the highest station in meters, or 0.0 if the cave doesn't have station
+ * positions
+ */
+inline double cwCaveStatistics::highestElevation() const {
+    return HighestElevation;
+}
+
+/**
+ * @brief cwCaveStatistics::shotCount
+ * @return The number of shots that are included in the length
+ */
+inline int cwCaveStatistics::shotCount() const {
+    return CaveTotals.ShotCount;
+}
+
+/**
+ * @brief cwCaveStatistics::stationCount
+ * @return The sum of all the trip station counts
+ */
+inline int cwCaveStatistics::stationCount() const {
+    return CaveTotals.StationCount;
+}
+
+#endif // CWCAVESTATISTICS_H
@@ -220,6 +220,49 @@ void cwCavingRegion::clearCaves() {
     }
 }
 
+/**
+  \brief Moves all the caves out of source and into this region
+
+  The existing caves are replaced and deleted later. The caves in source are reparented to this
+  region, without being copied, and source is left empty. Instead of inserting the caves one at a
+  time, this emits a single modelAboutToBeReset() and modelReset(), so listeners can rebuild once.
+
+  This isn't undoable. Both regions must be on the current thread.
+  */
+void cwCavingRegion::takeCaves(cwCavingRegion* source) {
+    Q_ASSERT(source != nullptr);
+    Q_ASSERT(source->thread() == thread());
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if(source == this) { return; }
+
+    QList<cwCave*> newCaves = source->Caves;
+
+    source->beginResetModel();
+    source->Caves.clear();
+    source->endResetModel();
+    emit source->caveCountChanged();
+
+    beginResetModel();
+
+    QList<cwCave*> oldCaves = Caves;
+    Caves = newCaves;
+
+    foreach(cwCave* cave, Caves) {
+        cave->setParent(this);
+        cave->setUndoStack(undoStack());
+    }
+
+    endResetModel();
+
+    foreach(cwCave* cave, oldCaves) {
+        cave->setParent(nullptr);
+        cave->deleteLater();
+    }
+
+    emit caveCountChanged();
+}
+
 /**
   \brief Get's the index of the cave
   */
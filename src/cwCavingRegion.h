@@ -54,6 +54,7 @@ public:
     Q_INVOKABLE void removeCave(int index);
     void removeCaves(int beginIndex, int endIndex);
     void clearCaves();
+    void takeCaves(cwCavingRegion* source);
 
     int indexOf(cwCave* cave);
 
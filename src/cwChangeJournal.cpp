@@ -0,0 +1,84 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwChangeJournal.h"
+
+//Qt includes
+#include <QTimer>
+
+cwChangeJournal::cwChangeJournal(QObject *parent) :
+    QObject(parent),
+    Timer(new QTimer(this)),
+    Latency(DefaultLatency),
+    PendingChanges(false),
+    CoalescedCount(0),
+    ExecutedCount(0)
+{
+    Timer->setSingleShot(true);
+    connect(Timer, &QTimer::timeout, this, &cwChangeJournal::flush);
+}
+
+/**
+ * @brief cwChangeJournal::setLatency
+ * @param latency - In milliseconds, negative values are clamped to zero
+ *
+ * A pending batch keeps the latency it was started with.
+ */
+void cwChangeJournal::setLatency(int latency) {
+    latency = qMax(0, latency);
+    if(Latency != latency) {
+        Latency = latency;
+        emit latencyChanged();
+    }
+}
+
+/**
+ * @brief cwChangeJournal::resetCounts
+ *
+ * Sets the coalesced and executed counts back to zero
+ */
+void cwChangeJournal::resetCounts()
+{
+    CoalescedCount = 0;
+    ExecutedCount = 0;
+    emit countsChanged();
+}
+
+/**
+ * @brief cwChangeJournal::markChanged
+ *
+ * Adds a change to the current batch. If there's no pending batch, this starts one.
+ */
+void cwChangeJournal::markChanged()
+{
+    if(PendingChanges) {
+        CoalescedCount++;
+        emit countsChanged();
+        return;
+    }
+
+    PendingChanges = true;
+    Timer->start(Latency);
+}
+
+/**
+ * @brief cwChangeJournal::flush
+ *
+ * Emits changed() right away, if there are pending changes. This is useful before waiting
+ * on the work that changed() starts, for example in unit tests.
+ */
+void cwChangeJournal::flush()
+{
+    if(!PendingChanges) { return; }
+
+    Timer->stop();
+    PendingChanges = false;
+    ExecutedCount++;
+    emit countsChanged();
+    emit changed();
+}
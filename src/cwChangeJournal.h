@@ -0,0 +1,100 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWCHANGEJOURNAL_H
+#define CWCHANGEJOURNAL_H
+
+//Qt includes
+#include <QObject>
+class QTimer;
+
+//Our includes
+#include "cwGlobals.h"
+
+/**
+ * @brief The cwChangeJournal class
+ *
+ * Batches change notifications together, so expensive work, like rerunning the line plot
+ * or triangulating scraps, only happens once per batch. Call markChanged() for every edit.
+ * changed() is emitted once, latency milliseconds after the first edit in the batch. A latency
+ * of zero batches all the edits that happen in one turn of the event loop.
+ *
+ * coalescedCount() is the number of edits that were merged into an existing batch, and
+ * executedCount() is the number of times changed() was emitted.
+ */
+class CAVEWHERE_LIB_EXPORT cwChangeJournal : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int latency READ latency WRITE setLatency NOTIFY latencyChanged)
+    Q_PROPERTY(int coalescedCount READ coalescedCount NOTIFY countsChanged)
+    Q_PROPERTY(int executedCount READ executedCount NOTIFY countsChanged)
+
+public:
+    static const int DefaultLatency = 50; //In milliseconds
+
+    explicit cwChangeJournal(QObject *parent = 0);
+
+    int latency() const;
+    void setLatency(int latency);
+
+    bool hasPendingChanges() const;
+
+    int coalescedCount() const;
+    int executedCount() const;
+    void resetCounts();
+
+signals:
+    void changed();
+    void latencyChanged();
+    void countsChanged();
+
+public slots:
+    void markChanged();
+    void flush();
+
+private:
+    QTimer* Timer;
+    int Latency; //!< In milliseconds
+    bool PendingChanges;
+    int CoalescedCount;
+    int ExecutedCount;
+};
+
+/**
+ * @brief cwChangeJournal::latency
+ * @return How long, in milliseconds, the journal waits after the first change before emitting changed()
+ */
+inline int cwChangeJournal::latency() const {
+    return Latency;
+}
+
+/**
+ * @brief cwChangeJournal::hasPendingChanges
+ * @return True if changes have been marked, but changed() hasn't been emitted yet
+ */
+inline bool cwChangeJournal::hasPendingChanges() const {
+    return PendingChanges;
+}
+
+/**
+ * @brief cwChangeJournal::coalescedCount
+ * @return The number of changes that were merged into a batch that was already pending
+ */
+inline int cwChangeJournal::coalescedCount() const {
+    return CoalescedCount;
+}
+
+/**
+ * @brief cwChangeJournal::executedCount
+ * @return The number of batches that have been emitted through changed()
+ */
+inline int cwChangeJournal::executedCount() const {
+    return ExecutedCount;
+}
+
+#endif // CWCHANGEJOURNAL_H
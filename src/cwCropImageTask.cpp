@@ -68,17 +68,17 @@ void cwCropImageTask::runTask() {
 
     cwImageData imageData = ImageProvider.data(Original.original());
     QRect cropArea = mapNormalizedToIndex(CropRect, imageData.size());
-    QImage image = QImage::fromData(imageData.data(), imageData.format());
 
+    //Only decode the crop area, instead of the whole note
+    QImage croppedImage = cwImageProvider::decodeImage(imageData, cropArea);
 
-    if(image.size().isEmpty()) {
+    if(croppedImage.size().isEmpty()) {
         qDebug() << "Can't crop an image with no size";
         stop();
         done();
         return;
     }
 
-    QImage croppedImage = image.copy(cropArea);
 //    qDebug() << "image:" << Original.original() << image << imageData.format() << croppedImage.size() << imageData.size() << CropRect << cropArea;
 
     QList<QImage> images;
@@ -14,6 +14,8 @@ cwErrorModel::cwErrorModel(QObject *parent) :
     FatalCount(0),
     WarningCount(0),
     FatalWaringCountUptoDate(false),
+    ExternalFatalCount(0),
+    ExternalWarningCount(0),
     Errors(new cwErrorListModel(this)),
     Parent(nullptr)
 {
@@ -147,6 +149,9 @@ void cwErrorModel::updateFatalAndWarningCount() const
         WarningCount += child->warningCount();
     }
 
+    FatalCount += ExternalFatalCount;
+    WarningCount += ExternalWarningCount;
+
     FatalWaringCountUptoDate = true;
 }
 
@@ -181,6 +186,28 @@ cwErrorListModel* cwErrorModel::errors() const {
     return Errors;
 }
 
+/**
+ * @brief cwErrorModel::setExternalCounts
+ * @param fatalCount - The number of fatal errors
+ * @param warningCount - The number of unsuppressed warnings
+ *
+ * Adds errors that are stored outside of this model to fatalCount() and warningCount(). For
+ * example, cwSurveyChunk keeps the errors for its cells in a flat array, and only creates
+ * a cwErrorModel for a cell when it's shown.
+ */
+void cwErrorModel::setExternalCounts(int fatalCount, int warningCount)
+{
+    if(ExternalFatalCount != fatalCount) {
+        ExternalFatalCount = fatalCount;
+        makeFatalDirty();
+    }
+
+    if(ExternalWarningCount != warningCount) {
+        ExternalWarningCount = warningCount;
+        makeWarningDirty();
+    }
+}
+
 /**
  * @brief cwErrorModel::childModels
  * @return
@@ -40,6 +40,8 @@ public:
 
     QList<cwErrorModel*> childModels() const;
 
+    void setExternalCounts(int fatalCount, int warningCount);
+
 signals:
     void fatalCountChanged();
     void warningCountChanged();
@@ -50,6 +52,9 @@ private:
 
     mutable bool FatalWaringCountUptoDate;
 
+    int ExternalFatalCount; //!< Fatal errors that are counted, but not stored in this model
+    int ExternalWarningCount; //!< Warnings that are counted, but not stored in this model
+
     cwErrorListModel* Errors;
     QList<cwErrorModel*> ChildModels;
 
@@ -0,0 +1,95 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwFrustum.h"
+
+/**
+ * @brief cwFrustum::cwFrustum
+ *
+ * Creates a frustum that contains everything
+ */
+cwFrustum::cwFrustum()
+{
+}
+
+/**
+ * @brief cwFrustum::cwFrustum
+ * @param viewProjectionMatrix - The camera's cwCamera::viewProjectionMatrix()
+ *
+ * Extracts the planes from the matrix's rows, see "Fast Extraction of Viewing Frustum Planes
+ * from the World-View-Projection Matrix" by Gribb and Hartmann.
+ */
+cwFrustum::cwFrustum(const QMatrix4x4 &viewProjectionMatrix)
+{
+    QVector4D row0 = viewProjectionMatrix.row(0);
+    QVector4D row1 = viewProjectionMatrix.row(1);
+    QVector4D row2 = viewProjectionMatrix.row(2);
+    QVector4D row3 = viewProjectionMatrix.row(3);
+
+    Planes[0] = row3 + row0; //Left
+    Planes[1] = row3 - row0; //Right
+    Planes[2] = row3 + row1; //Bottom
+    Planes[3] = row3 - row1; //Top
+    Planes[4] = row3 + row2; //Near
+    Planes[5] = row3 - row2; //Far
+
+    //Normalize, so the sphere test can compare distances
+    for(int i = 0; i < NumberOfPlanes; i++) {
+        float length = Planes[i].toVector3D().length();
+        if(length > 0.0f) {
+            Planes[i] /= length;
+        }
+    }
+}
+
+/**
+ * @brief cwFrustum::intersects
+ * @param center - The center of the sphere
+ * @param radius - The radius of the sphere
+ * @return True if the sphere is inside or partly inside of the frustum
+ */
+bool cwFrustum::intersects(const QVector3D &center, float radius) const
+{
+    for(int i = 0; i < NumberOfPlanes; i++) {
+        const QVector4D& plane = Planes[i];
+        float distance = QVector3D::dotProduct(plane.toVector3D(), center) + plane.w();
+        if(distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief cwFrustum::intersects
+ * @param box
+ * @return True if the box is inside or partly inside of the frustum. Null boxes are never
+ * inside and infinite boxes are always inside.
+ */
+bool cwFrustum::intersects(const QBox3D &box) const
+{
+    if(box.isNull()) { return false; }
+    if(box.isInfinite()) { return true; }
+
+    QVector3D minimum = box.minimum();
+    QVector3D maximum = box.maximum();
+
+    for(int i = 0; i < NumberOfPlanes; i++) {
+        const QVector4D& plane = Planes[i];
+
+        //The corner of the box that's furthest along the plane's normal
+        QVector3D corner(plane.x() >= 0.0f ? maximum.x() : minimum.x(),
+                         plane.y() >= 0.0f ? maximum.y() : minimum.y(),
+                         plane.z() >= 0.0f ? maximum.z() : minimum.z());
+
+        if(QVector3D::dotProduct(plane.toVector3D(), corner) + plane.w() < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWFRUSTUM_H
+#define CWFRUSTUM_H
+
+//Our includes
+#include "cwGlobals.h"
+
+//Qt includes
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QVector4D>
+#include <QBox3D>
+
+/**
+ * @brief The cwFrustum class
+ *
+ * The six clipping planes of a view projection matrix, in world coordinates. This is used to
+ * skip drawing geometry that's outside of the camera's view.
+ *
+ * The tests are conservative, geometry that's close to a corner of the frustum may pass even
+ * though it's outside, but geometry that's inside never fails.
+ */
+class CAVEWHERE_LIB_EXPORT cwFrustum
+{
+public:
+    cwFrustum();
+    cwFrustum(const QMatrix4x4& viewProjectionMatrix);
+
+    bool intersects(const QVector3D& center, float radius) const;
+    bool intersects(const QBox3D& box) const;
+
+private:
+    enum {
+        NumberOfPlanes = 6
+    };
+
+    //xyz is the normal, pointing into the frustum, and w is the distance
+    QVector4D Planes[NumberOfPlanes];
+};
+
+#endif // CWFRUSTUM_H
@@ -14,6 +14,8 @@
 #include "cwGLShader.h"
 #include "cwCamera.h"
 #include "cwGlobalDirectory.h"
+#include "cwScene.h"
+#include "cwFrustum.h"
 
 
 cwGLLinePlot::cwGLLinePlot(QObject *parent) :
@@ -22,7 +24,6 @@ cwGLLinePlot::cwGLLinePlot(QObject *parent) :
 {
     MaxZValue = 0.0;
     MinZValue = 0.0;
-    IndexBufferSize = 0;
 }
 
 void cwGLLinePlot::initialize() {
@@ -69,17 +70,18 @@ void cwGLLinePlot::initializeBuffers() {
     LinePlotVertexBuffer.create();
     LinePlotIndexBuffer.create();
 
+    //Caves are updated in place, see updateData()
     LinePlotVertexBuffer.bind();
-    LinePlotVertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    LinePlotVertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
     LinePlotVertexBuffer.release();
 
     LinePlotIndexBuffer.bind();
-    LinePlotIndexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    LinePlotIndexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
     LinePlotIndexBuffer.release();
 }
 
 void cwGLLinePlot::draw() {
-    if(Points.size() <= 0) { return; }
+    if(Chunks.isEmpty()) { return; }
 
     glLineWidth(1.0);
 
@@ -93,7 +95,19 @@ void cwGLLinePlot::draw() {
 
     ShaderProgram->setAttributeBuffer(vVertex, GL_FLOAT, 0, 3);
 
-    glDrawElements(GL_LINES, IndexBufferSize, GL_UNSIGNED_INT, nullptr);
+    const cwFrustum& frustum = scene()->frustum();
+
+    //One draw per cave
+    foreach(const Chunk& chunk, Chunks) {
+        int numberOfIndexes = chunk.Geometry.indexes().size();
+        if(numberOfIndexes == 0) { continue; }
+        if(!frustum.intersects(chunk.BoundingBox)) { continue; }
+
+        glDrawElements(GL_LINES,
+                       numberOfIndexes,
+                       GL_UNSIGNED_INT,
+                       reinterpret_cast<const GLvoid*>(chunk.IndexOffset * sizeof(unsigned int)));
+    }
 
     LinePlotVertexBuffer.release();
     LinePlotIndexBuffer.release();
@@ -103,27 +117,13 @@ void cwGLLinePlot::draw() {
 }
 
 /**
-  \brief Set the line points for the line plot object
-  */
-void cwGLLinePlot::setPoints(QVector<QVector3D> pointData) {
-    //Find the max value and the min value
-    MaxZValue = -std::numeric_limits<float>::max();
-    MinZValue = std::numeric_limits<float>::max();
-
-    for(int i = 0; i < pointData.size(); i++) {
-        MaxZValue = qMax(MaxZValue, (float)pointData[i].z());
-        MinZValue = qMin(MinZValue, (float)pointData[i].z());
-    }
-
-    Points = pointData;
-    markDataAsDirty();
-}
+  \brief Set the line plot of each cave
 
-/**
-  \brief Set the line indexes for the line plot object
+  Caves that share their data with the current line plot, because they haven't changed, aren't
+  uploaded again
   */
-void cwGLLinePlot::setIndexes(QVector<unsigned int> indexData) {
-    Indexes = indexData;
+void cwGLLinePlot::setCaveGeometries(QVector<cwLinePlotGeometryTask::CaveGeometry> caveGeometries) {
+    CaveGeometries = caveGeometries;
     markDataAsDirty();
 }
 
@@ -132,6 +132,10 @@ void cwGLLinePlot::setIndexes(QVector<unsigned int> indexData) {
  *
  * This is called by the cwGLRenderer to update all the dataobject's that are dirty.
  *
+ * Only the caves that have changed are uploaded, with glBufferSubData, into their range of
+ * the buffers. If a cave has outgrown its range, or caves were added or removed, the buffers
+ * are reallocated and all the caves are uploaded.
+ *
  * This is called in updateScene and is thread safe
  */
 void cwGLLinePlot::updateData() {
@@ -139,33 +143,151 @@ void cwGLLinePlot::updateData() {
 
     if(ShaderProgram == nullptr) { return; }
 
-    LinePlotVertexBuffer.bind();
-    LinePlotVertexBuffer.allocate(Points.data(), Points.size() * sizeof(QVector3D));
-    LinePlotVertexBuffer.release();
+    bool reallocate = Chunks.size() != CaveGeometries.size();
+
+    //Remove the caves that no longer exist
+    for(int i = CaveGeometries.size(); i < Chunks.size(); i++) {
+        if(geometryItersecter() != nullptr) {
+            geometryItersecter()->removeObject(this, i);
+        }
+    }
+
+    Chunks.resize(CaveGeometries.size());
+
+    for(int i = 0; i < Chunks.size(); i++) {
+        Chunk& chunk = Chunks[i];
+        const cwLinePlotGeometryTask::CaveGeometry& geometry = CaveGeometries.at(i);
+
+        //Fast when the data is shared, which is the case when the cave hasn't changed
+        if(chunk.Uploaded && chunk.Geometry == geometry) { continue; }
+
+        chunk.Geometry = geometry;
+        chunk.Uploaded = false;
+
+        QBox3D boundingBox;
+        foreach(const QVector3D& point, geometry.points()) {
+            boundingBox.unite(point);
+        }
+        chunk.BoundingBox = boundingBox;
+
+        if(geometry.points().size() > chunk.PointCapacity ||
+                geometry.indexes().size() > chunk.IndexCapacity)
+        {
+            reallocate = true;
+        }
+
+        if(geometryItersecter() != nullptr) {
+            //For geometry intersection
+            geometryItersecter()->removeObject(this, i);
+
+            cwGeometryItersecter::Object geometryObject(
+                        this, //This object's pointer
+                        i, //Id
+                        geometry.points(),
+                        geometry.indexes(),
+                        cwGeometryItersecter::Lines);
+
+            geometryItersecter()->addObject(geometryObject);
+        }
+    }
+
+    if(reallocate) {
+        allocateBuffers();
+    }
+
+    //Upload the caves that have changed, and find the bounds of the whole line plot
+    QBox3D boundingBox;
+    for(int i = 0; i < Chunks.size(); i++) {
+        Chunk& chunk = Chunks[i];
+        if(!chunk.Uploaded) {
+            uploadChunk(chunk);
+        }
+        boundingBox.unite(chunk.BoundingBox);
+    }
+
+    setBoundingBox(boundingBox);
+
+    if(boundingBox.isNull()) {
+        MaxZValue = -std::numeric_limits<float>::max();
+        MinZValue = std::numeric_limits<float>::max();
+    } else {
+        MaxZValue = boundingBox.maximum().z();
+        MinZValue = boundingBox.minimum().z();
+    }
 
     ShaderProgram->bind();
     ShaderProgram->setUniformValue(UniformMaxZValue, MaxZValue);
     ShaderProgram->setUniformValue(UniformMinZValue, MinZValue);
     ShaderProgram->release();
+}
+
+/**
+ * @brief cwGLLinePlot::allocateBuffers
+ *
+ * Lays out the caves, one after another, in the vertex and index buffers, with a quarter of
+ * their size extra, so surveying more of the cave usually fits in its range. This reallocates
+ * the buffers and all the caves need to be uploaded.
+ */
+void cwGLLinePlot::allocateBuffers() {
+    int pointOffset = 0;
+    int indexOffset = 0;
+
+    for(int i = 0; i < Chunks.size(); i++) {
+        Chunk& chunk = Chunks[i];
+        int numberOfPoints = chunk.Geometry.points().size();
+        int numberOfIndexes = chunk.Geometry.indexes().size();
+
+        chunk.PointOffset = pointOffset;
+        chunk.PointCapacity = numberOfPoints + numberOfPoints / 4;
+        chunk.IndexOffset = indexOffset;
+        chunk.IndexCapacity = numberOfIndexes + numberOfIndexes / 4;
+        chunk.Uploaded = false;
+
+        pointOffset += chunk.PointCapacity;
+        indexOffset += chunk.IndexCapacity;
+    }
+
+    LinePlotVertexBuffer.bind();
+    LinePlotVertexBuffer.allocate(pointOffset * sizeof(QVector3D));
+    LinePlotVertexBuffer.release();
 
     LinePlotIndexBuffer.bind();
-    LinePlotIndexBuffer.allocate(Indexes.data(), Indexes.size() * sizeof(unsigned int));
+    LinePlotIndexBuffer.allocate(indexOffset * sizeof(unsigned int));
     LinePlotIndexBuffer.release();
+}
+
+/**
+ * @brief cwGLLinePlot::uploadChunk
+ * @param chunk - Uploads the chunk's points and indexes into its range of the buffers
+ *
+ * The cave's indexes are offset to where its points are in the vertex buffer.
+ */
+void cwGLLinePlot::uploadChunk(cwGLLinePlot::Chunk &chunk) {
+    QVector<QVector3D> points = chunk.Geometry.points();
+    QVector<unsigned int> indexes = chunk.Geometry.indexes();
 
-    IndexBufferSize = Indexes.size();
+    Q_ASSERT(points.size() <= chunk.PointCapacity);
+    Q_ASSERT(indexes.size() <= chunk.IndexCapacity);
 
-    if(geometryItersecter() != nullptr) {
-        geometryItersecter()->clear(this);
+    for(int i = 0; i < indexes.size(); i++) {
+        indexes[i] += chunk.PointOffset;
+    }
 
-        //For geometry intersection
-        cwGeometryItersecter::Object geometryObject(
-                    this, //This object's pointer
-                    0, //Id
-                    Points,
-                    Indexes,
-                    cwGeometryItersecter::Lines);
+    if(!points.isEmpty()) {
+        LinePlotVertexBuffer.bind();
+        LinePlotVertexBuffer.write(chunk.PointOffset * sizeof(QVector3D),
+                                   points.constData(),
+                                   points.size() * sizeof(QVector3D));
+        LinePlotVertexBuffer.release();
+    }
 
-        //FIXME: This could potentially slow down the rendering.
-        geometryItersecter()->addObject(geometryObject);
+    if(!indexes.isEmpty()) {
+        LinePlotIndexBuffer.bind();
+        LinePlotIndexBuffer.write(chunk.IndexOffset * sizeof(unsigned int),
+                                  indexes.constData(),
+                                  indexes.size() * sizeof(unsigned int));
+        LinePlotIndexBuffer.release();
     }
+
+    chunk.Uploaded = true;
 }
@@ -10,6 +10,7 @@
 
 //Our includes
 #include "cwGLObject.h"
+#include "cwLinePlotGeometryTask.h"
 
 //Qt includes
 #include <QVector3D>
@@ -26,8 +27,7 @@ public:
     virtual void initialize();
     virtual void draw();
 
-    void setPoints(QVector<QVector3D> pointData);
-    void setIndexes(QVector<unsigned int> indexData);
+    void setCaveGeometries(QVector<cwLinePlotGeometryTask::CaveGeometry> caveGeometries);
 
     void updateData();
 
@@ -37,23 +37,47 @@ public slots:
 
 
 private:
+    /**
+     * A cave's range in the vertex and index buffers. Each range has room to grow, so editing
+     * a cave only uploads that cave's range.
+     */
+    class Chunk {
+    public:
+        Chunk() :
+            PointOffset(0),
+            PointCapacity(0),
+            IndexOffset(0),
+            IndexCapacity(0),
+            Uploaded(false)
+        {}
+
+        cwLinePlotGeometryTask::CaveGeometry Geometry;
+        QBox3D BoundingBox;
+        int PointOffset;
+        int PointCapacity;
+        int IndexOffset;
+        int IndexCapacity;
+        bool Uploaded; //!< False if the range in the buffers is out of date
+    };
+
     void initializeShaders();
     void initializeBuffers();
+    void allocateBuffers();
+    void uploadChunk(Chunk& chunk);
 
     float MaxZValue;
     float MinZValue;
 
     QOpenGLBuffer LinePlotVertexBuffer;
     QOpenGLBuffer LinePlotIndexBuffer;
-    int IndexBufferSize;
 
     int vVertex; //attribute location
     int UniformModelViewProjectionMatrix; //in shader uniform location
     int UniformMaxZValue; //in shader uniform location
     int UniformMinZValue; //in shader uniform location
 
-    QVector<QVector3D> Points;
-    QVector<unsigned int> Indexes;
+    QVector<cwLinePlotGeometryTask::CaveGeometry> CaveGeometries; //!< Set in the main thread
+    QVector<Chunk> Chunks; //!< In the rendering thread
 
     QOpenGLShaderProgram* ShaderProgram;
 };
@@ -16,6 +16,7 @@ cwGLObject::cwGLObject(QObject* parent) :
     Scene(nullptr),
     QueuedDataCommand(nullptr)
 {
+    BoundingBox.setToInfinite();
 //    Dirty = false;
     //    Scene = nullptr;
 }
@@ -25,6 +26,16 @@ cwGLObject::~cwGLObject()
 
 }
 
+/**
+ * @brief cwGLObject::culled
+ *
+ * Called instead of draw() when the whole object is outside of the camera's view. Reimplement
+ * this to reset anything that draw() counts per frame. This is called from the rendering thread.
+ */
+void cwGLObject::culled()
+{
+}
+
 /**
  * @brief cwGLObject::updateData
  *
@@ -10,6 +10,7 @@
 
 //Qt includes
 #include <QObject>
+#include <QBox3D>
 
 //Our includes
 class cwCamera;
@@ -28,6 +29,7 @@ public:
     //These methods should only be called in the rendering thread
     virtual void initialize() = 0;
     virtual void draw() = 0;
+    virtual void culled();
     virtual void updateData();
 
     void setScene(cwScene *scene);
@@ -39,14 +41,22 @@ public:
 
     void markDataAsDirty();
 
+    QBox3D boundingBox() const;
+
 //    bool isDirty() const;
 
 //protected:
 //    void setDirty(bool isDirty);
 
+protected:
+    void setBoundingBox(const QBox3D& boundingBox);
+
 private:
     cwScene* Scene;
 
+    //For culling, objects with an infinite bounding box are always drawn
+    QBox3D BoundingBox;
+
     //This is the last QueuedDataCommand, if this isn't nullptr
     //Then this command
     cwUpdateDataCommand* QueuedDataCommand;
@@ -61,6 +71,26 @@ private:
 
 
 
+/**
+ * @brief cwGLObject::boundingBox
+ * @return The bounds of the object's geometry, in world coordinates. This should only be
+ * called in the rendering thread
+ */
+inline QBox3D cwGLObject::boundingBox() const
+{
+    return BoundingBox;
+}
+
+/**
+ * @brief cwGLObject::setBoundingBox
+ * @param boundingBox - The bounds of the object's geometry. This should be updated in
+ * updateData(), so cwScene can cull the object when it's outside of the camera's view
+ */
+inline void cwGLObject::setBoundingBox(const QBox3D &boundingBox)
+{
+    BoundingBox = boundingBox;
+}
+
 /**
  * @brief cwGLObject::scene
  * @returns The scene that is resposible for this object
@@ -19,22 +19,45 @@
 #include "cwShaderDebugger.h"
 #include "cwGlobalDirectory.h"
 #include "cwProject.h"
+#include "cwProjection.h"
+#include "cwScene.h"
+#include "cwFrustum.h"
+
+//Std includes
+#include <algorithm>
+
+//How far, in pixels, a coarser scrap mesh can be from the full detail mesh on the screen
+static const double MaxLevelOfDetailError = 1.0;
 
 
 cwGLScraps::cwGLScraps(QObject *parent) :
     cwGLObject(parent),
     Project(nullptr),
     MaxScrapId(0),
+    DrawCallCount(0),
+    ScrapsCulled(0),
     Visible(true)
 {
 }
 
 void cwGLScraps::initialize() {
     initializeShaders();
+
+    PointBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    PointBuffer.create();
+
+    IndexBuffer = QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
+    IndexBuffer.create();
+
+    TexCoordBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    TexCoordBuffer.create();
 }
 
 void cwGLScraps::draw() {
-    if(Scraps.isEmpty()) { return; }
+    DrawCallCount = 0;
+    ScrapsCulled = 0;
+
+    if(DrawList.isEmpty()) { return; }
     if(!visible()) { return; }
 
     Program->bind();
@@ -42,30 +65,44 @@ void cwGLScraps::draw() {
     Program->enableAttributeArray(vVertex);
     Program->enableAttributeArray(vScrapTexCoords);
 
-    foreach(GLScrap scrap, Scraps) {
-        Program->setUniformValue(UniformScaleTexCoords, scrap.Texture->scaleTexCoords());
+    //The geometry of every scrap is in the same buffers, only the texture changes between scraps
+    IndexBuffer.bind();
 
-        scrap.Texture->updateData();
+    PointBuffer.bind();
+    Program->setAttributeBuffer(vVertex, GL_FLOAT, 0, 3);
 
-        scrap.Texture->bind();
+    TexCoordBuffer.bind();
+    Program->setAttributeBuffer(vScrapTexCoords, GL_FLOAT, 0, 2);
 
-        scrap.IndexBuffer.bind();
+    const cwFrustum& frustum = scene()->frustum();
 
-        scrap.PointBuffer.bind();
-        Program->setAttributeBuffer(vVertex, GL_FLOAT, 0, 3);
+    foreach(GLScrap* scrap, DrawList) {
+        if(!frustum.intersects(scrap->Center, scrap->Radius)) {
+            ScrapsCulled++;
+            continue;
+        }
 
-        scrap.TexCoords.bind();
-        Program->setAttributeBuffer(vScrapTexCoords, GL_FLOAT, 0, 2);
+        if(scrap->Texture->isDirty()) {
+            scrap->Texture->updateData();
+        }
 
-        glDrawElements(GL_TRIANGLES, scrap.NumberOfIndices, GL_UNSIGNED_INT, nullptr);
+        const Level& level = scrap->Levels.at(levelOfDetail(*scrap));
+        if(level.NumberOfIndices == 0) { continue; }
 
-        scrap.IndexBuffer.release();
-        scrap.PointBuffer.release();
-        scrap.TexCoords.release();
+        Program->setUniformValue(UniformScaleTexCoords, scrap->Texture->scaleTexCoords());
+        scrap->Texture->bind();
 
-        scrap.Texture->release();
+        glDrawElements(GL_TRIANGLES,
+                       level.NumberOfIndices,
+                       GL_UNSIGNED_INT,
+                       reinterpret_cast<const GLvoid*>((scrap->IndexOffset + level.Offset) * sizeof(uint)));
+        DrawCallCount++;
     }
 
+    IndexBuffer.release();
+    PointBuffer.release();
+    TexCoordBuffer.release();
+
     glBindTexture(GL_TEXTURE_2D, 0);
 
     Program->disableAttributeArray(vVertex);
@@ -73,6 +110,16 @@ void cwGLScraps::draw() {
     Program->release();
 }
 
+/**
+ * @brief cwGLScraps::culled
+ *
+ * The scene culled all the scraps, so nothing was drawn this frame
+ */
+void cwGLScraps::culled() {
+    DrawCallCount = 0;
+    ScrapsCulled = visible() ? DrawList.size() : 0;
+}
+
 /**
  * @brief cwGLScraps::updateData
  *
@@ -84,6 +131,8 @@ void cwGLScraps::updateData()
 
     if(geometryItersecter() == nullptr) { return; }
 
+    prefetchTextures();
+
     foreach(PendingScrapCommand command, PendingChanges.values()) {
         switch(command.type()) {
         case PendingScrapCommand::AddScrap:
@@ -128,9 +177,251 @@ void cwGLScraps::updateData()
         }
     }
 
+    if(!PendingChanges.isEmpty()) {
+        updateBuffers();
+    }
+
     PendingChanges.clear();
 }
 
+/**
+ * @brief cwGLScraps::updateBuffers
+ *
+ * Uploads the scraps that have changed, with glBufferSubData, into their range of the shared
+ * buffers and rebuilds the draw list. If a scrap has outgrown its range, the buffers are
+ * reallocated and all the scraps are uploaded. The ranges of removed scraps are reclaimed
+ * when the buffers are reallocated.
+ */
+void cwGLScraps::updateBuffers()
+{
+    bool reallocate = false;
+    for(auto iter = Scraps.constBegin(); iter != Scraps.constEnd(); ++iter) {
+        const GLScrap& scrap = iter.value();
+        const Level& lastLevel = scrap.Levels.last();
+        if(!scrap.Uploaded &&
+                (scrap.Data.points().size() > scrap.PointCapacity ||
+                 lastLevel.Offset + lastLevel.NumberOfIndices > scrap.IndexCapacity))
+        {
+            reallocate = true;
+            break;
+        }
+    }
+
+    if(reallocate) {
+        allocateBuffers();
+    }
+
+    DrawList.clear();
+    DrawList.reserve(Scraps.size());
+
+    QBox3D boundingBox;
+
+    for(auto iter = Scraps.begin(); iter != Scraps.end(); ++iter) {
+        GLScrap& scrap = iter.value();
+
+        if(!scrap.Uploaded) {
+            uploadScrap(scrap);
+        }
+
+        DrawList.append(&scrap);
+
+        if(!scrap.Data.points().isEmpty()) {
+            QVector3D radius(scrap.Radius, scrap.Radius, scrap.Radius);
+            boundingBox.unite(QBox3D(scrap.Center - radius, scrap.Center + radius));
+        }
+    }
+
+    //For culling all the scraps at once
+    setBoundingBox(boundingBox);
+}
+
+/**
+ * @brief cwGLScraps::allocateBuffers
+ *
+ * Lays out the scraps, one after another, in the shared buffers, with a quarter of their
+ * size extra, so a retriangulated scrap usually fits in its range. This reallocates the
+ * buffers and all the scraps need to be uploaded.
+ */
+void cwGLScraps::allocateBuffers()
+{
+    int pointOffset = 0;
+    int indexOffset = 0;
+
+    for(auto iter = Scraps.begin(); iter != Scraps.end(); ++iter) {
+        GLScrap& scrap = iter.value();
+        const Level& lastLevel = scrap.Levels.last();
+        int numberOfPoints = scrap.Data.points().size();
+        int numberOfIndices = lastLevel.Offset + lastLevel.NumberOfIndices;
+
+        scrap.PointOffset = pointOffset;
+        scrap.PointCapacity = numberOfPoints + numberOfPoints / 4;
+        scrap.IndexOffset = indexOffset;
+        scrap.IndexCapacity = numberOfIndices + numberOfIndices / 4;
+        scrap.Uploaded = false;
+
+        pointOffset += scrap.PointCapacity;
+        indexOffset += scrap.IndexCapacity;
+    }
+
+    PointBuffer.bind();
+    PointBuffer.allocate(pointOffset * sizeof(QVector3D));
+    PointBuffer.release();
+
+    TexCoordBuffer.bind();
+    TexCoordBuffer.allocate(pointOffset * sizeof(QVector2D));
+    TexCoordBuffer.release();
+
+    IndexBuffer.bind();
+    IndexBuffer.allocate(indexOffset * sizeof(uint));
+    IndexBuffer.release();
+}
+
+/**
+ * @brief cwGLScraps::uploadScrap
+ * @param scrap - Uploads the scrap's points, texture coordinates and indices into its range
+ * of the shared buffers
+ *
+ * The indices of all the levels of detail are offset to where the scrap's points are in the
+ * point buffer.
+ */
+void cwGLScraps::uploadScrap(GLScrap &scrap)
+{
+    const cwTriangulatedData& data = scrap.Data;
+    QVector<QVector3D> points = data.points();
+
+    //Texture coordinates should match the points, but pad them so they line up
+    QVector<QVector2D> texCoords = data.texCoords();
+    texCoords.resize(points.size());
+
+    const Level& lastLevel = scrap.Levels.last();
+    QVector<uint> indices;
+    indices.reserve(lastLevel.Offset + lastLevel.NumberOfIndices);
+
+    uint pointOffset = (uint)scrap.PointOffset;
+    foreach(uint index, data.indices()) {
+        indices.append(pointOffset + index);
+    }
+
+    foreach(const cwTriangulatedData::LevelOfDetail& levelOfDetail, data.levelsOfDetail()) {
+        foreach(uint index, levelOfDetail.indices()) {
+            indices.append(pointOffset + index);
+        }
+    }
+
+    Q_ASSERT(points.size() <= scrap.PointCapacity);
+    Q_ASSERT(indices.size() <= scrap.IndexCapacity);
+
+    if(!points.isEmpty()) {
+        PointBuffer.bind();
+        PointBuffer.write(scrap.PointOffset * sizeof(QVector3D),
+                          points.constData(),
+                          points.size() * sizeof(QVector3D));
+        PointBuffer.release();
+
+        TexCoordBuffer.bind();
+        TexCoordBuffer.write(scrap.PointOffset * sizeof(QVector2D),
+                             texCoords.constData(),
+                             texCoords.size() * sizeof(QVector2D));
+        TexCoordBuffer.release();
+    }
+
+    if(!indices.isEmpty()) {
+        IndexBuffer.bind();
+        IndexBuffer.write(scrap.IndexOffset * sizeof(uint),
+                          indices.constData(),
+                          indices.size() * sizeof(uint));
+        IndexBuffer.release();
+    }
+
+    scrap.Uploaded = true;
+}
+
+/**
+ * @brief cwGLScraps::prefetchTextures
+ *
+ * When many scraps are added at once, like after loading a project, this bulk loads all
+ * their textures' mipmaps before each scrap's texture starts loading. The scraps closest
+ * to the camera are fetched first.
+ */
+void cwGLScraps::prefetchTextures()
+{
+    if(project() == nullptr) { return; }
+
+    QVector3D eyePosition = camera() != nullptr ? camera()->viewMatrix().inverted() * QVector3D() : QVector3D();
+
+    QList< QPair<float, cwImage> > distanceToImage;
+    foreach(const PendingScrapCommand& command, PendingChanges) {
+        if(command.type() != PendingScrapCommand::AddScrap) { continue; }
+
+        cwTriangulatedData data = command.triangulatedData();
+        if(!data.croppedImage().isValid()) { continue; }
+        if(Scraps.contains(command.scrap()) &&
+                Scraps.value(command.scrap()).Texture->image() == data.croppedImage())
+        {
+            //Texture is already loaded
+            continue;
+        }
+
+        QVector3D center;
+        if(!data.points().isEmpty()) {
+            foreach(const QVector3D& point, data.points()) {
+                center += point;
+            }
+            center /= (float)data.points().size();
+        }
+
+        distanceToImage.append(QPair<float, cwImage>((center - eyePosition).lengthSquared(), data.croppedImage()));
+    }
+
+    //Only worth batching when there's more than one texture to load
+    if(distanceToImage.size() < 2) { return; }
+
+    std::sort(distanceToImage.begin(), distanceToImage.end(),
+              [](const QPair<float, cwImage>& a, const QPair<float, cwImage>& b) { return a.first < b.first; });
+
+    QList<cwImage> images;
+    images.reserve(distanceToImage.size());
+    for(int i = 0; i < distanceToImage.size(); i++) {
+        images.append(distanceToImage.at(i).second);
+    }
+
+    cwImageTexture::prefetch(project()->filename(), images);
+}
+
+/**
+ * @brief cwGLScraps::levelOfDetail
+ * @param scrap
+ * @return The index of the coarsest level of the scrap that's within MaxLevelOfDetailError
+ * pixels of the full detail mesh, on the screen
+ *
+ * For perspective projections, the pixels per meter are measured at the scrap's bounding
+ * sphere's closest point to the camera. If the camera is in the sphere, the full detail mesh is
+ * used.
+ */
+int cwGLScraps::levelOfDetail(const GLScrap &scrap) const
+{
+    if(scrap.Levels.size() <= 1) { return 0; }
+
+    double pixelsPerMeter;
+    if(camera()->projection().type() == cwProjection::Ortho) {
+        pixelsPerMeter = camera()->pixelsPerMeter();
+    } else {
+        QVector3D viewCenter = camera()->viewMatrix() * scrap.Center;
+        double depth = -viewCenter.z() - scrap.Radius;
+        if(depth <= 0.0) { return 0; }
+        pixelsPerMeter = camera()->projectionMatrix()(1, 1) * camera()->viewport().height() * 0.5 / depth;
+    }
+
+    int level = 0;
+    for(int i = 1; i < scrap.Levels.size(); i++) {
+        if(scrap.Levels.at(i).Error * pixelsPerMeter > MaxLevelOfDetailError) {
+            break;
+        }
+        level = i;
+    }
+    return level;
+}
+
 /**
  * @brief cwGLScraps::addScrapToUpdate
  * @param scrap - The scrap.  This isn't used, just for book keeping
@@ -223,7 +514,12 @@ void cwGLScraps::initializeShaders() {
 }
 
 cwGLScraps::GLScrap::GLScrap() :
-    NumberOfIndices(0),
+    PointOffset(0),
+    PointCapacity(0),
+    IndexOffset(0),
+    IndexCapacity(0),
+    Uploaded(false),
+    Radius(0.0),
     ScrapId(-1),
     Texture(nullptr)
 
@@ -232,18 +528,15 @@ cwGLScraps::GLScrap::GLScrap() :
 }
 
 cwGLScraps::GLScrap::GLScrap(const cwTriangulatedData& data, cwProject *project) :
+    PointOffset(0),
+    PointCapacity(0),
+    IndexOffset(0),
+    IndexCapacity(0),
+    Uploaded(false),
+    Radius(0.0),
     ScrapId(-1),
     Texture(new cwImageTexture())
 {
-    PointBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
-    PointBuffer.create();
-
-    IndexBuffer = QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
-    IndexBuffer.create();
-
-    TexCoords = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
-    TexCoords.create();
-
     //Upload the texture to the graphics card
     Texture->initialize();
     Texture->setProject(project->filename());
@@ -254,33 +547,44 @@ cwGLScraps::GLScrap::GLScrap(const cwTriangulatedData& data, cwProject *project)
 /**
  * @brief cwGLScraps::GLScrap::update
  * @param data.  This update the data in the glSCrap
+ *
+ * The geometry is uploaded by cwGLScraps::updateBuffers()
  */
 void cwGLScraps::GLScrap::update(const cwTriangulatedData &data)
 {
-    PointBuffer.bind();
-    int pointBufferSize = data.points().size() * sizeof(QVector3D);
-    PointBuffer.allocate(data.points().constData(), pointBufferSize);
-    PointBuffer.release();
-
-    IndexBuffer.bind();
-    int indexBufferSize = data.indices().size() * sizeof(uint);
-    IndexBuffer.allocate(data.indices().constData(), indexBufferSize);
-    IndexBuffer.release();
-    NumberOfIndices = data.indices().size();
+    Data = data;
+    Uploaded = false;
+
+    //All the levels of detail follow each other, the full detail mesh is first
+    int numberOfIndices = data.indices().size();
+    Levels.clear();
+    Levels.append(Level(0, numberOfIndices, 0.0));
+    foreach(cwTriangulatedData::LevelOfDetail levelOfDetail, data.levelsOfDetail()) {
+        Levels.append(Level(numberOfIndices, levelOfDetail.indices().size(), levelOfDetail.error()));
+        numberOfIndices += levelOfDetail.indices().size();
+    }
 
-    TexCoords.bind();
-    int texCoordSize = data.texCoords().size() * sizeof(QVector2D);
-    TexCoords.allocate(data.texCoords().constData(), texCoordSize);
-    TexCoords.release();
+    //The bounding sphere, for picking the level of detail
+    QVector<QVector3D> points = data.points();
+    if(!points.isEmpty()) {
+        QVector3D minimum = points.first();
+        QVector3D maximum = points.first();
+        foreach(const QVector3D& point, points) {
+            minimum = QVector3D(qMin(minimum.x(), point.x()), qMin(minimum.y(), point.y()), qMin(minimum.z(), point.z()));
+            maximum = QVector3D(qMax(maximum.x(), point.x()), qMax(maximum.y(), point.y()), qMax(maximum.z(), point.z()));
+        }
+        Center = (minimum + maximum) * 0.5;
+        Radius = (maximum - minimum).length() * 0.5;
+    } else {
+        Center = QVector3D();
+        Radius = 0.0;
+    }
 
     Texture->setImage(data.croppedImage());
 }
 
 void cwGLScraps::GLScrap::releaseResources()
 {
-    PointBuffer.release();
-    IndexBuffer.release();
-    TexCoords.release();
     delete Texture;
 }
 
@@ -39,11 +39,15 @@ public:
 
     void initialize();
     void draw();
+    void culled();
     void updateData();
 
     void addScrapToUpdate(cwScrap* scrap);
     void removeScrap(cwScrap* scrap);
 
+    int drawCallCount() const;
+    int scrapsCulled() const;
+
     bool visible() const;
     void setVisible(bool visible);
 
@@ -84,17 +88,44 @@ private:
 
     };
 
+    /**
+     * A range of the scrap's indices. The first level is the full detail mesh, the rest
+     * are the coarser meshes from cwTriangulatedData::levelsOfDetail()
+     */
+    class Level {
+    public:
+        Level() : Offset(0), NumberOfIndices(0), Error(0.0) {}
+        Level(int offset, int numberOfIndices, double error) :
+            Offset(offset),
+            NumberOfIndices(numberOfIndices),
+            Error(error)
+        {}
+
+        int Offset;
+        int NumberOfIndices;
+        double Error; //!< In meters
+    };
+
+    /**
+     * A scrap and its range in the shared buffers. Each range has room to grow, so
+     * retriangulating a scrap only uploads that scrap's range.
+     */
     class GLScrap {
 
     public:
         GLScrap();
         GLScrap(const cwTriangulatedData& data, cwProject* project);
 
-        QOpenGLBuffer PointBuffer;
-        QOpenGLBuffer IndexBuffer;
-        QOpenGLBuffer TexCoords;
+        cwTriangulatedData Data; //!< Uploaded into the scrap's range by uploadScrap()
+        int PointOffset; //!< Where the scrap's points and texture coordinates start
+        int PointCapacity;
+        int IndexOffset; //!< Where the scrap's indices start in the shared index buffer
+        int IndexCapacity;
+        bool Uploaded; //!< False if the range in the buffers is out of date
 
-        int NumberOfIndices;
+        QVector<Level> Levels; //!< Offsets are relative to IndexOffset
+        QVector3D Center; //!< Of the bounding sphere
+        float Radius; //!< Of the bounding sphere
         int ScrapId; //For intersection
 
         cwImageTexture* Texture;
@@ -119,9 +150,23 @@ private:
     QHash<cwScrap*, GLScrap> Scraps;
     int MaxScrapId;
 
+    //All the scraps' geometry is packed into these, so they're only bound once per frame
+    QOpenGLBuffer PointBuffer;
+    QOpenGLBuffer IndexBuffer;
+    QOpenGLBuffer TexCoordBuffer;
+    QVector<GLScrap*> DrawList; //!< Rebuilt by updateBuffers(), when pending changes are applied
+
+    int DrawCallCount; //!< The number of glDrawElements calls in the last frame
+    int ScrapsCulled; //!< The number of scraps outside of the camera's view in the last frame
+
     bool Visible; //!< True if the scraps are visible and false if they're not
 
     void initializeShaders();
+    void prefetchTextures();
+    void updateBuffers();
+    void allocateBuffers();
+    void uploadScrap(GLScrap& scrap);
+    int levelOfDetail(const GLScrap& scrap) const;
 
 };
 
@@ -132,6 +177,24 @@ inline cwProject* cwGLScraps::project() const {
     return Project;
 }
 
+/**
+ * @brief cwGLScraps::drawCallCount
+ * @return The number of draw calls made in the last frame. This is for profiling
+ */
+inline int cwGLScraps::drawCallCount() const {
+    return DrawCallCount;
+}
+
+/**
+ * @brief cwGLScraps::scrapsCulled
+ * @return The number of scraps that weren't drawn in the last frame, because they were outside
+ * of the camera's view. This includes frames where cwScene culled the whole object. This is for
+ * profiling
+ */
+inline int cwGLScraps::scrapsCulled() const {
+    return ScrapsCulled;
+}
+
 /**
 Gets visible
 */
@@ -12,12 +12,167 @@
 //Std limits
 #include <limits>
 #include <math.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <functional>
 
 //Qt includes
 #include <QtNumeric>
-#include <QPlane3D>
+#include <QVector4D>
 
-cwGeometryItersecter::cwGeometryItersecter()
+//The most primitives in a leaf of the spatial index
+static const int MaxItemsInLeaf = 4;
+
+/**
+ * Slab test of the ray against the box. Returns true if the ray enters the box before maxT,
+ * and sets enterT to where it enters.
+ */
+static bool rayHitsBox(const QVector3D& origin, const QVector3D& inverseDirection,
+                       const QVector3D& minimum, const QVector3D& maximum,
+                       double maxT, double* enterT)
+{
+    double nearT = 0.0;
+    double farT = maxT;
+    for(int i = 0; i < 3; i++) {
+        double t1 = (minimum[i] - origin[i]) * inverseDirection[i];
+        double t2 = (maximum[i] - origin[i]) * inverseDirection[i];
+        if(qIsNaN(t1) || qIsNaN(t2)) {
+            //The ray is parallel and on a face of the slab
+            continue;
+        }
+        nearT = qMax(nearT, qMin(t1, t2));
+        farT = qMin(farT, qMax(t1, t2));
+        if(nearT > farT) {
+            return false;
+        }
+    }
+    *enterT = nearT;
+    return true;
+}
+
+/**
+ * Möller–Trumbore ray triangle intersection, for both sides of the triangle. Returns t and the
+ * barycentric coordinates of the hit, or NaN if the ray misses.
+ */
+static double rayHitsTriangle(const QVector3D& origin, const QVector3D& direction,
+                              const QVector3D& p1, const QVector3D& p2, const QVector3D& p3,
+                              QVector3D* barycentric)
+{
+    QVector3D edge1 = p2 - p1;
+    QVector3D edge2 = p3 - p1;
+    QVector3D pVector = QVector3D::crossProduct(direction, edge2);
+    double determinant = QVector3D::dotProduct(edge1, pVector);
+    if(determinant == 0.0) {
+        return qSNaN();
+    }
+
+    double inverseDeterminant = 1.0 / determinant;
+    QVector3D tVector = origin - p1;
+    double u = QVector3D::dotProduct(tVector, pVector) * inverseDeterminant;
+    if(u < 0.0 || u > 1.0) {
+        return qSNaN();
+    }
+
+    QVector3D qVector = QVector3D::crossProduct(tVector, edge1);
+    double v = QVector3D::dotProduct(direction, qVector) * inverseDeterminant;
+    if(v < 0.0 || u + v > 1.0) {
+        return qSNaN();
+    }
+
+    double t = QVector3D::dotProduct(edge2, qVector) * inverseDeterminant;
+    if(t < 0.0) {
+        return qSNaN();
+    }
+
+    *barycentric = QVector3D(1.0 - u - v, u, v);
+    return t;
+}
+
+/**
+ * Maps point to the screen. Returns false if the point is behind the camera.
+ */
+static bool toScreen(const QMatrix4x4& viewProjectionMatrix, const QRect& viewport,
+                     const QVector3D& point, QPointF* screenPoint, double* w)
+{
+    QVector4D clip = viewProjectionMatrix * QVector4D(point, 1.0);
+    if(clip.w() <= 0.0) {
+        return false;
+    }
+
+    *screenPoint = QPointF(viewport.x() + (clip.x() / clip.w() + 1.0) * 0.5 * viewport.width(),
+                           viewport.y() + (clip.y() / clip.w() + 1.0) * 0.5 * viewport.height());
+    *w = clip.w();
+    return true;
+}
+
+/**
+ * Returns where point projects on to the ray, in the ray's t
+ */
+static double projectOnRay(const QRay3D& ray, const QVector3D& point)
+{
+    QVector3D direction = ray.direction();
+    return QVector3D::dotProduct(point - ray.origin(), direction) / direction.lengthSquared();
+}
+
+/**
+ * Returns the closest point on the segment ab to point, as a weight of b
+ */
+static double closestOnSegment(const QPointF& a, const QPointF& b, const QPointF& point)
+{
+    QPointF ab = b - a;
+    double lengthSquared = QPointF::dotProduct(ab, ab);
+    if(lengthSquared == 0.0) {
+        return 0.0;
+    }
+    return qBound(0.0, QPointF::dotProduct(point - a, ab) / lengthSquared, 1.0);
+}
+
+static double distance(const QPointF& a, const QPointF& b)
+{
+    QPointF delta = a - b;
+    return sqrt(QPointF::dotProduct(delta, delta));
+}
+
+static double cross(const QPointF& a, const QPointF& b, const QPointF& c)
+{
+    return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+}
+
+/**
+ * Returns the closest point on the screen space triangle to point, as barycentric coordinates
+ */
+static QVector3D closestOnTriangle(const QPointF& p1, const QPointF& p2, const QPointF& p3, const QPointF& point)
+{
+    double area = cross(p1, p2, p3);
+    if(area != 0.0) {
+        double w1 = cross(p2, p3, point) / area;
+        double w2 = cross(p3, p1, point) / area;
+        double w3 = cross(p1, p2, point) / area;
+        if(w1 >= 0.0 && w2 >= 0.0 && w3 >= 0.0) {
+            return QVector3D(w1, w2, w3);
+        }
+    }
+
+    //Outside, or a degenerate triangle, find the closest edge
+    double s12 = closestOnSegment(p1, p2, point);
+    double s23 = closestOnSegment(p2, p3, point);
+    double s31 = closestOnSegment(p3, p1, point);
+
+    double d12 = distance(p1 + (p2 - p1) * s12, point);
+    double d23 = distance(p2 + (p3 - p2) * s23, point);
+    double d31 = distance(p3 + (p1 - p3) * s31, point);
+
+    if(d12 <= d23 && d12 <= d31) {
+        return QVector3D(1.0 - s12, s12, 0.0);
+    } else if(d23 <= d31) {
+        return QVector3D(0.0, 1.0 - s23, s23);
+    }
+    return QVector3D(s31, 0.0, 1.0 - s31);
+}
+
+cwGeometryItersecter::cwGeometryItersecter() :
+    IndexDirty(false)
 {
 }
 
@@ -51,16 +206,17 @@ void cwGeometryItersecter::addObject(const cwGeometryItersecter::Object &object)
  */
 void cwGeometryItersecter::clear(cwGLObject *parentObject)
 {
+    IndexDirty = true;
+
     if(parentObject == nullptr) {
-        Nodes.clear();
+        Objects.clear();
         return;
     }
 
-    QList<Node>::iterator iter = Nodes.begin();
-    while(iter != Nodes.end()) {
-        Node& currentNode = *iter;
-        if(currentNode.Object.parent() == parentObject) {
-            iter = Nodes.erase(iter);
+    QList<Object>::iterator iter = Objects.begin();
+    while(iter != Objects.end()) {
+        if(iter->parent() == parentObject) {
+            iter = Objects.erase(iter);
         } else {
             iter++;
         }
@@ -76,13 +232,13 @@ void cwGeometryItersecter::clear(cwGLObject *parentObject)
  */
 void cwGeometryItersecter::removeObject(cwGLObject *parentObject, uint id)
 {
-    QList<Node>::iterator iter = Nodes.begin();
-    while(iter != Nodes.end()) {
-        Node& currentNode = *iter;
-        if(currentNode.Object.parent() == parentObject &&
-                currentNode.Object.id() == id)
+    QList<Object>::iterator iter = Objects.begin();
+    while(iter != Objects.end()) {
+        if(iter->parent() == parentObject &&
+                iter->id() == id)
         {
-            iter = Nodes.erase(iter);
+            iter = Objects.erase(iter);
+            IndexDirty = true;
         } else {
             ++iter;
         }
@@ -92,32 +248,278 @@ void cwGeometryItersecter::removeObject(cwGLObject *parentObject, uint id)
 /**
  * @brief cwGeometryItersecter::intersects
  * @param ray
- * @return Closes intersection to on the ray, or if no match, use nearest neighbor search
+ * @return The closest intersection on the ray, or if the ray misses, the nearest station to
+ * the ray. NaN if there's neither.
  */
 double cwGeometryItersecter::intersects(const QRay3D &ray) const
 {
-    QList<double> intersections;
+    Hit closest = closestHit(ray);
+    if(closest.isValid()) {
+        return closest.t();
+    }
+
+    QList<Hit> stations = nearestStations(ray, 1);
+    if(!stations.isEmpty()) {
+        return stations.first().t();
+    }
+
+    return qSNaN();
+}
+
+/**
+ * @brief cwGeometryItersecter::closestHit
+ * @param ray
+ * @return The closest triangle that the ray hits, in front of the ray's origin. Lines have no
+ * area, so they're never hit, use nearestStations() or primitivesWithin() for them.
+ */
+cwGeometryItersecter::Hit cwGeometryItersecter::closestHit(const QRay3D &ray) const
+{
+    updateIndex();
+
+    Hit closest;
+    if(PrimitiveTree.isEmpty()) { return closest; }
+
+    QVector3D origin = ray.origin();
+    QVector3D direction = ray.direction();
+    QVector3D inverseDirection(1.0f / direction.x(), 1.0f / direction.y(), 1.0f / direction.z());
+
+    double closestT = std::numeric_limits<double>::max();
+    const Primitive* closestPrimitive = nullptr;
+    QVector3D closestBarycentric;
 
-    foreach(Node node, Nodes) {
+    QVector<int> stack;
+    stack.append(0);
+    while(!stack.isEmpty()) {
+        const TreeNode& node = PrimitiveTree.at(stack.takeLast());
 
-        double t = node.BoundingBox.intersection(ray);
-        if(!qIsNaN(t)) {
-            intersections.append(t);
+        double enterT;
+        if(!rayHitsBox(origin, inverseDirection, node.Box.Minimum, node.Box.Maximum, closestT, &enterT)) {
+            continue;
+        }
+
+        if(node.Count == 0) {
+            stack.append(node.Right);
+            stack.append(node.Left);
+            continue;
+        }
+
+        for(int i = node.First; i < node.First + node.Count; i++) {
+            const Primitive& primitive = Primitives.at(i);
+            const Object& object = Objects.at(primitive.ObjectIndex);
+            if(object.type() != Triangles) { continue; }
+
+            const QVector<uint>& indexes = object.indexes();
+            const QVector<QVector3D>& points = object.points();
+
+            QVector3D barycentric;
+            double t = rayHitsTriangle(origin, direction,
+                                       points.at(indexes.at(primitive.IndexInIndexes)),
+                                       points.at(indexes.at(primitive.IndexInIndexes + 1)),
+                                       points.at(indexes.at(primitive.IndexInIndexes + 2)),
+                                       &barycentric);
+            if(!qIsNaN(t) && t < closestT) {
+                closestT = t;
+                closestPrimitive = &primitive;
+                closestBarycentric = barycentric;
+            }
         }
     }
 
-    //See if we've intersected anything
-    if(intersections.size() == 0) {
-        return nearestNeighbor(ray); //Do a nearest neighbor search
+    if(closestPrimitive != nullptr) {
+        closest = hit(*closestPrimitive, closestBarycentric);
+        closest.T = closestT;
+        closest.Distance = 0.0;
     }
 
-    //Find the max value int intersections
-    double maxValue = -std::numeric_limits<double>::max();
-    foreach(double t, intersections) {
-        maxValue = qMax(t, maxValue);
+    return closest;
+}
+
+/**
+ * @brief cwGeometryItersecter::nearestStations
+ * @param ray
+ * @param count - The number of stations to find
+ * @return The points of the line objects, the stations, that are closest to the ray, closest
+ * first. Only the stations in front of the ray's origin are found.
+ */
+QList<cwGeometryItersecter::Hit> cwGeometryItersecter::nearestStations(const QRay3D &ray, int count) const
+{
+    updateIndex();
+
+    QList<Hit> hits;
+    if(StationTree.isEmpty() || count <= 0) { return hits; }
+
+    typedef std::pair<double, int> DistanceAndIndex;
+
+    //The nodes to visit, closest bound first
+    std::priority_queue<DistanceAndIndex, std::vector<DistanceAndIndex>, std::greater<DistanceAndIndex> > nodes;
+    nodes.push(DistanceAndIndex(0.0, 0));
+
+    //The best stations found, furthest first
+    std::priority_queue<DistanceAndIndex> best;
+
+    while(!nodes.empty()) {
+        DistanceAndIndex current = nodes.top();
+        nodes.pop();
+
+        if((int)best.size() == count && current.first >= best.top().first) {
+            //Nothing left can be closer
+            break;
+        }
+
+        const TreeNode& node = StationTree.at(current.second);
+        if(node.Count == 0) {
+            int children[2] = {node.Left, node.Right};
+            for(int i = 0; i < 2; i++) {
+                int childIndex = children[i];
+
+                //The distance to the box's bounding sphere is a lower bound for its stations
+                const Bounds& box = StationTree.at(childIndex).Box;
+                QVector3D center = box.center();
+                double radius = (box.Maximum - box.Minimum).length() * 0.5;
+                double lowerBound = qMax(0.0, (double)ray.distance(center) - radius);
+                nodes.push(DistanceAndIndex(lowerBound, childIndex));
+            }
+            continue;
+        }
+
+        for(int i = node.First; i < node.First + node.Count; i++) {
+            QVector3D point = Stations.at(i).Box.Minimum;
+            if(projectOnRay(ray, point) <= 0.0) { continue; }
+
+            double stationDistance = ray.distance(point);
+            if((int)best.size() < count) {
+                best.push(DistanceAndIndex(stationDistance, i));
+            } else if(stationDistance < best.top().first) {
+                best.pop();
+                best.push(DistanceAndIndex(stationDistance, i));
+            }
+        }
     }
 
-    return maxValue;
+    while(!best.empty()) {
+        DistanceAndIndex station = best.top();
+        best.pop();
+
+        const Primitive& stationPoint = Stations.at(station.second);
+        const Object& object = Objects.at(stationPoint.ObjectIndex);
+
+        Hit stationHit;
+        stationHit.Parent = object.parent();
+        stationHit.Id = object.id();
+        stationHit.Type = object.type();
+        stationHit.PrimitiveIndex = stationPoint.IndexInIndexes;
+        stationHit.Barycentric = QVector3D(1.0, 0.0, 0.0);
+        stationHit.Point = object.points().at(stationPoint.IndexInIndexes);
+        stationHit.T = projectOnRay(ray, stationHit.Point);
+        stationHit.Distance = station.first;
+        hits.prepend(stationHit);
+    }
+
+    return hits;
+}
+
+/**
+ * @brief cwGeometryItersecter::primitivesWithin
+ * @param viewProjectionMatrix - The camera's view projection matrix
+ * @param viewport - The camera's viewport
+ * @param glViewportPoint - The point on the screen, in opengl viewport coordinates, see cwCamera::mapToGLViewport()
+ * @param pixelRadius - How far from glViewportPoint the primitives can be
+ * @return All the triangles and lines that are within pixelRadius of glViewportPoint on the
+ * screen, closest first. Each hit's point is the primitive's closest point to glViewportPoint.
+ *
+ * Primitives that are partly behind the camera are skipped.
+ */
+QList<cwGeometryItersecter::Hit> cwGeometryItersecter::primitivesWithin(const QMatrix4x4 &viewProjectionMatrix,
+                                                                       const QRect &viewport,
+                                                                       const QPointF &glViewportPoint,
+                                                                       double pixelRadius) const
+{
+    updateIndex();
+
+    QList<Hit> hits;
+    if(PrimitiveTree.isEmpty()) { return hits; }
+
+    QVector<int> stack;
+    stack.append(0);
+    while(!stack.isEmpty()) {
+        const TreeNode& node = PrimitiveTree.at(stack.takeLast());
+
+        //Find the box on the screen
+        bool behindCamera = false;
+        QRectF screenBox;
+        for(int i = 0; i < 8 && !behindCamera; i++) {
+            QVector3D corner(i & 1 ? node.Box.Maximum.x() : node.Box.Minimum.x(),
+                             i & 2 ? node.Box.Maximum.y() : node.Box.Minimum.y(),
+                             i & 4 ? node.Box.Maximum.z() : node.Box.Minimum.z());
+            QPointF screenCorner;
+            double w;
+            behindCamera = !toScreen(viewProjectionMatrix, viewport, corner, &screenCorner, &w);
+            screenBox = i == 0 ? QRectF(screenCorner, screenCorner) : screenBox.united(QRectF(screenCorner, screenCorner));
+        }
+
+        if(!behindCamera) {
+            QPointF closest(qBound(screenBox.left(), glViewportPoint.x(), screenBox.right()),
+                            qBound(screenBox.top(), glViewportPoint.y(), screenBox.bottom()));
+            if(distance(closest, glViewportPoint) > pixelRadius) {
+                continue;
+            }
+        }
+
+        if(node.Count == 0) {
+            stack.append(node.Right);
+            stack.append(node.Left);
+            continue;
+        }
+
+        for(int i = node.First; i < node.First + node.Count; i++) {
+            const Primitive& primitive = Primitives.at(i);
+            const Object& object = Objects.at(primitive.ObjectIndex);
+            int numberOfPoints = object.type() == Triangles ? 3 : 2;
+
+            QPointF screenPoints[3];
+            double w[3];
+            bool visible = true;
+            for(int j = 0; j < numberOfPoints && visible; j++) {
+                QVector3D point = object.points().at(object.indexes().at(primitive.IndexInIndexes + j));
+                visible = toScreen(viewProjectionMatrix, viewport, point, &screenPoints[j], &w[j]);
+            }
+            if(!visible) { continue; }
+
+            QVector3D screenBarycentric;
+            if(numberOfPoints == 3) {
+                screenBarycentric = closestOnTriangle(screenPoints[0], screenPoints[1], screenPoints[2], glViewportPoint);
+            } else {
+                double s = closestOnSegment(screenPoints[0], screenPoints[1], glViewportPoint);
+                screenBarycentric = QVector3D(1.0 - s, s, 0.0);
+            }
+
+            QPointF screenClosest;
+            for(int j = 0; j < numberOfPoints; j++) {
+                screenClosest += screenPoints[j] * screenBarycentric[j];
+            }
+
+            double pixelDistance = distance(screenClosest, glViewportPoint);
+            if(pixelDistance > pixelRadius) { continue; }
+
+            //Screen space barycentrics aren't linear in world space, correct them for perspective
+            QVector3D barycentric;
+            double sum = 0.0;
+            for(int j = 0; j < numberOfPoints; j++) {
+                barycentric[j] = screenBarycentric[j] / w[j];
+                sum += barycentric[j];
+            }
+            barycentric /= sum;
+
+            Hit primitiveHit = hit(primitive, barycentric);
+            primitiveHit.T = qSNaN();
+            primitiveHit.Distance = pixelDistance;
+            hits.append(primitiveHit);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.distance() < b.distance(); });
+
+    return hits;
 }
 
 /**
@@ -137,9 +539,8 @@ void cwGeometryItersecter::addTriangles(const cwGeometryItersecter::Object &obje
 
     removeObject(object.parent(), object.id());
 
-    for(int i = 0; i < object.indexes().size(); i+=3) {
-        Nodes.append(Node(object, i));
-    }
+    Objects.append(object);
+    IndexDirty = true;
 }
 
 /**
@@ -161,121 +562,145 @@ void cwGeometryItersecter::addLines(const cwGeometryItersecter::Object &object)
 
     removeObject(object.parent(), object.id());
 
-    for(int i = 0; i < object.indexes().size(); i+=2) {
-        Node node = Node(object, i);
-
-        //Make sure the node is valid
-        if(!node.BoundingBox.isNull()) {
-            Nodes.append(node);
-        }
-    }
+    Objects.append(object);
+    IndexDirty = true;
 }
 
-
 /**
- * @brief cwGeometryItersecter::nearestNeighbor
- * @param ray
- * @return Finds the point on the ray that's the nearest neigbor of the ray
+ * @brief cwGeometryItersecter::updateIndex
+ *
+ * Rebuilds the bounding volume hierarchies of the primitives and the stations, if objects
+ * have been added or removed since the last query
  */
-double cwGeometryItersecter::nearestNeighbor(const QRay3D &ray) const
+void cwGeometryItersecter::updateIndex() const
 {
+    if(!IndexDirty) { return; }
+    IndexDirty = false;
+
+    Primitives.clear();
+    PrimitiveTree.clear();
+    Stations.clear();
+    StationTree.clear();
+
+    for(int objectIndex = 0; objectIndex < Objects.size(); objectIndex++) {
+        const Object& object = Objects.at(objectIndex);
+        const QVector<QVector3D>& points = object.points();
+        const QVector<uint>& indexes = object.indexes();
+        int numberOfPoints = object.type() == Triangles ? 3 : 2;
+
+        for(int i = 0; i + numberOfPoints <= indexes.size(); i += numberOfPoints) {
+            Bounds bounds(points.at(indexes.at(i)));
+            for(int j = 1; j < numberOfPoints; j++) {
+                bounds.unite(points.at(indexes.at(i + j)));
+            }
+            Primitives.append(Primitive(objectIndex, i, bounds));
+        }
 
-    QVector<QVector3D> points;
-    points.resize(8);
-
-    double bestT = 0.0;
-    double bestDistance = std::numeric_limits<double>::max();
-
-    foreach(Node node, Nodes) {
-
-        QVector3D min = node.BoundingBox.minimum();
-        QVector3D max = node.BoundingBox.maximum();
-
-        points[0] = min;
-        points[1] = QVector3D(max.x(), min.y(), min.z());
-        points[2] = QVector3D(max.x(), max.y(), min.z());
-        points[3] = QVector3D(min.x(), max.y(), min.z());
-        points[4] = QVector3D(min.x(), min.y(), max.z());
-        points[5] = QVector3D(max.x(), min.y(), max.z());
-        points[6] = QVector3D(min.x(), max.y(), max.z());
-        points[7] = max;
-
-        for(int i = 0; i < 8; i++) {
-            const QVector3D& point = points.at(i);
-            double distance = ray.distance(point);
-            if(distance < bestDistance) {
-                double t = ray.projectedDistance(point);
-                if(t > 0.0) {
-                    bestDistance = distance;
-                    bestT = t;
+        if(object.type() == Lines) {
+            //Each station once, even if it's in many lines
+            QVector<bool> added(points.size(), false);
+            foreach(uint index, indexes) {
+                if(!added.at(index)) {
+                    added[index] = true;
+                    Stations.append(Primitive(objectIndex, index, Bounds(points.at(index))));
                 }
             }
         }
     }
 
-    if(bestT == 0.0) {
-        return qSNaN();
+    if(!Primitives.isEmpty()) {
+        buildTree(&PrimitiveTree, &Primitives, 0, Primitives.size());
     }
 
-    return bestT;
+    if(!Stations.isEmpty()) {
+        buildTree(&StationTree, &Stations, 0, Stations.size());
+    }
 }
 
-
-cwGeometryItersecter::Node::Node(const cwGeometryItersecter::Object &object, int indexInIndexes) :
-    Object(object),
-    IndexInIndexes(indexInIndexes)
+/**
+ * @brief cwGeometryItersecter::hit
+ * @param primitive
+ * @param barycentric - The weights of the primitive's points
+ * @return A hit on the primitive, at the barycentric point
+ */
+cwGeometryItersecter::Hit cwGeometryItersecter::hit(const Primitive &primitive, const QVector3D &barycentric) const
 {
-
-    switch(object.type()) {
-    case Triangles:
-        BoundingBox = triangleToBoundingBox();
-        break;
-    case Lines:
-        BoundingBox = lineToBoundingBox();
-        break;
-    default:
-        break;
+    const Object& object = Objects.at(primitive.ObjectIndex);
+
+    Hit hit;
+    hit.Parent = object.parent();
+    hit.Id = object.id();
+    hit.Type = object.type();
+    hit.Barycentric = barycentric;
+
+    int numberOfPoints = object.type() == Triangles ? 3 : 2;
+    hit.PrimitiveIndex = primitive.IndexInIndexes / numberOfPoints;
+    for(int i = 0; i < numberOfPoints; i++) {
+        hit.Point += object.points().at(object.indexes().at(primitive.IndexInIndexes + i)) * barycentric[i];
     }
-
+    return hit;
 }
 
 /**
- * @brief cwGeometryItersecter::Node::triangleToBoundingBox
- * @return Creates a bounding box around a triangle
+ * @brief cwGeometryItersecter::Bounds::unite
+ * @param point - Grows the bounds to include point
  */
-QBox3D cwGeometryItersecter::Node::triangleToBoundingBox() const
+void cwGeometryItersecter::Bounds::unite(const QVector3D &point)
 {
-    QVector3D p1 = Object.points().at(Object.indexes().at(IndexInIndexes));
-    QVector3D p2 = Object.points().at(Object.indexes().at(IndexInIndexes + 1));
-    QVector3D p3 = Object.points().at(Object.indexes().at(IndexInIndexes + 2));
-
-    QVector3D maxPoint(qMax(p1.x(), qMax(p2.x(), p3.x())),
-                       qMax(p1.y(), qMax(p2.y(), p3.y())),
-                       qMax(p1.z(), qMax(p2.z(), p3.z())));
-
-    QVector3D minPoint(qMin(p1.x(), qMin(p2.x(), p3.x())),
-                       qMin(p1.y(), qMin(p2.y(), p3.y())),
-                       qMin(p1.z(), qMin(p2.z(), p3.z())));
+    Minimum = QVector3D(qMin(Minimum.x(), point.x()), qMin(Minimum.y(), point.y()), qMin(Minimum.z(), point.z()));
+    Maximum = QVector3D(qMax(Maximum.x(), point.x()), qMax(Maximum.y(), point.y()), qMax(Maximum.z(), point.z()));
+}
 
-    return QBox3D(minPoint, maxPoint);
+/**
+ * @brief cwGeometryItersecter::Bounds::unite
+ * @param bounds - Grows the bounds to include bounds
+ */
+void cwGeometryItersecter::Bounds::unite(const cwGeometryItersecter::Bounds &bounds)
+{
+    unite(bounds.Minimum);
+    unite(bounds.Maximum);
 }
 
 /**
- * @brief cwGeometryItersecter::Node::lineToBoundingBox
- * @return Creates a bounding box around a line
+ * @brief cwGeometryItersecter::buildTree
+ * @return The index of the node
+ *
+ * Builds the bounding volume hierarchy for items[first, first + count). The items are
+ * reordered, so each leaf's items are next to each other.
  */
-QBox3D cwGeometryItersecter::Node::lineToBoundingBox() const
+int cwGeometryItersecter::buildTree(QVector<TreeNode> *nodes, QVector<Primitive> *items, int first, int count)
 {
-    QVector3D p1 = Object.points().at(Object.indexes().at(IndexInIndexes));
-    QVector3D p2 = Object.points().at(Object.indexes().at(IndexInIndexes + 1));
+    int nodeIndex = nodes->size();
+    nodes->append(TreeNode());
+
+    Bounds bounds = items->at(first).Box;
+    Bounds centers(bounds.center());
+    for(int i = first + 1; i < first + count; i++) {
+        bounds.unite(items->at(i).Box);
+        centers.unite(items->at(i).Box.center());
+    }
+    (*nodes)[nodeIndex].Box = bounds;
+
+    QVector3D extent = centers.Maximum - centers.Minimum;
+    if(count <= MaxItemsInLeaf || extent == QVector3D()) {
+        //Small enough, or all the items are in the same place and can't be split
+        (*nodes)[nodeIndex].First = first;
+        (*nodes)[nodeIndex].Count = count;
+        return nodeIndex;
+    }
 
-    QVector3D maxPoint(qMax(p1.x(), p2.x()),
-                       qMax(p1.y(), p2.y()),
-                       qMax(p1.z(), p2.z()));
+    //Split at the median of the longest axis
+    int axis = 0;
+    if(extent.y() > extent[axis]) { axis = 1; }
+    if(extent.z() > extent[axis]) { axis = 2; }
 
-    QVector3D minPoint(qMin(p1.x(), p2.x()),
-                       qMin(p1.y(), p2.y()),
-                       qMin(p1.z(), p2.z()));
+    int middle = first + count / 2;
+    std::nth_element(items->begin() + first, items->begin() + middle, items->begin() + first + count,
+                     [axis](const Primitive& a, const Primitive& b) { return a.Box.center()[axis] < b.Box.center()[axis]; });
 
-    return QBox3D(minPoint, maxPoint);
+    int left = buildTree(nodes, items, first, middle - first);
+    int right = buildTree(nodes, items, middle, first + count - middle);
+    (*nodes)[nodeIndex].Left = left;
+    (*nodes)[nodeIndex].Right = right;
+    return nodeIndex;
 }
@@ -13,6 +13,9 @@
 #include <QVector3D>
 #include <QRay3D>
 #include <QBox3D>
+#include <QMatrix4x4>
+#include <QRect>
+#include <QPointF>
 
 //Our includes
 class cwGLObject;
@@ -53,6 +56,54 @@ public:
         PrimitiveType Type;
     };
 
+    /**
+     * A primitive, or a station, that was found by one of the queries
+     */
+    class Hit {
+    public:
+        Hit() :
+            Parent(nullptr),
+            Id(0),
+            Type(None),
+            PrimitiveIndex(-1),
+            T(0.0),
+            Distance(0.0)
+        {}
+
+        bool isValid() const { return PrimitiveIndex >= 0; }
+
+        cwGLObject* parent() const { return Parent; }
+        uint id() const { return Id; }
+        PrimitiveType type() const { return Type; }
+
+        //The triangle or line in the object's indexes, or the point for stations
+        int primitiveIndex() const { return PrimitiveIndex; }
+
+        //The weights of the primitive's points, in index order, that make up point()
+        QVector3D barycentric() const { return Barycentric; }
+
+        QVector3D point() const { return Point; }
+
+        //Where point() is along the ray, this is NaN for primitivesWithin()
+        double t() const { return T; }
+
+        //How far point() is from what was queried, 0.0 for closestHit(), in world units
+        //for nearestStations(), and in pixels for primitivesWithin()
+        double distance() const { return Distance; }
+
+    private:
+        cwGLObject* Parent;
+        uint Id;
+        PrimitiveType Type;
+        int PrimitiveIndex;
+        QVector3D Barycentric;
+        QVector3D Point;
+        double T;
+        double Distance;
+
+        friend class cwGeometryItersecter;
+    };
+
     cwGeometryItersecter();
 
     void addObject(const cwGeometryItersecter::Object& object);
@@ -61,31 +112,79 @@ public:
 
     double intersects(const QRay3D& ray) const;
 
+    Hit closestHit(const QRay3D& ray) const;
+    QList<Hit> nearestStations(const QRay3D& ray, int count) const;
+    QList<Hit> primitivesWithin(const QMatrix4x4& viewProjectionMatrix,
+                                const QRect& viewport,
+                                const QPointF& glViewportPoint,
+                                double pixelRadius) const;
 
 private:
 
-    class Node {
+    /**
+     * An axis aligned box. This is lighter than QBox3D, which also handles null and infinite boxes
+     */
+    class Bounds {
     public:
-        Node();
-        Node(const cwGeometryItersecter::Object& object, int indexInIndexes);
+        Bounds() {}
+        Bounds(const QVector3D& point) : Minimum(point), Maximum(point) {}
 
-        QBox3D BoundingBox;
-        cwGeometryItersecter::Object Object;
-        int IndexInIndexes; //Where in Object this Node point's to
+        void unite(const QVector3D& point);
+        void unite(const Bounds& bounds);
+        QVector3D center() const { return (Minimum + Maximum) * 0.5f; }
 
-    private:
-        QBox3D triangleToBoundingBox() const;
-        QBox3D lineToBoundingBox() const;
+        QVector3D Minimum;
+        QVector3D Maximum;
+    };
 
+    /**
+     * A triangle or line of an Object
+     */
+    class Primitive {
+    public:
+        Primitive() : ObjectIndex(-1), IndexInIndexes(-1) {}
+        Primitive(int objectIndex, int indexInIndexes, const Bounds& bounds) :
+            ObjectIndex(objectIndex),
+            IndexInIndexes(indexInIndexes),
+            Box(bounds)
+        {}
+
+        int ObjectIndex;
+        int IndexInIndexes; //Where in the object's indexes this primitive starts
+        Bounds Box;
     };
 
-    QList<Node> Nodes;
+    /**
+     * A node of a bounding volume hierarchy. Leaves have Count items starting at First, other
+     * nodes have Count of 0 and two children.
+     */
+    class TreeNode {
+    public:
+        TreeNode() : First(0), Count(0), Left(-1), Right(-1) {}
+
+        Bounds Box;
+        int First;
+        int Count;
+        int Left;
+        int Right;
+    };
+
+    QList<Object> Objects;
+
+    //The spatial index. It's rebuilt by the next query after objects are added or removed
+    mutable bool IndexDirty;
+    mutable QVector<Primitive> Primitives; //Sorted by the tree
+    mutable QVector<TreeNode> PrimitiveTree;
+    mutable QVector<Primitive> Stations; //The points of line objects, IndexInIndexes is the index of the point
+    mutable QVector<TreeNode> StationTree;
 
     void addTriangles(const cwGeometryItersecter::Object& object);
     void addLines(const cwGeometryItersecter::Object& object);
 
-    double nearestNeighbor(const QRay3D& ray) const;
-//    double LineLineIntersect(QVector3D p1, QVector3D p2, QVector3D p3, QVector3D p4) const;
+    void updateIndex() const;
+    Hit hit(const Primitive& primitive, const QVector3D& barycentric) const;
+
+    static int buildTree(QVector<TreeNode>* nodes, QVector<Primitive>* items, int first, int count);
 };
 
 inline uint qHash(const cwGeometryItersecter::Object& object) {
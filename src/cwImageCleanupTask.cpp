@@ -21,12 +21,22 @@
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QVariant>
-#include <QSet>
 
-cwImageCleanupTask::cwImageCleanupTask()
+cwImageCleanupTask::cwImageCleanupTask() :
+    NumberOfRemovedImages(0)
 {
 }
 
+/**
+ * @brief cwImageCleanupTask::setRegion
+ * @param region - The images in region are kept, all others are removed
+ *
+ * This copies the image ids out of the region, so it needs to be called on the region's thread
+ */
+void cwImageCleanupTask::setRegion(const cwCavingRegion *region)
+{
+    UsedImageReferences = usedImageReferences(region);
+}
 
 /**
  * @brief cwImageCleanupTask::runTask
@@ -35,108 +45,196 @@ cwImageCleanupTask::cwImageCleanupTask()
  */
 void cwImageCleanupTask::runTask()
 {
+    NumberOfRemovedImages = 0;
+
     //Connect to the database
     bool connected = connectToDatabase("UnusedImagesCleanupTask");
 
     if(connected) {
-        tryFetchAllImageIds();
+        bool removed = removeUnusedImages();
 
-        QSet<int> validIds = extractAllValidImageIds();
-        QSet<int> unusedIds = DatabaseIds.subtract(validIds);
+        if(removed && isRunning()) {
+            incrementalVacuum();
+        }
 
-        beginTransation();
+        //Close the database
+        Database.close();
+    }
 
-        QString SQL("DELETE FROM Images WHERE id == ?");
-        QSqlQuery removeImageIdQuery(Database);
+    done();
+}
 
-        bool successful = removeImageIdQuery.prepare(SQL);
-        if(!successful) {
-            qDebug() << "Couldn't delete images:" << removeImageIdQuery.lastError() << LOCATION;
-            stop();
-            endTransation();
-            return;
-        }
+/**
+ * @brief cwImageCleanupTask::removeUnusedImages
+ * @return True if the unused images were removed
+ *
+ * Copies the used image ids into a temporary table, and removes all the other images with a
+ * single statement. Then raises the referenceCount of images that the region uses more often than
+ * the database knows about.
+ */
+bool cwImageCleanupTask::removeUnusedImages()
+{
+    beginTransation();
 
-        foreach(int id, unusedIds) {
-            removeImageIdQuery.bindValue(0, id);
-            removeImageIdQuery.exec();
-        }
+    if(!fillTempTable("UsedImageIds", UsedImageReferences) ||
+            !fillTempTable("LoadedImageIds", LoadedReferenceCounts))
+    {
+        stop();
+        endTransation();
+        return false;
+    }
 
+    //If the image isn't in LoadedImageIds, the sub select is NULL and the image is kept
+    QSqlQuery removeQuery(Database);
+    bool successful = removeQuery.exec("DELETE FROM Images WHERE id NOT IN (SELECT id FROM temp.UsedImageIds) "
+                                       "AND referenceCount <= (SELECT loaded.referenceCount FROM temp.LoadedImageIds loaded WHERE loaded.id = Images.id)");
+    if(!successful) {
+        qDebug() << "Couldn't delete images:" << removeQuery.lastError() << LOCATION;
+        stop();
         endTransation();
+        return false;
+    }
 
-        //Close the database
-        Database.close();
+    NumberOfRemovedImages = removeQuery.numRowsAffected();
+
+    QSqlQuery referenceQuery(Database);
+    successful = referenceQuery.exec("UPDATE Images SET referenceCount = (SELECT used.referenceCount FROM temp.UsedImageIds used WHERE used.id = Images.id) "
+                                     "WHERE referenceCount < (SELECT used.referenceCount FROM temp.UsedImageIds used WHERE used.id = Images.id)");
+    if(!successful) {
+        qDebug() << "Couldn't update image reference counts:" << referenceQuery.lastError() << LOCATION;
     }
 
-    done();
-}
+    QSqlQuery query(Database);
+    query.exec("DROP TABLE IF EXISTS temp.UsedImageIds");
+    query.exec("DROP TABLE IF EXISTS temp.LoadedImageIds");
 
+    endTransation();
+    return true;
+}
 
 /**
- * @brief cwImageCleanupTask::tryFetchAllImageIds
+ * @brief cwImageCleanupTask::fillTempTable
+ * @param table - The name of the temporary table
+ * @param referenceCounts - Image id to reference count that are inserted into the table
+ * @return True if the table was created and filled
  */
-void cwImageCleanupTask::tryFetchAllImageIds()
+bool cwImageCleanupTask::fillTempTable(QString table, const QHash<int, int> &referenceCounts)
 {
-    cwSQLManager::Transaction transaction(&Database, cwSQLManager::ReadOnly);
+    QSqlQuery query(Database);
+
+    bool successful = query.exec(QString("CREATE TEMP TABLE IF NOT EXISTS %1 (id INTEGER PRIMARY KEY, referenceCount INTEGER)").arg(table));
+    if(!successful) {
+        qDebug() << "Couldn't create" << table << "table:" << query.lastError() << LOCATION;
+        return false;
+    }
 
-    QString sql("select id from images");
-    QSqlQuery imageIdsQuery(sql, Database);
+    query.exec(QString("DELETE FROM temp.%1").arg(table));
 
-    QSet<int> ids;
-    while(imageIdsQuery.next()) {
-        int id = imageIdsQuery.value(0).toInt();
-        ids.insert(id);
+    QVariantList ids;
+    QVariantList counts;
+    ids.reserve(referenceCounts.size());
+    counts.reserve(referenceCounts.size());
+    for(auto iter = referenceCounts.constBegin(); iter != referenceCounts.constEnd(); ++iter) {
+        ids.append(iter.key());
+        counts.append(iter.value());
     }
 
-    DatabaseIds = ids;
+    QSqlQuery insertQuery(Database);
+    insertQuery.prepare(QString("INSERT INTO temp.%1 (id, referenceCount) VALUES (?, ?)").arg(table));
+    insertQuery.addBindValue(ids);
+    insertQuery.addBindValue(counts);
+    successful = insertQuery.execBatch();
+    if(!successful) {
+        qDebug() << "Couldn't insert into" << table << ":" << insertQuery.lastError() << LOCATION;
+    }
+    return successful;
+}
+
+/**
+ * @brief cwImageCleanupTask::incrementalVacuum
+ *
+ * Gives the free pages back to the file system, VacuumPagesPerStep pages at a time. Other
+ * connections can use the database between each step. This does nothing if the database
+ * isn't using incremental vacuuming, see cwRegionLoadTask::insureVacuuming().
+ */
+void cwImageCleanupTask::incrementalVacuum()
+{
+    QSqlQuery query(Database);
+
+    while(isRunning()) {
+        int freePages = 0;
+        if(query.exec("PRAGMA freelist_count") && query.next()) {
+            freePages = query.value(0).toInt();
+        }
+        query.finish();
+
+        if(freePages <= 0) {
+            break;
+        }
+
+        if(!query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(VacuumPagesPerStep))) {
+            qDebug() << "Incremental vacuum error:" << query.lastError() << LOCATION;
+            break;
+        }
 
+        //Step through the results, the pages are only freed while stepping
+        while(query.next()) { }
+        query.finish();
+    }
 }
 
 /**
- * @brief cwImageCleanupTask::extractAllValidImageIds
- * @return All the valid image ids in the database
+ * @brief cwImageCleanupTask::usedImageReferences
+ * @return All the image ids that are used by the region, with the number of references to each
  *
- * This will go through all the cavewhere structure and add all id's to the
- * set of valid Ids
+ * This will go through all the cavewhere structure and count every cwImage that uses an id
  */
-QSet<int> cwImageCleanupTask::extractAllValidImageIds()
+QHash<int, int> cwImageCleanupTask::usedImageReferences(const cwCavingRegion* region)
 {
-    QSet<int> ids;
+    QHash<int, int> references;
 
-    foreach(cwCave* cave, Region->caves()) {
+    if(region == nullptr) {
+        return references;
+    }
+
+    foreach(cwCave* cave, region->caves()) {
         foreach(cwTrip* trip, cave->trips()) {
             foreach(cwNote* note, trip->notes()->notes()) {
-                cwImage image = note->image();
-                QSet<int> imageIds = imageToSet(image);
-                ids = ids.unite(imageIds);
+                addImageReferences(note->image(), &references);
 
                 foreach(cwScrap* scrap, note->scraps()) {
-                    image = scrap->triangulationData().croppedImage();
-                    imageIds = imageToSet(image);
-                    ids = ids.unite(imageIds);
+                    addImageReferences(scrap->triangulationData().croppedImage(), &references);
+
+                    foreach(const cwTriangulatedData& recentData, scrap->recentTriangulations()) {
+                        addImageReferences(recentData.croppedImage(), &references);
+                    }
                 }
             }
         }
     }
 
-    return ids;
+    return references;
 }
 
 /**
- * @brief cwImageCleanupTask::imageToSet
+ * @brief cwImageCleanupTask::addImageReferences
  * @param image
- * @return The converted image into a set of ids
+ * @param references - Each id in image gets one more reference
+ *
+ * The icon doesn't hold a reference when it's the original, like cwProject::removeImage()
  */
-QSet<int> cwImageCleanupTask::imageToSet(cwImage image) const
+void cwImageCleanupTask::addImageReferences(cwImage image, QHash<int, int>* references)
 {
-    QSet<int> ids;
-    ids.insert(image.icon());
-    ids.insert(image.original());
+    if(!image.isValid()) {
+        return;
+    }
 
-    foreach(int mipmapId, image.mipmaps()) {
-        ids.insert(mipmapId);
+    (*references)[image.original()]++;
+    if(image.icon() != image.original()) {
+        (*references)[image.icon()]++;
     }
 
-    return ids;
+    foreach(int mipmapId, image.mipmaps()) {
+        (*references)[mipmapId]++;
+    }
 }
-
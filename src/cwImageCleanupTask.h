@@ -14,52 +14,80 @@
 class cwCavingRegion;
 
 //Qt includes
-#include <QSet>
+#include <QHash>
 
 /**
  * @brief The cwImageCleanupTask class
  *
  * This removes un-used images from the database
+ *
+ * The ids of the images that are in use are copied into a temporary table, and all other images
+ * are removed with a single DELETE. The freed pages are then given back to the file system with
+ * incremental vacuums in small steps, so the database isn't locked for long.
+ *
+ * Identical images are shared and reference counted, see cwProject::addImage(). The region is
+ * the source of truth: images that it doesn't use are removed no matter their referenceCount, and
+ * images that it uses more often than their referenceCount have the count raised.
+ *
+ * setRegion() must be called on the region's thread. The task itself can be run on any thread.
  */
 class cwImageCleanupTask : public cwProjectIOTask
 {
 public:
     cwImageCleanupTask();
 
-    void setRegion(cwCavingRegion* region);
-    cwCavingRegion* region() const;
+    void setRegion(const cwCavingRegion* region);
+
+    void setLoadedReferenceCounts(QHash<int, int> referenceCounts);
+    QHash<int, int> loadedReferenceCounts() const;
+
+    int numberOfRemovedImages() const;
+
+    static QHash<int, int> usedImageReferences(const cwCavingRegion* region);
 
 protected:
     void runTask();
 
 private:
-    cwCavingRegion* Region;
-    QList<cwImage> UnusedImages;
-    QSet<int> DatabaseIds;
-
-    void populateUnusedImages();
-    QSet<int> extractAllValidImageIds();
-    QSet<int> imageToSet(cwImage image) const;
+    //The number of pages freed by each incremental vacuum step
+    static const int VacuumPagesPerStep = 256;
 
+    QHash<int, int> UsedImageReferences; //!< Image id to the number of cwImage's using it
+    QHash<int, int> LoadedReferenceCounts; //!< Image id to referenceCount when the region was loaded
+    int NumberOfRemovedImages;
 
-private slots:
-    void tryFetchAllImageIds();
-
+    bool removeUnusedImages();
+    bool fillTempTable(QString table, const QHash<int, int>& referenceCounts);
+    void incrementalVacuum();
 
+    static void addImageReferences(cwImage image, QHash<int, int>* references);
 };
 
 /**
- * @brief cwImageCleanupTask::setRegion
- * @param region
+ * @brief cwImageCleanupTask::setLoadedReferenceCounts
+ * @param referenceCounts - Image id to its referenceCount, when the region was loaded
+ *
+ * Only images in referenceCounts are removed. Images added after loading aren't in the region
+ * yet, and images that were reused after loading have a larger referenceCount, so neither are
+ * removed. See cwRegionLoadTask::imageReferenceCounts()
  */
-inline void cwImageCleanupTask::setRegion(cwCavingRegion *region)
+inline void cwImageCleanupTask::setLoadedReferenceCounts(QHash<int, int> referenceCounts)
 {
-    Region = region;
+    LoadedReferenceCounts = referenceCounts;
 }
 
-inline cwCavingRegion *cwImageCleanupTask::region() const
+inline QHash<int, int> cwImageCleanupTask::loadedReferenceCounts() const
+{
+    return LoadedReferenceCounts;
+}
+
+/**
+ * @brief cwImageCleanupTask::numberOfRemovedImages
+ * @return The number of images that were removed the last time the task ran
+ */
+inline int cwImageCleanupTask::numberOfRemovedImages() const
 {
-    return Region;
+    return NumberOfRemovedImages;
 }
 
 
@@ -20,10 +20,17 @@
 #include <QMutexLocker>
 #include <QDebug>
 #include <QSqlError>
+#include <QtConcurrentMap>
+#include <QStringList>
+#include <QHash>
+#include <QBuffer>
+#include <QImageReader>
+#include <QPainter>
 
 const QString cwImageProvider::Name = "sqlimagequery";
 const QString cwImageProvider::RequestImageSQL = "SELECT type,width,height,dotsPerMeter,imageData from Images where id=?";
 const QString cwImageProvider::RequestMetadataSQL = "SELECT type,width,height,dotsPerMeter from Images where id=?";
+const QString cwImageProvider::RequestImageBatchSQL = "SELECT id,type,width,height,dotsPerMeter,imageData from Images where id IN (%1)";
 const QByteArray cwImageProvider::Dxt1_GZ_Extension = "dxt1.gz";
 
 QAtomicInt cwImageProvider::ConnectionCounter;
@@ -40,6 +47,9 @@ cwImageProvider::cwImageProvider() :
   \brief This extracts a image from the database
 
   See Qt docs for details
+
+  If requestedSize is set, the image is decoded straight to that size. JPEG's are then decoded at a
+  fraction of their full resolution, so thumbnails of large scans don't decode every pixel.
   */
 QImage cwImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize) {
     bool okay;
@@ -52,10 +62,18 @@ QImage cwImageProvider::requestImage(const QString &id, QSize *size, const QSize
 
     //Extract the image data from the database
     QByteArray type;
-    QByteArray imageData = requestImageData(sqlId, size, &type);
+    QSize originalSize;
+    QByteArray imageData = requestImageData(sqlId, &originalSize, &type);
+
+    int maxSize = qMax(requestedSize.width(), requestedSize.height());
+
+    QSize scaledSize;
+    if(maxSize > 0 && !originalSize.isEmpty()) {
+        scaledSize = originalSize.scaled(QSize(maxSize, maxSize), Qt::KeepAspectRatio);
+    }
 
     //Read the image in
-    QImage image = QImage::fromData(imageData, type);
+    QImage image = decodeImage(cwImageData(originalSize, 0, type, imageData), QRect(), scaledSize);
 
     //Make sure the image is good
     if(image.isNull()) {
@@ -63,10 +81,9 @@ QImage cwImageProvider::requestImage(const QString &id, QSize *size, const QSize
         return QImage();
     }
 
-    int maxSize = qMax(requestedSize.width(), requestedSize.height());
-    if(maxSize > 0) {
+    if(maxSize > 0 && image.size() != scaledSize) {
 
-        //Get the size of the image, scale it and return it.
+        //The database didn't have the size, scale it after decoding
         QImage scaledImage = image.scaled(QSize(maxSize, maxSize), Qt::KeepAspectRatio, Qt::SmoothTransformation);
         *size = scaledImage.size();
 
@@ -154,6 +171,7 @@ cwImageData cwImageProvider::data(int id, bool metaDataOnly) const {
         qDebug() << "cwProjectImageProvider:: Couldn't connect to database:" << ProjectPath << database.lastError().text() << LOCATION;
         return cwImageData();
     }
+    cwSQLManager::instance()->configureConnection(database);
 
     cwSQLManager::instance()->beginTransaction(database, cwSQLManager::ReadOnly);
 
@@ -212,6 +230,117 @@ cwImageData cwImageProvider::data(int id, bool metaDataOnly) const {
     return cwImageData();
 }
 
+/**
+ * @brief cwImageProvider::data
+ * @param ids - The image ids to fetch
+ * @param decompress - If true, dxt1.gz blobs are uncompressed, otherwise the zlib'ed data is returned
+ * @return The image data for each id, in the same order as ids
+ *
+ * Unlike data(int), this only opens one connection to the database and fetches all the images with
+ * a single query. The qCompress'd blobs are uncompressed in parallel on the global thread pool. If an
+ * id isn't in the database, an empty cwImageData is returned in its place.
+ */
+QList<cwImageData> cwImageProvider::data(const QList<int> &ids, bool decompress) const
+{
+    QList<cwImageData> results;
+    if(ids.isEmpty()) {
+        return results;
+    }
+
+    //Needed to get around const correctness
+    cwImageProvider* castedConstThis = const_cast<cwImageProvider*>(this);
+    int connectionName = castedConstThis->ConnectionCounter.fetchAndAddAcquire(1);
+
+    //Define the database
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", QString("requestImageBatch/%1").arg(connectionName));
+    database.setDatabaseName(projectPath());
+
+    //Create an sql connection
+    bool connected = database.open();
+    if(!connected) {
+        qDebug() << "cwProjectImageProvider:: Couldn't connect to database:" << ProjectPath << database.lastError().text() << LOCATION;
+        return results;
+    }
+    cwSQLManager::instance()->configureConnection(database);
+
+    //One placeholder per id
+    QStringList placeholders;
+    placeholders.reserve(ids.size());
+    for(int i = 0; i < ids.size(); i++) {
+        placeholders.append("?");
+    }
+    QString batchSQL = RequestImageBatchSQL.arg(placeholders.join(","));
+
+    QHash<int, cwImageData> idToData;
+    bool successful = false;
+
+    {
+        cwSQLManager::Transaction transaction(&database, cwSQLManager::ReadOnly);
+
+        QSqlQuery query(database);
+        if(!query.prepare(batchSQL)) {
+            qDebug() << "cwProjectImageProvider:: Couldn't prepare query " << batchSQL << query.lastError().text() << LOCATION;
+        } else {
+            for(int i = 0; i < ids.size(); i++) {
+                query.bindValue(i, ids.at(i));
+            }
+
+            if(!query.exec()) {
+                qDebug() << "Couldn't exec batch image query:" << query.lastError().text() << LOCATION;
+            } else {
+                while(query.next()) {
+                    int id = query.value(0).toInt();
+                    QByteArray type = query.value(1).toByteArray();
+                    QSize size = QSize(query.value(2).toInt(), query.value(3).toInt());
+                    int dotsPerMeter = query.value(4).toInt();
+                    QByteArray imageData = query.value(5).toByteArray();
+                    idToData.insert(id, cwImageData(size, dotsPerMeter, type, imageData));
+                }
+                successful = true;
+            }
+        }
+    }
+
+    //The query and transaction are finished, so the connection is always closed
+    database.close();
+
+    if(!successful) {
+        return results;
+    }
+
+    results.reserve(ids.size());
+    foreach(int id, ids) {
+        if(!idToData.contains(id)) {
+            qDebug() << "Query has no data for id:" << id << LOCATION;
+        }
+        results.append(idToData.value(id));
+    }
+
+    if(decompress) {
+        //Remove the zlib compression from the images in parallel
+        results = QtConcurrent::blockingMapped(results, &cwImageProvider::uncompressData);
+    }
+
+    return results;
+}
+
+/**
+ * @brief cwImageProvider::uncompressData
+ * @param imageData - The image data that may be zlib compressed
+ * @return Returns imageData without zlib compression. If imageData isn't dxt1.gz, imageData is
+ * returned unmodified
+ */
+cwImageData cwImageProvider::uncompressData(const cwImageData &imageData)
+{
+    if(imageData.format() == cwImageProvider::Dxt1_GZ_Extension) {
+        return cwImageData(imageData.size(),
+                           imageData.dotsPerMeter(),
+                           imageData.format(),
+                           qUncompress(imageData.data()));
+    }
+    return imageData;
+}
+
 /**
   \brief Gets a QImage from the image provider.  If the image at id is null, then
   this will return a empty image
@@ -225,6 +354,92 @@ QImage cwImageProvider::image(int id) const
     return QImage();
 }
 
+/**
+ * @brief cwImageProvider::image
+ * @param id - The id of the image
+ * @param clipRect - The part of the image, in pixels, that's decoded
+ * @param scaledSize - The size the clipped image is decoded to, invalid for no scaling
+ * @return Only the clipRect of the image at id, see decodeImage()
+ */
+QImage cwImageProvider::image(int id, const QRect &clipRect, const QSize &scaledSize) const
+{
+    return decodeImage(data(id), clipRect, scaledSize);
+}
+
+/**
+ * @brief cwImageProvider::decodeImage
+ * @param imageData - The encoded image, with the size that's stored in the database
+ * @param clipRect - The part of the image, in pixels, that's decoded. Invalid decodes everything
+ * @param scaledSize - The size of the decoded image, this is applied after clipping
+ * @return The decoded image, or a null image if imageData can't be decoded
+ *
+ * This decodes with a QImageReader, instead of decoding the whole image and then copying and
+ * scaling it. The JPEG reader stops at the bottom of clipRect and scales in the DCT, so a crop of
+ * a large scan only allocates the crop and a thumbnail only decodes a fraction of the pixels.
+ * Readers without clip or scale support decode the whole image and clip it themselves.
+ *
+ * Like QImage::copy(), the result is always the size of clipRect. The parts of clipRect that are
+ * outside of the image are filled with 0.
+ */
+QImage cwImageProvider::decodeImage(const cwImageData &imageData, const QRect &clipRect, const QSize &scaledSize)
+{
+    if(imageData.format() == cwImageProvider::Dxt1_GZ_Extension) {
+        return QImage();
+    }
+
+    QByteArray data = imageData.data();
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer, imageData.format());
+
+    //The readers fail if the clip goes outside of the image, so only the inside is decoded
+    QRect clip = clipRect;
+    if(clipRect.isValid() && !imageData.size().isEmpty()) {
+        clip = clipRect.intersected(QRect(QPoint(0, 0), imageData.size()));
+    }
+    bool needsPadding = clipRect.isValid() && clip != clipRect;
+
+    if(clipRect.isValid() && !clip.isEmpty()) {
+        reader.setClipRect(clip);
+    }
+
+    //Padded images are scaled after padding, so the padding is scaled too
+    if(scaledSize.isValid() && !needsPadding) {
+        reader.setScaledSize(scaledSize);
+    }
+
+    QImage image;
+    if(!clipRect.isValid() || !clip.isEmpty()) {
+        image = reader.read();
+        if(image.isNull()) {
+            qDebug() << "Couldn't decode image:" << reader.errorString() << LOCATION;
+            return image;
+        }
+    }
+
+    if(needsPadding) {
+        //QPainter can't draw into indexed images
+        QImage::Format format = image.isNull() || image.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32;
+        QImage padded(clipRect.size(), format);
+        padded.fill(0);
+
+        if(!image.isNull()) {
+            QPainter painter(&padded);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(clip.topLeft() - clipRect.topLeft(), image);
+        }
+
+        image = padded;
+
+        if(scaledSize.isValid()) {
+            image = image.scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+
+    return image;
+}
+
 /**
  * @brief cwProjectImageProvider::scaleTexCoords
  * @param id
@@ -14,6 +14,7 @@
 #include <QMutex>
 #include <QDebug>
 #include <QVector2D>
+#include <QRect>
 
 //Our includes
 #include "cwImage.h"
@@ -34,9 +35,13 @@ public:
 
     cwImageData originalMetadata(const cwImage& image) const;
     cwImageData data(int id, bool metaDataOnly = false) const;
+    QList<cwImageData> data(const QList<int>& ids, bool decompress = true) const;
     QImage image(int id) const;
+    QImage image(int id, const QRect& clipRect, const QSize& scaledSize = QSize()) const;
     QVector2D scaleTexCoords(const cwImage &image) const;
 
+    static QImage decodeImage(const cwImageData& imageData, const QRect& clipRect = QRect(), const QSize& scaledSize = QSize());
+
 public slots:
     void setProjectPath(QString projectPath);
 
@@ -44,12 +49,15 @@ public slots:
 private:
     static const QString RequestImageSQL;
     static const QString RequestMetadataSQL;
+    static const QString RequestImageBatchSQL;
     QString ProjectPath;
     QMutex ProjectPathMutex;
 
     static QAtomicInt ConnectionCounter;
 
     QString projectPath() const;
+
+    static cwImageData uncompressData(const cwImageData& imageData);
 };
 
 #endif // CWPROJECTIMAGEPROVIDER_H
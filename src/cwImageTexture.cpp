@@ -9,6 +9,7 @@
 #include "cwImageTexture.h"
 #include "cwImageProvider.h"
 #include "cwTextureUploadTask.h"
+#include "cwTexturePrefetchTask.h"
 #include "cwDebug.h"
 
 //QT includes
@@ -29,10 +30,7 @@ cwImageTexture::cwImageTexture(QObject *parent) :
     TextureId(0),
     TextureUploadTask(nullptr)
 {
-    if(TextureLoadingThread == nullptr) {
-        TextureLoadingThread = new QThread();
-        TextureLoadingThread->start(QThread::LowPriority);
-    }
+    textureLoadingThread();
 }
 
 /**
@@ -192,7 +190,7 @@ void cwImageTexture::startLoadingImage()
 
         if(TextureUploadTask == nullptr) {
             TextureUploadTask = new cwTextureUploadTask();
-            TextureUploadTask->setThread(TextureLoadingThread);
+            TextureUploadTask->setThread(textureLoadingThread());
 
             connect(TextureUploadTask, &cwTextureUploadTask::finished, this, &cwImageTexture::markAsDirty);
             connect(TextureUploadTask, &cwTextureUploadTask::finished, this, &cwImageTexture::textureUploaded);
@@ -211,6 +209,45 @@ void cwImageTexture::startLoadingImage()
     }
 }
 
+/**
+ * @brief cwImageTexture::prefetch
+ * @param project - The project filename that the images are stored in
+ * @param images - The images to prefetch, highest priority first
+ *
+ * Queues a bulk load of all the images' mipmaps on the texture loading thread. Because
+ * the prefetch is queued before the textures start loading, the cwTextureUploadTask's
+ * will find their mipmaps in the cache instead of querying the database one level at a time.
+ */
+void cwImageTexture::prefetch(QString project, QList<cwImage> images)
+{
+    if(project.isEmpty() || images.isEmpty()) { return; }
+
+    cwTexturePrefetchTask* prefetchTask = new cwTexturePrefetchTask();
+    prefetchTask->setThread(textureLoadingThread());
+    prefetchTask->setProjectFilename(project);
+    prefetchTask->setImages(images);
+
+    connect(prefetchTask, &cwTexturePrefetchTask::finished, prefetchTask, &cwTexturePrefetchTask::deleteLater);
+    connect(prefetchTask, &cwTexturePrefetchTask::stopped, prefetchTask, &cwTexturePrefetchTask::deleteLater);
+
+    prefetchTask->start();
+}
+
+/**
+ * @brief cwImageTexture::textureLoadingThread
+ * @return The thread that all textures are loaded on
+ *
+ * This is one of cwTaskScheduler's background threads. All textures share the same thread, so
+ * prefetch() runs before the uploads that were queued after it.
+ */
+QThread *cwImageTexture::textureLoadingThread()
+{
+    if(TextureLoadingThread == nullptr) {
+        TextureLoadingThread = cwTaskScheduler::instance()->acquireThread(cwTaskScheduler::Background);
+    }
+    return TextureLoadingThread;
+}
+
 /**
  * @brief cwImageTexture::reinitilizeLoadNoteWatcher
  */
@@ -47,6 +47,8 @@ public:
 
     bool isDirty() const;
 
+    static void prefetch(QString project, QList<cwImage> images);
+
 signals:
     void projectChanged();
     void imageChanged();
@@ -67,6 +69,8 @@ private:
     static QThread* TextureLoadingThread;
     cwTextureUploadTask* TextureUploadTask;
 
+    static QThread* textureLoadingThread();
+
     void deleteLoadNoteTask();
     void deleteGLTexture();
 
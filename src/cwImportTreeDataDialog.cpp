@@ -41,6 +41,7 @@ cwImportTreeDataDialog::cwImportTreeDataDialog(Names names, cwTreeDataImporter*
     setupTypeComboBox();
 
     //Move the importer to another thread
+    ImportThread->setObjectName("ImportThread");
     Importer->setThread(ImportThread);
 
     //Connect the importer up
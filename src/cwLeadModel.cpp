@@ -545,6 +545,7 @@ void cwLeadModel::setRegionTreeModel(cwRegionTreeModel* regionModel) {
         if(!RegionTreeModel.isNull()) {
             connect(RegionTreeModel.data(), &cwRegionTreeModel::rowsInserted, this, &cwLeadModel::insertScraps);
             connect(RegionTreeModel.data(), &cwRegionTreeModel::rowsAboutToBeRemoved, this, &cwLeadModel::removeScraps);
+            connect(RegionTreeModel.data(), &cwRegionTreeModel::modelReset, this, &cwLeadModel::fullModelReset);
         }
 
         fullModelReset();
@@ -9,6 +9,10 @@
 #include "cwLeadView.h"
 #include "cwRegionTreeModel.h"
 #include "cwCavingRegion.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyNoteModel.h"
+#include "cwNote.h"
 #include "cwScrapLeadView.h"
 #include "cwTransformUpdater.h"
 #include "cwSelectionManager.h"
@@ -43,22 +47,31 @@ cwRegionTreeModel* cwLeadView::regionModel() const {
 * @brief cwLeadView::setRegionModel
 * @param regionModel
 *
-* Sets the region model that is used to listen to scraps being added or removed
+* Sets the region model that is used to listen to scraps being added or removed. When a
+* project is loaded, the model is reset and all the lead views are recreated.
 */
 void cwLeadView::setRegionModel(cwRegionTreeModel* regionModel) {
     if(RegionModel != regionModel) {
         if(!RegionModel.isNull()) {
             disconnect(RegionModel.data(), &cwRegionTreeModel::rowsInserted, this, &cwLeadView::scrapsAdded);
             disconnect(RegionModel.data(), &cwRegionTreeModel::rowsAboutToBeRemoved, this, &cwLeadView::scrapsRemoved);
+            disconnect(RegionModel.data(), &cwRegionTreeModel::modelAboutToBeReset, this, &cwLeadView::removeAllScraps);
+            disconnect(RegionModel.data(), &cwRegionTreeModel::modelReset, this, &cwLeadView::addAllScraps);
         }
 
+        removeAllScraps();
+
         RegionModel = regionModel;
 
         if(!RegionModel.isNull()) {
             connect(RegionModel.data(), &cwRegionTreeModel::rowsInserted, this, &cwLeadView::scrapsAdded);
             connect(RegionModel.data(), &cwRegionTreeModel::rowsAboutToBeRemoved, this, &cwLeadView::scrapsRemoved);
+            connect(RegionModel.data(), &cwRegionTreeModel::modelAboutToBeReset, this, &cwLeadView::removeAllScraps);
+            connect(RegionModel.data(), &cwRegionTreeModel::modelReset, this, &cwLeadView::addAllScraps);
         }
 
+        addAllScraps();
+
         emit regionModelChanged();
     }
 }
@@ -94,7 +107,9 @@ void cwLeadView::removeScrap(cwScrap *scrap)
     Q_ASSERT(scrap != nullptr);
     Q_ASSERT(ScrapToView.contains(scrap));
 
-    cwScrapLeadView* view = ScrapToView.value(scrap);
+    //Stop listening to the scrap right away, it may be deleted before the view
+    cwScrapLeadView* view = ScrapToView.take(scrap);
+    view->setScrap(nullptr);
     view->deleteLater();
 }
 
@@ -142,6 +157,39 @@ void cwLeadView::scrapsRemoved(QModelIndex parent, int begin, int end)
     }
 }
 
+/**
+ * @brief cwLeadView::addAllScraps
+ *
+ * Adds a lead view for every scrap in the region. This is called once the model has been reset,
+ * for example, when a project is loaded.
+ */
+void cwLeadView::addAllScraps()
+{
+    if(RegionModel.isNull() || RegionModel->cavingRegion() == nullptr) { return; }
+
+    foreach(cwCave* cave, RegionModel->cavingRegion()->caves()) {
+        foreach(cwTrip* trip, cave->trips()) {
+            foreach(cwNote* note, trip->notes()->notes()) {
+                foreach(cwScrap* scrap, note->scraps()) {
+                    addScrap(scrap);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief cwLeadView::removeAllScraps
+ *
+ * Removes all the lead views. This is called before the model is reset, while the old scraps
+ * still exist.
+ */
+void cwLeadView::removeAllScraps()
+{
+    foreach(cwScrap* scrap, ScrapToView.keys()) {
+        removeScrap(scrap);
+    }
+}
 
 /**
 * @brief cwLeadView::camera
@@ -66,6 +66,8 @@ private:
 private slots:
     void scrapsAdded(QModelIndex parent, int begin, int end);
     void scrapsRemoved(QModelIndex parent, int begin, int end);
+    void addAllScraps();
+    void removeAllScraps();
 
 };
 
@@ -16,9 +16,6 @@
 #include "cwDebug.h"
 #include "cwLength.h"
 
-//Std includes
-#include <limits>
-
 //Qt includes
 #include <QLineF>
 
@@ -39,14 +36,27 @@ void cwLinePlotGeometryTask::runTask() {
     PointData.clear();
     IndexData.clear();
     StationIndexLookup.clear();
-    CavesLengthAndDepths.resize(Region->caveCount());
+
+    QVector<CaveGeometry> caveGeometries;
+    caveGeometries.reserve(Region->caveCount());
 
     for(int caveIndex = 0; caveIndex < Region->caveCount(); caveIndex++) {
+        int firstPoint = PointData.size();
+        int firstIndex = IndexData.size();
+
         addStationPositions(caveIndex);
         addShotLines(caveIndex);
 
+        CaveGeometry geometry = caveGeometry(firstPoint, firstIndex);
+        if(caveIndex < CaveGeometries.size() && CaveGeometries.at(caveIndex) == geometry) {
+            //Hasn't changed, share the previous data so it isn't uploaded again
+            geometry = CaveGeometries.at(caveIndex);
+        }
+        caveGeometries.append(geometry);
     }
 
+    CaveGeometries = caveGeometries;
+
     PointData.squeeze();
     IndexData.squeeze();
 
@@ -89,10 +99,6 @@ void cwLinePlotGeometryTask::addShotLines(int caveIndex) {
 
     cwCave* cave = Region->cave(caveIndex);
 
-    double minDepth = std::numeric_limits<double>::max();
-    double maxDepth = -std::numeric_limits<double>::max();
-    double length = 0.0; //Cave's length
-
     //Go through all the trips in the cave
     for(int tripIndex = 0; tripIndex < cave->tripCount(); tripIndex++) {
         cwTrip* trip = cave->trip(tripIndex);
@@ -100,39 +106,22 @@ void cwLinePlotGeometryTask::addShotLines(int caveIndex) {
         //Go through all the chunks in the trip
         foreach(cwSurveyChunk* chunk, trip->chunks()) {
 
-            if(chunk->stationCount() < 2) { continue; }
-
-            cwStation firstStation = chunk->station(0);
+            const cwSurveyChunkColumns& columns = chunk->columns();
+            if(columns.stationCount() < 2) { continue; }
 
-            QString fullName = fullStationName(caveIndex, cave->name(), firstStation.name());
+            QString fullName = fullStationName(caveIndex, cave->name(), columns.name(0));
             if(!StationIndexLookup.contains(fullName)) {
                 qDebug() << "Warning! Couldn't find station position index (will result in rendering artifacts): " << fullName << LOCATION;
             }
 
             unsigned int previousStationIndex = StationIndexLookup.value(fullName, 0);
 
-            QVector3D previousPoint = PointData.at(previousStationIndex);
-            minDepth = qMin(minDepth, (double)previousPoint.z());
-            maxDepth = qMax(maxDepth, (double)previousPoint.z());
-
             //Go through all the the stations/shots in the chunk
-            for(int stationIndex = 1; stationIndex < chunk->stationCount(); stationIndex++) {
-                cwStation station = chunk->station(stationIndex);
-                cwShot shot = chunk->shot(stationIndex - 1);
-
+            for(int stationIndex = 1; stationIndex < columns.stationCount(); stationIndex++) {
                 //Look up the index
-                fullName = fullStationName(caveIndex, cave->name(), station.name());
+                fullName = fullStationName(caveIndex, cave->name(), columns.name(stationIndex));
                 if(StationIndexLookup.contains(fullName)) {
-                    unsigned int stationIndex = StationIndexLookup.value(fullStationName(caveIndex, cave->name(), station.name()), 0);
-
-                    //Depth and length calculation
-                    QVector3D currentPoint = PointData.at(stationIndex);
-                    if(shot.isDistanceIncluded()) {
-                        minDepth = qMin(minDepth, (double)currentPoint.z());
-                        maxDepth = qMax(maxDepth, (double)currentPoint.z());
-                        length += QVector3D(currentPoint - previousPoint).length();
-                    }
-                    previousPoint = currentPoint;
+                    unsigned int stationIndex = StationIndexLookup.value(fullName, 0);
 
                     IndexData.append(previousStationIndex);
                     IndexData.append(stationIndex);
@@ -142,11 +131,30 @@ void cwLinePlotGeometryTask::addShotLines(int caveIndex) {
             }
         }
     }
-
-    //Update the length and depth information for the cave
-    double depth = maxDepth - minDepth;
-    CavesLengthAndDepths[caveIndex] = LengthAndDepth(length, depth);
 }
 
+/**
+  \brief Helper to runTask
 
+  Copies the cave's points and lines, that were added by addStationPositions() and
+  addShotLines(), out of PointData and IndexData. The indexes are made relative to the cave's
+  first point. Lines to stations that aren't in the cave are skipped.
+  */
+cwLinePlotGeometryTask::CaveGeometry cwLinePlotGeometryTask::caveGeometry(int firstPoint, int firstIndex) const {
+    QVector<QVector3D> points = PointData.mid(firstPoint);
+
+    QVector<unsigned int> indexes;
+    indexes.reserve(IndexData.size() - firstIndex);
+    for(int i = firstIndex; i + 1 < IndexData.size(); i += 2) {
+        unsigned int first = IndexData.at(i);
+        unsigned int second = IndexData.at(i + 1);
+        if(first < (unsigned int)firstPoint || second < (unsigned int)firstPoint) {
+            continue;
+        }
+
+        indexes.append(first - firstPoint);
+        indexes.append(second - firstPoint);
+    }
 
+    return CaveGeometry(points, indexes);
+}
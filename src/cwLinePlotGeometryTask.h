@@ -30,17 +30,32 @@ class cwLinePlotGeometryTask : public cwTask
 
 public:
 
-    class LengthAndDepth {
+    /**
+     * The line plot of one cave. The indexes are into the cave's points, so each cave can be
+     * uploaded to the graphics card on its own.
+     */
+    class CaveGeometry {
     public:
-        LengthAndDepth() : Depth(-1), Length(-1) { }
-        LengthAndDepth(double length, double depth) : Depth(depth), Length(length) {}
+        CaveGeometry() { }
+        CaveGeometry(QVector<QVector3D> points, QVector<unsigned int> indexes) :
+            Points(points),
+            Indexes(indexes)
+        { }
 
-        double length() const { return Length; }
-        double depth() const { return Depth; }
+        QVector<QVector3D> points() const { return Points; }
+        QVector<unsigned int> indexes() const { return Indexes; }
+
+        bool operator==(const CaveGeometry& other) const {
+            return Points == other.Points && Indexes == other.Indexes;
+        }
+
+        bool operator!=(const CaveGeometry& other) const {
+            return !operator==(other);
+        }
 
     private:
-        double Depth;
-        double Length;
+        QVector<QVector3D> Points;
+        QVector<unsigned int> Indexes;
     };
 
     explicit cwLinePlotGeometryTask(QObject *parent = 0);
@@ -51,7 +66,7 @@ public:
     //Outputs
     QVector<QVector3D> pointData() const;
     QVector<unsigned int> indexData() const;
-    QVector<LengthAndDepth> cavesLengthAndDepths() const;
+    QVector<CaveGeometry> caveGeometries() const;
 
 protected:
     void runTask();
@@ -67,13 +82,14 @@ private:
     //Outputs
     QVector<QVector3D> PointData;
     QVector<unsigned int> IndexData;
-    QVector<LengthAndDepth> CavesLengthAndDepths;
+    QVector<CaveGeometry> CaveGeometries; //Also the previous run's geometry, while running
 
     //Lookup to look up the station and get it's index
     QMap< QString, unsigned int > StationIndexLookup;
 
     void addStationPositions(int caveIndex);
     void addShotLines(int caveIndex);
+    CaveGeometry caveGeometry(int firstPoint, int firstIndex) const;
 
     QString fullStationName(int caveIndex, QString caveName, QString stationName) const;
 };
@@ -104,12 +120,15 @@ inline QVector<unsigned int> cwLinePlotGeometryTask::indexData() const {
 }
 
 /**
- * @brief cwLinePlotGeometryTask::cavesLengthAndDepths
- * @return Get all the cave's lengths and depths
+ * @brief cwLinePlotGeometryTask::caveGeometries
+ * @return The line plot split up by cave, in the same order as the region's caves
+ *
+ * Caves that haven't changed since the previous run share their data with the previous
+ * run's geometry, so comparing them is cheap.
  */
-inline QVector<cwLinePlotGeometryTask::LengthAndDepth> cwLinePlotGeometryTask::cavesLengthAndDepths() const
+inline QVector<cwLinePlotGeometryTask::CaveGeometry> cwLinePlotGeometryTask::caveGeometries() const
 {
-    return CavesLengthAndDepths;
+    return CaveGeometries;
 }
 
 /**
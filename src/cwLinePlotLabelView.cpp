@@ -25,6 +25,8 @@ void cwLinePlotLabelView::setRegion(cwCavingRegion* region) {
         if(Region != nullptr) {
             disconnect(Region, &cwCavingRegion::insertedCaves, this, &cwLinePlotLabelView::addCaves);
             disconnect(Region, &cwCavingRegion::beginRemoveCaves, this, &cwLinePlotLabelView::removeCaves);
+            disconnect(Region, &cwCavingRegion::modelAboutToBeReset, this, &cwLinePlotLabelView::removeAllCaves);
+            disconnect(Region, &cwCavingRegion::modelReset, this, &cwLinePlotLabelView::addAllCaves);
         }
 
         Region = region;
@@ -33,6 +35,8 @@ void cwLinePlotLabelView::setRegion(cwCavingRegion* region) {
         if(Region != nullptr) {
             connect(Region, &cwCavingRegion::insertedCaves, this, &cwLinePlotLabelView::addCaves);
             connect(Region, &cwCavingRegion::beginRemoveCaves, this, &cwLinePlotLabelView::removeCaves);
+            connect(Region, &cwCavingRegion::modelAboutToBeReset, this, &cwLinePlotLabelView::removeAllCaves);
+            connect(Region, &cwCavingRegion::modelReset, this, &cwLinePlotLabelView::addAllCaves);
 
             if(Region->hasCaves()) {
                 //Add all the caves
@@ -82,6 +86,31 @@ void cwLinePlotLabelView::removeCaves(int begin, int end)
     }
 }
 
+/**
+ * @brief cwLinePlotLabelView::addAllCaves
+ *
+ * Called when the region's caves have been replaced
+ */
+void cwLinePlotLabelView::addAllCaves()
+{
+    if(Region->hasCaves()) {
+        addCaves(0, Region->caveCount() - 1);
+    }
+}
+
+/**
+ * @brief cwLinePlotLabelView::removeAllCaves
+ *
+ * Called before the region's caves are replaced
+ */
+void cwLinePlotLabelView::removeAllCaves()
+{
+    foreach(cwCave* cave, Region->caves()) {
+        disconnectCave(cave);
+    }
+    clear();
+}
+
 /**
  * @brief cwLinePlotLabelView::updateStations
  */
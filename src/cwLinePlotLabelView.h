@@ -48,6 +48,8 @@ public slots:
 private slots:
     void addCaves(int begin, int end);
     void removeCaves(int begion, int end);
+    void addAllCaves();
+    void removeAllCaves();
     void updateStations();
 
 
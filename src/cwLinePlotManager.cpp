@@ -18,7 +18,6 @@
 #include "cwSurveyNoteModel.h"
 #include "cwScrap.h"
 #include "cwDebug.h"
-#include "cwLength.h"
 #include "cwSurveyChunkSignaler.h"
 #include "cwErrorModel.h"
 #include "cwErrorListModel.h"
@@ -47,21 +46,18 @@ cwLinePlotManager::cwLinePlotManager(QObject *parent) :
     SurveySignaler->addConnectionToChunks(SIGNAL(stationsRemoved(int,int)), this, SLOT(runSurvex()));
     SurveySignaler->addConnectionToChunks(SIGNAL(dataChanged(cwSurveyChunk::DataRole,int)), this, SLOT(runSurvex()));
 
-    LinePlotThread = new QThread(this);
-    LinePlotThread->start();
+    //Batches all the edits together, so the line plot task isn't restarted for every edit
+    ChangeJournal = new cwChangeJournal(this);
+    connect(ChangeJournal, SIGNAL(changed()), SLOT(runLinePlotTask()));
 
     LinePlotTask = new cwLinePlotTask();
-    LinePlotTask->setThread(LinePlotThread);
-    connect(LinePlotTask, SIGNAL(shouldRerun()), SLOT(runSurvex())); //So the task is rerun
+    LinePlotTask->setThread(cwTaskScheduler::Interactive);
+    connect(LinePlotTask, SIGNAL(shouldRerun()), SLOT(runLinePlotTask())); //So the task is rerun
     connect(LinePlotTask, SIGNAL(finished()), SLOT(updateLinePlot()));
 }
 
 cwLinePlotManager::~cwLinePlotManager() {
-    LinePlotTask->stop();
-
-    QMetaObject::invokeMethod(LinePlotThread, "quit");
-    LinePlotThread->wait();
-
+    LinePlotTask->stopAndWait();
     delete LinePlotTask;
 }
 
@@ -75,6 +71,7 @@ void cwLinePlotManager::setRegion(cwCavingRegion* region) {
     //Connect all signal from the region
     connect(Region, SIGNAL(insertedCaves(int,int)), SLOT(runSurvex()));
     connect(Region, SIGNAL(removedCaves(int,int)), SLOT(runSurvex()));
+    connect(Region, SIGNAL(modelReset()), SLOT(runSurvex()));
 
     SurveySignaler->setRegion(Region);
 
@@ -97,6 +94,7 @@ void cwLinePlotManager::setGLLinePlot(cwGLLinePlot* linePlot) {
  */
 void cwLinePlotManager::waitToFinish()
 {
+    ChangeJournal->flush();
     LinePlotTask->waitToFinish();
 }
 
@@ -212,9 +210,22 @@ void cwLinePlotManager::clearUnconnectedChunkErrors()
 
 
 /**
-  \brief Run the line plot task
+  \brief Records that the survey data has changed
+
+  The line plot task is run by runLinePlotTask(), once the change journal's latency has passed
   */
 void cwLinePlotManager::runSurvex() {
+    if(Region != nullptr) {
+        ChangeJournal->markChanged();
+    }
+}
+
+/**
+  \brief Run the line plot task
+
+  If the task is already running, it's restarted, because the region has changed since it started
+  */
+void cwLinePlotManager::runLinePlotTask() {
     if(Region != nullptr) {
         if(LinePlotTask->isReady()) {
 //            qDebug() << "Running the task";
@@ -245,8 +256,8 @@ void cwLinePlotManager::updateLinePlot() {
     //Validate all the objects in resultData, remove any that were delete before the task was over
     validateResultsData(resultData); //Modifies resultData inplace
 
-    //Update all the positions for all the caves that need to be updated
-    //Also update the length and depth information
+    //Update all the positions for all the caves that need to be updated. The cave's length and
+    //depth are kept up to date by its cwCaveStatistics
     QMapIterator<cwCave*, cwLinePlotTask::LinePlotCaveData> iter(resultData.caveData());
     while(iter.hasNext()) {
         iter.next();
@@ -258,21 +269,11 @@ void cwLinePlotManager::updateLinePlot() {
         if(caveData.hasStationPositionsChanged()) {
             cave->setStationPositionLookup(caveData.stationPositions());
         }
-
-        if(caveData.hasDepthLengthChanged()) {
-            //Update the cave's depth and length
-            double length = cwUnits::convert(caveData.length(), cwUnits::Meters, (cwUnits::LengthUnit)cave->length()->unit());
-            double depth = cwUnits::convert(caveData.depth(), cwUnits::Meters, (cwUnits::LengthUnit)cave->depth()->unit());
-
-            cave->length()->setValue(length);
-            cave->depth()->setValue(depth);
-        }
     }
 
     //Update the 3D plot
     if(GLLinePlot != nullptr) {
-        GLLinePlot->setPoints(resultData.stationPositions());
-        GLLinePlot->setIndexes(resultData.linePlotIndexData());
+        GLLinePlot->setCaveGeometries(resultData.caveGeometries());
     }
 
     //Mark all caves as up todate
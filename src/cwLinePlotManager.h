@@ -20,6 +20,7 @@ class cwGLLinePlot;
 class cwSurveyChunkSignaler;
 class cwErrorListModel;
 #include "cwLinePlotTask.h"
+#include "cwChangeJournal.h"
 #include "cwGlobals.h"
 
 //Qt includes
@@ -39,6 +40,8 @@ public:
 
     void waitToFinish();
 
+    cwChangeJournal* changeJournal() const;
+
 signals:
     void stationPositionInCavesChanged(QList<cwCave*>);
     void stationPositionInTripsChanged(QList<cwTrip*>);
@@ -51,7 +54,7 @@ private:
     QList<QPointer<cwErrorListModel>> UnconnectedChunks; //Current unconnected chunks
 
     cwLinePlotTask* LinePlotTask;
-    QThread* LinePlotThread;
+    cwChangeJournal* ChangeJournal; //!< Batches edits before the line plot task is run
 
     cwGLLinePlot* GLLinePlot;
 
@@ -67,8 +70,17 @@ private:
 
 private slots:
     void runSurvex();
+    void runLinePlotTask();
 
     void updateLinePlot();
 };
 
+/**
+ * @brief cwLinePlotManager::changeJournal
+ * @return The journal that batches edits. Use this to set the latency or read the coalesced counts
+ */
+inline cwChangeJournal* cwLinePlotManager::changeJournal() const {
+    return ChangeJournal;
+}
+
 #endif // CWLINEPLOTMANAGER_H
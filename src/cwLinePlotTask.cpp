@@ -26,20 +26,12 @@
 
 //Qt includes
 #include <QDebug>
-#include <QTime>
 #include <QThread>
 
 //Std includes
 #include <math.h>
 
-/**
- * @brief cwLinePlotTask::LinePlotCaveData::setDepth
- * @param depth - This is the cave depth calculated by the task
- */
 cwLinePlotTask::LinePlotCaveData::LinePlotCaveData() :
-    DepthLengthChanged(false),
-    Depth(0.0),
-    Length(0.0),
     StationPostionsChanged(false)
 {
 }
@@ -154,7 +146,6 @@ void cwLinePlotTask::runTask() {
         //Initilize the cave station lookup, from previous run
         initializeCaveStationLookups();
 
-        Time.start();
         exportData();
 
     } catch(QString) {
@@ -246,13 +237,8 @@ void cwLinePlotTask::generateCenterlineGeometry() {
 void cwLinePlotTask::linePlotTaskComplete() {
 
     //Copy all the from the CenterLineGemoetryTask into the results
-    Result.StationPositions = CenterlineGeometryTask->pointData();
-    Result.LinePlotIndexData = CenterlineGeometryTask->indexData();
+    Result.CaveGeometries = CenterlineGeometryTask->caveGeometries();
 
-    //Update the depth and length of the cave
-    updateDepthLength();
-
-//    qDebug() << "Finished running linePlotTask:" << Time.elapsed() << "ms";
     done();
 }
 
@@ -275,25 +261,6 @@ void cwLinePlotTask::updateStationPositionForCaves(const cwStationPositionLookup
     updateExteralCaveStationLookups();
 }
 
-/**
- * @brief cwLinePlotTask::updateDepthLength
- */
-void cwLinePlotTask::updateDepthLength()
-{
-    QVector<cwLinePlotGeometryTask::LengthAndDepth> caveLengthAndDepth = CenterlineGeometryTask->cavesLengthAndDepths();
-    Q_ASSERT(Region->caveCount() == caveLengthAndDepth.size());
-
-    //Update all cave station position models
-    for(int i = 0; i < Region->caveCount(); i++) {
-        //Get the region's caves
-        cwLinePlotGeometryTask::LengthAndDepth lengthAndDepth = caveLengthAndDepth.at(i);
-
-        LinePlotCaveData& caveData = createLinePlotCaveDataAt(i);
-        caveData.setLength(lengthAndDepth.length());
-        caveData.setDepth(lengthAndDepth.depth());
-    }
-}
-
 /**
  * @brief cwLinePlotTask::checkForErrors
  */
@@ -646,8 +613,7 @@ void cwLinePlotTask::LinePlotResultData::clear()
     Caves.clear();
     Trips.clear();
     Scraps.clear();
-    StationPositions.clear();
-    LinePlotIndexData.clear();
+    CaveGeometries.clear();
 }
 
 /**
@@ -661,9 +627,10 @@ cwLinePlotTask::StationTripScrapLookup::StationTripScrapLookup(cwCave *cave)
     for(int tripIndex = 0; tripIndex < cave->tripCount(); tripIndex++) {
         cwTrip* trip = cave->trip(tripIndex);
         foreach(cwSurveyChunk* surveyChunk, trip->chunks()) {
-            foreach(cwStation station, surveyChunk->stations()) {
+            const cwSurveyChunkColumns& columns = surveyChunk->columns();
+            for(int i = 0; i < columns.stationCount(); i++) {
                 //Add trip to the multi hash
-                MapStationToTrip.insertMulti(station.name(), tripIndex);
+                MapStationToTrip.insertMulti(columns.name(i), tripIndex);
             }
         }
 
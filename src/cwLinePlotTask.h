@@ -11,7 +11,7 @@
 //Our includes
 #include "cwTask.h"
 class cwCavingRegion;
-class cwLinePlotGeometryTask;
+#include "cwLinePlotGeometryTask.h"
 #include "cwStationPositionLookup.h"
 #include "cwFindUnconnectedSurveyChunksTask.h"
 class cwSurvexExporterRegionTask;
@@ -26,7 +26,6 @@ class cwCave;
 //Qt includes
 #include <QTemporaryFile>
 #include <QVector3D>
-#include <QTime>
 #include <QVector>
 #include <QSet>
 
@@ -39,23 +38,15 @@ public:
     public:
         LinePlotCaveData();
 
-        void setDepth(double depth);
-        void setLength(double length);
         void setStationPositions(cwStationPositionLookup positionLookup);
         void setUnconnectedChunkError(QList<cwFindUnconnectedSurveyChunksTask::Result> results);
 
-        double depth() const;
-        double length() const;
         cwStationPositionLookup stationPositions() const;
         QList<cwFindUnconnectedSurveyChunksTask::Result> unconnectedChunkError() const;
 
-        bool hasDepthLengthChanged() const;
         bool hasStationPositionsChanged() const;
 
     private:
-        bool DepthLengthChanged;
-        double Depth;
-        double Length;
         QList<cwFindUnconnectedSurveyChunksTask::Result> UnconnectedChunksErrors;
 
         bool StationPostionsChanged;
@@ -80,21 +71,18 @@ public:
         void setCaveData(QMap<cwCave*, LinePlotCaveData> caveData);
         void setTrip(QSet<cwTrip*> trips);
         void setScraps(QSet<cwScrap*> scraps);
-        void setPositions(QVector<QVector3D> positions);
-        void setPlotIndexData(QVector<unsigned int> indexData);      
+        void setCaveGeometries(QVector<cwLinePlotGeometryTask::CaveGeometry> caveGeometries);
 
         QMap<cwCave*, LinePlotCaveData> caveData() const;
         QSet<cwTrip*> trips() const;
         QSet<cwScrap*> scraps() const;
-        QVector<QVector3D> stationPositions() const;
-        QVector<unsigned int> linePlotIndexData() const;
+        QVector<cwLinePlotGeometryTask::CaveGeometry> caveGeometries() const;
 
     private:
         QMap<cwCave*, LinePlotCaveData> Caves;
         QSet<cwTrip*> Trips;
         QSet<cwScrap*> Scraps;
-        QVector<QVector3D> StationPositions;
-        QVector<unsigned int> LinePlotIndexData;
+        QVector<cwLinePlotGeometryTask::CaveGeometry> CaveGeometries;
 
         friend class cwLinePlotTask;
     };
@@ -123,9 +111,6 @@ private slots:
     //For setting up all the station positions
     void updateStationPositionForCaves(const cwStationPositionLookup& stationPostions);
 
-    //Update the depth and length data
-    void updateDepthLength();
-
 private:
     /**
      * TripDataPtrs, CaveDataPtrs, and RegionDataPtrs, store pointers to original
@@ -203,9 +188,6 @@ private:
     //What's returned
     LinePlotResultData Result;
 
-    //For performance testing
-    QTime Time;
-
     void checkForErrors();
     void encodeCaveNames();
     void initializeCaveStationLookups();
@@ -257,25 +239,14 @@ inline QSet<cwScrap *> cwLinePlotTask::LinePlotResultData::scraps() const
 }
 
 /**
- * @brief cwLinePlotTask::LinePlotResultData::stationPositions
+ * @brief cwLinePlotTask::LinePlotResultData::caveGeometries
  *
- * This returns all the positions of the points.  This is used strictly for rendering.
+ * This returns the line plot of each cave.  This is used strictly for rendering.
  * This functions aren't thread safe!! You should only call these if the task isn't running
  */
-inline QVector<QVector3D> cwLinePlotTask::LinePlotResultData::stationPositions() const
+inline QVector<cwLinePlotGeometryTask::CaveGeometry> cwLinePlotTask::LinePlotResultData::caveGeometries() const
 {
-    return StationPositions;
-}
-
-/**
- * @brief cwLinePlotTask::LinePlotResultData::linePlotIndexData
- * @return Returns all the plot line data indexes.  This is to construct a line array
- *
- *  This functions aren't thread safe!! You should only call these if the task isn't running
- */
-inline QVector<unsigned int> cwLinePlotTask::LinePlotResultData::linePlotIndexData() const
-{
-    return LinePlotIndexData;
+    return CaveGeometries;
 }
 
 
@@ -304,19 +275,11 @@ inline void cwLinePlotTask::LinePlotResultData::setScraps(QSet<cwScrap*> scraps)
 }
 
 /**
- * @brief cwLinePlotTask::LinePlotResultData::setPositions
- * @param positions
- */
-inline void cwLinePlotTask::LinePlotResultData::setPositions(QVector<QVector3D> positions) {
-    StationPositions = positions;
-}
-
-/**
- * @brief cwLinePlotTask::LinePlotResultData::setPlotIndexData
- * @param indexData
+ * @brief cwLinePlotTask::LinePlotResultData::setCaveGeometries
+ * @param caveGeometries
  */
-inline void cwLinePlotTask::LinePlotResultData::setPlotIndexData(QVector<unsigned int> indexData) {
-    LinePlotIndexData = indexData;
+inline void cwLinePlotTask::LinePlotResultData::setCaveGeometries(QVector<cwLinePlotGeometryTask::CaveGeometry> caveGeometries) {
+    CaveGeometries = caveGeometries;
 }
 
 /**
@@ -352,22 +315,6 @@ inline QList<QPair<int, int> > cwLinePlotTask::StationTripScrapLookup::scraps(QS
 }
 
 
-inline void cwLinePlotTask::LinePlotCaveData::setDepth(double depth)
-{
-    Depth = depth;
-    DepthLengthChanged = true;
-}
-
-/**
- * @brief cwLinePlotTask::LinePlotCaveData::setLength
- * @param length
- */
-inline void cwLinePlotTask::LinePlotCaveData::setLength(double length)
-{
-    Length = length;
-    DepthLengthChanged = true;
-}
-
 /**
  * @brief cwLinePlotTask::LinePlotCaveData::setStationPositions
  * @param positionLookup
@@ -387,24 +334,6 @@ inline void cwLinePlotTask::LinePlotCaveData::setUnconnectedChunkError(QList<cwF
     UnconnectedChunksErrors = results;
 }
 
-/**
- * @brief cwLinePlotTask::LinePlotCaveData::depth
- * @return The depth of the cave
- */
-inline double cwLinePlotTask::LinePlotCaveData::depth() const
-{
-    return Depth;
-}
-
-/**
- * @brief cwLinePlotTask::LinePlotCaveData::length
- * @return The length of the cave
- */
-inline double cwLinePlotTask::LinePlotCaveData::length() const
-{
-    return Length;
-}
-
 /**
  * @brief cwLinePlotTask::LinePlotCaveData::stationPositions
  * @return All the station positions of the cave
@@ -424,16 +353,6 @@ inline QList<cwFindUnconnectedSurveyChunksTask::Result> cwLinePlotTask::LinePlot
     return UnconnectedChunksErrors;
 }
 
-/**
- * @brief cwLinePlotTask::LinePlotCaveData::hasDepthLengthChanged
- *
- * Return's true if the depth and the legth has     changed
- */
-inline bool cwLinePlotTask::LinePlotCaveData::hasDepthLengthChanged() const
-{
-    return DepthLengthChanged;
-}
-
 /**
  * @brief cwLinePlotTask::LinePlotCaveData::hasStationPositionsChanged
  *
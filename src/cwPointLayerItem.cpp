@@ -0,0 +1,376 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwPointLayerItem.h"
+#include "cwTransformUpdater.h"
+
+//Qt includes
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QMouseEvent>
+#include <QtMath>
+
+//Std includes
+#include <limits>
+
+//The number of sides of the polygon that's drawn for each point
+static const int NumberOfSides = 8;
+static const int VerticesPerPoint = NumberOfSides * 3 * 2; //Border and fill triangles
+
+//The mouse needs to move this many pixels before the point is dragged
+static const double DragThreshold = 3.0;
+
+cwPointLayerItem::cwPointLayerItem(QQuickItem *parent) :
+    QQuickItem(parent),
+    HiddenIndex(-1),
+    Color(Qt::green),
+    BorderColor(Qt::black),
+    PointSize(9.0),
+    ScreenPointsDirty(true),
+    GeometryDirty(true),
+    PressedIndex(-1),
+    Dragging(false)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+}
+
+/**
+ * @brief cwPointLayerItem::setTransformUpdater
+ * @param updater - Maps the points from model coordinates into this item's coordinates
+ */
+void cwPointLayerItem::setTransformUpdater(cwTransformUpdater *updater)
+{
+    if(TransformUpdater != updater) {
+        if(!TransformUpdater.isNull()) {
+            disconnect(TransformUpdater, nullptr, this, nullptr);
+        }
+
+        TransformUpdater = updater;
+
+        if(!TransformUpdater.isNull()) {
+            connect(TransformUpdater, &cwTransformUpdater::matrixChanged, this, &cwPointLayerItem::transformChanged);
+        }
+
+        transformChanged();
+    }
+}
+
+void cwPointLayerItem::setColor(QColor color)
+{
+    if(Color != color) {
+        Color = color;
+        GeometryDirty = true;
+        update();
+        emit colorChanged();
+    }
+}
+
+void cwPointLayerItem::setBorderColor(QColor borderColor)
+{
+    if(BorderColor != borderColor) {
+        BorderColor = borderColor;
+        GeometryDirty = true;
+        update();
+        emit borderColorChanged();
+    }
+}
+
+void cwPointLayerItem::setPointSize(double pointSize)
+{
+    if(PointSize != pointSize) {
+        PointSize = pointSize;
+        pointsChanged();
+        emit pointSizeChanged();
+    }
+}
+
+/**
+ * @brief cwPointLayerItem::setPoints
+ * @param points - Replaces all the points in the layer
+ */
+void cwPointLayerItem::setPoints(const QVector<QVector3D> &points)
+{
+    Points = points;
+    pointsChanged();
+}
+
+void cwPointLayerItem::setPoint(int index, const QVector3D &point)
+{
+    if(index < 0 || index >= Points.size()) { return; }
+    Points[index] = point;
+    pointsChanged();
+}
+
+/**
+ * @brief cwPointLayerItem::insertPoints
+ * @param index - Where points are inserted
+ * @param points - The new points
+ */
+void cwPointLayerItem::insertPoints(int index, const QVector<QVector3D> &points)
+{
+    if(index < 0 || index > Points.size()) { return; }
+
+    Points.insert(index, points.size(), QVector3D());
+    for(int i = 0; i < points.size(); i++) {
+        Points[index + i] = points.at(i);
+    }
+
+    pointsChanged();
+}
+
+/**
+ * @brief cwPointLayerItem::removePoints
+ * @param begin - The first point removed
+ * @param end - The last point removed
+ */
+void cwPointLayerItem::removePoints(int begin, int end)
+{
+    if(begin < 0 || end >= Points.size() || begin > end) { return; }
+    Points.remove(begin, end - begin + 1);
+    pointsChanged();
+}
+
+/**
+ * @brief cwPointLayerItem::setHiddenIndex
+ * @param index - The point that isn't drawn or hit tested, usually because the selected point has
+ * it's own item. Set to -1 to draw all the points.
+ */
+void cwPointLayerItem::setHiddenIndex(int index)
+{
+    if(HiddenIndex != index) {
+        HiddenIndex = index;
+        pointsChanged();
+    }
+}
+
+/**
+ * @brief cwPointLayerItem::indexAt
+ * @param point - In this item's coordinates
+ * @return The index of the closest point that's under point, or -1 if there's no point
+ */
+int cwPointLayerItem::indexAt(const QPointF &point) const
+{
+    updateScreenPoints();
+
+    double radius = PointSize * 0.5 + 1.0; //Include the border
+    double radiusSquared = radius * radius;
+    GridCell center = gridCell(point);
+
+    int closestIndex = -1;
+    double closestDistance = std::numeric_limits<double>::max();
+
+    //The cell size is bigger than a point, so the point can only be in the neighboring cells
+    for(int x = center.first - 1; x <= center.first + 1; x++) {
+        for(int y = center.second - 1; y <= center.second + 1; y++) {
+            QHash<GridCell, QVector<int> >::const_iterator iter = HitGrid.constFind(GridCell(x, y));
+            if(iter == HitGrid.constEnd()) {
+                continue;
+            }
+
+            foreach(int index, iter.value()) {
+                QPointF delta = ScreenPoints.at(index) - point;
+                double distance = QPointF::dotProduct(delta, delta);
+                if(distance <= radiusSquared && distance < closestDistance) {
+                    closestDistance = distance;
+                    closestIndex = index;
+                }
+            }
+        }
+    }
+
+    return closestIndex;
+}
+
+/**
+ * @brief cwPointLayerItem::contains
+ *
+ * Only the points are part of the item, so the mouse can interact with whatever is between them
+ */
+bool cwPointLayerItem::contains(const QPointF &point) const
+{
+    return indexAt(point) >= 0;
+}
+
+/**
+ * @brief cwPointLayerItem::updatePaintNode
+ *
+ * Generates a polygon with a border for each point, all in one geometry node
+ */
+QSGNode *cwPointLayerItem::updatePaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *)
+{
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if(node == nullptr) {
+        node = new QSGGeometryNode();
+
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(GL_TRIANGLES);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+
+        node->setMaterial(new QSGVertexColorMaterial());
+        node->setFlag(QSGNode::OwnsMaterial);
+
+        GeometryDirty = true;
+    }
+
+    if(!GeometryDirty) {
+        return node;
+    }
+
+    updateScreenPoints();
+
+    int numberOfVisiblePoints = ScreenPoints.size();
+    if(HiddenIndex >= 0 && HiddenIndex < ScreenPoints.size()) {
+        numberOfVisiblePoints--;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(numberOfVisiblePoints * VerticesPerPoint);
+
+    //The unit polygon
+    QPointF polygon[NumberOfSides];
+    for(int i = 0; i < NumberOfSides; i++) {
+        double angle = 2.0 * M_PI * (double)i / (double)NumberOfSides;
+        polygon[i] = QPointF(qCos(angle), qSin(angle));
+    }
+
+    double borderRadius = PointSize * 0.5;
+    double fillRadius = qMax(0.0, borderRadius - 1.0);
+
+    QSGGeometry::ColoredPoint2D* vertices = geometry->vertexDataAsColoredPoint2D();
+    int vertexIndex = 0;
+
+    auto addPolygon = [&](const QPointF& center, double radius, const QColor& color) {
+        uchar r = color.red();
+        uchar g = color.green();
+        uchar b = color.blue();
+        uchar a = color.alpha();
+        for(int i = 0; i < NumberOfSides; i++) {
+            QPointF p1 = center + polygon[i] * radius;
+            QPointF p2 = center + polygon[(i + 1) % NumberOfSides] * radius;
+            vertices[vertexIndex++].set(center.x(), center.y(), r, g, b, a);
+            vertices[vertexIndex++].set(p1.x(), p1.y(), r, g, b, a);
+            vertices[vertexIndex++].set(p2.x(), p2.y(), r, g, b, a);
+        }
+    };
+
+    for(int i = 0; i < ScreenPoints.size(); i++) {
+        if(i == HiddenIndex) { continue; }
+        addPolygon(ScreenPoints.at(i), borderRadius, BorderColor);
+        addPolygon(ScreenPoints.at(i), fillRadius, Color);
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    GeometryDirty = false;
+
+    return node;
+}
+
+void cwPointLayerItem::mousePressEvent(QMouseEvent *event)
+{
+    PressedIndex = indexAt(event->localPos());
+    if(PressedIndex < 0) {
+        event->ignore();
+        return;
+    }
+
+    PressPosition = event->localPos();
+    Dragging = false;
+    event->accept();
+
+    emit pointPressed(PressedIndex);
+}
+
+void cwPointLayerItem::mouseMoveEvent(QMouseEvent *event)
+{
+    if(PressedIndex < 0 || TransformUpdater.isNull()) { return; }
+
+    QPointF delta = event->localPos() - PressPosition;
+    if(!Dragging && QPointF::dotProduct(delta, delta) <= DragThreshold * DragThreshold) {
+        return;
+    }
+
+    Dragging = true;
+    emit pointMoved(PressedIndex, TransformUpdater->mapFromViewportToModel(event->localPos()));
+}
+
+void cwPointLayerItem::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    PressedIndex = -1;
+    Dragging = false;
+}
+
+/**
+ * @brief cwPointLayerItem::transformChanged
+ *
+ * Called when the view has been panned or zoomed
+ */
+void cwPointLayerItem::transformChanged()
+{
+    pointsChanged();
+}
+
+/**
+ * @brief cwPointLayerItem::pointsChanged
+ *
+ * Marks the screen positions and the geometry as out of date
+ */
+void cwPointLayerItem::pointsChanged()
+{
+    ScreenPointsDirty = true;
+    GeometryDirty = true;
+    update();
+}
+
+/**
+ * @brief cwPointLayerItem::updateScreenPoints
+ *
+ * Maps all the points into this item's coordinates and rebuilds the hit testing grid
+ */
+void cwPointLayerItem::updateScreenPoints() const
+{
+    if(!ScreenPointsDirty) { return; }
+
+    ScreenPoints.resize(Points.size());
+    HitGrid.clear();
+
+    QMatrix4x4 matrix = TransformUpdater.isNull() ? QMatrix4x4() : TransformUpdater->matrix();
+
+    for(int i = 0; i < Points.size(); i++) {
+        QPointF screenPoint = (matrix * Points.at(i)).toPointF();
+        ScreenPoints[i] = screenPoint;
+
+        if(i != HiddenIndex) {
+            HitGrid[gridCell(screenPoint)].append(i);
+        }
+    }
+
+    ScreenPointsDirty = false;
+}
+
+/**
+ * @brief cwPointLayerItem::gridCell
+ * @return The hit testing grid cell that point is in
+ */
+cwPointLayerItem::GridCell cwPointLayerItem::gridCell(const QPointF &point) const
+{
+    double size = gridCellSize();
+    return GridCell(qFloor(point.x() / size), qFloor(point.y() / size));
+}
+
+/**
+ * @brief cwPointLayerItem::gridCellSize
+ * @return The size of a grid cell. This is bigger than a point so a hit test only needs to check
+ * neighboring cells.
+ */
+double cwPointLayerItem::gridCellSize() const
+{
+    return qMax(1.0, PointSize + 2.0);
+}
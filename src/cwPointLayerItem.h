@@ -0,0 +1,147 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWPOINTLAYERITEM_H
+#define CWPOINTLAYERITEM_H
+
+//Our includes
+class cwTransformUpdater;
+
+//Qt includes
+#include <QQuickItem>
+#include <QPointer>
+#include <QVector>
+#include <QVector3D>
+#include <QHash>
+#include <QColor>
+
+/**
+ * @brief The cwPointLayerItem class
+ *
+ * Draws many point handles as a single scene graph geometry node, instead of one QML item per
+ * point. Points are in model coordinates and are mapped to the screen with the transformUpdater's
+ * matrix, so panning and zooming only re-transforms the point array.
+ *
+ * The layer does its own hit testing with a grid of the points' screen positions. Pressing a
+ * point emits pointPressed() and dragging it emits pointMoved(). Presses that miss every
+ * point are ignored, so they fall through to the items below.
+ *
+ * cwAbstractPointManager uses this for managers with lots of points, and only creates a QML item
+ * for the selected point, see setHiddenIndex().
+ */
+class cwPointLayerItem : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor borderColor READ borderColor WRITE setBorderColor NOTIFY borderColorChanged)
+    Q_PROPERTY(double pointSize READ pointSize WRITE setPointSize NOTIFY pointSizeChanged)
+
+public:
+    explicit cwPointLayerItem(QQuickItem *parent = 0);
+
+    cwTransformUpdater* transformUpdater() const;
+    void setTransformUpdater(cwTransformUpdater* updater);
+
+    QColor color() const;
+    void setColor(QColor color);
+
+    QColor borderColor() const;
+    void setBorderColor(QColor borderColor);
+
+    double pointSize() const;
+    void setPointSize(double pointSize);
+
+    int numberOfPoints() const;
+    void setPoints(const QVector<QVector3D>& points);
+    void setPoint(int index, const QVector3D& point);
+    void insertPoints(int index, const QVector<QVector3D>& points);
+    void removePoints(int begin, int end);
+
+    int hiddenIndex() const;
+    void setHiddenIndex(int index);
+
+    int indexAt(const QPointF& point) const;
+    bool contains(const QPointF& point) const;
+
+signals:
+    void colorChanged();
+    void borderColorChanged();
+    void pointSizeChanged();
+
+    void pointPressed(int index);
+    void pointMoved(int index, QVector3D modelPoint);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*);
+
+    void mousePressEvent(QMouseEvent* event);
+    void mouseMoveEvent(QMouseEvent* event);
+    void mouseReleaseEvent(QMouseEvent* event);
+
+private slots:
+    void transformChanged();
+
+private:
+    typedef QPair<int, int> GridCell;
+
+    QPointer<cwTransformUpdater> TransformUpdater;
+
+    QVector<QVector3D> Points; //!< In model coordinates
+    int HiddenIndex; //!< This point isn't drawn or hit, because it has it's own item
+
+    QColor Color;
+    QColor BorderColor;
+    double PointSize;
+
+    //Screen positions and the hit testing grid, updated lazily after the points or matrix change
+    mutable QVector<QPointF> ScreenPoints;
+    mutable QHash<GridCell, QVector<int> > HitGrid;
+    mutable bool ScreenPointsDirty;
+
+    bool GeometryDirty;
+
+    //Mouse dragging
+    int PressedIndex;
+    QPointF PressPosition;
+    bool Dragging;
+
+    void pointsChanged();
+    void updateScreenPoints() const;
+    GridCell gridCell(const QPointF& point) const;
+    double gridCellSize() const;
+};
+
+inline cwTransformUpdater* cwPointLayerItem::transformUpdater() const {
+    return TransformUpdater;
+}
+
+inline QColor cwPointLayerItem::color() const {
+    return Color;
+}
+
+inline QColor cwPointLayerItem::borderColor() const {
+    return BorderColor;
+}
+
+/**
+ * @brief cwPointLayerItem::pointSize
+ * @return The diameter of each point in pixels
+ */
+inline double cwPointLayerItem::pointSize() const {
+    return PointSize;
+}
+
+inline int cwPointLayerItem::numberOfPoints() const {
+    return Points.size();
+}
+
+inline int cwPointLayerItem::hiddenIndex() const {
+    return HiddenIndex;
+}
+
+#endif // CWPOINTLAYERITEM_H
@@ -0,0 +1,968 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwPolygonGridClassifier.h"
+
+//Std includes
+#include <algorithm>
+#include <cmath>
+
+cwPolygonGridClassifier::cwPolygonGridClassifier()
+{
+}
+
+/**
+ * @brief cwPolygonGridClassifier::cwPolygonGridClassifier
+ * @param gridPoints - The points of the grid, in row major order
+ * @param gridSize - The number of points in x and y
+ * @param polygon - The polygon, it's implicitly closed like QPolygonF::containsPoint()
+ */
+cwPolygonGridClassifier::cwPolygonGridClassifier(const QVector<QPointF> &gridPoints, QSize gridSize, const QPolygonF &polygon) :
+    GridSize(gridSize),
+    Polygon(polygon)
+{
+    Q_ASSERT(gridPoints.size() == gridSize.width() * gridSize.height());
+
+    int width = GridSize.width();
+    int height = GridSize.height();
+
+    if(width <= 0 || height <= 0) {
+        GridSize = QSize(0, 0);
+        return;
+    }
+
+    ColumnX.resize(width);
+    RowY.resize(height);
+    for(int x = 0; x < width; x++) {
+        ColumnX[x] = gridPoints.at(cellIndex(x, 0)).x();
+    }
+    for(int y = 0; y < height; y++) {
+        RowY[y] = gridPoints.at(cellIndex(0, y)).y();
+    }
+
+    classifyPoints();
+    classifyCells(gridPoints);
+}
+
+/**
+ * @brief cwPolygonGridClassifier::edgeCount
+ * @return The number of edges in the polygon, including the closing edge if the polygon isn't closed
+ */
+int cwPolygonGridClassifier::edgeCount() const
+{
+    if(Polygon.size() < 2) {
+        return 0;
+    }
+    return Polygon.size() - 1 + (Polygon.isClosed() ? 0 : 1);
+}
+
+/**
+ * @brief cwPolygonGridClassifier::edge
+ * @param edgeIndex - The index of the edge
+ * @return The edge from point edgeIndex to the next point. The closing edge goes from the last
+ * point to the first.
+ */
+QLineF cwPolygonGridClassifier::edge(int edgeIndex) const
+{
+    if(edgeIndex == Polygon.size() - 1) {
+        return QLineF(Polygon.last(), Polygon.first());
+    }
+    return QLineF(Polygon.at(edgeIndex), Polygon.at(edgeIndex + 1));
+}
+
+/**
+ * @brief cwPolygonGridClassifier::clipCell
+ * @param origin - The index of the top left point of the cell
+ * @return The simple polygons where the cell overlaps the polygon, in no particular winding
+ *
+ * Only the polygon edges that overlap the cell are used, see cellEdges(). The edges are clipped
+ * to the cell and split where they cross each other. Each piece keeps the side that's inside of
+ * the polygon on its left. The sides of the cell are split where the pieces touch them, and the
+ * parts that are inside are added. Walking the pieces end to start gives the simple polygons.
+ *
+ * Whether a point is inside is found like QPolygonF::containsPoint() but only with the cell's
+ * edges, see containsPoint(). This handles outlines that run along the grid lines or touch the
+ * corners of the cell.
+ */
+QList<QPolygonF> cwPolygonGridClassifier::clipCell(int origin) const
+{
+    QList<QPolygonF> polygons;
+    CellBounds bounds = cellBounds(origin);
+
+    switch(cell(origin)) {
+    case Outside:
+        return polygons;
+    case Inside: {
+        QPolygonF cellPolygon;
+        cellPolygon << QPointF(bounds.Left, bounds.Top)
+                    << QPointF(bounds.Right, bounds.Top)
+                    << QPointF(bounds.Right, bounds.Bottom)
+                    << QPointF(bounds.Left, bounds.Bottom);
+        polygons.append(cellPolygon);
+        return polygons;
+    }
+    case Boundary:
+        break;
+    }
+
+    QVector<int> cellEdgeIndexes = cellEdges(origin);
+    QVector<int> edges = parityEdges(cellEdgeIndexes, bounds);
+
+    //Where the pieces touch the sides of the cell, starting with the corners
+    QVector<QPair<double, QPointF> > sidePoints;
+    sidePoints.append(qMakePair(perimeterPosition(QPointF(bounds.Left, bounds.Top), bounds), QPointF(bounds.Left, bounds.Top)));
+    sidePoints.append(qMakePair(perimeterPosition(QPointF(bounds.Right, bounds.Top), bounds), QPointF(bounds.Right, bounds.Top)));
+    sidePoints.append(qMakePair(perimeterPosition(QPointF(bounds.Right, bounds.Bottom), bounds), QPointF(bounds.Right, bounds.Bottom)));
+    sidePoints.append(qMakePair(perimeterPosition(QPointF(bounds.Left, bounds.Bottom), bounds), QPointF(bounds.Left, bounds.Bottom)));
+
+    //The parts of the polygon's edges that are in the cell
+    QVector<QLineF> pieces;
+    pieces.reserve(cellEdgeIndexes.size());
+    foreach(int edgeIndex, cellEdgeIndexes) {
+        QPointF p1;
+        QPointF p2;
+        if(!clipToBounds(edge(edgeIndex), bounds, &p1, &p2)) {
+            continue;
+        }
+
+        p1 = snapToSides(p1, bounds, &sidePoints);
+        p2 = snapToSides(p2, bounds, &sidePoints);
+        if(p1.x() != p2.x() || p1.y() != p2.y()) {
+            pieces.append(QLineF(p1, p2));
+        }
+    }
+
+    QVector<int> chains;
+    pieces = splitAtCrossings(pieces, &chains);
+
+    //Pieces of the same chain have the inside on the same side. The longest piece of each chain
+    //is tested, because short pieces near a vertex are too small to test on their own.
+    QVector<int> longestFirst;
+    longestFirst.reserve(pieces.size());
+    for(int i = 0; i < pieces.size(); i++) {
+        longestFirst.append(i);
+    }
+    std::sort(longestFirst.begin(), longestFirst.end(),
+              [&pieces](int a, int b) { return pieces.at(a).length() > pieces.at(b).length(); });
+
+    QHash<int, bool> chainInsideOnLeft;
+    foreach(int i, longestFirst) {
+        const QLineF& piece = pieces.at(i);
+        if(chainInsideOnLeft.contains(chains.at(i)) || onSameSide(piece.p1(), piece.p2(), bounds)) {
+            continue;
+        }
+
+        bool insideOnLeft = containsPoint(leftOf(piece, bounds), origin, edges);
+        bool insideOnRight = containsPoint(leftOf(QLineF(piece.p2(), piece.p1()), bounds), origin, edges);
+        if(insideOnLeft != insideOnRight) {
+            chainInsideOnLeft.insert(chains.at(i), insideOnLeft);
+        }
+    }
+
+    //The directed segments that outline the clipped polygons, inside is always on the left
+    QVector<QLineF> segments;
+
+    for(int i = 0; i < pieces.size(); i++) {
+        const QLineF& piece = pieces.at(i);
+
+        //Pieces along the sides are covered by the sides
+        if(onSameSide(piece.p1(), piece.p2(), bounds) || !chainInsideOnLeft.contains(chains.at(i))) {
+            continue;
+        }
+
+        if(chainInsideOnLeft.value(chains.at(i))) {
+            segments.append(piece);
+        } else {
+            segments.append(QLineF(piece.p2(), piece.p1()));
+        }
+    }
+
+    //Order the side points around the cell
+    std::sort(sidePoints.begin(), sidePoints.end(),
+              [](const QPair<double, QPointF>& a, const QPair<double, QPointF>& b) { return a.first < b.first; });
+
+    //Add the parts of the cell's sides that are inside
+    for(int i = 0; i < sidePoints.size(); i++) {
+        const QPair<double, QPointF>& current = sidePoints.at(i);
+        const QPair<double, QPointF>& next = sidePoints.at((i + 1) % sidePoints.size());
+        QLineF side(current.second, next.second);
+        if(containsPoint(leftOf(side, bounds), origin, edges)) {
+            segments.append(side);
+        }
+    }
+
+    //Remove points that are almost the same, these are left by vertices that are next to a side
+    foreach(const QPolygonF& loop, traceLoops(segments)) {
+        QPolygonF polygon;
+        polygon.reserve(loop.size());
+        foreach(const QPointF& point, loop) {
+            if(!polygon.isEmpty() && polygon.last() == point) {
+                if(onPerimeter(point, bounds)) {
+                    polygon.last() = point;
+                }
+                continue;
+            }
+            polygon.append(point);
+        }
+
+        if(polygon.size() > 1 && polygon.first() == polygon.last()) {
+            if(onPerimeter(polygon.last(), bounds)) {
+                polygon.first() = polygon.last();
+            }
+            polygon.removeLast();
+        }
+
+        if(polygon.size() >= 3) {
+            polygons.append(polygon);
+        }
+    }
+
+    return polygons;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::cellBounds
+ * @param origin - The index of the top left point of the cell
+ * @return The rectangle of the cell
+ */
+cwPolygonGridClassifier::CellBounds cwPolygonGridClassifier::cellBounds(int origin) const
+{
+    int x = origin % GridSize.width();
+    int y = origin / GridSize.width();
+
+    CellBounds bounds;
+    bounds.Left = qMin(ColumnX.at(x), ColumnX.at(x + 1));
+    bounds.Right = qMax(ColumnX.at(x), ColumnX.at(x + 1));
+    bounds.Top = qMin(RowY.at(y), RowY.at(y + 1));
+    bounds.Bottom = qMax(RowY.at(y), RowY.at(y + 1));
+    return bounds;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::parityEdges
+ * @param edges - The cell's edges, see cellEdges()
+ * @return The cell's edges, and the edges that connect to them through vertices that are left of
+ * the cell, between its top and bottom.
+ *
+ * A ray to the left of a point in the cell crosses those edges differently than a ray to the
+ * left of the cell's origin, even though they don't overlap the cell. See containsPoint().
+ */
+QVector<int> cwPolygonGridClassifier::parityEdges(const QVector<int> &edges, const CellBounds &bounds) const
+{
+    QVector<int> parity = edges;
+    int count = edgeCount();
+
+    foreach(int edgeIndex, edges) {
+        //Walk backwards, then forwards, while the shared vertex is left of the cell
+        for(int direction = -1; direction <= 1; direction += 2) {
+            int current = edgeIndex;
+            while(true) {
+                QLineF line = edge(current);
+                QPointF vertex = direction < 0 ? line.p1() : line.p2();
+                if(!(vertex.x() < bounds.Left && vertex.y() >= bounds.Top && vertex.y() <= bounds.Bottom)) {
+                    break;
+                }
+
+                current = (current + direction + count) % count;
+                if(parity.contains(current)) {
+                    break;
+                }
+                parity.append(current);
+            }
+        }
+    }
+
+    return parity;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::containsPoint
+ * @param point - A point in the cell at origin
+ * @param edges - The cell's parity edges, see parityEdges()
+ * @return True if QPolygonF::containsPoint() with Qt::OddEvenFill would return true
+ *
+ * The rest of the edges cross a ray to the left of point and a ray to the left of the cell's
+ * origin the same number of times, mod 2. So the origin's classification is only flipped by the
+ * edges that cross one ray but not the other.
+ */
+bool cwPolygonGridClassifier::containsPoint(const QPointF &point, int origin, const QVector<int> &edges) const
+{
+    QPointF originPoint(ColumnX.at(origin % GridSize.width()), RowY.at(origin / GridSize.width()));
+
+    bool inside = PointClassification.at(origin) == Inside;
+    foreach(int edgeIndex, edges) {
+        QLineF line = edge(edgeIndex);
+        if(crossesRayLeftOf(line, point) != crossesRayLeftOf(line, originPoint)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::crossesRayLeftOf
+ * @return True if the edge crosses a horizontal ray that goes from point to the left. This is the
+ * same test that QPolygonF::containsPoint() does.
+ */
+bool cwPolygonGridClassifier::crossesRayLeftOf(const QLineF &edge, const QPointF &point)
+{
+    double x1 = edge.x1();
+    double y1 = edge.y1();
+    double x2 = edge.x2();
+    double y2 = edge.y2();
+
+    if(qFuzzyCompare(y1, y2)) {
+        return false;
+    }
+
+    if(y2 < y1) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
+    return point.y() >= y1 && point.y() < y2 &&
+            x1 + ((x2 - x1) / (y2 - y1)) * (point.y() - y1) <= point.x();
+}
+
+/**
+ * @brief cwPolygonGridClassifier::clipToBounds
+ * @param edge - The edge that's clipped
+ * @param clippedP1 - Set to the first point of the edge that's in the cell
+ * @param clippedP2 - Set to the last point of the edge that's in the cell
+ * @return False if the edge is outside of the cell
+ *
+ * Points that are clipped to a side are put exactly on the side, so pieces of different edges
+ * that touch the same side can be sorted around the cell.
+ */
+bool cwPolygonGridClassifier::clipToBounds(const QLineF &edge, const CellBounds &bounds, QPointF *clippedP1, QPointF *clippedP2)
+{
+    double t[2] = { 0.0, 1.0 };
+    int side[2] = { -1, -1 };
+
+    //Left, right, top and bottom
+    double p[4] = { -edge.dx(), edge.dx(), -edge.dy(), edge.dy() };
+    double q[4] = { edge.x1() - bounds.Left, bounds.Right - edge.x1(), edge.y1() - bounds.Top, bounds.Bottom - edge.y1() };
+
+    for(int i = 0; i < 4; i++) {
+        if(p[i] == 0.0) {
+            if(q[i] < 0.0) {
+                return false;
+            }
+        } else {
+            double ratio = q[i] / p[i];
+            if(p[i] < 0.0) {
+                if(ratio > t[0]) {
+                    t[0] = ratio;
+                    side[0] = i;
+                }
+            } else {
+                if(ratio < t[1]) {
+                    t[1] = ratio;
+                    side[1] = i;
+                }
+            }
+            if(t[0] > t[1]) {
+                return false;
+            }
+        }
+    }
+
+    QPointF points[2];
+    for(int i = 0; i < 2; i++) {
+        if(side[i] == -1) {
+            points[i] = i == 0 ? edge.p1() : edge.p2();
+            continue;
+        }
+
+        QPointF point = edge.pointAt(t[i]);
+        point.setX(qBound(bounds.Left, point.x(), bounds.Right));
+        point.setY(qBound(bounds.Top, point.y(), bounds.Bottom));
+        switch(side[i]) {
+        case 0:
+            point.setX(bounds.Left);
+            break;
+        case 1:
+            point.setX(bounds.Right);
+            break;
+        case 2:
+            point.setY(bounds.Top);
+            break;
+        case 3:
+            point.setY(bounds.Bottom);
+            break;
+        }
+        points[i] = point;
+    }
+
+    *clippedP1 = points[0];
+    *clippedP2 = points[1];
+    return true;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::snapToSides
+ * @param point - The end of a clipped edge
+ * @param sidePoints - The points on the sides of the cell, with their perimeterPosition()
+ * @return The point, moved onto a side if it's almost on it. Points on the sides that are almost
+ * the same as one in sidePoints are replaced by it, otherwise they're added to sidePoints.
+ *
+ * Vertices that are next to a side, and edges that are clipped at the same place, can be off by
+ * round off. This keeps the ends of the pieces that should touch exactly the same.
+ */
+QPointF cwPolygonGridClassifier::snapToSides(const QPointF &point, const CellBounds &bounds, QVector<QPair<double, QPointF> > *sidePoints)
+{
+    static const double ToleranceFraction = 1e-10;
+
+    double perimeter = 2.0 * (bounds.Right - bounds.Left + bounds.Bottom - bounds.Top);
+    double tolerance = ToleranceFraction * perimeter;
+
+    double x = qBound(bounds.Left, point.x(), bounds.Right);
+    double y = qBound(bounds.Top, point.y(), bounds.Bottom);
+    if(x - bounds.Left <= tolerance) {
+        x = bounds.Left;
+    } else if(bounds.Right - x <= tolerance) {
+        x = bounds.Right;
+    }
+    if(y - bounds.Top <= tolerance) {
+        y = bounds.Top;
+    } else if(bounds.Bottom - y <= tolerance) {
+        y = bounds.Bottom;
+    }
+
+    QPointF snapped(x, y);
+    if(!onPerimeter(snapped, bounds)) {
+        return snapped;
+    }
+
+    double position = perimeterPosition(snapped, bounds);
+    for(int i = 0; i < sidePoints->size(); i++) {
+        double distance = fabs(sidePoints->at(i).first - position);
+        if(qMin(distance, perimeter - distance) <= tolerance) {
+            return sidePoints->at(i).second;
+        }
+    }
+
+    sidePoints->append(qMakePair(position, snapped));
+    return snapped;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::splitAtCrossings
+ * @param pieces - Clipped edges, in polygon order
+ * @param chains - Set to the chain of each split piece. A chain is a run of pieces that are
+ * connected end to start, without a crossing.
+ * @return The pieces split where they cross or touch each other. This only happens in cells where
+ * the outline crosses itself or touches itself.
+ */
+QVector<QLineF> cwPolygonGridClassifier::splitAtCrossings(const QVector<QLineF> &pieces, QVector<int>* chains)
+{
+    static const double Tolerance = 1e-9;
+
+    QVector<QList<QPair<double, QPointF> > > splits(pieces.size());
+
+    for(int i = 0; i < pieces.size(); i++) {
+        for(int j = i + 1; j < pieces.size(); j++) {
+            const QLineF& first = pieces.at(i);
+            const QLineF& second = pieces.at(j);
+
+            QPointF intersection;
+            if(first.intersect(second, &intersection) != QLineF::BoundedIntersection) {
+                continue;
+            }
+
+            //Where the intersection is on each piece
+            double firstT = QPointF::dotProduct(intersection - first.p1(), first.p2() - first.p1()) /
+                    QPointF::dotProduct(first.p2() - first.p1(), first.p2() - first.p1());
+            double secondT = QPointF::dotProduct(intersection - second.p1(), second.p2() - second.p1()) /
+                    QPointF::dotProduct(second.p2() - second.p1(), second.p2() - second.p1());
+
+            bool firstInterior = firstT > Tolerance && firstT < 1.0 - Tolerance;
+            bool secondInterior = secondT > Tolerance && secondT < 1.0 - Tolerance;
+
+            //Use the existing end point, when one piece ends on the other
+            if(firstInterior && !secondInterior) {
+                intersection = secondT < 0.5 ? second.p1() : second.p2();
+            } else if(secondInterior && !firstInterior) {
+                intersection = firstT < 0.5 ? first.p1() : first.p2();
+            }
+
+            if(firstInterior) {
+                splits[i].append(qMakePair(firstT, intersection));
+            }
+            if(secondInterior) {
+                splits[j].append(qMakePair(secondT, intersection));
+            }
+        }
+    }
+
+    QVector<QLineF> splitPieces;
+    splitPieces.reserve(pieces.size());
+    chains->clear();
+    chains->reserve(pieces.size());
+
+    int chain = -1;
+    for(int i = 0; i < pieces.size(); i++) {
+        QList<QPair<double, QPointF> >& pieceSplits = splits[i];
+        std::sort(pieceSplits.begin(), pieceSplits.end(),
+                  [](const QPair<double, QPointF>& a, const QPair<double, QPointF>& b) { return a.first < b.first; });
+
+        QPointF start = pieces.at(i).p1();
+        if(splitPieces.isEmpty() || splitPieces.last().x2() != start.x() || splitPieces.last().y2() != start.y()) {
+            chain++;
+        }
+
+        for(int j = 0; j < pieceSplits.size(); j++) {
+            const QPointF& end = pieceSplits.at(j).second;
+            if(start.x() != end.x() || start.y() != end.y()) {
+                splitPieces.append(QLineF(start, end));
+                chains->append(chain);
+                chain++;
+                start = end;
+            }
+        }
+        splitPieces.append(QLineF(start, pieces.at(i).p2()));
+        chains->append(chain);
+    }
+
+    //The last chain continues into the first, when the polygon's closing vertex is in the cell
+    if(chain > 0 &&
+            splitPieces.last().x2() == splitPieces.first().x1() &&
+            splitPieces.last().y2() == splitPieces.first().y1())
+    {
+        for(int i = chains->size() - 1; i >= 0 && chains->at(i) == chain; i--) {
+            (*chains)[i] = 0;
+        }
+    }
+
+    return splitPieces;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::traceLoops
+ * @param segments - Directed segments where the inside is on the left
+ * @return The closed loops that the segments make, without the repeated first point
+ *
+ * Where more than one segment leaves a point, the segment that turns the most to the left is
+ * taken, which keeps to the inside. This keeps polygons that only touch at a point separate, so
+ * the loops are simple.
+ */
+QList<QPolygonF> cwPolygonGridClassifier::traceLoops(const QVector<QLineF> &segments)
+{
+    QList<QPolygonF> loops;
+    QVector<bool> used(segments.size(), false);
+
+    for(int first = 0; first < segments.size(); first++) {
+        if(used.at(first)) {
+            continue;
+        }
+
+        QPolygonF loop;
+        loop.append(segments.at(first).p1());
+        used[first] = true;
+
+        int current = first;
+        bool closed = false;
+        for(int step = 0; step < segments.size(); step++) {
+            const QLineF& currentSegment = segments.at(current);
+
+            int next = -1;
+            double nextTurn = 0.0;
+            for(int i = 0; i < segments.size(); i++) {
+                if(used.at(i) && i != first) {
+                    continue;
+                }
+
+                const QLineF& segment = segments.at(i);
+                if(segment.x1() != currentSegment.x2() || segment.y1() != currentSegment.y2()) {
+                    continue;
+                }
+
+                double cross = currentSegment.dx() * segment.dy() - currentSegment.dy() * segment.dx();
+                double dot = currentSegment.dx() * segment.dx() + currentSegment.dy() * segment.dy();
+                double turn = atan2(cross, dot);
+                if(next == -1 || turn > nextTurn) {
+                    next = i;
+                    nextTurn = turn;
+                }
+            }
+
+            if(next == -1) {
+                break;
+            }
+
+            if(next == first) {
+                closed = true;
+                break;
+            }
+
+            used[next] = true;
+            loop.append(segments.at(next).p1());
+            current = next;
+        }
+
+        if(closed && loop.size() >= 3) {
+            loops.append(loop);
+        }
+    }
+
+    return loops;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::onSameSide
+ * @return True if both points are exactly on the same side of the cell
+ */
+bool cwPolygonGridClassifier::onSameSide(const QPointF &p1, const QPointF &p2, const CellBounds &bounds)
+{
+    return (p1.x() == bounds.Left && p2.x() == bounds.Left) ||
+            (p1.x() == bounds.Right && p2.x() == bounds.Right) ||
+            (p1.y() == bounds.Top && p2.y() == bounds.Top) ||
+            (p1.y() == bounds.Bottom && p2.y() == bounds.Bottom);
+}
+
+/**
+ * @brief cwPolygonGridClassifier::onPerimeter
+ * @return True if the point is exactly on one of the cell's sides
+ */
+bool cwPolygonGridClassifier::onPerimeter(const QPointF &point, const CellBounds &bounds)
+{
+    return point.x() == bounds.Left || point.x() == bounds.Right ||
+            point.y() == bounds.Top || point.y() == bounds.Bottom;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::perimeterPosition
+ * @param point - A point on the perimeter of the cell
+ * @return The distance from the top left corner, going to the top right, bottom right, and bottom
+ * left corners. This walks the cell with the inside on the left.
+ */
+double cwPolygonGridClassifier::perimeterPosition(const QPointF &point, const CellBounds &bounds)
+{
+    double width = bounds.Right - bounds.Left;
+    double height = bounds.Bottom - bounds.Top;
+
+    if(point.y() == bounds.Top) {
+        return point.x() - bounds.Left;
+    } else if(point.x() == bounds.Right) {
+        return width + point.y() - bounds.Top;
+    } else if(point.y() == bounds.Bottom) {
+        return width + height + bounds.Right - point.x();
+    }
+    return 2.0 * width + height + bounds.Bottom - point.y();
+}
+
+/**
+ * @brief cwPolygonGridClassifier::leftOf
+ * @return A point just to the left of the middle of segment, kept in the cell. This is used to
+ * test which side of a segment is inside of the polygon.
+ */
+QPointF cwPolygonGridClassifier::leftOf(const QLineF &segment, const CellBounds &bounds)
+{
+    static const double NudgeFraction = 1e-6;
+
+    double length = segment.length();
+    double cellSize = qMin(bounds.Right - bounds.Left, bounds.Bottom - bounds.Top);
+    double nudge = NudgeFraction * qMin(length, cellSize);
+
+    QPointF middle = segment.pointAt(0.5);
+    QPointF left = middle + QPointF(-segment.dy(), segment.dx()) * (nudge / length);
+
+    return QPointF(qBound(bounds.Left, left.x(), bounds.Right),
+                   qBound(bounds.Top, left.y(), bounds.Bottom));
+}
+
+/**
+ * @brief cwPolygonGridClassifier::classifyPoints
+ *
+ * Finds where each row crosses the polygon's edges and walks the row's points left to right,
+ * counting the crossings. The crossings are calculated exactly like QPolygonF::containsPoint(),
+ * horizontal edges are ignored and an edge covers [y1, y2).
+ */
+void cwPolygonGridClassifier::classifyPoints()
+{
+    int width = GridSize.width();
+    int height = GridSize.height();
+
+    PointClassification.fill(Outside, width * height);
+
+    if(Polygon.isEmpty()) {
+        return;
+    }
+
+    //The non horizontal edges, with y1 < y2
+    struct ScanEdge {
+        double X1;
+        double Y1;
+        double X2;
+        double Y2;
+    };
+
+    QVector<ScanEdge> scanEdges;
+    scanEdges.reserve(edgeCount());
+    for(int i = 0; i < edgeCount(); i++) {
+        QLineF line = edge(i);
+        double x1 = line.x1();
+        double y1 = line.y1();
+        double x2 = line.x2();
+        double y2 = line.y2();
+
+        if(qFuzzyCompare(y1, y2)) {
+            continue;
+        }
+
+        if(y2 < y1) {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+        }
+
+        ScanEdge scanEdge = {x1, y1, x2, y2};
+        scanEdges.append(scanEdge);
+    }
+
+    bool ascendingColumns = isAscending(ColumnX);
+
+    QVector<double> crossings;
+    for(int y = 0; y < height; y++) {
+        double rowY = RowY.at(y);
+
+        crossings.resize(0);
+        foreach(const ScanEdge& scanEdge, scanEdges) {
+            if(rowY >= scanEdge.Y1 && rowY < scanEdge.Y2) {
+                crossings.append(scanEdge.X1 + ((scanEdge.X2 - scanEdge.X1) / (scanEdge.Y2 - scanEdge.Y1)) * (rowY - scanEdge.Y1));
+            }
+        }
+
+        if(crossings.isEmpty()) {
+            continue;
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        int crossed = 0;
+        for(int x = 0; x < width; x++) {
+            double pointX = ColumnX.at(x);
+
+            if(ascendingColumns) {
+                while(crossed < crossings.size() && crossings.at(crossed) <= pointX) {
+                    crossed++;
+                }
+            } else {
+                crossed = std::upper_bound(crossings.begin(), crossings.end(), pointX) - crossings.begin();
+            }
+
+            if(crossed % 2 == 1) {
+                PointClassification[cellIndex(x, y)] = Inside;
+            }
+        }
+    }
+}
+
+/**
+ * @brief cwPolygonGridClassifier::classifyCells
+ *
+ * Marks the Boundary cells by walking every edge through the cells it overlaps. The rest of the
+ * cells are Inside if all their corners are inside.
+ */
+void cwPolygonGridClassifier::classifyCells(const QVector<QPointF> &gridPoints)
+{
+    int width = GridSize.width();
+    int height = GridSize.height();
+
+    CellClassification.fill(Outside, width * height);
+
+    for(int i = 0; i < edgeCount(); i++) {
+        addEdgeToCells(i, gridPoints);
+    }
+
+    for(int y = 0; y < height - 1; y++) {
+        for(int x = 0; x < width - 1; x++) {
+            int origin = cellIndex(x, y);
+            if(CellClassification.at(origin) == Boundary) {
+                continue;
+            }
+
+            if(PointClassification.at(origin) == Inside &&
+                    PointClassification.at(origin + 1) == Inside &&
+                    PointClassification.at(origin + width) == Inside &&
+                    PointClassification.at(origin + width + 1) == Inside)
+            {
+                CellClassification[origin] = Inside;
+            }
+        }
+    }
+}
+
+/**
+ * @brief cwPolygonGridClassifier::addEdgeToCells
+ * @param edgeIndex - The polygon edge
+ *
+ * Tests the edge against the cells of each row that it overlaps, plus one cell on each side for
+ * round off. If the rows or columns aren't sorted, every cell is tested.
+ */
+void cwPolygonGridClassifier::addEdgeToCells(int edgeIndex, const QVector<QPointF> &gridPoints)
+{
+    int width = GridSize.width();
+    int cellsX = width - 1;
+    int cellsY = GridSize.height() - 1;
+
+    if(cellsX <= 0 || cellsY <= 0) {
+        return;
+    }
+
+    QLineF line = edge(edgeIndex);
+
+    //QPolygonF::intersects() style tests use the closing edge from the first point to the last
+    bool closingEdge = edgeIndex == Polygon.size() - 1;
+    QLineF testLine = closingEdge ? QLineF(line.p2(), line.p1()) : line;
+
+    bool sorted = isAscending(ColumnX) && isAscending(RowY);
+
+    int firstRow = 0;
+    int lastRow = cellsY - 1;
+    if(sorted) {
+        double minY = qMin(line.y1(), line.y2());
+        double maxY = qMax(line.y1(), line.y2());
+        firstRow = qMax(0, int(std::lower_bound(RowY.begin(), RowY.end(), minY) - RowY.begin()) - 2);
+        lastRow = qMin(cellsY - 1, int(std::upper_bound(RowY.begin(), RowY.end(), maxY) - RowY.begin()));
+    }
+
+    static const double Tolerance = 1e-9;
+
+    for(int y = firstRow; y <= lastRow; y++) {
+        int firstColumn = 0;
+        int lastColumn = cellsX - 1;
+
+        if(sorted) {
+            double xMin;
+            double xMax;
+            if(line.dy() == 0.0) {
+                xMin = qMin(line.x1(), line.x2());
+                xMax = qMax(line.x1(), line.x2());
+            } else {
+                //The part of the edge that's in this row
+                double t0 = (RowY.at(y) - line.y1()) / line.dy();
+                double t1 = (RowY.at(y + 1) - line.y1()) / line.dy();
+                if(t0 > t1) {
+                    std::swap(t0, t1);
+                }
+
+                t0 = qMax(t0 - Tolerance, 0.0);
+                t1 = qMin(t1 + Tolerance, 1.0);
+                if(t0 > t1) {
+                    continue;
+                }
+
+                double x0 = line.x1() + t0 * line.dx();
+                double x1 = line.x1() + t1 * line.dx();
+                xMin = qMin(x0, x1);
+                xMax = qMax(x0, x1);
+            }
+
+            firstColumn = qMax(0, int(std::lower_bound(ColumnX.begin(), ColumnX.end(), xMin) - ColumnX.begin()) - 2);
+            lastColumn = qMin(cellsX - 1, int(std::upper_bound(ColumnX.begin(), ColumnX.end(), xMax) - ColumnX.begin()));
+        }
+
+        for(int x = firstColumn; x <= lastColumn; x++) {
+            int origin = cellIndex(x, y);
+
+            bool intersects = quadIntersects(gridPoints, origin, width, testLine);
+            if(intersects) {
+                CellClassification[origin] = Boundary;
+            }
+
+            const QPointF& topLeft = gridPoints.at(origin);
+            const QPointF& bottomRight = gridPoints.at(origin + width + 1);
+            if(intersects || overlapsRect(line,
+                                          qMin(topLeft.x(), bottomRight.x()),
+                                          qMin(topLeft.y(), bottomRight.y()),
+                                          qMax(topLeft.x(), bottomRight.x()),
+                                          qMax(topLeft.y(), bottomRight.y())))
+            {
+                CellEdges[origin].append(edgeIndex);
+            }
+        }
+    }
+}
+
+/**
+ * @brief cwPolygonGridClassifier::isAscending
+ * @return True if values are sorted from smallest to largest
+ */
+bool cwPolygonGridClassifier::isAscending(const QVector<double> &values) const
+{
+    for(int i = 1; i < values.size(); i++) {
+        if(!(values.at(i - 1) < values.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::quadIntersects
+ * @return True if one of the four edges of the cell at origin has a bounded intersection with edge
+ *
+ * The quad's edges are tested in the same order, and with the same QLineF::intersect() call, as
+ * cwTriangulateTask did, so the results match exactly.
+ */
+bool cwPolygonGridClassifier::quadIntersects(const QVector<QPointF> &gridPoints, int origin, int gridWidth, const QLineF &edge)
+{
+    const QPointF& topLeft = gridPoints.at(origin);
+    const QPointF& topRight = gridPoints.at(origin + 1);
+    const QPointF& bottomLeft = gridPoints.at(origin + gridWidth);
+    const QPointF& bottomRight = gridPoints.at(origin + gridWidth + 1);
+
+    QLineF quadEdges[4] = {
+        QLineF(topLeft, topRight),
+        QLineF(topRight, bottomRight),
+        QLineF(bottomRight, bottomLeft),
+        QLineF(bottomLeft, topLeft)
+    };
+
+    QPointF intersectionPoint;
+    for(int i = 0; i < 4; i++) {
+        if(edge.intersect(quadEdges[i], &intersectionPoint) == QLineF::BoundedIntersection) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::overlapsRect
+ * @return True if any part of edge is in the closed rectangle
+ *
+ * This clips the edge to the rectangle, like Liang-Barsky
+ */
+bool cwPolygonGridClassifier::overlapsRect(const QLineF &edge, double left, double top, double right, double bottom)
+{
+    double t0 = 0.0;
+    double t1 = 1.0;
+
+    double p[4] = { -edge.dx(), edge.dx(), -edge.dy(), edge.dy() };
+    double q[4] = { edge.x1() - left, right - edge.x1(), edge.y1() - top, bottom - edge.y1() };
+
+    for(int i = 0; i < 4; i++) {
+        if(p[i] == 0.0) {
+            if(q[i] < 0.0) {
+                return false;
+            }
+        } else {
+            double t = q[i] / p[i];
+            if(p[i] < 0.0) {
+                t0 = qMax(t0, t);
+            } else {
+                t1 = qMin(t1, t);
+            }
+            if(t0 > t1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
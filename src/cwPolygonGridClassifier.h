@@ -0,0 +1,161 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWPOLYGONGRIDCLASSIFIER_H
+#define CWPOLYGONGRIDCLASSIFIER_H
+
+//Our includes
+#include "cwGlobals.h"
+
+//Qt includes
+#include <QVector>
+#include <QPointF>
+#include <QPolygonF>
+#include <QLineF>
+#include <QSize>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+/**
+ * @brief The cwPolygonGridClassifier class
+ *
+ * Labels every point and cell of a regular grid as inside, outside or on the boundary of a
+ * polygon. This is used by cwTriangulateTask to find the full and partial quads of a scrap.
+ *
+ * Points are classified with one scanline per grid row. The row's crossings with the polygon's
+ * edges are sorted, and the points are walked left to right, so the outline isn't walked for
+ * every point. This gives the same answer as QPolygonF::containsPoint() with Qt::OddEvenFill.
+ *
+ * Cells are classified by walking each polygon edge through the rows and columns of cells that
+ * it overlaps. A cell is Boundary if one of its four edges has a QLineF::BoundedIntersection
+ * with a polygon edge, Inside if all four corners are inside, and Outside otherwise. Boundary
+ * cells keep the polygon edges that overlap them, see cellEdges(), and can be clipped to the
+ * polygon with clipCell() without looking at the rest of the outline.
+ *
+ * A cell is identified by the index of its top left point, like cwTriangulateTask's quads. The
+ * grid points must be in row major order, with rows and columns that are equally spaced.
+ */
+class CAVEWHERE_LIB_EXPORT cwPolygonGridClassifier
+{
+public:
+    enum Classification {
+        Outside,
+        Inside,
+        Boundary
+    };
+
+    cwPolygonGridClassifier();
+    cwPolygonGridClassifier(const QVector<QPointF>& gridPoints, QSize gridSize, const QPolygonF& polygon);
+
+    QSize gridSize() const;
+    const QPolygonF& polygon() const;
+
+    Classification point(int index) const;
+    Classification cell(int origin) const;
+    QVector<int> cellEdges(int origin) const;
+
+    int edgeCount() const;
+    QLineF edge(int edgeIndex) const;
+
+    QList<QPolygonF> clipCell(int origin) const;
+
+private:
+    //The closed rectangle of a cell, the sides are exactly the grid's rows and columns
+    struct CellBounds {
+        double Left;
+        double Top;
+        double Right;
+        double Bottom;
+    };
+
+    QSize GridSize;
+    QPolygonF Polygon;
+
+    QVector<double> ColumnX; //!< The x of each column of points
+    QVector<double> RowY; //!< The y of each row of points
+
+    QVector<quint8> PointClassification;
+    QVector<quint8> CellClassification; //!< Indexed by the origin of the cell, like the points
+    QHash<int, QVector<int> > CellEdges; //!< Cell origin to the polygon edges that overlap it
+
+    void classifyPoints();
+    void classifyCells(const QVector<QPointF>& gridPoints);
+    void addEdgeToCells(int edgeIndex, const QVector<QPointF>& gridPoints);
+
+    bool isAscending(const QVector<double>& values) const;
+    int cellIndex(int x, int y) const;
+    CellBounds cellBounds(int origin) const;
+    QVector<int> parityEdges(const QVector<int>& edges, const CellBounds& bounds) const;
+    bool containsPoint(const QPointF& point, int origin, const QVector<int>& edges) const;
+    static bool crossesRayLeftOf(const QLineF& edge, const QPointF& point);
+    static bool clipToBounds(const QLineF& edge, const CellBounds& bounds, QPointF* clippedP1, QPointF* clippedP2);
+    static QPointF snapToSides(const QPointF& point, const CellBounds& bounds, QVector<QPair<double, QPointF> >* sidePoints);
+    static QVector<QLineF> splitAtCrossings(const QVector<QLineF>& pieces, QVector<int>* chains);
+    static QList<QPolygonF> traceLoops(const QVector<QLineF>& segments);
+    static bool onSameSide(const QPointF& p1, const QPointF& p2, const CellBounds& bounds);
+    static bool onPerimeter(const QPointF& point, const CellBounds& bounds);
+    static double perimeterPosition(const QPointF& point, const CellBounds& bounds);
+    static QPointF leftOf(const QLineF& segment, const CellBounds& bounds);
+    static bool quadIntersects(const QVector<QPointF>& gridPoints, int origin, int gridWidth, const QLineF& edge);
+    static bool overlapsRect(const QLineF& edge, double left, double top, double right, double bottom);
+};
+
+/**
+ * @brief cwPolygonGridClassifier::gridSize
+ * @return The number of points in x and y
+ */
+inline QSize cwPolygonGridClassifier::gridSize() const
+{
+    return GridSize;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::polygon
+ * @return The polygon that the grid was classified against
+ */
+inline const QPolygonF &cwPolygonGridClassifier::polygon() const
+{
+    return Polygon;
+}
+
+/**
+ * @brief cwPolygonGridClassifier::point
+ * @param index - The index of the grid point
+ * @return Inside if the point is in the polygon, otherwise Outside
+ */
+inline cwPolygonGridClassifier::Classification cwPolygonGridClassifier::point(int index) const
+{
+    return static_cast<Classification>(PointClassification.at(index));
+}
+
+/**
+ * @brief cwPolygonGridClassifier::cell
+ * @param origin - The index of the top left point of the cell
+ * @return The classification of the cell
+ */
+inline cwPolygonGridClassifier::Classification cwPolygonGridClassifier::cell(int origin) const
+{
+    return static_cast<Classification>(CellClassification.at(origin));
+}
+
+/**
+ * @brief cwPolygonGridClassifier::cellEdges
+ * @param origin - The index of the top left point of the cell
+ * @return The indices of the polygon edges that overlap the cell, in polygon order. See edge()
+ */
+inline QVector<int> cwPolygonGridClassifier::cellEdges(int origin) const
+{
+    return CellEdges.value(origin);
+}
+
+inline int cwPolygonGridClassifier::cellIndex(int x, int y) const
+{
+    return y * GridSize.width() + x;
+}
+
+#endif // CWPOLYGONGRIDCLASSIFIER_H
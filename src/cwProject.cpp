@@ -19,6 +19,8 @@
 #include "cwDebug.h"
 #include "cwSQLManager.h"
 #include "cwTaskManagerModel.h"
+#include "cwImageCleanupTask.h"
+#include "cwTextureUploadTask.h"
 
 //Qt includes
 #include <QDir>
@@ -30,6 +32,8 @@
 #include <QUndoStack>
 #include <QFileDialog>
 #include <QSettings>
+#include <QTimer>
+#include <QCryptographicHash>
 
 /**
   By default, a project is open to a temporary directory
@@ -43,15 +47,17 @@ cwProject::cwProject(QObject* parent) :
 {
     newProject();
 
-    //Create a new thread
-    LoadSaveThread = new QThread(this);
-    LoadSaveThread->start();
+    //Loading, saving and adding images share one of the scheduler's threads, so they happen in order
+    LoadSaveThread = cwTaskScheduler::instance()->acquireThread(cwTaskScheduler::Interactive);
 }
 
 cwProject::~cwProject()
 {
-    LoadSaveThread->quit();
-    LoadSaveThread->wait();
+    //Let the queued saves finish writing to the project file
+    cwTaskScheduler::instance()->flush(LoadSaveThread);
+    cwTaskScheduler::instance()->releaseThread(LoadSaveThread);
+
+    cwTextureUploadTask::clearCache(ProjectFile);
 }
 
 /**
@@ -62,7 +68,7 @@ void cwProject::createTempProjectFile() {
     if(isTemporaryProject()) {
         //Remove the old temp project file
         if(QFileInfo(filename()).exists()) {
-            QFile::remove(filename());
+            removeProjectFile(filename());
         }
     }
 
@@ -83,6 +89,7 @@ void cwProject::createTempProjectFile() {
         qDebug() << "Couldn't open temp project file: " << ProjectFile;
         return;
     }
+    cwSQLManager::instance()->configureConnection(ProjectDatabase);
 
     //Create default schema
     createDefaultSchema();
@@ -102,7 +109,7 @@ void cwProject::createTempProjectFile() {
   id | gunzipCompressedXML
 
   Columns Images:
-  id | type | shouldDelete | data
+  id | type | shouldDelete | width | height | dotsPerMeter | imageData | contentHash | referenceCount
 
   */
 void cwProject::createDefaultSchema() {
@@ -245,35 +252,49 @@ QString cwProject::convertFromURL(QString filenameUrl) const
     Saves the project as.  This will copy the current project to a different location, leaving
     the original. If the project is a temperary project, the temperary project will be removed
     from disk.
+
+    Returns false and emits saveAsFailed() if the project couldn't be copied. The project keeps
+    its current file when this fails.
   */
-void cwProject::saveAs(QString newFilename){
+bool cwProject::saveAs(QString newFilename){
     newFilename = cwGlobals::addExtension(newFilename, "cw");
     newFilename = convertFromURL(newFilename);
 
     //Just save it the user is overwritting it
     if(newFilename == filename()) {
         privateSave();
-        return;
+        return true;
+    }
+
+    //Finish the saves that are already queued, so they're in the copy
+    cwTaskScheduler::instance()->flush(LoadSaveThread);
+
+    //Write the WAL journal back into the project file, otherwise the copy is missing data.
+    //This is done before removing the existing file, so a failure doesn't lose it.
+    if(!checkpointProjectFile()) {
+        emit saveAsFailed(QString("Couldn't write the project's journal into %1, so it can't be copied to %2")
+                          .arg(filename()).arg(newFilename));
+        return false;
     }
 
     //Try to remove the existing file
     if(QFileInfo(newFilename).exists()) {
         bool couldRemove = QFile::remove(newFilename);
         if(!couldRemove) {
-            qDebug() << "Couldn't remove " << newFilename;
-            return;
+            emit saveAsFailed(QString("Couldn't remove %1").arg(newFilename));
+            return false;
         }
     }
 
     //Copy the old file to the new location
     bool couldCopy = QFile::copy(filename(), newFilename);
     if(!couldCopy) {
-        qDebug() << "Couldn't copy " << filename() << "to" << newFilename;
-        return;
+        emit saveAsFailed(QString("Couldn't copy %1 to %2").arg(filename()).arg(newFilename));
+        return false;
     }
 
     if(isTemporaryProject()) {
-        QFile::remove(filename());
+        removeProjectFile(filename());
     }
 
     //Update the project filename
@@ -284,6 +305,51 @@ void cwProject::saveAs(QString newFilename){
     privateSave();
 
     emit temporaryProjectChanged();
+
+    return true;
+}
+
+/**
+ * @brief cwProject::checkpointProjectFile
+ * @return True if the project's WAL journal was completely moved into the project file, so the
+ * file can be copied. False if the file is missing data that's only in the journal.
+ */
+bool cwProject::checkpointProjectFile()
+{
+    QString connectionName("CheckpointConnection");
+    bool success = false;
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(filename());
+        if(database.open()) {
+            cwSQLManager::instance()->configureConnection(database);
+            success = cwSQLManager::instance()->checkpoint(database);
+            if(!success) {
+                qDebug() << "Couldn't checkpoint" << filename() << LOCATION;
+            }
+            database.close();
+        } else {
+            qDebug() << "Couldn't open" << filename() << "for checkpointing" << database.lastError().text() << LOCATION;
+        }
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return success;
+}
+
+/**
+ * @brief cwProject::removeProjectFile
+ * @param filename - The project file
+ *
+ * Removes the project file and sqlite's WAL journal files that are next to it.
+ */
+void cwProject::removeProjectFile(QString filename)
+{
+    QFile::remove(filename);
+    QFile::remove(filename + "-wal");
+    QFile::remove(filename + "-shm");
 }
 
 /**
@@ -359,10 +425,34 @@ void cwProject::updateRegionData() {
     //Update the project filename
     setFilename(LoadTask->databaseFilename());
 
-    //Copy the data from the loaded region
-    LoadTask->copyRegionTo(*Region);
+    //The old caves are deleted, so nothing on the undo stack can refer to them
+    UndoStack->clear();
+
+    //Move the data from the loaded region, this replaces the caves in Region with one reset
+    LoadTask->moveRegionTo(*Region);
 
     emit temporaryProjectChanged();
+
+    //Remove unused images once the loaded project is up
+    QTimer::singleShot(0, this, SLOT(cleanupImages()));
+}
+
+/**
+ * @brief cwProject::cleanupImages
+ *
+ * Removes the images that aren't used by the region from the project file, in the background
+ */
+void cwProject::cleanupImages()
+{
+    cwImageCleanupTask* cleanupTask = new cwImageCleanupTask();
+    connect(cleanupTask, SIGNAL(finished()), cleanupTask, SLOT(deleteLater()));
+    connect(cleanupTask, SIGNAL(stopped()), cleanupTask, SLOT(deleteLater()));
+
+    cleanupTask->setDatabaseFilename(filename());
+    cleanupTask->setRegion(Region);
+    cleanupTask->setLoadedReferenceCounts(LoadTask->imageReferenceCounts());
+    cleanupTask->setThread(cwTaskScheduler::Background);
+    cleanupTask->start();
 }
 
 /**
@@ -402,6 +492,9 @@ void cwProject::deleteImageTask()
   */
 void cwProject::setFilename(QString newFilename) {
     if(newFilename != filename()) {
+        //The old file's decoded mipmaps are never used again
+        cwTextureUploadTask::clearCache(ProjectFile);
+
         ProjectFile = newFilename;
         emit filenameChanged(ProjectFile);
     }
@@ -448,13 +541,26 @@ void cwProject::addImages(QList<QUrl> noteImagePath, QObject* receiver, const ch
 
   This static function takes a database and adds the imageData to the database
 
+  If an image with the same contentHash is already in the database, its referenceCount is
+  increased and its id is returned, instead of storing the data again. If contentHash is empty, the
+  hash is calculated with imageHash(). Images without data are always inserted.
+
   This returns the id of the image in the database
   */
-int cwProject::addImage(const QSqlDatabase& database, const cwImageData& imageData) {
+int cwProject::addImage(const QSqlDatabase& database, const cwImageData& imageData, QByteArray contentHash) {
     cwSQLManager::Transaction transaction(&database);
 
-    QString SQL = "INSERT INTO Images (type, shouldDelete, width, height, dotsPerMeter, imageData) "
-            "VALUES (?, ?, ?, ?, ?, ?)";
+    if(contentHash.isEmpty()) {
+        contentHash = imageHash(imageData);
+    }
+
+    int existingId = referenceImage(database, contentHash);
+    if(existingId != -1) {
+        return existingId;
+    }
+
+    QString SQL = "INSERT INTO Images (type, shouldDelete, width, height, dotsPerMeter, imageData, contentHash, referenceCount) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, 1)";
 
     QSqlQuery query(database);
     bool successful = query.prepare(SQL);
@@ -470,12 +576,116 @@ int cwProject::addImage(const QSqlDatabase& database, const cwImageData& imageDa
     query.bindValue(3, imageData.size().height());
     query.bindValue(4, imageData.dotsPerMeter());
     query.bindValue(5, imageData.data());
+    query.bindValue(6, contentHash.isEmpty() ? QVariant(QVariant::ByteArray) : QVariant(contentHash));
     query.exec();
 
     //Get the id of the last inserted id
     return query.lastInsertId().toInt();
 }
 
+/**
+ * @brief cwProject::reuseImage
+ * @param database - The project database
+ * @param contentHash - The hash of the image, see imageHash() and derivedImageHash()
+ * @return The id of the image with contentHash, or -1 if there's no image with the hash
+ *
+ * If the image exists, this adds a reference to it, so the caller must treat the id like one
+ * returned by addImage(). This is used to skip creating an image that's already in the project,
+ * like the mipmaps of an image that's re-imported.
+ */
+int cwProject::reuseImage(const QSqlDatabase &database, const QByteArray &contentHash)
+{
+    if(contentHash.isEmpty()) {
+        return -1;
+    }
+
+    cwSQLManager::Transaction transaction(&database);
+    return referenceImage(database, contentHash);
+}
+
+/**
+ * @brief cwProject::imageHash
+ * @param imageData - The image
+ * @return The content hash of the image, or an empty QByteArray if the image has no data
+ */
+QByteArray cwProject::imageHash(const cwImageData &imageData)
+{
+    if(imageData.data().isEmpty()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(imageData.format());
+    hash.addData(QByteArray::number(imageData.size().width()));
+    hash.addData("x");
+    hash.addData(QByteArray::number(imageData.size().height()));
+    hash.addData(imageData.data());
+    return hash.result();
+}
+
+/**
+ * @brief cwProject::derivedImageHash
+ * @param sourceHash - The hash of the image that's the source of the derived image
+ * @param kind - How the image is derived, for example "icon" or a mipmap format
+ * @param size - The size of the derived image
+ * @return The hash that identifies the derived image, or an empty QByteArray if sourceHash is empty
+ *
+ * Icons and mipmaps are created the same way from the same source, so they're identified by their
+ * source instead of their data. This lets them be found with reuseImage() before doing the
+ * expensive work of creating them.
+ */
+QByteArray cwProject::derivedImageHash(const QByteArray &sourceHash, const QByteArray &kind, QSize size)
+{
+    if(sourceHash.isEmpty()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(sourceHash);
+    hash.addData(kind);
+    hash.addData(QByteArray::number(size.width()));
+    hash.addData("x");
+    hash.addData(QByteArray::number(size.height()));
+    return hash.result();
+}
+
+/**
+ * @brief cwProject::referenceImage
+ * @return The id of the image with contentHash, with one more reference, or -1
+ *
+ * This should be called inside of a transaction
+ */
+int cwProject::referenceImage(const QSqlDatabase &database, const QByteArray &contentHash)
+{
+    if(contentHash.isEmpty()) {
+        return -1;
+    }
+
+    QSqlQuery findQuery(database);
+    findQuery.prepare("SELECT id FROM Images WHERE contentHash = ?");
+    findQuery.bindValue(0, contentHash);
+    if(!findQuery.exec()) {
+        qDebug() << "Couldn't look up image hash:" << findQuery.lastError() << LOCATION;
+        return -1;
+    }
+
+    if(!findQuery.next()) {
+        return -1;
+    }
+
+    int id = findQuery.value(0).toInt();
+
+    QSqlQuery referenceQuery(database);
+    referenceQuery.prepare("UPDATE Images SET referenceCount = referenceCount + 1 WHERE id = ?");
+    referenceQuery.bindValue(0, id);
+    if(!referenceQuery.exec()) {
+        qDebug() << "Couldn't add image reference:" << referenceQuery.lastError() << LOCATION;
+        return -1;
+    }
+
+    return id;
+}
+
 /**
  * @brief cwProject::updateImage
  * @param database - The database where the image is going to be inserted into
@@ -511,6 +721,9 @@ bool cwProject::updateImage(const QSqlDatabase &database, const cwImageData &ima
  * @param database - The database connection
  * @param image - The Image that going to be removed
  * @return True if the image could be removed, and false if it couldn't be removed
+ *
+ * This releases the image's reference to each of its ids. Images are only deleted once nothing
+ * references them, because identical images are shared, see addImage().
  */
 bool cwProject::removeImage(const QSqlDatabase &database, cwImage image, bool withTransaction)
 {
@@ -518,36 +731,39 @@ bool cwProject::removeImage(const QSqlDatabase &database, cwImage image, bool wi
         cwSQLManager::instance()->beginTransaction(database);
     }
 
-    //Create the delete SQL statement
-    QString SQL("DELETE FROM Images WHERE");
-    SQL += QString(" id == %1").arg(image.original());
-    SQL += QString(" OR ");
-    SQL += QString(" id == %1").arg(image.icon());
+    //The icon only holds a reference when it isn't the original, see cwAddImageTask::createIcon()
+    QVariantList ids;
+    ids.append(image.original());
+    if(image.icon() != image.original()) {
+        ids.append(image.icon());
+    }
     foreach(int mipmapId, image.mipmaps()) {
-        SQL += QString(" OR ");
-        SQL += QString(" id == %1").arg(mipmapId);
+        ids.append(mipmapId);
     }
 
-    QSqlQuery query(database);
-    bool successful = query.prepare(SQL);
+    QSqlQuery releaseQuery(database);
+    releaseQuery.prepare("UPDATE Images SET referenceCount = referenceCount - 1 WHERE id = ?");
+    releaseQuery.addBindValue(ids);
+    bool successful = releaseQuery.execBatch();
 
-    if(!successful) {
-        qDebug() << "Couldn't delete images: " << query.lastError();
+    if(successful) {
+        QSqlQuery deleteQuery(database);
+        deleteQuery.prepare("DELETE FROM Images WHERE id = ? AND referenceCount <= 0");
+        deleteQuery.addBindValue(ids);
+        successful = deleteQuery.execBatch();
 
-        if(withTransaction) {
-            cwSQLManager::instance()->endTransaction(database);
+        if(!successful) {
+            qDebug() << "Couldn't delete images: " << deleteQuery.lastError() << LOCATION;
         }
-
-        return false;
+    } else {
+        qDebug() << "Couldn't release images: " << releaseQuery.lastError() << LOCATION;
     }
 
-    query.exec();
-
     if(withTransaction) {
         cwSQLManager::instance()->endTransaction(database);
     }
 
-    return true;
+    return successful;
 }
 
 /**
@@ -557,11 +773,15 @@ bool cwProject::removeImage(const QSqlDatabase &database, cwImage image, bool wi
 void cwProject::createDefaultSchema(const QSqlDatabase &database)
 {
 
-    //Create the database with full vacuum so we don't use up tons of space
+    //Create the database with incremental vacuum so we don't use up tons of space, cwImageCleanupTask
+    //gives the free pages back
     QSqlQuery vacuumQuery(database);
-    QString query = QString("PRAGMA auto_vacuum = 1");
+    QString query = QString("PRAGMA auto_vacuum = 2");
     vacuumQuery.exec(query);
 
+    //Readers, like cwImageProvider, can keep going while the project is being saved
+    cwSQLManager::instance()->enableWriteAheadLog(database);
+
     cwSQLManager::Transaction transaction(&database);
 
     //Create the caving region
@@ -596,8 +816,24 @@ void cwProject::createDefaultSchema(const QSqlDatabase &database)
             QString("width INTEGER,") + //The width of the image
             QString("height INTEGER,") + //The height of the image
             QString("dotsPerMeter INTEGER,") + //The resolution of the image
-            QString("imageData BLOB)"); //The blob that stores the image data
+            QString("imageData BLOB,") + //The blob that stores the image data
+            QString("contentHash BLOB,") + //Identifies the image data, see imageHash()
+            QString("referenceCount INTEGER NOT NULL DEFAULT 1)"); //Number of cwImage's using the image
     createTable(database, imageTableQuery);
+
+    createImageHashIndex(database);
+}
+
+/**
+ * @brief cwProject::createImageHashIndex
+ * @param database - The project database
+ *
+ * Creates the unique index on Images.contentHash, this makes addImage()'s look up fast and
+ * prevents the same image from being stored twice. Images without a hash (NULL) aren't unique.
+ */
+void cwProject::createImageHashIndex(const QSqlDatabase &database)
+{
+    createTable(database, "CREATE UNIQUE INDEX IF NOT EXISTS ImagesContentHash ON Images (contentHash)");
 }
 
 /**
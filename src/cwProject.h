@@ -52,7 +52,7 @@ public:
     void setUndoStack(QUndoStack* undoStack);
 
     Q_INVOKABLE void save();
-    Q_INVOKABLE void saveAs(QString newFilename);
+    Q_INVOKABLE bool saveAs(QString newFilename);
 
     Q_INVOKABLE void newProject();
 
@@ -63,11 +63,16 @@ public:
 
     void addImages(QList<QUrl> noteImagePath, QObject* reciever, const char* slot);
 
-    static int addImage(const QSqlDatabase& database, const cwImageData& imageData);
+    static int addImage(const QSqlDatabase& database, const cwImageData& imageData, QByteArray contentHash = QByteArray());
+    static int reuseImage(const QSqlDatabase& database, const QByteArray& contentHash);
     static bool updateImage(const QSqlDatabase& database, const cwImageData& imageData, int id);
     static bool removeImage(const QSqlDatabase& database, cwImage image, bool withTransaction = true);
 
     static void createDefaultSchema(const QSqlDatabase& database);
+    static void createImageHashIndex(const QSqlDatabase& database);
+
+    static QByteArray imageHash(const cwImageData& imageData);
+    static QByteArray derivedImageHash(const QByteArray& sourceHash, const QByteArray& kind, QSize size);
 
     bool isTemporaryProject() const;
 
@@ -78,6 +83,7 @@ signals:
     void undoStackChanged();
     void temporaryProjectChanged();
     void regionChanged();
+    void saveAsFailed(QString errorMessage);
 
 public slots:
      void loadFile(QString filename);
@@ -94,7 +100,7 @@ private:
 
     //For loading images from the disk into this project
     cwRegionLoadTask* LoadTask;
-    QThread* LoadSaveThread;
+    QThread* LoadSaveThread; //!< From cwTaskScheduler
 
     //The undo stack
     QUndoStack* UndoStack;
@@ -103,9 +109,12 @@ private:
     QPointer<cwTaskManagerModel> TaskManager;
 
     void createTempProjectFile();
+    bool checkpointProjectFile();
+    static void removeProjectFile(QString filename);
     void createDefaultSchema();
 
     static void createTable(const QSqlDatabase& database, QString sql); //Helpers to createDefaultSchema
+    static int referenceImage(const QSqlDatabase& database, const QByteArray& contentHash);
     static void insertDocumentation(const QSqlDatabase& database, QList<QPair<QString, QString> > filenames); //Helpers to createDefaultSchema
 
     void setFilename(QString newFilename);
@@ -116,6 +125,7 @@ private:
 private slots:
     void updateRegionData();
     void startDeleteImageTask();
+    void cleanupImages();
     void deleteImageTask();
 
 };
@@ -41,6 +41,8 @@ bool cwProjectIOTask::connectToDatabase(QString connectionName) {
     if(!connected) {
         qDebug() << "Couldn't connect to database for" << connectionName << DatabasePath << LOCATION;
         stop();
+    } else {
+        cwSQLManager::instance()->configureConnection(Database);
     }
 
     return connected;
@@ -58,7 +58,8 @@
 #include "cwItemSelectionModel.h"
 #include "cwSurveyExportManager.h"
 #include "cwSurveyImportManager.h"
-#include "cwTripLengthTask.h"
+#include "cwTripStatistics.h"
+#include "cwCaveStatistics.h"
 #include "cwLabel3dView.h"
 #include "cwLinePlotLabelView.h"
 #include "cwAbstractPointManager.h"
@@ -86,6 +87,7 @@
 #include "cwCaptureGroupModel.h"
 #include "cwEventRecorderModel.h"
 #include "cwTaskManagerModel.h"
+#include "cwTaskTraceModel.h"
 #include "cwPageSelectionModel.h"
 #include "cwPageView.h"
 #include "cwPage.h"
@@ -174,7 +176,8 @@ void cwQMLRegister::registerQML()
     qmlRegisterType<cwItemSelectionModel>("Cavewhere", 1, 0, "ItemSelectionModel");
     qmlRegisterType<cwSurveyExportManager>("Cavewhere", 1, 0, "SurveyExportManager");
     qmlRegisterType<cwSurveyImportManager>("Cavewhere", 1, 0, "SurveyImportManager");
-    qmlRegisterType<cwTripLengthTask>("Cavewhere", 1, 0, "TripLengthTask");
+    qmlRegisterType<cwTripStatistics>("Cavewhere", 1, 0, "TripStatistics");
+    qmlRegisterType<cwCaveStatistics>("Cavewhere", 1, 0, "CaveStatistics");
     qmlRegisterType<cwLabel3dView>("Cavewhere", 1, 0, "Label3dView");
     qmlRegisterType<cwLinePlotLabelView>("Cavewhere", 1, 0, "LinePlotLabelView");
     qmlRegisterType<cwScrapItem>("Cavewhere", 1, 0, "ScrapItem");
@@ -208,6 +211,7 @@ void cwQMLRegister::registerQML()
     qmlRegisterType<cwCaptureGroupModel>("Cavewhere", 1, 0, "CaptureGroupModel");
     qmlRegisterType<cwEventRecorderModel>("Cavewhere", 1, 0, "EventRecorderModel");
     qmlRegisterType<cwTaskManagerModel>("Cavewhere", 1, 0, "TaskManagerModel");
+    qmlRegisterType<cwTaskTraceModel>("Cavewhere", 1, 0, "TaskTraceModel");
     qmlRegisterType<cwPageSelectionModel>("Cavewhere", 1, 0, "PageSelectionModel");
     qmlRegisterType<cwPageView>("Cavewhere", 1, 0, "PageView");
     qmlRegisterType<cwPage>("Cavewhere", 1, 0, "Page");
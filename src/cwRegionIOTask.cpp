@@ -42,27 +42,29 @@ void cwRegionIOTask::setCavingRegion(const cwCavingRegion& region) {
 }
 
 /**
- * @brief cwRegionIOTask::copyRegionTo
+ * @brief cwRegionIOTask::moveRegionTo
  * @param region
  *
- * This will copy the data out the region io task into region.
+ * This will move the caves out of the region io task into region, without copying them.
+ * The caves are moved to region's thread and reparented to region. The task's region is
+ * left empty.
  *
- * This fuction makes sure that the thread for region is correct when coping
- * the region.
+ * This should be called from region's thread.
  */
-void cwRegionIOTask::copyRegionTo(cwCavingRegion &region)
+void cwRegionIOTask::moveRegionTo(cwCavingRegion &region)
 {
     Q_ASSERT(thread() == Region->thread());
+    Q_ASSERT(QThread::currentThread() == region.thread());
 
-    //Move the region to the current thread
+    //Move the region, and all the caves, to the current thread
     if(QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "moveRegionToThread",
                                   Qt::BlockingQueuedConnection,
                                   Q_ARG(QThread*, QThread::currentThread()));
     }
 
-    //Preform copy
-    region = *Region;
+    //Hand off the caves
+    region.takeCaves(Region);
 
     //Move Region back to task's thread
     if(QThread::currentThread() != thread()) {
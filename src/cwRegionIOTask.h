@@ -20,7 +20,7 @@ public:
 
     void setCavingRegion(const cwCavingRegion& region);
 
-    void copyRegionTo(cwCavingRegion& region);
+    void moveRegionTo(cwCavingRegion& region);
 
 protected:
     cwCavingRegion* Region;
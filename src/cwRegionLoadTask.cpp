@@ -7,7 +7,6 @@
 
 //Our includes
 #include "cwRegionLoadTask.h"
-#include "cwImageCleanupTask.h"
 #include "cwCavingRegion.h"
 #include "cwCave.h"
 #include "cwUnits.h"
@@ -21,6 +20,7 @@
 #include "cwSurveyNoteModel.h"
 #include "cwImageResolution.h"
 #include "cwSQLManager.h"
+#include "cwProject.h"
 #include "cwDebug.h"
 
 ////Serielization includes
@@ -55,6 +55,12 @@ void cwRegionLoadTask::runTask() {
         //This makes sure that sqlite is clean up after it self
         insureVacuuming();
 
+        //Older projects don't have the columns for sharing identical images
+        insureImageReferenceCounting();
+
+        //Let readers run while the project is being saved
+        cwSQLManager::instance()->enableWriteAheadLog(Database);
+
         //Try loading Proto Buffer
         bool success = loadFromProtoBuffer();
 
@@ -100,11 +106,8 @@ bool cwRegionLoadTask::loadFromProtoBuffer()
 
     loadCavingRegion(region);
 
-    //Clean up old images
-    cwImageCleanupTask imageCleanupTask;
-    imageCleanupTask.setDatabaseFilename(databaseFilename());
-    imageCleanupTask.setRegion(Region);
-    imageCleanupTask.start();
+    //Unused images are cleaned up by cwProject, after the region has been loaded
+    ImageReferenceCounts = readImageReferenceCounts();
 
     Database.close();
     return true;
@@ -401,6 +404,13 @@ void cwRegionLoadTask::loadScrap(const CavewhereProto::Scrap& protoScrap, cwScra
     loadNoteTranformation(protoScrap.notetransformation(), scrap->noteTransformation());
     scrap->setCalculateNoteTransform(protoScrap.calculatenotetransform());
     scrap->setTriangulationData(loadTriangulatedData(protoScrap.triangledata()));
+
+    QList<cwTriangulatedData> recentData;
+    recentData.reserve(protoScrap.recenttriangledata_size());
+    for(int i = 0; i < protoScrap.recenttriangledata_size(); i++) {
+        recentData.append(loadTriangulatedData(protoScrap.recenttriangledata(i)));
+    }
+    scrap->setRecentTriangulations(recentData);
 }
 
 /**
@@ -475,12 +485,29 @@ cwTriangulatedData cwRegionLoadTask::loadTriangulatedData(const CavewhereProto::
         leadPositions[i] = loadVector3D(protoTriangulatedData.leadpositions(i));
     }
 
+    QList<cwTriangulatedData::LevelOfDetail> levels;
+    levels.reserve(protoTriangulatedData.levelsofdetail_size());
+    for(int i = 0; i < protoTriangulatedData.levelsofdetail_size(); i++) {
+        const CavewhereProto::LevelOfDetail& protoLevel = protoTriangulatedData.levelsofdetail(i);
+        QVector<uint> levelIndexes;
+        levelIndexes.resize(protoLevel.indices_size());
+        for(int j = 0; j < protoLevel.indices_size(); j++) {
+            levelIndexes[j] = protoLevel.indices(j);
+        }
+        levels.append(cwTriangulatedData::LevelOfDetail(levelIndexes, protoLevel.error()));
+    }
+
+    QByteArray inputHash(protoTriangulatedData.inputhash().data(),
+                         (int)protoTriangulatedData.inputhash().size());
+
     bool stale = protoTriangulatedData.stale();
 
     data.setPoints(points);
     data.setTexCoords(texCoords);
     data.setIndices(indexes);
     data.setLeadPoints(leadPositions);
+    data.setLevelsOfDetail(levels);
+    data.setInputHash(inputHash);
     data.setStale(stale);
 
     return data;
@@ -745,12 +772,29 @@ QStringList cwRegionLoadTask::loadStringList(const QtProto::QStringList &protoSt
 
 
 
+/**
+ * @brief cwRegionLoadTask::readImageReferenceCounts
+ * @return All the image ids in the database, with their referenceCount
+ */
+QHash<int, int> cwRegionLoadTask::readImageReferenceCounts()
+{
+    cwSQLManager::Transaction transaction(&Database, cwSQLManager::ReadOnly);
+
+    QHash<int, int> referenceCounts;
+    QSqlQuery query("SELECT id, referenceCount FROM Images", Database);
+    while(query.next()) {
+        referenceCounts.insert(query.value(0).toInt(), query.value(1).toInt());
+    }
+    return referenceCounts;
+}
+
 /**
  * @brief cwRegionLoadTask::insureVacuuming
  *
- * This will make sure that the SQL database is using vacuuming
+ * This will make sure that the SQL database is using incremental vacuuming
  *
- * This make sure sqlite is cleaning up after itself
+ * This make sure sqlite is cleaning up after itself. The free pages are given back by
+ * cwImageCleanupTask in small steps, instead of on every commit.
  */
 void cwRegionLoadTask::insureVacuuming()
 {
@@ -770,29 +814,70 @@ void cwRegionLoadTask::insureVacuuming()
     switch(vacuum) {
     case 0: {
         //Vacuum is off
-        //Turn on full Vacuum
-        QSqlQuery turnOnFullVacuum(Database);
+        //Turn on incremental Vacuum, this only needs a full VACUUM once, to convert the file
+        QSqlQuery turnOnVacuum(Database);
 
-        bool success = turnOnFullVacuum.exec("PRAGMA auto_vacuum = 1");
+        bool success = turnOnVacuum.exec("PRAGMA auto_vacuum = 2");
         if(!success) {
-            qDebug() << "Turn on vacuum error:" << turnOnFullVacuum.lastError().text() << LOCATION;
+            qDebug() << "Turn on vacuum error:" << turnOnVacuum.lastError().text() << LOCATION;
         }
 
-        success = turnOnFullVacuum.exec("VACUUM");
+        success = turnOnVacuum.exec("VACUUM");
         if(!success) {
-            qDebug() << "Vacuum error:" << turnOnFullVacuum.lastError().text();
+            qDebug() << "Vacuum error:" << turnOnVacuum.lastError().text();
         }
+        break;
     }
-    case 1:
-        //Full Vacuum
-        break; //Do nothing
-    case 2: {
-        //Incremental Vacuum
-        QString SQL = "PRAGMA auto_vacuum 1";
-        QSqlQuery turnOnFullVacuum(Database);
-        turnOnFullVacuum.exec(SQL);
+    case 1: {
+        //Full Vacuum, switching to incremental doesn't need a VACUUM
+        QSqlQuery turnOnIncrementalVacuum(Database);
+        bool success = turnOnIncrementalVacuum.exec("PRAGMA auto_vacuum = 2");
+        if(!success) {
+            qDebug() << "Turn on incremental vacuum error:" << turnOnIncrementalVacuum.lastError().text() << LOCATION;
+        }
+        break;
     }
+    case 2:
+        //Incremental Vacuum
+        break; //Do nothing
     }
 }
 
+/**
+ * @brief cwRegionLoadTask::insureImageReferenceCounting
+ *
+ * Adds the contentHash and referenceCount columns to the Images table, if the project was
+ * created before identical images were shared, see cwProject::addImage(). Existing images don't
+ * get a hash, they're only shared with images that are added from now on.
+ */
+void cwRegionLoadTask::insureImageReferenceCounting()
+{
+    bool hasContentHash = false;
+    bool hasReferenceCount = false;
 
+    {
+        QSqlQuery tableInfoQuery("PRAGMA table_info(Images)", Database);
+        while(tableInfoQuery.next()) {
+            QString column = tableInfoQuery.value(1).toString();
+            hasContentHash = hasContentHash || column == "contentHash";
+            hasReferenceCount = hasReferenceCount || column == "referenceCount";
+        }
+    }
+
+    cwSQLManager::Transaction transaction(&Database);
+
+    QSqlQuery alterQuery(Database);
+    if(!hasContentHash) {
+        if(!alterQuery.exec("ALTER TABLE Images ADD COLUMN contentHash BLOB")) {
+            qDebug() << "Couldn't add contentHash:" << alterQuery.lastError().text() << LOCATION;
+        }
+    }
+
+    if(!hasReferenceCount) {
+        if(!alterQuery.exec("ALTER TABLE Images ADD COLUMN referenceCount INTEGER NOT NULL DEFAULT 1")) {
+            qDebug() << "Couldn't add referenceCount:" << alterQuery.lastError().text() << LOCATION;
+        }
+    }
+
+    cwProject::createImageHashIndex(Database);
+}
@@ -35,12 +35,17 @@ class cwLength;
 #include "cavewhere.pb.h"
 #include "qt.pb.h"
 
+//Qt includes
+#include <QHash>
+
 class cwRegionLoadTask : public cwRegionIOTask
 {
     Q_OBJECT
 public:
     explicit cwRegionLoadTask(QObject *parent = 0);
 
+    QHash<int, int> imageReferenceCounts() const;
+
 signals:
     void finishedLoading();
 
@@ -98,8 +103,22 @@ private:
 //    bool loadFromBoostSerialization();
 
     void insureVacuuming();
+    void insureImageReferenceCounting();
+    QHash<int, int> readImageReferenceCounts();
+
+    QHash<int, int> ImageReferenceCounts; //!< Image id to referenceCount when the region was loaded
 
 
 };
 
+/**
+ * @brief cwRegionLoadTask::imageReferenceCounts
+ * @return Every image id in the database, with its referenceCount, when the region was loaded.
+ * See cwImageCleanupTask::setLoadedReferenceCounts()
+ */
+inline QHash<int, int> cwRegionLoadTask::imageReferenceCounts() const
+{
+    return ImageReferenceCounts;
+}
+
 #endif // CWREGIONLOADTASK_H
@@ -279,6 +279,10 @@ void cwRegionSaveTask::saveScrap(CavewhereProto::Scrap *protoScrap, cwScrap *scr
     saveNoteTranformation(protoScrap->mutable_notetransformation(), scrap->noteTransformation());
     protoScrap->set_calculatenotetransform(scrap->calculateNoteTransform());
     saveTriangulatedData(protoScrap->mutable_triangledata(), scrap->triangulationData());
+
+    foreach(const cwTriangulatedData& recentData, scrap->recentTriangulations()) {
+        saveTriangulatedData(protoScrap->add_recenttriangledata(), recentData);
+    }
 }
 
 /**
@@ -348,6 +352,17 @@ void cwRegionSaveTask::saveTriangulatedData(CavewhereProto::TriangulatedData *pr
         saveVector3D(protoVector3D, leadPoint);
     }
 
+    foreach(cwTriangulatedData::LevelOfDetail level, triangluatedData.levelsOfDetail()) {
+        CavewhereProto::LevelOfDetail* protoLevel = protoTriangulatedData->add_levelsofdetail();
+        foreach(uint index, level.indices()) {
+            protoLevel->add_indices(index);
+        }
+        protoLevel->set_error(level.error());
+    }
+
+    QByteArray inputHash = triangluatedData.inputHash();
+    protoTriangulatedData->set_inputhash(inputHash.constData(), inputHash.size());
+
     protoTriangulatedData->set_stale(triangluatedData.isStale());
 }
 
@@ -120,6 +120,33 @@ void cwRegionTreeModel::removedCaves(QModelIndex parent, int begin, int end)
     endRemoveRows();
 }
 
+/**
+ * @brief cwRegionTreeModel::beginResetCaves
+ *
+ * Called when all the caves in the region are about to be replaced
+ */
+void cwRegionTreeModel::beginResetCaves()
+{
+    if(rowCount() > 0) {
+        removeCaveConnections(0, rowCount() - 1);
+    }
+    beginResetModel();
+}
+
+/**
+ * @brief cwRegionTreeModel::endResetCaves
+ *
+ * Called once all the caves in the region have been replaced. Listeners get a single
+ * modelReset() instead of an insert for every cave, trip, note and scrap.
+ */
+void cwRegionTreeModel::endResetCaves()
+{
+    endResetModel();
+    if(rowCount() > 0) {
+        addCaveConnections(0, rowCount() - 1);
+    }
+}
+
 /**
  * @brief cwRegionTreeModel::beginInsertTrips
  * @param parent
@@ -343,6 +370,8 @@ void cwRegionTreeModel::setCavingRegion(cwCavingRegion* region) {
     connect(Region, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(insertedCaves(QModelIndex,int,int)));
     connect(Region, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), SLOT(beginRemoveCaves(QModelIndex,int,int)));
     connect(Region, SIGNAL(rowsRemoved(QModelIndex,int,int)), SLOT(removedCaves(QModelIndex,int,int)));
+    connect(Region, SIGNAL(modelAboutToBeReset()), SLOT(beginResetCaves()));
+    connect(Region, SIGNAL(modelReset()), SLOT(endResetCaves()));
     endResetModel();
 
     if(rowCount() > 0) {
@@ -85,6 +85,8 @@ private slots:
     void insertedCaves(QModelIndex parent, int begin, int end);
     void beginRemoveCaves(QModelIndex parent, int begin, int end);
     void removedCaves(QModelIndex parent, int begin, int end);
+    void beginResetCaves();
+    void endResetCaves();
 
     void beginInsertTrips(QModelIndex parent, int begin, int end);
     void insertedTrips(QModelIndex parent, int begin, int end);
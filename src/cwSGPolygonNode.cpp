@@ -26,7 +26,11 @@ void cwSGPolygonNode::setPolygon(const QPolygonF &polygon) {
 
     //Trianglate the polygon
     QVector<QPointF> results;
-    cwTriangulate::Process(polygon, results);
+    if(!cwTriangulate::Process(polygon, results)) {
+        //The outline crosses itself, the ear clipper still fills most of it
+        results.clear();
+        cwTriangulate::EarClip(polygon, results);
+    }
 
     QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), results.size());
     geometry->setDrawingMode(GL_TRIANGLES);
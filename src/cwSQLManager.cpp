@@ -10,6 +10,8 @@
 #include <QSqlError>
 #include <QSqlDatabase>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QWriteLocker>
 
 //Sqlite lite includes
 #include <sqlite3.h>
@@ -22,7 +24,8 @@
 cwSQLManager* cwSQLManager::Instance = new cwSQLManager();
 
 cwSQLManager::cwSQLManager(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    BusyTimeout(30000)
 {
 }
 
@@ -49,44 +52,70 @@ cwSQLManager *cwSQLManager::instance()
  * Warning Calling the function multiple times in the same thread, with out calling endTransaction()
  * will cause deadlock!
  *
- * Returns false if the was an SQL error and prints out that error
+ * Returns false if the was an SQL error and prints out that error. If the database stays busy for
+ * longer than busyTimeout(), this gives up and returns false.
  *
  * @param database - The database that this will start a connection with
  * @param type - ReadOnly should only be used when using select queries. It is safe to use WriteRead
- * for all queries, including SELECT statements. WriteRead will block other calls with ReadOnly and
- * WriteRead and make the function synconous. If ReadOnly is specified, other ReadOnly transactions
- * can occur in different threads. This property control a QReadWriteLock.
- *
+ * for all queries, including SELECT statements. WriteRead will block other calls with WriteRead and
+ * make the function synconous. ReadOnly uses BEGIN DEFERRED and WriteRead uses BEGIN IMMEDIATE, so
+ * a writer holds sqlite's write lock for the whole transaction. If the database isn't using the WAL
+ * journal, WriteRead also blocks ReadOnly, through a QReadWriteLock. With the WAL journal, ReadOnly
+ * transactions don't lock and run while a writer is in flight.
  */
 bool cwSQLManager::beginTransaction(const QSqlDatabase& database, QueryType type)
 {
-    QReadWriteLock* lock = fetchDatabaseMutex(database.databaseName());
+    QString databaseName = database.databaseName();
+    QReadWriteLock* lock = fetchDatabaseMutex(databaseName);
+    bool locked = true;
+
+    QString beginTransationQuery;
     switch(type) {
     case ReadOnly:
-        lock->lockForRead();
+        //Readers on a WAL database read a snapshot, they don't have to wait on the writer
+        if(isWriteAheadLog(databaseName)) {
+            locked = false;
+        } else {
+            lock->lockForRead();
+        }
+        beginTransationQuery = "BEGIN DEFERRED";
         break;
     case WriteRead:
         lock->lockForWrite();
+        beginTransationQuery = "BEGIN IMMEDIATE";
         break;
     }
 
+    if(locked) {
+        QMutexLocker locker(&DatabaseHashMutex);
+        LockedConnections.insert(database.connectionName());
+    }
+
     //SQLITE begin transation
-    QString beginTransationQuery = "BEGIN TRANSACTION";
+    QElapsedTimer timer;
+    timer.start();
+
     QSqlQuery query = database.exec(beginTransationQuery);
     QSqlError error = query.lastError();
-    while (error.isValid() && error.number() == SQLITE_BUSY) {
-        //Try to wait until the database becomes less busy
-        QThread::currentThread()->sleep(250);
+
+    //Another process (or a connection that bypasses this class) has the database, back off and retry
+    unsigned long backoff = 1;
+    while(error.isValid() && error.number() == SQLITE_BUSY && timer.elapsed() < busyTimeout()) {
+        QThread::msleep(backoff);
+        backoff = qMin(backoff * 2, 250ul);
         query = database.exec(beginTransationQuery);
         error = query.lastError();
     }
 
     if(error.isValid()) {
-        if(error.number() != SQLITE_BUSY) {
+        if(error.number() == SQLITE_BUSY) {
+            qDebug() << "Database is busy, gave up after" << timer.elapsed() << "ms" << LOCATION;
+        } else {
             //Some other error
             qDebug() << "Database error when trying to begin transaction:" << error << error.text() << LOCATION;
-            return false;
         }
+        unlock(database);
+        return false;
     }
     return true;
 }
@@ -117,8 +146,122 @@ void cwSQLManager::endTransaction(const QSqlDatabase &database, cwSQLManager::En
         qDebug() << "Couldn't" << commitTransationQuery << "transaction:" << query.lastError() << LOCATION;
     }
 
-    QReadWriteLock* lock = fetchDatabaseMutex(database.databaseName());
-    lock->unlock();
+    unlock(database);
+}
+
+/**
+ * @brief cwSQLManager::configureConnection
+ * @param database - An open connection
+ *
+ * This sets the sqlite busy timeout on the connection, so statements that run outside of
+ * beginTransaction() wait for the database instead of failing with SQL_BUSY right away. Call this
+ * after opening a connection to a project.
+ */
+void cwSQLManager::configureConnection(const QSqlDatabase &database) const
+{
+    QSqlQuery query(database);
+    if(!query.exec(QString("PRAGMA busy_timeout = %1").arg(busyTimeout()))) {
+        qDebug() << "Couldn't set busy timeout:" << query.lastError().text() << LOCATION;
+    }
+}
+
+/**
+ * @brief cwSQLManager::enableWriteAheadLog
+ * @param database - An open connection to the project
+ * @return True if the database is now using the WAL journal
+ *
+ * This switches the database file to sqlite's WAL journal. The journal mode is stored in the file,
+ * so this only needs to be called when a project is created or opened. Every other connection to
+ * the same file will then use the concurrent reader path in beginTransaction().
+ */
+bool cwSQLManager::enableWriteAheadLog(const QSqlDatabase &database)
+{
+    //The journal mode can't change while someone is in a transaction
+    QWriteLocker locker(fetchDatabaseMutex(database.databaseName()));
+
+    QSqlQuery query(database);
+    if(!query.exec("PRAGMA journal_mode = WAL")) {
+        qDebug() << "Couldn't turn on WAL:" << query.lastError().text() << LOCATION;
+        return false;
+    }
+
+    QString mode;
+    if(query.next()) {
+        mode = query.value(0).toString().toLower();
+    }
+
+    if(mode != "wal") {
+        qDebug() << "Database" << database.databaseName() << "is using journal mode" << mode << "instead of WAL" << LOCATION;
+        return false;
+    }
+
+    QMutexLocker hashLocker(&DatabaseHashMutex);
+    WriteAheadLogDatabases.insert(database.databaseName());
+    return true;
+}
+
+/**
+ * @brief cwSQLManager::journalMode
+ * @param database - An open connection
+ * @return The journal mode that the database file is using
+ */
+cwSQLManager::JournalMode cwSQLManager::journalMode(const QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if(query.exec("PRAGMA journal_mode") && query.next()) {
+        if(query.value(0).toString().toLower() == "wal") {
+            QMutexLocker locker(&DatabaseHashMutex);
+            WriteAheadLogDatabases.insert(database.databaseName());
+            return WriteAheadLog;
+        }
+    }
+    return RollbackJournal;
+}
+
+/**
+ * @brief cwSQLManager::checkpoint
+ * @param database - An open connection
+ * @return True if all the data in the WAL journal was written back to the database file
+ *
+ * This should be called before copying the database file on disk. Otherwise the copy will be
+ * missing all the transactions that are only in the -wal file. This does nothing if the database
+ * isn't using the WAL journal.
+ */
+bool cwSQLManager::checkpoint(const QSqlDatabase &database)
+{
+    if(journalMode(database) != WriteAheadLog) {
+        return true;
+    }
+
+    //Wait for the writer to finish
+    QWriteLocker locker(fetchDatabaseMutex(database.databaseName()));
+
+    QSqlQuery query(database);
+    if(!query.exec("PRAGMA wal_checkpoint(TRUNCATE)")) {
+        qDebug() << "Couldn't checkpoint:" << query.lastError().text() << LOCATION;
+        return false;
+    }
+
+    //The first column is 1 if the checkpoint couldn't finish
+    return query.next() && query.value(0).toInt() == 0;
+}
+
+/**
+ * @brief cwSQLManager::setBusyTimeout
+ * @param milliseconds - How long beginTransaction() waits on a busy database
+ */
+void cwSQLManager::setBusyTimeout(int milliseconds)
+{
+    BusyTimeout.store(milliseconds);
+}
+
+/**
+ * @brief cwSQLManager::busyTimeout
+ * @return How long beginTransaction() waits on a busy database, in milliseconds
+ */
+int cwSQLManager::busyTimeout() const
+{
+    return BusyTimeout.load();
 }
 
 /**
@@ -136,6 +279,37 @@ QReadWriteLock* cwSQLManager::fetchDatabaseMutex(QString databaseName)
    return DatabaseNameToMutexIndex.value(databaseName, nullptr);
 }
 
+/**
+ * @brief cwSQLManager::isWriteAheadLog
+ * @param databaseName - The name of the database
+ * @return True if enableWriteAheadLog() or journalMode() found the database using the WAL journal
+ */
+bool cwSQLManager::isWriteAheadLog(QString databaseName)
+{
+    QMutexLocker locker(&DatabaseHashMutex);
+    return WriteAheadLogDatabases.contains(databaseName);
+}
+
+/**
+ * @brief cwSQLManager::unlock
+ * @param database
+ *
+ * Releases the lock that beginTransaction() took for the connection. WAL readers don't take a lock,
+ * so nothing is released for them.
+ */
+void cwSQLManager::unlock(const QSqlDatabase &database)
+{
+    bool locked;
+    {
+        QMutexLocker locker(&DatabaseHashMutex);
+        locked = LockedConnections.remove(database.connectionName());
+    }
+
+    if(locked) {
+        fetchDatabaseMutex(database.databaseName())->unlock();
+    }
+}
+
 /**
  * @brief cwSQLManager::Transaction::Transaction
  *
@@ -171,7 +345,7 @@ cwSQLManager::Transaction::~Transaction()
  */
 void cwSQLManager::Transaction::rollBack()
 {
-    cwSQLManager::instance()->endTransaction(*Database, cwSQLManager::Commit);
+    cwSQLManager::instance()->endTransaction(*Database, cwSQLManager::RollBack);
     RolledBack = true;
 }
 
@@ -15,17 +15,24 @@
 #include <QMap>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QSet>
+#include <QAtomicInt>
 
 /**
  * @brief The cwSQLManager class
  *
  * This is as singleton class. To use the class use cwSQLManager::instance()
  *
- * This class uses a mutex to make all sql transactions synchronous. Because of this, it may cause
- * the calling thread to block. The mutrex is locked when calling beginTransaction() and unlocked
- * when calling endTransaction(). If another application is using the database, and SQL_BUSY error
- * happends, this class will try wait 250ms and try to begin a transaction. Using QSqlQuery outside
- * of this class can cause SQL_BUSY errors.
+ * This class uses a QReadWriteLock per database file to make sql transactions synchronous. Because
+ * of this, it may cause the calling thread to block. The lock is taken when calling
+ * beginTransaction() and released when calling endTransaction(). If another application is using
+ * the database, and SQL_BUSY error happends, this class backs off, starting at a few milliseconds,
+ * and tries again until busyTimeout() has passed. Using QSqlQuery outside of this class can cause
+ * SQL_BUSY errors.
+ *
+ * If the database has been opened with enableWriteAheadLog(), sqlite's WAL journal is used. Readers
+ * see a snapshot of the database and don't block, or get blocked by, the writer. ReadOnly
+ * transactions then take no lock at all and only WriteRead transactions are serialized.
  *
  * This class allows for multiple database (databases in different files) to be handled correctly.
  * This class will not block access to multiple databases and can be read and written to asynchronously.
@@ -44,6 +51,11 @@ public:
         RollBack
     };
 
+    enum JournalMode {
+        RollbackJournal,
+        WriteAheadLog
+    };
+
     class Transaction {
     public:
         Transaction(const QSqlDatabase *database, QueryType type = WriteRead);
@@ -65,6 +77,14 @@ public:
     bool beginTransaction(const QSqlDatabase& database, QueryType type = WriteRead);
     void endTransaction(const QSqlDatabase& database, EndType type = Commit);
 
+    void configureConnection(const QSqlDatabase& database) const;
+    bool enableWriteAheadLog(const QSqlDatabase& database);
+    JournalMode journalMode(const QSqlDatabase& database);
+    bool checkpoint(const QSqlDatabase& database);
+
+    void setBusyTimeout(int milliseconds);
+    int busyTimeout() const;
+
 signals:
 
 public slots:
@@ -75,13 +95,23 @@ private:
     static cwSQLManager* Instance;
 
     QReadWriteLock *fetchDatabaseMutex(QString databaseFile);
+    bool isWriteAheadLog(QString databaseName);
+    void unlock(const QSqlDatabase& database);
 
-    //This protects the two structures below
+    //This protects the structures below
     QMutex DatabaseHashMutex;
 
     //Converts a DatabaseName into a Mutex to protect the database
     QHash<QString, QReadWriteLock*> DatabaseNameToMutexIndex;
 
+    //Databases that are using the WAL journal
+    QSet<QString> WriteAheadLogDatabases;
+
+    //Connection names that are holding a lock between beginTransaction() and endTransaction()
+    QSet<QString> LockedConnections;
+
+    QAtomicInt BusyTimeout; //In milliseconds
+
 };
 
 #endif // CWSQLMANAGER_H
@@ -12,12 +12,15 @@
 #include "cwSceneCommand.h"
 #include "cwShaderDebugger.h"
 #include "cwInitializeOpenGLFunctionsCommand.h"
+#include "cwCamera.h"
 
 cwScene::cwScene(QObject *parent) :
     QObject(parent),
     GeometryItersecter(new cwGeometryItersecter()),
     ShaderDebugger(new cwShaderDebugger(this)),
     Camera(nullptr),
+    ObjectsDrawn(0),
+    ObjectsCulled(0),
     ExcutingCommands(false)
 {
     cwInitializeOpenGLFunctionsCommand* initOpenGLFunctionCommand = new cwInitializeOpenGLFunctionsCommand();
@@ -46,9 +49,20 @@ void cwScene::paint()
     glEnable (GL_BLEND);
     glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    Frustum = Camera != nullptr ? cwFrustum(Camera->viewProjectionMatrix()) : cwFrustum();
+    ObjectsDrawn = 0;
+    ObjectsCulled = 0;
+
     //Simple opaque rendering
     foreach(cwGLObject* item, RenderingObjects) {
+        if(!Frustum.intersects(item->boundingBox())) {
+            item->culled();
+            ObjectsCulled++;
+            continue;
+        }
+
         item->draw();
+        ObjectsDrawn++;
     }
 
     glDisable(GL_DEPTH_TEST);
@@ -22,6 +22,7 @@ class cwCamera;
 class cwShaderDebugger;
 class cwSceneCommand;
 class cwGeometryItersecter;
+#include "cwFrustum.h"
 
 /**
  * @brief The cwScene class
@@ -53,6 +54,12 @@ public:
 
     cwShaderDebugger* shaderDebugger() const;
 
+    const cwFrustum& frustum() const;
+
+    //Frame statistics, for the last paint()
+    int objectsDrawn() const;
+    int objectsCulled() const;
+
     void update();
 
 signals:
@@ -74,6 +81,12 @@ private:
     //The main camera for the viewer
     cwCamera* Camera;
 
+    //The camera's view, updated at the start of each paint()
+    cwFrustum Frustum;
+
+    int ObjectsDrawn;
+    int ObjectsCulled;
+
     //All the Queued scene command
     QQueue<cwSceneCommand*> CommandQueue;
     bool ExcutingCommands;
@@ -87,6 +100,34 @@ inline cwShaderDebugger *cwScene::shaderDebugger() const
     return ShaderDebugger;
 }
 
+/**
+ * @brief cwScene::frustum
+ * @return The camera's view frustum for the frame that's being painted. cwGLObjects can use
+ * this in draw() to cull parts of their geometry
+ */
+inline const cwFrustum& cwScene::frustum() const
+{
+    return Frustum;
+}
+
+/**
+ * @brief cwScene::objectsDrawn
+ * @return The number of cwGLObjects that were drawn in the last paint()
+ */
+inline int cwScene::objectsDrawn() const
+{
+    return ObjectsDrawn;
+}
+
+/**
+ * @brief cwScene::objectsCulled
+ * @return The number of cwGLObjects that were outside of the camera's view in the last paint()
+ */
+inline int cwScene::objectsCulled() const
+{
+    return ObjectsCulled;
+}
+
 
 
 #endif // CWSCENE_H
@@ -914,6 +914,7 @@ const cwScrap & cwScrap::copy(const cwScrap &other) {
     *NoteTransformation = *(other.NoteTransformation);
     setCalculateNoteTransform(other.CalculateNoteTransform);
     TriangulationData = other.TriangulationData;
+    RecentTriangulations = other.RecentTriangulations;
 
     emit stationsReset();
 
@@ -940,3 +941,10 @@ void cwScrap::setTriangulationData(cwTriangulatedData data) {
 
     leadsDataChanged(0, leads().size() - 1, roles);
 }
+
+/**
+  \brief Sets the triangulations that this scrap had before, most recent first
+  */
+void cwScrap::setRecentTriangulations(QList<cwTriangulatedData> recentData) {
+    RecentTriangulations = recentData;
+}
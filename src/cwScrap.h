@@ -105,6 +105,9 @@ public:
     void setTriangulationData(cwTriangulatedData data);
     cwTriangulatedData triangulationData() const;
 
+    void setRecentTriangulations(QList<cwTriangulatedData> recentData);
+    QList<cwTriangulatedData> recentTriangulations() const;
+
 public slots:
     void updateNoteTransformation();
 
@@ -173,6 +176,9 @@ private:
     cwTriangulatedData TriangulationData;
     bool TriangulationDataDirty;
 
+    //Triangulations that this scrap had before, most recent first, see cwScrapManager
+    QList<cwTriangulatedData> RecentTriangulations;
+
     //Clamps a pointF that's in note coordinates to the scrap
     QPointF clampToScrap(QPointF point);
     bool pointOnLine(QLineF line, QPointF point);
@@ -290,5 +296,15 @@ inline cwTriangulatedData cwScrap::triangulationData() const {
     return TriangulationData;
 }
 
+/**
+  \brief Gets the triangulations that this scrap had before, most recent first
+
+  These are kept by cwScrapManager, so undoing an edit doesn't have to triangulate the
+  scrap again. They're saved with the project.
+  */
+inline QList<cwTriangulatedData> cwScrap::recentTriangulations() const {
+    return RecentTriangulations;
+}
+
 
 #endif // CWSCRAP_H
@@ -27,19 +27,24 @@
 //Qt includes
 #include <QThread>
 
+const int cwScrapManager::MaxCachedMeshes = 3;
+
 cwScrapManager::cwScrapManager(QObject *parent) :
     QObject(parent),
     //    Region(nullptr),
     LinePlotManager(nullptr),
-    TriangulateThread(new QThread(this)),
     TriangulateTask(new cwTriangulateTask()),
     RemoveImageTask(new cwRemoveImageTask(this)), //Runs in the scrapManager's thread
+    ChangeJournal(new cwChangeJournal(this)),
     Project(nullptr),
     TaskManagerModel(nullptr),
     GLScraps(nullptr),
     AutomaticUpdate(true)
 {
-    TriangulateTask->setThread(TriangulateThread);
+    TriangulateTask->setThread(cwTaskScheduler::Interactive);
+
+    //Batches scrap edits together, so dragging a point doesn't restart the triangulation for every move
+    connect(ChangeJournal, &cwChangeJournal::changed, this, &cwScrapManager::runDirtyScraps);
 
     connect(TriangulateTask, SIGNAL(finished()), SLOT(taskFinished()));
     connect(TriangulateTask, &cwTriangulateTask::shouldRerun, this, &cwScrapManager::rerunDirtyScraps);
@@ -48,9 +53,8 @@ cwScrapManager::cwScrapManager(QObject *parent) :
 
 cwScrapManager::~cwScrapManager()
 {
-    TriangulateTask->stop();
-    TriangulateThread->quit();
-    TriangulateThread->wait();
+    TriangulateTask->stopAndWait();
+    delete TriangulateTask;
 }
 
 /**
@@ -87,6 +91,10 @@ void cwScrapManager::setRegionTreeModel(cwRegionTreeModel *regionTreeModel)
                        this, &cwScrapManager::inserted);
             disconnect(RegionModel.data(), &cwRegionTreeModel::rowsAboutToBeRemoved,
                        this, &cwScrapManager::removed);
+            disconnect(RegionModel.data(), &cwRegionTreeModel::modelAboutToBeReset,
+                       this, &cwScrapManager::handleRegionAboutToReset);
+            disconnect(RegionModel.data(), &cwRegionTreeModel::modelReset,
+                       this, &cwScrapManager::handleRegionReset);
         }
 
         RegionModel = regionTreeModel;
@@ -96,6 +104,10 @@ void cwScrapManager::setRegionTreeModel(cwRegionTreeModel *regionTreeModel)
                     this, &cwScrapManager::inserted);
             connect(RegionModel.data(), &cwRegionTreeModel::rowsAboutToBeRemoved,
                     this, &cwScrapManager::removed);
+            connect(RegionModel.data(), &cwRegionTreeModel::modelAboutToBeReset,
+                    this, &cwScrapManager::handleRegionAboutToReset);
+            connect(RegionModel.data(), &cwRegionTreeModel::modelReset,
+                    this, &cwScrapManager::handleRegionReset);
         }
 
         handleRegionReset();
@@ -168,6 +180,19 @@ void cwScrapManager::updateAllScraps() {
     }
 
     updateScrapGeometryHelper(scraps);
+    ChangeJournal->flush();
+}
+
+/**
+ * @brief cwScrapManager::waitToFinish
+ *
+ * Runs the pending scrap edits and blocks until they're triangulated. This is useful
+ * for unit testing.
+ */
+void cwScrapManager::waitToFinish()
+{
+    ChangeJournal->flush();
+    TriangulateTask->waitToFinish();
 }
 
 /**
@@ -204,7 +229,50 @@ void cwScrapManager::updateStationPositionChangedForScraps(QList<cwScrap *> scra
 
 void cwScrapManager::rerunDirtyScraps()
 {
-    updateScrapGeometry(DirtyScraps.toList());
+    runDirtyScraps();
+}
+
+/**
+ * @brief cwScrapManager::runDirtyScraps
+ *
+ * Called by the change journal once a batch of edits is ready. If the triangulation task is
+ * running, it's only restarted if one of the scraps that it's triangulating has changed. Otherwise,
+ * the new dirty scraps are run after the task finishes.
+ */
+void cwScrapManager::runDirtyScraps()
+{
+    if(DirtyScraps.isEmpty()) { return; }
+
+    if(TriangulateTask->isReady()) {
+        QList<cwTriangulateInData> scrapData;
+        QList<cwImage> imagesToRemove;
+        WaitingForUpdate.clear();
+        ChangedWhileRunning.clear();
+
+        foreach(cwScrap* scrap, DirtyScraps) {
+            cwTriangulateInData inData = mapScrapToTriangulateInData(scrap);
+            if(reuseTriangulation(scrap, TriangulateTask->inputHash(inData), &imagesToRemove)) {
+                //The input hasn't changed from a previous run, no need to crop or triangulate
+                DirtyScraps.remove(scrap);
+                disconnect(scrap, SIGNAL(destroyed(QObject*)), this, SLOT(scrapDeleted(QObject*)));
+                continue;
+            }
+
+            WaitingForUpdate.append(scrap);
+            scrapData.append(inData);
+        }
+
+        removeImages(imagesToRemove);
+
+        if(scrapData.isEmpty()) { return; }
+
+        TriangulateTask->setProjectFilename(Project->filename());
+        TriangulateTask->setScrapData(scrapData);
+        TriangulateTask->start();
+    } else if(!ChangedWhileRunning.isEmpty()) {
+        //The task's input has changed, restart the task
+        TriangulateTask->restart();
+    }
 }
 
 /**
@@ -216,6 +284,7 @@ void cwScrapManager::scrapDeleted(QObject *scrapObj)
     cwScrap* scrap = static_cast<cwScrap*>(scrapObj);
     addToDeletedScraps(scrap);
     DirtyScraps.remove(scrap); //scrapObj);
+    ChangedWhileRunning.remove(scrap);
 }
 
 /**
@@ -258,9 +327,19 @@ void cwScrapManager::addToDeletedScraps(cwScrap *scrap)
  */
 bool cwScrapManager::scrapImagesOkay(cwScrap *scrap)
 {
-    if(scrap->triangulationData().croppedImage().isValid()) {
+    return imagesOkay(scrap->triangulationData().croppedImage());
+}
+
+/**
+ * @brief cwScrapManager::imagesOkay
+ * @param image
+ * @return Returns true if all the mipmaps of image are in the database, and false if they're missing
+ */
+bool cwScrapManager::imagesOkay(const cwImage &image)
+{
+    if(image.isValid()) {
         //Should be in the database
-        foreach(int mipmap, scrap->triangulationData().croppedImage().mipmaps()) {
+        foreach(int mipmap, image.mipmaps()) {
             cwImageData imageData = ImageProvider.data(mipmap, true);
             if(!imageData.size().isValid()) {
                 return false;
@@ -272,6 +351,118 @@ bool cwScrapManager::scrapImagesOkay(cwScrap *scrap)
     return false;
 }
 
+/**
+ * @brief cwScrapManager::reuseTriangulation
+ * @param scrap - The dirty scrap
+ * @param inputHash - The cwTriangulateTask::inputHash() of the scrap's current input
+ * @param imagesToRemove - Images that are evicted from the scrap's recent triangulations are appended to this
+ * @return True if the scrap's triangulation was found without running the task
+ *
+ * The scrap's own data is used if it was made from the same input, for example, if a station
+ * moved and then moved back. Otherwise, the scrap's recently replaced meshes are checked, this is
+ * what makes undo and redo cheap. The scrap's current data is cached in exchange.
+ */
+bool cwScrapManager::reuseTriangulation(cwScrap *scrap, const QByteArray &inputHash, QList<cwImage> *imagesToRemove)
+{
+    cwTriangulatedData currentData = scrap->triangulationData();
+
+    if(!currentData.isNull() &&
+            currentData.inputHash() == inputHash &&
+            scrapImagesOkay(scrap))
+    {
+        currentData.setStale(false);
+        scrap->setTriangulationData(currentData);
+        return true;
+    }
+
+    QList<cwTriangulatedData> recentData = scrap->recentTriangulations();
+
+    int cachedIndex = -1;
+    for(int i = 0; i < recentData.size(); i++) {
+        if(recentData.at(i).inputHash() == inputHash) {
+            cachedIndex = i;
+            break;
+        }
+    }
+
+    if(cachedIndex == -1) {
+        return false;
+    }
+
+    cwTriangulatedData cachedData = recentData.takeAt(cachedIndex);
+    scrap->setRecentTriangulations(recentData);
+
+    if(!imagesOkay(cachedData.croppedImage())) {
+        //The cropped image is missing from the database, so there's nothing to release
+        return false;
+    }
+
+    cacheTriangulation(scrap, currentData, imagesToRemove);
+
+    cachedData.setStale(false);
+    scrap->setTriangulationData(cachedData);
+    GLScraps->addScrapToUpdate(scrap);
+    return true;
+}
+
+/**
+ * @brief cwScrapManager::cacheTriangulation
+ * @param scrap - The scrap that keeps the triangulation
+ * @param data - The triangulation that the scrap no longer uses
+ * @param imagesToRemove - The cropped images that should be removed from the database
+ *
+ * Keeps data in the scrap's recent triangulations, so it can be reused if the scrap goes back to
+ * the same input. The recent triangulations are saved with the project, so this also works after
+ * the project is reloaded. The least recently used mesh is evicted when the scrap has more than
+ * MaxCachedMeshes. Data that can't be reused, old data without an input hash, has its cropped
+ * image removed right away.
+ */
+void cwScrapManager::cacheTriangulation(cwScrap *scrap, const cwTriangulatedData &data, QList<cwImage> *imagesToRemove)
+{
+    cwImage image = data.croppedImage();
+    if(!image.isValid()) {
+        return;
+    }
+
+    QByteArray inputHash = data.inputHash();
+    if(inputHash.isEmpty() || data.isNull()) {
+        imagesToRemove->append(image);
+        return;
+    }
+
+    QList<cwTriangulatedData> recentData = scrap->recentTriangulations();
+
+    for(int i = recentData.size() - 1; i >= 0; i--) {
+        if(recentData.at(i).inputHash() == inputHash) {
+            //Replace the older mesh for the same input
+            imagesToRemove->append(recentData.takeAt(i).croppedImage());
+        }
+    }
+
+    recentData.prepend(data);
+
+    while(recentData.size() > MaxCachedMeshes) {
+        imagesToRemove->append(recentData.takeLast().croppedImage());
+    }
+
+    scrap->setRecentTriangulations(recentData);
+}
+
+/**
+ * @brief cwScrapManager::removeImages
+ * @param images - Removes these images from the project's database
+ */
+void cwScrapManager::removeImages(const QList<cwImage> &images)
+{
+    if(images.isEmpty()) {
+        return;
+    }
+
+    RemoveImageTask->setImagesToRemove(images);
+    RemoveImageTask->setDatabaseFilename(Project->filename());
+    RemoveImageTask->start(); //This runs in this thread, should be very quick
+}
+
 /**
  * @brief cwScrapManager::handleRegionReset
  *
@@ -283,6 +474,7 @@ void cwScrapManager::handleRegionReset()
         foreach(cwCave* cave, RegionModel->cavingRegion()->caves()) {
             foreach(cwTrip* trip, cave->trips()) {
                 foreach(cwNote* note, trip->notes()->notes()) {
+                    connectNote(note);
                     scrapInsertedHelper(note, 0, note->scraps().size() - 1);
                 }
             }
@@ -290,6 +482,26 @@ void cwScrapManager::handleRegionReset()
     }
 }
 
+/**
+ * @brief cwScrapManager::handleRegionAboutToReset
+ *
+ * This is called before all the caves in the RegionTreeModel are replaced. This removes
+ * all the scraps in the current region.
+ */
+void cwScrapManager::handleRegionAboutToReset()
+{
+    if(RegionModel->cavingRegion() != nullptr) {
+        foreach(cwCave* cave, RegionModel->cavingRegion()->caves()) {
+            foreach(cwTrip* trip, cave->trips()) {
+                foreach(cwNote* note, trip->notes()->notes()) {
+                    disconnectNote(note);
+                    scrapRemovedHelper(note, 0, note->scraps().size() - 1);
+                }
+            }
+        }
+    }
+}
+
 /**
  * @brief cwScrapManager::inserted
  * @param parent
@@ -423,34 +635,25 @@ void cwScrapManager::updateScrapGeometryHelper(QList<cwScrap *> scraps)
 {
     if(scraps.isEmpty()) { return; }
 
+    bool taskRunning = !TriangulateTask->isReady();
+
     //Union NeedUpdate list with scraps, these are the scraps that need to be updated
     foreach(cwScrap* scrap, scraps) {
-        connect(scrap, SIGNAL(destroyed(QObject*)), this, SLOT(scrapDeleted(QObject*)));
+        connect(scrap, SIGNAL(destroyed(QObject*)), this, SLOT(scrapDeleted(QObject*)), Qt::UniqueConnection);
 
         cwTriangulatedData oldData = scrap->triangulationData();
         oldData.setStale(true);
         scrap->setTriangulationData(oldData);
 
         DirtyScraps.insert(scrap);
-    }
 
-    if(TriangulateTask->isReady()) {
-        //Running
-        QList<cwTriangulateInData> scrapData;
-        WaitingForUpdate.clear();
-
-        foreach(cwScrap* scrap, scraps) {
-            WaitingForUpdate.append(scrap);
-            scrapData.append(mapScrapToTriangulateInData(scrap));
+        if(taskRunning && WaitingForUpdate.contains(scrap)) {
+            ChangedWhileRunning.insert(scrap);
         }
-
-        TriangulateTask->setProjectFilename(Project->filename());
-        TriangulateTask->setScrapData(scrapData);
-        TriangulateTask->start();
-    } else {
-        //Isn't ready!, restart the task
-        TriangulateTask->restart();
     }
+
+    //The task is started, or restarted, once the batch is ready
+    ChangeJournal->markChanged();
 }
 
 /**
@@ -808,11 +1011,14 @@ void cwScrapManager::taskFinished() {
             return;
         }
 
-        //Clear all the scraps that need to be update, because we are updating now
-        foreach(cwScrap* scrap, DirtyScraps) {
-            disconnect(scrap, SIGNAL(destroyed(QObject*)), this, SLOT(scrapDeleted(QObject*)));
+        //Clear the scraps that were just triangulated. Scraps that were edited while the task was
+        //running stay dirty and are run next.
+        foreach(cwScrap* scrap, WaitingForUpdate) {
+            if(DirtyScraps.remove(scrap)) {
+                disconnect(scrap, SIGNAL(destroyed(QObject*)), this, SLOT(scrapDeleted(QObject*)));
+            }
         }
-        DirtyScraps.clear();
+        ChangedWhileRunning.clear();
 
         //Make sure there's the same amount of data
         if(WaitingForUpdate.size() != scrapDataset.size()) {
@@ -841,18 +1047,12 @@ void cwScrapManager::taskFinished() {
 
         DeletedScraps.clear();
 
-        //Removed all cropped image data
+        //Cache the replaced data, this removes the cropped images that can't be reused
         foreach(cwScrap* scrap, validScraps) {
-            cwImage image = scrap->triangulationData().croppedImage();
-            qDebug() << "Image is valid:" << image.isValid();
-            if(image.isValid()) {
-                imagesToRemove.append(image);
-            }
+            cacheTriangulation(scrap, scrap->triangulationData(), &imagesToRemove);
         }
 
-        RemoveImageTask->setImagesToRemove(imagesToRemove);
-        RemoveImageTask->setDatabaseFilename(Project->filename());
-        RemoveImageTask->start(); //This runs in this thread, should be very quick
+        removeImages(imagesToRemove);
 
         for(int i = 0; i < validScraps.size(); i++) {
             cwScrap* scrap = validScraps.at(i);
@@ -863,6 +1063,10 @@ void cwScrapManager::taskFinished() {
             scrap->setTriangulationData(triangleData);
             GLScraps->addScrapToUpdate(scrap);
         }
+
+        if(!DirtyScraps.isEmpty()) {
+            ChangeJournal->markChanged();
+        }
     }
 }
 
@@ -14,6 +14,7 @@
 #include <QSet>
 #include <QWeakPointer>
 #include <QPointer>
+#include <QByteArray>
 
 //Our includes
 class cwCavingRegion;
@@ -32,7 +33,9 @@ class cwTaskManagerModel;
 class cwRegionTreeModel;
 #include "cwNoteStation.h"
 #include "cwTriangulateInData.h"
+#include "cwTriangulatedData.h"
 #include "cwImageProvider.h"
+#include "cwChangeJournal.h"
 
 /**
     The scrap manager listens to changes in the notes and creates all
@@ -58,6 +61,10 @@ public:
     bool automaticUpdate() const;
     void setAutomaticUpdate(bool automaticUpdate);
 
+    cwChangeJournal* changeJournal() const;
+
+    void waitToFinish();
+
 signals:
     void automaticUpdateChanged();
 
@@ -74,11 +81,16 @@ private:
     QList<cwScrap*> WaitingForUpdate; //These are the scraps that are running through task
     QSet<cwScrap*> DirtyScraps; //These are the scraps that need to be updated
     QSet<cwScrap*> DeletedScraps; //All the deleted scraps
+    QSet<cwScrap*> ChangedWhileRunning; //Scraps in WaitingForUpdate that changed after the task started
+
+    //The number of replaced triangulations that each scrap keeps in cwScrap::recentTriangulations(),
+    //so undo and redo don't have to rerun the task
+    static const int MaxCachedMeshes;
 
     //The task that'll be run
-    QThread* TriangulateThread;
     cwTriangulateTask* TriangulateTask;
     cwRemoveImageTask* RemoveImageTask;
+    cwChangeJournal* ChangeJournal; //Batches edits before the triangulation task is run
     cwProject* Project;
     cwTaskManagerModel* TaskManagerModel;
 
@@ -107,9 +119,15 @@ private:
     void addToDeletedScraps(cwScrap* scrap);
 
     bool scrapImagesOkay(cwScrap* scrap);
+    bool imagesOkay(const cwImage& image);
+
+    bool reuseTriangulation(cwScrap* scrap, const QByteArray& inputHash, QList<cwImage>* imagesToRemove);
+    void cacheTriangulation(cwScrap* scrap, const cwTriangulatedData& data, QList<cwImage>* imagesToRemove);
+    void removeImages(const QList<cwImage>& images);
 
 private slots:
     void handleRegionReset();
+    void handleRegionAboutToReset();
 
     void inserted(QModelIndex parent, int begin, int end);
     void removed(QModelIndex parent, int begin, int end);
@@ -133,6 +151,7 @@ private slots:
 
     void updateStationPositionChangedForScraps(QList<cwScrap*> scraps);
     void rerunDirtyScraps();
+    void runDirtyScraps();
 
     void scrapDeleted(QObject* scrap);
 
@@ -159,6 +178,14 @@ inline bool cwScrapManager::automaticUpdate() const {
     return AutomaticUpdate;
 }
 
+/**
+ * @brief cwScrapManager::changeJournal
+ * @return The journal that batches scrap edits. Use this to set the latency or read the coalesced counts
+ */
+inline cwChangeJournal* cwScrapManager::changeJournal() const {
+    return ChangeJournal;
+}
+
 
 
 
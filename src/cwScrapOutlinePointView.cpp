@@ -8,10 +8,13 @@
 //Our includes
 #include "cwScrapOutlinePointView.h"
 #include "cwScrap.h"
+#include "cwScrapItem.h"
 
 cwScrapOutlinePointView::cwScrapOutlinePointView(QQuickItem *parent) :
     cwScrapPointView(parent)
 {
+    //Scraps can have thousands of outline points
+    enablePointLayer();
 }
 
 
@@ -43,8 +46,44 @@ void cwScrapOutlinePointView::setScrap(cwScrap *scrap)
 
 void cwScrapOutlinePointView::updateItemPosition(QQuickItem *item, int pointIndex)
 {
-    QPointF point = Scrap->points().at(pointIndex);
-    item->setProperty("position3D", QVector3D(point));
+    item->setProperty("position3D", pointPosition(pointIndex));
+}
+
+/**
+ * @brief cwScrapOutlinePointView::pointPosition
+ * @return The outline point at pointIndex
+ */
+QVector3D cwScrapOutlinePointView::pointPosition(int pointIndex) const
+{
+    return QVector3D(Scrap->points().at(pointIndex));
+}
+
+/**
+ * @brief cwScrapOutlinePointView::pointLayerPressed
+ *
+ * Same as pressing a ScrapOutlinePoint. Pressing the first point closes the scrap.
+ */
+void cwScrapOutlinePointView::pointLayerPressed(int pointIndex)
+{
+    if(scrapItem() != nullptr) {
+        scrapItem()->setSelected(true);
+    }
+
+    if(pointIndex == 0 && Scrap != nullptr) {
+        Scrap->close();
+    }
+}
+
+/**
+ * @brief cwScrapOutlinePointView::pointLayerMoved
+ *
+ * Moves the outline point while it's dragged in the point layer
+ */
+void cwScrapOutlinePointView::pointLayerMoved(int pointIndex, QVector3D modelPoint)
+{
+    if(Scrap != nullptr) {
+        Scrap->setPoint(pointIndex, modelPoint.toPointF());
+    }
 }
 
 
@@ -25,6 +25,9 @@ public:
 protected:
     virtual QUrl qmlSource() const;
     virtual void updateItemPosition(QQuickItem* item, int pointIndex);
+    virtual QVector3D pointPosition(int pointIndex) const;
+    virtual void pointLayerPressed(int pointIndex);
+    virtual void pointLayerMoved(int pointIndex, QVector3D modelPoint);
     
 public slots:
 
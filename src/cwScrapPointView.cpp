@@ -8,6 +8,7 @@
 #include "cwScrapPointView.h"
 #include "cwScrap.h"
 #include "cwScrapItem.h"
+#include "cwPointLayerItem.h"
 
 cwScrapPointView::cwScrapPointView(QQuickItem *parent) :
     cwAbstractPointManager(parent),
@@ -30,12 +31,34 @@ Sets scrapItem
 */
 void cwScrapPointView::setScrapItem(cwScrapItem* scrapItem) {
     if(ScrapItem != scrapItem) {
+        if(ScrapItem != nullptr) {
+            disconnect(ScrapItem, &cwScrapItem::selectedChanged, this, &cwScrapPointView::updatePointLayerVisibility);
+        }
+
         ScrapItem = scrapItem;
+
+        if(ScrapItem != nullptr) {
+            connect(ScrapItem, &cwScrapItem::selectedChanged, this, &cwScrapPointView::updatePointLayerVisibility);
+        }
+
         updateAllItemData();
+        updatePointLayerVisibility();
         emit scrapItemChanged();
     }
 }
 
+/**
+ * @brief cwScrapPointView::updatePointLayerVisibility
+ *
+ * Like the point items, the point layer is only shown when the scrap is selected
+ */
+void cwScrapPointView::updatePointLayerVisibility()
+{
+    if(pointLayer() != nullptr) {
+        pointLayer()->setVisible(ScrapItem != nullptr && ScrapItem->isSelected());
+    }
+}
+
 void cwScrapPointView::setScrap(cwScrap* scrap) {
     Q_UNUSED(scrap);
     emit scrapChanged();
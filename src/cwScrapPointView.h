@@ -35,6 +35,9 @@ signals:
 
 public slots:
 
+private slots:
+    void updatePointLayerVisibility();
+
 protected:
     cwScrap* Scrap; //!< The scrap this is class keeps track of
 
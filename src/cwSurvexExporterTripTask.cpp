@@ -197,14 +197,16 @@ void cwSurvexExporterTripTask::writeLRUDData(QTextStream& stream, cwTrip* trip)
     foreach(cwSurveyChunk* chunk, trip->chunks()) {
         stream << "*data passage station left right up down ignoreall" << endl;
 
-        foreach(cwStation station, chunk->stations()) {
-            if(station.isValid()) {
+        const cwSurveyChunkColumns& columns = chunk->columns();
+        for(int i = 0; i < columns.stationCount(); i++) {
+            QString name = columns.name(i);
+            if(!name.isEmpty()) {
                 QString dataLine = dataLineTemplate
-                        .arg(station.name(), TextPadding)
-                        .arg(toSupportedLength(station.left(), station.leftInputState()), TextPadding)
-                        .arg(toSupportedLength(station.right(), station.rightInputState()), TextPadding)
-                        .arg(toSupportedLength(station.up(), station.upInputState()), TextPadding)
-                        .arg(toSupportedLength(station.down(), station.downInputState()), TextPadding);
+                        .arg(name, TextPadding)
+                        .arg(toSupportedLength(columns.left().at(i), static_cast<cwDistanceStates::State>(columns.leftStates().at(i))), TextPadding)
+                        .arg(toSupportedLength(columns.right().at(i), static_cast<cwDistanceStates::State>(columns.rightStates().at(i))), TextPadding)
+                        .arg(toSupportedLength(columns.up().at(i), static_cast<cwDistanceStates::State>(columns.upStates().at(i))), TextPadding)
+                        .arg(toSupportedLength(columns.down().at(i), static_cast<cwDistanceStates::State>(columns.downStates().at(i))), TextPadding);
 
                 stream << dataLine << endl;
             }
@@ -317,22 +319,25 @@ void cwSurvexExporterTripTask::writeChunk(QTextStream& stream,
         dataLineTemplate = QString("%1 %2 %3 %4 %5");
     }
 
-    for(int i = 0; i < chunk->stationCount() - 1; i++) {
+    const cwSurveyChunkColumns& columns = chunk->columns();
+    int numberOfShots = qMin(columns.stationCount() - 1, columns.shotCount());
+
+    for(int i = 0; i < numberOfShots; i++) {
 
         //Make sure we can still be run
         if(!parentIsRunning() && !isRunning()) { return; }
 
-        cwStation fromStation = chunk->station(i);
-        cwStation toStation = chunk->station(i + 1);
-        cwShot shot = chunk->shot(i);
+        QString fromStationName = columns.name(i);
+        QString toStationName = columns.name(i + 1);
 
-        if(!fromStation.isValid() || !toStation.isValid()) { continue; }
+        if(fromStationName.isEmpty() || toStationName.isEmpty()) { continue; }
 
-        QString distance = toSupportedLength(shot.distance(), cwDistanceStates::Valid);
-        QString compass = compassToString(shot.compass(), shot.compassState());
-        QString backCompass = compassToString(shot.backCompass(), shot.backCompassState());
-        QString clino = clinoToString(shot.clino(), shot.clinoState());
-        QString backClino = clinoToString(shot.backClino(), shot.backClinoState());
+        QString distance = toSupportedLength(columns.distance().at(i), cwDistanceStates::Valid);
+        QString compass = compassToString(columns.compass().at(i), static_cast<cwCompassStates::State>(columns.compassStates().at(i)));
+        QString backCompass = compassToString(columns.backCompass().at(i), static_cast<cwCompassStates::State>(columns.backCompassStates().at(i)));
+        QString clino = clinoToString(columns.clino().at(i), static_cast<cwClinoStates::State>(columns.clinoStates().at(i)));
+        QString backClino = clinoToString(columns.backClino().at(i), static_cast<cwClinoStates::State>(columns.backClinoStates().at(i)));
+        bool distanceIncluded = columns.distanceIncluded().at(i);
 
         //Make sure the model is good
         if(distance.isEmpty()) { continue; }
@@ -342,15 +347,15 @@ void cwSurvexExporterTripTask::writeChunk(QTextStream& stream,
                     backClino.compare("up", Qt::CaseInsensitive) != 0 &&
                     backClino.compare("down", Qt::CaseInsensitive) != 0) {
                Errors.append(QString("Error: No compass reading for %1 to %2")
-                             .arg(fromStation.name())
-                             .arg(toStation.name()));
+                             .arg(fromStationName)
+                             .arg(toStationName));
            }
         }
 
         if(clino.isEmpty() && backClino.isEmpty()) {
             Errors.append(QString("Error: No Clino reading for %1 to %2")
-                          .arg(fromStation.name())
-                          .arg(toStation.name()));
+                          .arg(fromStationName)
+                          .arg(toStationName));
         }
 
         if(compass.isEmpty()) { compass = "-"; }
@@ -370,8 +375,8 @@ void cwSurvexExporterTripTask::writeChunk(QTextStream& stream,
         QString line;
         if(hasFrontSights && hasBackSights) {
              line = dataLineTemplate
-                    .arg(fromStation.name(), TextPadding)
-                    .arg(toStation.name(), TextPadding)
+                    .arg(fromStationName, TextPadding)
+                    .arg(toStationName, TextPadding)
                     .arg(distance, TextPadding)
                     .arg(compass, TextPadding)
                     .arg(backCompass, TextPadding)
@@ -379,29 +384,29 @@ void cwSurvexExporterTripTask::writeChunk(QTextStream& stream,
                     .arg(backClino, TextPadding);
         } else if(hasFrontSights) {
             line = dataLineTemplate
-                   .arg(fromStation.name(), TextPadding)
-                   .arg(toStation.name(), TextPadding)
+                   .arg(fromStationName, TextPadding)
+                   .arg(toStationName, TextPadding)
                    .arg(distance, TextPadding)
                    .arg(compass, TextPadding)
                    .arg(clino, TextPadding);
         } else if(hasBackSights) {
             line = dataLineTemplate
-                   .arg(fromStation.name(), TextPadding)
-                   .arg(toStation.name(), TextPadding)
+                   .arg(fromStationName, TextPadding)
+                   .arg(toStationName, TextPadding)
                    .arg(distance, TextPadding)
                    .arg(backCompass, TextPadding)
                    .arg(backClino, TextPadding);
         }
 
         //Distance should be excluded, mark as duplicate
-        if(!shot.isDistanceIncluded()) {
+        if(!distanceIncluded) {
             stream << "*flags duplicate" << endl;
         }
 
         stream << line << endl;
 
         //Turn duplication off
-        if(!shot.isDistanceIncluded()) {
+        if(!distanceIncluded) {
             stream << "*flags not duplicate" << endl;
         }
 
@@ -32,6 +32,8 @@
 cwSurveyChunk::cwSurveyChunk(QObject * parent) :
     QObject(parent),
     ErrorModel(new cwErrorModel(this)),
+    UnshownFatalCount(0),
+    UnshownWarningCount(0),
     ParentTrip(nullptr)
 {
 
@@ -45,21 +47,20 @@ cwSurveyChunk::cwSurveyChunk(QObject * parent) :
 cwSurveyChunk::cwSurveyChunk(const cwSurveyChunk& chunk) :
     QObject(),
     ErrorModel(new cwErrorModel(this)),
+    UnshownFatalCount(0),
+    UnshownWarningCount(0),
     ParentTrip(nullptr)
 {
 
-    //Copy all the stations
-    Stations = chunk.Stations;
-
-    //Copy all the shots
-    Shots = chunk.Shots;
+    //Copy all the stations and shots, the columns are implicitly shared
+    Columns = chunk.Columns;
 }
 
 /**
   \brief Checks if the survey Chunk is valid
   */
 bool cwSurveyChunk::isValid() const {
-    return (Stations.size() - 1) == Shots.size() && !Stations.empty() && !Shots.empty();
+    return (Columns.stationCount() - 1) == Columns.shotCount() && Columns.stationCount() > 0 && Columns.shotCount() > 0;
 }
 
 /**
@@ -70,7 +71,7 @@ cwCave* cwSurveyChunk::parentCave() const {
 }
 
 int cwSurveyChunk::stationCount() const {
-    return Stations.count();
+    return Columns.stationCount();
 }
 
 /**
@@ -136,18 +137,18 @@ void cwSurveyChunk::setParentTrip(cwTrip* trip) {
 
 cwStation cwSurveyChunk::station(int index) const {
     if(stationIndexCheck(index)) {
-        return Stations[index];
+        return Columns.station(index);
     }
     return cwStation();
 }
 
 int cwSurveyChunk::shotCount() const {
-    return Shots.size();
+    return Columns.shotCount();
 }
 
 cwShot cwSurveyChunk::shot(int index) const {
     if(shotIndexCheck(index)) {
-        return Shots[index];
+        return Columns.shot(index);
     }
     return cwShot();
 }
@@ -160,29 +161,29 @@ cwShot cwSurveyChunk::shot(int index) const {
   */
 void cwSurveyChunk::appendNewShot() {
     //Check for special case
-    if(!isValid() && Stations.size() <= 2 && Shots.size() <= 1) {
+    if(!isValid() && Columns.stationCount() <= 2 && Columns.shotCount() <= 1) {
         //Make valid
-        for(int i = Stations.size(); i < 2; i++) {
-            Stations.append(cwStation());
+        for(int i = Columns.stationCount(); i < 2; i++) {
+            Columns.appendStation(cwStation());
             emit stationsAdded(i, i);
         }
 
-        if(Shots.size() != 1) {
-            Shots.append(cwShot());
+        if(Columns.shotCount() != 1) {
+            Columns.appendShot(cwShot());
             emit shotsAdded(0, 0);
         }
 
-        checkForStationError(Stations.size() - 2);
-        checkForStationError(Stations.size() - 1);
-        checkForShotError(Shots.size() - 1);
+        checkForStationError(Columns.stationCount() - 2);
+        checkForStationError(Columns.stationCount() - 1);
+        checkForShotError(Columns.shotCount() - 1);
 
         return;
     }
 
 
     cwStation fromStation;
-    if(!Stations.isEmpty()) {
-        fromStation = Stations.last();
+    if(Columns.stationCount() > 0) {
+        fromStation = Columns.station(Columns.stationCount() - 1);
         if(!fromStation.isValid()) {
             return;
         }
@@ -209,22 +210,22 @@ void cwSurveyChunk::appendShot(cwStation fromStation, cwStation toStation, cwSho
     if(!canAddShot(fromStation, toStation)) { return; }
 
     int index;
-    int firstIndex = Stations.size();
-    if(Stations.empty()) {
-        Stations.append(fromStation);
-        checkForStationError(Stations.size() - 1);
+    int firstIndex = Columns.stationCount();
+    if(Columns.stationCount() == 0) {
+        Columns.appendStation(fromStation);
+        checkForStationError(Columns.stationCount() - 1);
     }
 
-    index = Shots.size();
-    Shots.append(shot);
+    index = Columns.shotCount();
+    Columns.appendShot(shot);
     emit shotsAdded(index, index);
 
-    index = Stations.size();
-    Stations.append(toStation);
+    index = Columns.stationCount();
+    Columns.appendStation(toStation);
     emit stationsAdded(firstIndex, index);
 
-    checkForStationError(Stations.size() - 1);
-    checkForShotError(Shots.size() - 1);
+    checkForStationError(Columns.stationCount() - 1);
+    checkForShotError(Columns.shotCount() - 1);
 }
 
 /**
@@ -236,34 +237,31 @@ void cwSurveyChunk::appendShot(cwStation fromStation, cwStation toStation, cwSho
   This will create a new chunk, that the caller is responsible for deleting
   */
 cwSurveyChunk* cwSurveyChunk::splitAtStation(int stationIndex) {
-    if(stationIndex < 1 || stationIndex >= Stations.size()) { return nullptr; }
+    if(stationIndex < 1 || stationIndex >= Columns.stationCount()) { return nullptr; }
 
     cwSurveyChunk* newChunk = new cwSurveyChunk(this);
-    newChunk->Stations.append(cwStation()); //Add an empty station to the front
+    newChunk->Columns.appendStation(cwStation()); //Add an empty station to the front
 
     //Copy the points from one chunk to another
-    for(int i = stationIndex; i < Stations.size(); i++) {
+    for(int i = stationIndex; i < Columns.stationCount(); i++) {
 
         //Get the current stations and shots
-        cwStation station = Stations[i];
+        cwStation station = Columns.station(i);
         cwShot currentShot = shot(i - 1);
 
-        newChunk->Stations.append(station);
+        newChunk->Columns.appendStation(station);
         if(currentShot.isValid()) {
-            newChunk->Shots.append(currentShot);
+            newChunk->Columns.appendShot(currentShot);
         }
     }
 
-    int stationEnd = Stations.size() - 1;
-    int shotEnd = Shots.size() - 1;
+    int stationEnd = Columns.stationCount() - 1;
+    int shotEnd = Columns.shotCount() - 1;
 
 
     //Remove the stations and shots from the list
     int shotIndex = stationIndex - 1;
-    QList<cwStation>::iterator stationIter = Stations.begin() + stationIndex;
-    QList<cwShot>::iterator shotIter = Shots.begin() + shotIndex;
-    Stations.erase(stationIter, Stations.end());
-    Shots.erase(shotIter, Shots.end());
+    Columns.resize(stationIndex, shotIndex);
 
     emit stationsRemoved(stationIndex, stationEnd);
     emit shotsRemoved(shotIndex, shotEnd);
@@ -290,8 +288,8 @@ cwSurveyChunk* cwSurveyChunk::splitAtStation(int stationIndex) {
 
   */
 void cwSurveyChunk::insertStation(int stationIndex, Direction direction) {
-    if(Stations.empty()) { appendNewShot(); return; }
-    if(stationIndex < 0 || stationIndex >= Stations.size()) { return; }
+    if(Columns.stationCount() == 0) { appendNewShot(); return; }
+    if(stationIndex < 0 || stationIndex >= Columns.stationCount()) { return; }
 
     int shotIndex = stationIndex;
 
@@ -301,8 +299,8 @@ void cwSurveyChunk::insertStation(int stationIndex, Direction direction) {
 
     cwStation station;
 
-    Stations.insert(stationIndex, station);
-    Shots.insert(shotIndex, cwShot());
+    Columns.insertStation(stationIndex, station);
+    Columns.insertShot(shotIndex, cwShot());
 
     emit stationsAdded(stationIndex, stationIndex);
     emit shotsAdded(shotIndex, shotIndex);
@@ -317,8 +315,8 @@ void cwSurveyChunk::insertStation(int stationIndex, Direction direction) {
   at index + 1.  A station will also be added as well
   */
 void cwSurveyChunk::insertShot(int shotIndex, Direction direction) {
-    if(Stations.empty()) { appendNewShot(); return; }
-    if(shotIndex < 0 || shotIndex >= Stations.size()) { return; }
+    if(Columns.stationCount() == 0) { appendNewShot(); return; }
+    if(shotIndex < 0 || shotIndex >= Columns.stationCount()) { return; }
 
     int stationIndex = shotIndex + 1;
 
@@ -328,10 +326,10 @@ void cwSurveyChunk::insertShot(int shotIndex, Direction direction) {
 
     cwStation station;
 
-    Stations.insert(stationIndex, station);
+    Columns.insertStation(stationIndex, station);
     emit stationsAdded(stationIndex, stationIndex);
 
-    Shots.insert(shotIndex, cwShot());
+    Columns.insertShot(shotIndex, cwShot());
     emit shotsAdded(shotIndex, shotIndex);
 
     updateErrors();
@@ -345,7 +343,8 @@ void cwSurveyChunk::insertShot(int shotIndex, Direction direction) {
   */
 bool cwSurveyChunk::canAddShot(const cwStation& fromStation, const cwStation& toStation) {
     Q_UNUSED(toStation);
-    return Stations.empty() || Stations.last().name().compare(fromStation.name(), Qt::CaseInsensitive) == 0;
+    return Columns.stationCount() == 0 ||
+            Columns.name(Columns.stationCount() - 1).compare(fromStation.name(), Qt::CaseInsensitive) == 0;
 }
 
 ///**
@@ -498,26 +497,27 @@ bool cwSurveyChunk::isShotRole(cwSurveyChunk::DataRole role) const {
   */
 QString cwSurveyChunk::guessLastStationName() const {
     //Need a least two stations for this to work.
-    if(stations().size() < 2) {
+    if(Columns.stationCount() < 2) {
         return QString();
     }
 
-    if(stations().last().name().isEmpty()) {
+    if(Columns.name(Columns.stationCount() - 1).isEmpty()) {
         QString stationName;
 
-        if(stations().size() == 2) {
+        if(Columns.stationCount() == 2) {
             //Try to get the station name from the previous chunk
             QList<cwSurveyChunk*> chunks = parentTrip()->chunks();
             int index = chunks.indexOf(const_cast<cwSurveyChunk*>(this)) - 1;
             cwSurveyChunk* previousChunk = parentTrip()->chunk(index);
-            if(previousChunk != nullptr) {
-                stationName = previousChunk->stations().last().name();
+            if(previousChunk != nullptr && previousChunk->stationCount() > 0) {
+                const cwSurveyChunkColumns& previousColumns = previousChunk->columns();
+                stationName = previousColumns.name(previousColumns.stationCount() - 1);
             }
         }
 
         if(stationName.isEmpty()) {
-            int secondToLastStation = stations().size() - 2;
-            stationName = stations().at(secondToLastStation).name();
+            int secondToLastStation = Columns.stationCount() - 2;
+            stationName = Columns.name(secondToLastStation);
         }
 
         QString nextStation = guessNextStation(stationName);
@@ -556,8 +556,8 @@ QString cwSurveyChunk::guessNextStation(QString stationName) const {
  * If the index is out of range, this function will do nothing
  */
 void cwSurveyChunk::setStation(cwStation station, int index){
-    if(index < 0 || index >= Stations.size()) { return; }
-    Stations[index] = station;
+    if(index < 0 || index >= Columns.stationCount()) { return; }
+    Columns.setStation(index, station);
     dataChanged(StationNameRole, index);
     dataChanged(StationLeftRole, index);
     dataChanged(StationRightRole, index);
@@ -581,23 +581,23 @@ bool cwSurveyChunk::isStationAndShotsEmpty() const
         return true;
     }
 
-    foreach(cwStation station, Stations) {
-        if(!station.name().isEmpty() ||
-                station.leftInputState() != cwDistanceStates::Empty ||
-                station.rightInputState() != cwDistanceStates::Empty ||
-                station.upInputState() != cwDistanceStates::Empty ||
-                station.downInputState() != cwDistanceStates::Empty)
+    for(int i = 0; i < Columns.stationCount(); i++) {
+        if(!Columns.name(i).isEmpty() ||
+                Columns.leftStates().at(i) != cwDistanceStates::Empty ||
+                Columns.rightStates().at(i) != cwDistanceStates::Empty ||
+                Columns.upStates().at(i) != cwDistanceStates::Empty ||
+                Columns.downStates().at(i) != cwDistanceStates::Empty)
         {
             return false;
         }
     }
 
-    foreach(cwShot shot, Shots) {
-        if(shot.distanceState() != cwDistanceStates::Empty ||
-                shot.backCompassState() != cwCompassStates::Empty ||
-                shot.compassState() != cwCompassStates::Empty ||
-                shot.clinoState() != cwClinoStates::Empty ||
-                shot.backClinoState() != cwClinoStates::Empty)
+    for(int i = 0; i < Columns.shotCount(); i++) {
+        if(Columns.distanceStates().at(i) != cwDistanceStates::Empty ||
+                Columns.backCompassStates().at(i) != cwCompassStates::Empty ||
+                Columns.compassStates().at(i) != cwCompassStates::Empty ||
+                Columns.clinoStates().at(i) != cwClinoStates::Empty ||
+                Columns.backClinoStates().at(i) != cwClinoStates::Empty)
         {
             return false;
         }
@@ -623,31 +623,30 @@ QVariant cwSurveyChunk::data(DataRole role, int index) const {
   \brief Helper function to data
   */
 QVariant cwSurveyChunk::stationData(DataRole role, int index) const {
-    if(index < 0 || index >= Stations.size()) { return QVariant(); }
-
-    const cwStation& station = Stations[index];
+    if(index < 0 || index >= Columns.stationCount()) { return QVariant(); }
 
+    //Read straight from the columns, without creating a cwStation
     switch (role) {
     case StationNameRole:
-        return station.name();
+        return Columns.name(index);
     case StationLeftRole:
-        if(station.leftInputState() == cwDistanceStates::Valid) {
-            return QString::number(station.left(), 'g', -1);
+        if(Columns.leftStates().at(index) == cwDistanceStates::Valid) {
+            return QString::number(Columns.left().at(index), 'g', -1);
         }
         break;
     case StationRightRole:
-        if(station.rightInputState() == cwDistanceStates::Valid) {
-            return QString::number(station.right(), 'g', -1);
+        if(Columns.rightStates().at(index) == cwDistanceStates::Valid) {
+            return QString::number(Columns.right().at(index), 'g', -1);
         }
         break;
     case StationUpRole:
-        if(station.upInputState() == cwDistanceStates::Valid) {
-            return QString::number(station.up(), 'g', -1);
+        if(Columns.upStates().at(index) == cwDistanceStates::Valid) {
+            return QString::number(Columns.up().at(index), 'g', -1);
         }
         break;
     case StationDownRole:
-        if(station.downInputState() == cwDistanceStates::Valid) {
-            return QString::number(station.down(), 'g', -1);
+        if(Columns.downStates().at(index) == cwDistanceStates::Valid) {
+            return QString::number(Columns.down().at(index), 'g', -1);
         }
         break;
     default:
@@ -660,32 +659,31 @@ QVariant cwSurveyChunk::stationData(DataRole role, int index) const {
   \brief Helper function to data
   */
 QVariant cwSurveyChunk::shotData(DataRole role, int index) const {
-    if(index < 0 || index >= Shots.size()) { return QVariant(); }
-
-    const cwShot& shot = Shots[index];
+    if(index < 0 || index >= Columns.shotCount()) { return QVariant(); }
 
+    //Read straight from the columns, without creating a cwShot
     switch(role) {
     case ShotDistanceRole:
-        if(shot.distanceState() == cwDistanceStates::Valid) {
-            return QString::number(shot.distance(), 'g', -1);
+        if(Columns.distanceStates().at(index) == cwDistanceStates::Valid) {
+            return QString::number(Columns.distance().at(index), 'g', -1);
         }
         break;
     case ShotDistanceIncludedRole:
-        return shot.isDistanceIncluded();
+        return static_cast<bool>(Columns.distanceIncluded().at(index));
     case ShotCompassRole:
-        if(shot.compassState() == cwCompassStates::Valid) {
-            return QString::number(shot.compass(), 'g', -1);
+        if(Columns.compassStates().at(index) == cwCompassStates::Valid) {
+            return QString::number(Columns.compass().at(index), 'g', -1);
         }
         break;
     case ShotBackCompassRole:
-        if(shot.backCompassState() == cwCompassStates::Valid) {
-            return QString::number(shot.backCompass(), 'g', -1);
+        if(Columns.backCompassStates().at(index) == cwCompassStates::Valid) {
+            return QString::number(Columns.backCompass().at(index), 'g', -1);
         }
         break;
     case ShotClinoRole: {
-        switch(shot.clinoState()) {
+        switch(static_cast<cwClinoStates::State>(Columns.clinoStates().at(index))) {
         case cwClinoStates::Valid:
-            return QString::number(shot.clino(), 'g', -1);
+            return QString::number(Columns.clino().at(index), 'g', -1);
         case cwClinoStates::Empty:
             return QVariant();
         case cwClinoStates::Down:
@@ -696,9 +694,9 @@ QVariant cwSurveyChunk::shotData(DataRole role, int index) const {
         break;
     }
     case ShotBackClinoRole:
-        switch(shot.backClinoState()) {
+        switch(static_cast<cwClinoStates::State>(Columns.backClinoStates().at(index))) {
         case cwClinoStates::Valid:
-            return QString::number(shot.backClino(), 'g', -1);
+            return QString::number(Columns.backClino().at(index), 'g', -1);
         case cwClinoStates::Empty:
             return QVariant();
         case cwClinoStates::Down:
@@ -717,7 +715,7 @@ QVariant cwSurveyChunk::shotData(DataRole role, int index) const {
   \brief Sets the station's data for role, index, and data
   */
 void cwSurveyChunk::setStationData(cwSurveyChunk::DataRole role, int index, const QVariant& data) {
-    if(index < 0 || index >= Stations.size()) {
+    if(index < 0 || index >= Columns.stationCount()) {
         qDebug() << QString("Can't set station data for role \"%1\" at index: \"%2\" with data: \"%3\"")
                     .arg(role).arg(index).arg(data.toString()) << LOCATION;
         return;
@@ -728,34 +726,33 @@ void cwSurveyChunk::setStationData(cwSurveyChunk::DataRole role, int index, cons
         return;
     }
 
+    //The station's setters do the validation, the result is written back into the columns
     QString dataString = data.toString();
-    cwStation& station = Stations[index];
-
+    cwStation station = Columns.station(index);
     switch (role) {
     case StationNameRole:
         station.setName(dataString);
-        emit dataChanged(role, index);
         break;
     case StationLeftRole:
         station.setLeft(dataString);
-        emit dataChanged(role, index);
         break;
     case StationRightRole:
         station.setRight(dataString);
-        emit dataChanged(role, index);
         break;
     case StationUpRole:
         station.setUp(dataString);
-        emit dataChanged(role, index);
         break;
     case StationDownRole:
         station.setDown(dataString);
-        emit dataChanged(role, index);
         break;
     default:
         qDebug() << "Can't find role:" << role << LOCATION;
+        return;
     }
 
+    Columns.setStation(index, station);
+    emit dataChanged(role, index);
+
     checkForErrorOnDataChanged(role, index);
 
 }
@@ -764,7 +761,7 @@ void cwSurveyChunk::setStationData(cwSurveyChunk::DataRole role, int index, cons
   \brief Sets the shot's data for role, index, and data
   */
 void cwSurveyChunk::setShotData(cwSurveyChunk::DataRole role, int index, const QVariant& data) {
-    if(index < 0 || index >= Shots.size()) {
+    if(index < 0 || index >= Columns.shotCount()) {
         qDebug() << QString("Can't set shot data for role \"%1\" at index: \"%2\" with data: \"%3\"")
                     .arg(role).arg(index).arg(data.toString()) << LOCATION;
         return;
@@ -775,37 +772,35 @@ void cwSurveyChunk::setShotData(cwSurveyChunk::DataRole role, int index, const Q
         return;
     }
 
-    cwShot& shot = Shots[index];
-
+    //The shot's setters do the validation, the result is written back into the columns
+    cwShot shot = Columns.shot(index);
     switch(role) {
     case ShotDistanceRole:
         shot.setDistance(data.toString());
-        emit dataChanged(role, index);
         break;
     case ShotDistanceIncludedRole:
         shot.setDistanceIncluded(data.toBool());
-        emit dataChanged(role, index);
         break;
     case ShotCompassRole:
         shot.setCompass(data.toString());
-        emit dataChanged(role, index);
         break;
     case ShotBackCompassRole:
         shot.setBackCompass(data.toString());
-        emit dataChanged(role, index);
         break;
     case ShotClinoRole:
         shot.setClino(data.toString());
-        emit dataChanged(role, index);
         break;
     case ShotBackClinoRole:
         shot.setBackClino(data.toString());
-        emit  dataChanged(role, index);
         break;
     default:
         qDebug() << "Can't find role:" << role << LOCATION;
+        return;
     }
 
+    Columns.setShot(index, shot);
+    emit dataChanged(role, index);
+
     checkForErrorOnDataChanged(role, index);
 }
 
@@ -880,18 +875,63 @@ void cwSurveyChunk::checkForErrorOnDataChanged(cwSurveyChunk::DataRole role, int
     default:
         break;
     }
+
+    updateErrorCounts();
 }
 
 /**
  * @brief cwSurveyChunk::checkForError
  * @param role - The role that will be checked
- * @param index - The index o
+ * @param index - The index of the station or shot
+ *
+ * Updates the errors for a single cell. If the cell's errors changed, this emits errorsChanged().
+ * The running error counts are updated for this cell only, call updateErrorCounts() after
+ * checking all the cells to push them to the chunk's error model.
  */
 void cwSurveyChunk::checkForError(cwSurveyChunk::DataRole role, int index)
 {
-    Q_UNUSED(role)
-    Q_UNUSED(index)
+    //Shots appended to the end of the chunk don't go through updateErrors()
+    resizeCellErrors(StationErrors, Columns.stationCount() * NumberOfStationRoles, NumberOfStationRoles, StationNameRole);
+    resizeCellErrors(ShotErrors, Columns.shotCount() * NumberOfShotRoles, NumberOfShotRoles, ShotDistanceRole);
+
+    int offset = errorCellOffset(role, index);
+    if(offset < 0) { return; }
 
+    QList<cwError> errors = checkCell(role, index);
+
+    CellErrors& cell = isStationRole(role) ? StationErrors[offset] : ShotErrors[offset];
+    if(cell.Errors == errors) {
+        return;
+    }
+
+    CellIndex cellIndex(index, role);
+    cwErrorModel* cellModel = CellErrorModels.value(cellIndex, nullptr);
+
+    if(cellModel == nullptr) {
+        addErrorCounts(cell, -1);
+        cell = CellErrors(errors);
+        addErrorCounts(cell, 1);
+    } else {
+        //The cell is counted through its model
+        cell = CellErrors(errors);
+        if(errors.isEmpty()) {
+            removeCellErrorModel(cellIndex);
+        } else {
+            setCellErrorModel(cellModel, errors);
+        }
+    }
+
+    emit errorsChanged(role, index);
+}
+
+/**
+ * @brief cwSurveyChunk::checkCell
+ * @param role - The role that will be checked
+ * @param index - The index of the station or shot
+ * @return All the errors for the cell
+ */
+QList<cwError> cwSurveyChunk::checkCell(cwSurveyChunk::DataRole role, int index) const
+{
     QList<cwError> errors;
 
     switch(role) {
@@ -934,62 +974,113 @@ void cwSurveyChunk::checkForError(cwSurveyChunk::DataRole role, int index)
         break;
     }
 
-    CellIndex cellIndex = CellIndex(index, role);
-    cwErrorModel* cellModel = nullptr;
-    if(!CellErrorModels.contains(cellIndex) && !errors.isEmpty()) {
-        cellModel = new cwErrorModel(ErrorModel);
-        cellModel->setParentModel(ErrorModel);
-        CellErrorModels.insert(cellIndex, cellModel);
+    return errors;
+}
+
+/**
+ * @brief cwSurveyChunk::errorCellOffset
+ * @return The offset of the cell in StationErrors or ShotErrors, or -1 if index is out of range
+ */
+int cwSurveyChunk::errorCellOffset(cwSurveyChunk::DataRole role, int index) const
+{
+    int offset = -1;
+    if(isStationRole(role)) {
+        if(!stationIndexCheck(index)) { return -1; }
+        offset = index * NumberOfStationRoles + (role - StationNameRole);
+        return offset < StationErrors.size() ? offset : -1;
     } else {
-        cellModel = CellErrorModels.value(cellIndex, nullptr);
+        if(!shotIndexCheck(index)) { return -1; }
+        offset = index * NumberOfShotRoles + (role - ShotDistanceRole);
+        return offset < ShotErrors.size() ? offset : -1;
     }
+}
 
+/**
+ * @brief cwSurveyChunk::setCellErrorModel
+ * @param cellModel - A cell model that's been created by errorsAt()
+ * @param errors - The cell's new errors
+ */
+void cwSurveyChunk::setCellErrorModel(cwErrorModel *cellModel, const QList<cwError> &errors)
+{
+    if(cellModel->errors()->toList() != errors) {
+        cellModel->errors()->clear();
+        cellModel->errors()->append(errors);
+    }
+}
+
+/**
+ * @brief cwSurveyChunk::removeCellErrorModel
+ *
+ * Deletes the cell's model and clears it from the database of errors
+ */
+void cwSurveyChunk::removeCellErrorModel(const CellIndex &cellIndex)
+{
+    cwErrorModel* cellModel = CellErrorModels.take(cellIndex);
     if(cellModel != nullptr) {
-        if(errors.isEmpty()) {
-            //Delete the cellModel and clear it from the database of errors
-            cellModel->setParentModel(nullptr);
-            cellModel->deleteLater();
-            CellErrorModels.remove(cellIndex);
-        }  else {
-            //Clear the previous errors
-            if(cellModel->errors()->toList() != errors) {
-                cellModel->errors()->clear();
-                cellModel->errors()->append(errors);
-                emit errorsChanged(role, index);
-            }
+        cellModel->setParentModel(nullptr);
+        cellModel->deleteLater();
+    }
+}
+
+/**
+ * @brief cwSurveyChunk::resizeCellErrors
+ * @param cells - StationErrors or ShotErrors
+ * @param size - The new number of cells
+ *
+ * Cells that are cut off are removed from the running error counts
+ */
+void cwSurveyChunk::resizeCellErrors(QVector<CellErrors> &cells, int size, int rolesPerRow, DataRole firstRole)
+{
+    if(cells.size() == size) { return; }
+
+    for(int i = size; i < cells.size(); i++) {
+        CellIndex cellIndex(i / rolesPerRow, firstRole + i % rolesPerRow);
+        if(!CellErrorModels.contains(cellIndex)) {
+            addErrorCounts(cells.at(i), -1);
         }
     }
+
+    cells.resize(size);
 }
 
 /**
- * @brief cwSurveyChunk::checkForStationError
- * @param index
+ * @brief cwSurveyChunk::addErrorCounts
+ * @param cell - The cell that's added to, or removed from, the running error counts
+ * @param sign - 1 to add the cell's errors, -1 to remove them
  */
-void cwSurveyChunk::checkForStationError(int index)
+void cwSurveyChunk::addErrorCounts(const CellErrors &cell, int sign)
 {
-    Q_ASSERT(index >= 0);
-    Q_ASSERT(index < Stations.size());
-    checkForError(StationNameRole, index);
-    checkForError(StationLeftRole, index);
-    checkForError(StationRightRole, index);
-    checkForError(StationUpRole, index);
-    checkForError(StationDownRole, index);
+    UnshownFatalCount += sign * cell.FatalCount;
+    UnshownWarningCount += sign * cell.WarningCount;
 }
 
 /**
- * @brief cwSurveyChunk::checkForShotError
- * @param index
+ * @brief cwSurveyChunk::updateErrorCounts
+ *
+ * Updates ErrorModel's counts with the errors of all the cells that don't have a cwErrorModel.
+ * Cells with a cwErrorModel are counted through ErrorModel's child models.
  */
-void cwSurveyChunk::checkForShotError(int index)
+void cwSurveyChunk::updateErrorCounts()
 {
-    Q_ASSERT(index >= 0);
-    Q_ASSERT(index < Shots.size());
-    checkForError(ShotDistanceRole, index);
-    checkForError(ShotDistanceIncludedRole, index);
-    checkForError(ShotCompassRole, index);
-    checkForError(ShotBackCompassRole, index);
-    checkForError(ShotClinoRole, index);
-    checkForError(ShotBackClinoRole, index);
+    ErrorModel->setExternalCounts(UnshownFatalCount, UnshownWarningCount);
+}
+
+/**
+ * @brief cwSurveyChunk::CellErrors::CellErrors
+ * @param errors - The errors for the cell
+ */
+cwSurveyChunk::CellErrors::CellErrors(const QList<cwError> &errors) :
+    FatalCount(0),
+    WarningCount(0),
+    Errors(errors)
+{
+    foreach(const cwError& error, Errors) {
+        if(error.type() == cwError::Fatal) {
+            FatalCount++;
+        } else if(error.type() == cwError::Warning && !error.suppressed()) {
+            WarningCount++;
+        }
+    }
 }
 
 /**
@@ -1314,18 +1405,79 @@ bool cwSurveyChunk::isStationDataEmpty(int index) const
 
 
 /**
- * @brief cwSurveyChunk::updateErrorIndexes
+ * @brief cwSurveyChunk::updateErrors
+ *
+ * Validates the whole chunk. This is called when stations and shots are added or removed.
+ *
+ * All the cells are checked into new error arrays first. Then only the cells that changed
+ * emit errorsChanged(), and the cell models that the editor is showing are updated. The running
+ * error counts are recounted from the new arrays.
  */
 void cwSurveyChunk::updateErrors()
 {
     clearErrors();
 
-    for(int i = 0; i < Shots.size(); i++) {
-        checkForShotError(i);
+    QVector<CellErrors> stationErrors(Columns.stationCount() * NumberOfStationRoles);
+    QVector<CellErrors> shotErrors(Columns.shotCount() * NumberOfShotRoles);
+
+    UnshownFatalCount = 0;
+    UnshownWarningCount = 0;
+
+    for(int i = 0; i < Columns.stationCount(); i++) {
+        for(int r = 0; r < NumberOfStationRoles; r++) {
+            DataRole role = static_cast<DataRole>(StationNameRole + r);
+            CellErrors& cell = stationErrors[i * NumberOfStationRoles + r];
+            cell = CellErrors(checkCell(role, i));
+            addErrorCounts(cell, 1);
+        }
     }
 
-    for(int i = 0; i < Stations.size(); i++) {
-        checkForStationError(i);
+    for(int i = 0; i < Columns.shotCount(); i++) {
+        for(int r = 0; r < NumberOfShotRoles; r++) {
+            DataRole role = static_cast<DataRole>(ShotDistanceRole + r);
+            CellErrors& cell = shotErrors[i * NumberOfShotRoles + r];
+            cell = CellErrors(checkCell(role, i));
+            addErrorCounts(cell, 1);
+        }
+    }
+
+    //Find the cells that have changed
+    QList<CellIndex> changedCells;
+    auto findChanged = [&](const QVector<CellErrors>& oldCells, const QVector<CellErrors>& newCells,
+            int rolesPerRow, DataRole firstRole)
+    {
+        int size = qMax(oldCells.size(), newCells.size());
+        for(int i = 0; i < size; i++) {
+            bool oldHasErrors = i < oldCells.size() && !oldCells.at(i).Errors.isEmpty();
+            bool newHasErrors = i < newCells.size() && !newCells.at(i).Errors.isEmpty();
+            if(!oldHasErrors && !newHasErrors) { continue; }
+            if(oldHasErrors && newHasErrors && oldCells.at(i).Errors == newCells.at(i).Errors) { continue; }
+            changedCells.append(CellIndex(i / rolesPerRow, firstRole + i % rolesPerRow));
+        }
+    };
+
+    findChanged(StationErrors, stationErrors, NumberOfStationRoles, StationNameRole);
+    findChanged(ShotErrors, shotErrors, NumberOfShotRoles, ShotDistanceRole);
+
+    StationErrors = stationErrors;
+    ShotErrors = shotErrors;
+
+    //Update the cell models, removing the models that no longer have errors
+    foreach(CellIndex cellIndex, CellErrorModels.keys()) {
+        int offset = errorCellOffset(cellIndex.role(), cellIndex.index());
+        const QVector<CellErrors>& cells = isStationRole(cellIndex.role()) ? StationErrors : ShotErrors;
+        if(offset < 0 || cells.at(offset).Errors.isEmpty()) {
+            removeCellErrorModel(cellIndex);
+        } else {
+            setCellErrorModel(CellErrorModels.value(cellIndex), cells.at(offset).Errors);
+            addErrorCounts(cells.at(offset), -1); //Counted through the model
+        }
+    }
+
+    updateErrorCounts();
+
+    foreach(CellIndex cellIndex, changedCells) {
+        emit errorsChanged(cellIndex.role(), cellIndex.index());
     }
 }
 
@@ -1376,6 +1528,7 @@ void cwSurveyChunk::updateCompassErrors()
    for(int i = 0; i < shotCount(); i++) {
        checkForError(ShotCompassRole, i);
    }
+   updateErrorCounts();
 }
 
 /**
@@ -1389,6 +1542,7 @@ void cwSurveyChunk::updateClinoErrors()
     for(int i = 0; i < shotCount(); i++) {
         checkForError(ShotClinoRole, i);
     }
+    updateErrorCounts();
 }
 
 /**
@@ -1402,6 +1556,7 @@ void cwSurveyChunk::updateCompassClinoErrors()
        checkForError(ShotClinoRole, i);
        checkForError(ShotBackClinoRole, i);
    }
+   updateErrorCounts();
 }
 
 /**
@@ -1459,14 +1614,37 @@ void cwSurveyChunk::setData(DataRole role, int index, QVariant data) {
 //}
 
 /**
- * @brief cwSurveyChunk::error
+ * @brief cwSurveyChunk::errorsAt
  * @param role
  * @param index
- * @return Returns the error at index with role.
+ * @return Returns the error model for the cell at index with role, or nullptr if the cell
+ * doesn't have any errors. The model is created the first time it's asked for, usually when
+ * the survey editor shows the cell.
  */
-cwErrorModel* cwSurveyChunk::errorsAt(int index, cwSurveyChunk::DataRole role) const
+cwErrorModel* cwSurveyChunk::errorsAt(int index, cwSurveyChunk::DataRole role)
 {
-    return CellErrorModels.value(CellIndex(index, role), nullptr);
+    CellIndex cellIndex(index, role);
+    cwErrorModel* cellModel = CellErrorModels.value(cellIndex, nullptr);
+    if(cellModel != nullptr) {
+        return cellModel;
+    }
+
+    int offset = errorCellOffset(role, index);
+    if(offset < 0) { return nullptr; }
+
+    const CellErrors& cell = isStationRole(role) ? StationErrors.at(offset) : ShotErrors.at(offset);
+    if(cell.Errors.isEmpty()) { return nullptr; }
+
+    //Create the model the first time the cell is shown, the cell is now counted through the model
+    cellModel = new cwErrorModel(ErrorModel);
+    cellModel->errors()->append(cell.Errors);
+    cellModel->setParentModel(ErrorModel);
+    CellErrorModels.insert(cellIndex, cellModel);
+
+    addErrorCounts(cell, -1);
+    updateErrorCounts();
+
+    return cellModel;
 }
 
 ///**
@@ -1496,10 +1674,10 @@ cwErrorModel* cwSurveyChunk::errorsAt(int index, cwSurveyChunk::DataRole role) c
   This does no bounds checking!!!
   */
 void cwSurveyChunk::remove(int stationIndex, int shotIndex) {
-    Stations.removeAt(stationIndex);
+    Columns.removeStation(stationIndex);
     emit stationsRemoved(stationIndex, stationIndex);
 
-    Shots.removeAt(shotIndex);
+    Columns.removeShot(shotIndex);
     emit shotsRemoved(shotIndex, shotIndex);
 }
 
@@ -1551,8 +1729,8 @@ int cwSurveyChunk::index(int index, Direction direction) {
 bool cwSurveyChunk::hasStation(QString stationName) const {
 
     //Linear search...
-    foreach(cwStation station, Stations) {
-        if(station.name().compare(stationName, Qt::CaseInsensitive) == 0) {
+    for(int i = 0; i < Columns.stationCount(); i++) {
+        if(Columns.name(i).compare(stationName, Qt::CaseInsensitive) == 0) {
             return true;
         }
     }
@@ -1595,8 +1773,8 @@ QSet<cwStation> cwSurveyChunk::neighboringStations(QString stationName) const {
   */
 QList<int> cwSurveyChunk::indicesOfStation(QString stationName) const {
     QList<int> indices;
-    for(int i = 0; i < Stations.size(); i++) {
-        if(Stations[i].name().compare(stationName, Qt::CaseInsensitive) == 0) {
+    for(int i = 0; i < Columns.stationCount(); i++) {
+        if(Columns.name(i).compare(stationName, Qt::CaseInsensitive) == 0) {
             indices.append(i);
         }
     }
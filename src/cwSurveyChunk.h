@@ -14,6 +14,7 @@
 #include "cwShot.h"
 #include "cwError.h"
 #include "cwGlobals.h"
+#include "cwSurveyChunkColumns.h"
 class cwErrorModel;
 class cwTrip;
 class cwCave;
@@ -23,6 +24,8 @@ class cwCave;
 #include <QList>
 //#include <QDeclarativeListProperty>
 #include <QVariant>
+#include <QVector>
+#include <QMap>
 
 class CAVEWHERE_LIB_EXPORT cwSurveyChunk : public QObject {
     Q_OBJECT
@@ -73,6 +76,7 @@ public:
 
     QList<cwStation> stations() const;
     QList<cwShot> shots() const;
+    const cwSurveyChunkColumns& columns() const;
 
     bool hasStation(QString stationName) const;
     QSet<cwStation> neighboringStations(QString stationName) const;
@@ -139,7 +143,7 @@ public slots:
     void setData(DataRole role, int index, QVariant data);
 
 //    QVariantList errors() const;
-    cwErrorModel* errorsAt(int index, DataRole role) const;
+    cwErrorModel* errorsAt(int index, DataRole role);
 //    void setSuppressWarning(cwError warning, bool suppress);
 
 
@@ -157,24 +161,53 @@ private:
             return Index < other.Index;
         }
 
+        int index() const { return Index; }
+        DataRole role() const { return static_cast<DataRole>(Role); }
+
     private:
         int Index;
         int Role;
     };
 
-    QList<cwStation> Stations;
-    QList<cwShot> Shots;
+    /**
+     * The errors for one cell. Cells without errors don't allocate anything.
+     */
+    class CellErrors {
+    public:
+        CellErrors() : FatalCount(0), WarningCount(0) {}
+        CellErrors(const QList<cwError>& errors);
+
+        int FatalCount;
+        int WarningCount; //Unsuppressed warnings
+        QList<cwError> Errors;
+    };
+
+    static const int NumberOfStationRoles = 5; //StationNameRole to StationDownRole
+    static const int NumberOfShotRoles = 6; //ShotDistanceRole to ShotBackClinoRole
+
+    //All the station and shot data, cwStation and cwShot are only created when asked for
+    cwSurveyChunkColumns Columns;
 
     cwErrorModel* ErrorModel;
+
+    //Errors for each cell, NumberOfStationRoles per station and NumberOfShotRoles per shot
+    QVector<CellErrors> StationErrors;
+    QVector<CellErrors> ShotErrors;
+
+    //Only created when a cell is shown, see errorsAt()
     QMap<CellIndex, cwErrorModel*> CellErrorModels;
 
+    //Errors of the cells that don't have a model in CellErrorModels
+    int UnshownFatalCount;
+    int UnshownWarningCount;
+
 
     cwTrip* ParentTrip;
     bool Editting; //!< Puts the survey chunk in a edditing state, this will try to keep a empty shot at the end of the chunk
     ConnectedState IsConnectedState; //!<
 
-    bool shotIndexCheck(int index) const { return index >= 0 && index < Shots.count();  }
-    bool stationIndexCheck(int index) const { return index >= 0 && index < Stations.count(); }
+    bool shotIndexCheck(int index) const { return index >= 0 && index < Columns.shotCount();  }
+    bool stationIndexCheck(int index) const { return index >= 0 && index < Columns.stationCount(); }
 
     void remove(int stationIndex, int shotIndex);
     int index(int index, Direction direction);
@@ -191,8 +224,13 @@ private:
 
     void checkForErrorOnDataChanged(DataRole role, int index);
     void checkForError(DataRole role, int index);
-    void checkForStationError(int index);
-    void checkForShotError(int index);
+    QList<cwError> checkCell(DataRole role, int index) const;
+    int errorCellOffset(DataRole role, int index) const;
+    void setCellErrorModel(cwErrorModel* cellModel, const QList<cwError>& errors);
+    void removeCellErrorModel(const CellIndex& cellIndex);
+    void resizeCellErrors(QVector<CellErrors>& cells, int size, int rolesPerRow, DataRole firstRole);
+    void addErrorCounts(const CellErrors& cell, int sign);
+    void updateErrorCounts();
     QList<cwError> checkLRUDError(cwSurveyChunk::DataRole role, int index) const;
     QList<cwError> checkDataError(cwSurveyChunk::DataRole role, int index) const;
     QList<cwError> checkWithTolerance(cwSurveyChunk::DataRole frontSightRole, cwSurveyChunk::DataRole backSightRole, int index, double tolerance = 2.0, QString units = "°") const;
@@ -225,19 +263,32 @@ inline cwTrip* cwSurveyChunk::parentTrip() const {
 /**
   \brief Gets all the stations
 
+  This creates a cwStation for every station, use columns() to read through all the stations.
   You shouldn't modify the station data from this list
   */
 inline QList<cwStation> cwSurveyChunk::stations() const {
-    return Stations;
+    return Columns.stations();
 }
 
 /**
   \brief Gets all the shot date
 
+  This creates a cwShot for every shot, use columns() to read through all the shots.
   You shouldn't modify the shot data from this list
   */
 inline QList<cwShot> cwSurveyChunk::shots() const {
-    return Shots;
+    return Columns.shots();
+}
+
+/**
+ * @brief cwSurveyChunk::columns
+ * @return The station and shot data of the chunk as contiguous columns
+ *
+ * This is useful for code that reads every station or shot in the chunk, like statistics
+ * and exporters.
+ */
+inline const cwSurveyChunkColumns& cwSurveyChunk::columns() const {
+    return Columns;
 }
 
 
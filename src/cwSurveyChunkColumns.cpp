@@ -0,0 +1,303 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwSurveyChunkColumns.h"
+
+cwSurveyChunkColumns::cwSurveyChunkColumns()
+{
+}
+
+/**
+ * @brief cwSurveyChunkColumns::includedDistance
+ * @param numberOfShots - If not null, this is set to the number of shots that were added up
+ * @return The sum of all the valid shot distances that are included in the length
+ */
+double cwSurveyChunkColumns::includedDistance(int *numberOfShots) const
+{
+    double distance = 0.0;
+    int count = 0;
+
+    const double* distances = Distance.constData();
+    const quint8* states = DistanceStates.constData();
+    const quint8* included = DistanceIncluded.constData();
+
+    for(int i = 0; i < Distance.size(); i++) {
+        if(states[i] == cwDistanceStates::Valid && included[i]) {
+            distance += distances[i];
+            count++;
+        }
+    }
+
+    if(numberOfShots != nullptr) {
+        *numberOfShots = count;
+    }
+
+    return distance;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::station
+ * @return The station at stationIndex
+ */
+cwStation cwSurveyChunkColumns::station(int stationIndex) const
+{
+    cwStation station(name(stationIndex));
+    station.setLeft(Left.at(stationIndex));
+    station.setLeftInputState(static_cast<cwDistanceStates::State>(LeftStates.at(stationIndex)));
+    station.setRight(Right.at(stationIndex));
+    station.setRightInputState(static_cast<cwDistanceStates::State>(RightStates.at(stationIndex)));
+    station.setUp(Up.at(stationIndex));
+    station.setUpInputState(static_cast<cwDistanceStates::State>(UpStates.at(stationIndex)));
+    station.setDown(Down.at(stationIndex));
+    station.setDownInputState(static_cast<cwDistanceStates::State>(DownStates.at(stationIndex)));
+    return station;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::shot
+ * @return The shot at shotIndex
+ */
+cwShot cwSurveyChunkColumns::shot(int shotIndex) const
+{
+    cwShot shot;
+    shot.setDistance(Distance.at(shotIndex));
+    shot.setDistanceState(static_cast<cwDistanceStates::State>(DistanceStates.at(shotIndex)));
+    shot.setCompass(Compass.at(shotIndex));
+    shot.setCompassState(static_cast<cwCompassStates::State>(CompassStates.at(shotIndex)));
+    shot.setBackCompass(BackCompass.at(shotIndex));
+    shot.setBackCompassState(static_cast<cwCompassStates::State>(BackCompassStates.at(shotIndex)));
+    shot.setClino(Clino.at(shotIndex));
+    shot.setClinoState(static_cast<cwClinoStates::State>(ClinoStates.at(shotIndex)));
+    shot.setBackClino(BackClino.at(shotIndex));
+    shot.setBackClinoState(static_cast<cwClinoStates::State>(BackClinoStates.at(shotIndex)));
+    shot.setDistanceIncluded(DistanceIncluded.at(shotIndex));
+    return shot;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::stations
+ * @return All the stations, this creates a cwStation for each one
+ */
+QList<cwStation> cwSurveyChunkColumns::stations() const
+{
+    QList<cwStation> stations;
+    stations.reserve(stationCount());
+    for(int i = 0; i < stationCount(); i++) {
+        stations.append(station(i));
+    }
+    return stations;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::shots
+ * @return All the shots, this creates a cwShot for each one
+ */
+QList<cwShot> cwSurveyChunkColumns::shots() const
+{
+    QList<cwShot> shots;
+    shots.reserve(shotCount());
+    for(int i = 0; i < shotCount(); i++) {
+        shots.append(shot(i));
+    }
+    return shots;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::insertStation
+ * @param stationIndex - Where the station is inserted, from 0 to stationCount()
+ * @param station - The station that's copied into the columns
+ */
+void cwSurveyChunkColumns::insertStation(int stationIndex, const cwStation &station)
+{
+    Q_ASSERT(stationIndex >= 0 && stationIndex <= stationCount());
+
+    NameIds.insert(stationIndex, nameId(station.name()));
+    Left.insert(stationIndex, station.left());
+    Right.insert(stationIndex, station.right());
+    Up.insert(stationIndex, station.up());
+    Down.insert(stationIndex, station.down());
+    LeftStates.insert(stationIndex, station.leftInputState());
+    RightStates.insert(stationIndex, station.rightInputState());
+    UpStates.insert(stationIndex, station.upInputState());
+    DownStates.insert(stationIndex, station.downInputState());
+}
+
+/**
+ * @brief cwSurveyChunkColumns::setStation
+ * @param stationIndex - The station that's replaced
+ * @param station - The station that's copied into the columns
+ */
+void cwSurveyChunkColumns::setStation(int stationIndex, const cwStation &station)
+{
+    NameIds[stationIndex] = nameId(station.name());
+    Left[stationIndex] = station.left();
+    Right[stationIndex] = station.right();
+    Up[stationIndex] = station.up();
+    Down[stationIndex] = station.down();
+    LeftStates[stationIndex] = station.leftInputState();
+    RightStates[stationIndex] = station.rightInputState();
+    UpStates[stationIndex] = station.upInputState();
+    DownStates[stationIndex] = station.downInputState();
+
+    compactNames();
+}
+
+/**
+ * @brief cwSurveyChunkColumns::removeStation
+ * @param stationIndex - The station that's removed
+ */
+void cwSurveyChunkColumns::removeStation(int stationIndex)
+{
+    NameIds.remove(stationIndex);
+    Left.remove(stationIndex);
+    Right.remove(stationIndex);
+    Up.remove(stationIndex);
+    Down.remove(stationIndex);
+    LeftStates.remove(stationIndex);
+    RightStates.remove(stationIndex);
+    UpStates.remove(stationIndex);
+    DownStates.remove(stationIndex);
+
+    compactNames();
+}
+
+/**
+ * @brief cwSurveyChunkColumns::insertShot
+ * @param shotIndex - Where the shot is inserted, from 0 to shotCount()
+ * @param shot - The shot that's copied into the columns
+ */
+void cwSurveyChunkColumns::insertShot(int shotIndex, const cwShot &shot)
+{
+    Q_ASSERT(shotIndex >= 0 && shotIndex <= shotCount());
+
+    Distance.insert(shotIndex, shot.distance());
+    Compass.insert(shotIndex, shot.compass());
+    BackCompass.insert(shotIndex, shot.backCompass());
+    Clino.insert(shotIndex, shot.clino());
+    BackClino.insert(shotIndex, shot.backClino());
+    DistanceStates.insert(shotIndex, shot.distanceState());
+    CompassStates.insert(shotIndex, shot.compassState());
+    BackCompassStates.insert(shotIndex, shot.backCompassState());
+    ClinoStates.insert(shotIndex, shot.clinoState());
+    BackClinoStates.insert(shotIndex, shot.backClinoState());
+    DistanceIncluded.insert(shotIndex, shot.isDistanceIncluded());
+}
+
+/**
+ * @brief cwSurveyChunkColumns::setShot
+ * @param shotIndex - The shot that's replaced
+ * @param shot - The shot that's copied into the columns
+ */
+void cwSurveyChunkColumns::setShot(int shotIndex, const cwShot &shot)
+{
+    Distance[shotIndex] = shot.distance();
+    Compass[shotIndex] = shot.compass();
+    BackCompass[shotIndex] = shot.backCompass();
+    Clino[shotIndex] = shot.clino();
+    BackClino[shotIndex] = shot.backClino();
+    DistanceStates[shotIndex] = shot.distanceState();
+    CompassStates[shotIndex] = shot.compassState();
+    BackCompassStates[shotIndex] = shot.backCompassState();
+    ClinoStates[shotIndex] = shot.clinoState();
+    BackClinoStates[shotIndex] = shot.backClinoState();
+    DistanceIncluded[shotIndex] = shot.isDistanceIncluded();
+}
+
+/**
+ * @brief cwSurveyChunkColumns::removeShot
+ * @param shotIndex - The shot that's removed
+ */
+void cwSurveyChunkColumns::removeShot(int shotIndex)
+{
+    Distance.remove(shotIndex);
+    Compass.remove(shotIndex);
+    BackCompass.remove(shotIndex);
+    Clino.remove(shotIndex);
+    BackClino.remove(shotIndex);
+    DistanceStates.remove(shotIndex);
+    CompassStates.remove(shotIndex);
+    BackCompassStates.remove(shotIndex);
+    ClinoStates.remove(shotIndex);
+    BackClinoStates.remove(shotIndex);
+    DistanceIncluded.remove(shotIndex);
+}
+
+/**
+ * @brief cwSurveyChunkColumns::resize
+ * @param numberOfStations - Must be less or equal to stationCount()
+ * @param numberOfShots - Must be less or equal to shotCount()
+ *
+ * Removes the stations and shots at the end of the columns
+ */
+void cwSurveyChunkColumns::resize(int numberOfStations, int numberOfShots)
+{
+    Q_ASSERT(numberOfStations <= stationCount());
+    Q_ASSERT(numberOfShots <= shotCount());
+
+    NameIds.resize(numberOfStations);
+    Left.resize(numberOfStations);
+    Right.resize(numberOfStations);
+    Up.resize(numberOfStations);
+    Down.resize(numberOfStations);
+    LeftStates.resize(numberOfStations);
+    RightStates.resize(numberOfStations);
+    UpStates.resize(numberOfStations);
+    DownStates.resize(numberOfStations);
+
+    Distance.resize(numberOfShots);
+    Compass.resize(numberOfShots);
+    BackCompass.resize(numberOfShots);
+    Clino.resize(numberOfShots);
+    BackClino.resize(numberOfShots);
+    DistanceStates.resize(numberOfShots);
+    CompassStates.resize(numberOfShots);
+    BackCompassStates.resize(numberOfShots);
+    ClinoStates.resize(numberOfShots);
+    BackClinoStates.resize(numberOfShots);
+    DistanceIncluded.resize(numberOfShots);
+
+    compactNames();
+}
+
+/**
+ * @brief cwSurveyChunkColumns::nameId
+ * @param name - The station name
+ * @return The id of the name in the name table. The name is added if it isn't in the table.
+ */
+int cwSurveyChunkColumns::nameId(const QString &name)
+{
+    int id = NameToId.value(name, -1);
+    if(id == -1) {
+        id = Names.size();
+        Names.append(name);
+        NameToId.insert(name, id);
+    }
+    return id;
+}
+
+/**
+ * @brief cwSurveyChunkColumns::compactNames
+ *
+ * Typing a station name adds a name for every key press, and removed stations leave their
+ * names behind. This removes the names that aren't used, once the table is twice as big
+ * as it needs to be.
+ */
+void cwSurveyChunkColumns::compactNames()
+{
+    if(Names.size() <= stationCount() * 2 + 16) {
+        return;
+    }
+
+    QStringList oldNames = Names;
+    Names.clear();
+    NameToId.clear();
+
+    for(int i = 0; i < NameIds.size(); i++) {
+        NameIds[i] = nameId(oldNames.at(NameIds.at(i)));
+    }
+}
@@ -0,0 +1,162 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWSURVEYCHUNKCOLUMNS_H
+#define CWSURVEYCHUNKCOLUMNS_H
+
+//Our includes
+#include "cwStation.h"
+#include "cwShot.h"
+#include "cwReadingStates.h"
+#include "cwGlobals.h"
+
+//Qt includes
+#include <QVector>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+
+/**
+ * @brief The cwSurveyChunkColumns class
+ *
+ * The storage of a survey chunk's stations and shots. Each reading is a contiguous array of
+ * doubles with a parallel array of state bytes, and station names are stored as ids into a
+ * table of unique names. Statistics and exporters can stream over the columns without going
+ * through QVariant, or a cwStation and cwShot for every reading.
+ *
+ * cwStation and cwShot are only created when they're asked for, with station() and shot().
+ * Edits are written back with setStation() and setShot(), so the value types still do all
+ * the validation.
+ */
+class CAVEWHERE_LIB_EXPORT cwSurveyChunkColumns
+{
+public:
+    cwSurveyChunkColumns();
+
+    int stationCount() const;
+    int shotCount() const;
+
+    //Stations
+    QString name(int stationIndex) const;
+    const QVector<int>& nameIds() const;
+    const QStringList& names() const;
+
+    const QVector<double>& left() const;
+    const QVector<double>& right() const;
+    const QVector<double>& up() const;
+    const QVector<double>& down() const;
+    const QVector<quint8>& leftStates() const;
+    const QVector<quint8>& rightStates() const;
+    const QVector<quint8>& upStates() const;
+    const QVector<quint8>& downStates() const;
+
+    //Shots
+    const QVector<double>& distance() const;
+    const QVector<double>& compass() const;
+    const QVector<double>& backCompass() const;
+    const QVector<double>& clino() const;
+    const QVector<double>& backClino() const;
+    const QVector<quint8>& distanceStates() const;
+    const QVector<quint8>& compassStates() const;
+    const QVector<quint8>& backCompassStates() const;
+    const QVector<quint8>& clinoStates() const;
+    const QVector<quint8>& backClinoStates() const;
+    const QVector<quint8>& distanceIncluded() const;
+
+    double includedDistance(int* numberOfShots = nullptr) const;
+
+    cwStation station(int stationIndex) const;
+    cwShot shot(int shotIndex) const;
+    QList<cwStation> stations() const;
+    QList<cwShot> shots() const;
+
+    void insertStation(int stationIndex, const cwStation& station);
+    void appendStation(const cwStation& station);
+    void setStation(int stationIndex, const cwStation& station);
+    void removeStation(int stationIndex);
+
+    void insertShot(int shotIndex, const cwShot& shot);
+    void appendShot(const cwShot& shot);
+    void setShot(int shotIndex, const cwShot& shot);
+    void removeShot(int shotIndex);
+
+    void resize(int numberOfStations, int numberOfShots);
+
+private:
+    QStringList Names;
+    QHash<QString, int> NameToId;
+    QVector<int> NameIds;
+
+    QVector<double> Left;
+    QVector<double> Right;
+    QVector<double> Up;
+    QVector<double> Down;
+    QVector<quint8> LeftStates;
+    QVector<quint8> RightStates;
+    QVector<quint8> UpStates;
+    QVector<quint8> DownStates;
+
+    QVector<double> Distance;
+    QVector<double> Compass;
+    QVector<double> BackCompass;
+    QVector<double> Clino;
+    QVector<double> BackClino;
+    QVector<quint8> DistanceStates;
+    QVector<quint8> CompassStates;
+    QVector<quint8> BackCompassStates;
+    QVector<quint8> ClinoStates;
+    QVector<quint8> BackClinoStates;
+    QVector<quint8> DistanceIncluded;
+
+    int nameId(const QString& name);
+    void compactNames();
+};
+
+inline int cwSurveyChunkColumns::stationCount() const { return NameIds.size(); }
+inline int cwSurveyChunkColumns::shotCount() const { return Distance.size(); }
+
+/**
+ * @brief cwSurveyChunkColumns::name
+ * @return The name of the station at stationIndex
+ */
+inline QString cwSurveyChunkColumns::name(int stationIndex) const {
+    return Names.at(NameIds.at(stationIndex));
+}
+
+inline const QVector<int>& cwSurveyChunkColumns::nameIds() const { return NameIds; }
+inline const QStringList& cwSurveyChunkColumns::names() const { return Names; }
+
+inline const QVector<double>& cwSurveyChunkColumns::left() const { return Left; }
+inline const QVector<double>& cwSurveyChunkColumns::right() const { return Right; }
+inline const QVector<double>& cwSurveyChunkColumns::up() const { return Up; }
+inline const QVector<double>& cwSurveyChunkColumns::down() const { return Down; }
+inline const QVector<quint8>& cwSurveyChunkColumns::leftStates() const { return LeftStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::rightStates() const { return RightStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::upStates() const { return UpStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::downStates() const { return DownStates; }
+
+inline const QVector<double>& cwSurveyChunkColumns::distance() const { return Distance; }
+inline const QVector<double>& cwSurveyChunkColumns::compass() const { return Compass; }
+inline const QVector<double>& cwSurveyChunkColumns::backCompass() const { return BackCompass; }
+inline const QVector<double>& cwSurveyChunkColumns::clino() const { return Clino; }
+inline const QVector<double>& cwSurveyChunkColumns::backClino() const { return BackClino; }
+inline const QVector<quint8>& cwSurveyChunkColumns::distanceStates() const { return DistanceStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::compassStates() const { return CompassStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::backCompassStates() const { return BackCompassStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::clinoStates() const { return ClinoStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::backClinoStates() const { return BackClinoStates; }
+inline const QVector<quint8>& cwSurveyChunkColumns::distanceIncluded() const { return DistanceIncluded; }
+
+inline void cwSurveyChunkColumns::appendStation(const cwStation &station) {
+    insertStation(stationCount(), station);
+}
+
+inline void cwSurveyChunkColumns::appendShot(const cwShot &shot) {
+    insertShot(shotCount(), shot);
+}
+
+#endif // CWSURVEYCHUNKCOLUMNS_H
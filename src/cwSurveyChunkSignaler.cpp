@@ -37,6 +37,8 @@ void cwSurveyChunkSignaler::setRegion(cwCavingRegion* region) {
         //Connect all signal from the region
         connect(Region.data(), &cwCavingRegion::insertedCaves, this, &cwSurveyChunkSignaler::connectAddedCaves);
         connect(Region.data(), &cwCavingRegion::beginRemoveCaves, this, &cwSurveyChunkSignaler::disconnectRemovedCaves);
+        connect(Region.data(), &cwCavingRegion::modelAboutToBeReset, this, &cwSurveyChunkSignaler::disconnectAllCaves);
+        connect(Region.data(), &cwCavingRegion::modelReset, this, &cwSurveyChunkSignaler::connectAllCaves);
 
         //Connect all sub data
         connectCaves(Region);
@@ -302,6 +304,16 @@ void cwSurveyChunkSignaler::connectAddedCaves(int beginIndex, int endIndex)
     }
 }
 
+/**
+ * @brief cwSurveyChunkSignaler::connectAllCaves
+ *
+ * Called when the region's caves have been replaced
+ */
+void cwSurveyChunkSignaler::connectAllCaves()
+{
+    connectCaves(Region);
+}
+
 /**
  * @brief cwSurveyChunkSignaler::connectAddedTrips
  * @param beginIndex
@@ -348,6 +360,18 @@ void cwSurveyChunkSignaler::disconnectRemovedCaves(int beginIndex, int endIndex)
     }
 }
 
+/**
+ * @brief cwSurveyChunkSignaler::disconnectAllCaves
+ *
+ * Called before the region's caves are replaced
+ */
+void cwSurveyChunkSignaler::disconnectAllCaves()
+{
+    foreach(cwCave* cave, Region->caves()) {
+        disconnectCave(cave);
+    }
+}
+
 /**
  * @brief cwSurveyChunkSignaler::disconnectRemovedTrips
  * @param beginIndex
@@ -99,10 +99,12 @@ private:
 
 private slots:
    void connectAddedCaves(int beginIndex, int endIndex);
+   void connectAllCaves();
    void connectAddedTrips(int beginIndex, int endIndex);
    void connectAddedChunks(int beginIndex, int endIndex);
 
    void disconnectRemovedCaves(int beginIndex, int endIndex);
+   void disconnectAllCaves();
    void disconnectRemovedTrips(int beginIndex, int endIndex);
    void disconnectRemovedChunks(int beginIndex, int endIndex);
 
@@ -25,11 +25,9 @@
 #include <QMenu>
 #include <QItemSelectionModel>
 #include <QDebug>
-#include <QThread>
 
 cwSurveyExportManager::cwSurveyExportManager(QObject *parent) :
-    QObject(parent),
-    ExportThread(new QThread(this))
+    QObject(parent)
 {
 }
 
@@ -37,8 +35,10 @@ cwSurveyExportManager::cwSurveyExportManager(QObject *parent) :
     Destructor
   */
 cwSurveyExportManager::~cwSurveyExportManager() {
-    ExportThread->exit();
-    ExportThread->wait();
+    foreach(cwTask* exportTask, ExportTasks) {
+        exportTask->stopAndWait();
+        delete exportTask;
+    }
 }
 
 /**
@@ -56,10 +56,7 @@ void cwSurveyExportManager::exportSurvexRegion(QString filename) {
     cwSurvexExporterRegionTask* exportTask = new cwSurvexExporterRegionTask();
     exportTask->setOutputFile(filename);
     exportTask->setData(*cavingRegion());
-    connect(exportTask, SIGNAL(finished()), SLOT(exporterFinished()));
-    connect(exportTask, SIGNAL(stopped()), SLOT(exporterFinished()));
-    exportTask->setThread(ExportThread);
-    exportTask->start();
+    startExportTask(exportTask);
 }
 
 /**
@@ -76,10 +73,7 @@ void cwSurveyExportManager::exportSurvexCave(QString filename) {
         cwSurvexExporterCaveTask* exportTask = new cwSurvexExporterCaveTask();
         exportTask->setOutputFile(filename);
         exportTask->setData(*cave);
-        connect(exportTask, SIGNAL(finished()), SLOT(exporterFinished()));
-        connect(exportTask, SIGNAL(stopped()), SLOT(exporterFinished()));
-        exportTask->setThread(ExportThread);
-        exportTask->start();
+        startExportTask(exportTask);
     }
 }
 
@@ -96,10 +90,7 @@ void cwSurveyExportManager::exportSurvexTrip(QString filename) {
         cwSurvexExporterTripTask* exportTask = new cwSurvexExporterTripTask();
         exportTask->setOutputFile(filename);
         exportTask->setData(*trip);
-        connect(exportTask, SIGNAL(finished()), SLOT(exporterFinished()));
-        connect(exportTask, SIGNAL(stopped()), SLOT(exporterFinished()));
-        exportTask->setThread(ExportThread);
-        exportTask->start();
+        startExportTask(exportTask);
     }
 }
 
@@ -117,10 +108,7 @@ void cwSurveyExportManager::exportCaveToCompass(QString filename) {
         cwCompassExportCaveTask* exportTask = new cwCompassExportCaveTask();
         exportTask->setOutputFile(filename);
         exportTask->setData(*cave);
-        connect(exportTask, SIGNAL(finished()), SLOT(exporterFinished()));
-        connect(exportTask, SIGNAL(stopped()), SLOT(exporterFinished()));
-        exportTask->setThread(ExportThread);
-        exportTask->start();
+        startExportTask(exportTask);
     }
 }
 
@@ -129,10 +117,26 @@ void cwSurveyExportManager::exportCaveToCompass(QString filename) {
   */
 void cwSurveyExportManager::exporterFinished() {
     if(sender()) {
+        ExportTasks.removeOne(static_cast<cwTask*>(sender()));
         sender()->deleteLater();
     }
 }
 
+/**
+  \brief Runs the exportTask on a background thread
+
+  The task is deleted once it's finished. If the manager is deleted first, the
+  destructor stops the task and waits for it.
+  */
+void cwSurveyExportManager::startExportTask(cwTask *exportTask)
+{
+    connect(exportTask, SIGNAL(finished()), SLOT(exporterFinished()));
+    connect(exportTask, SIGNAL(stopped()), SLOT(exporterFinished()));
+    ExportTasks.append(exportTask);
+    exportTask->setThread(cwTaskScheduler::Background);
+    exportTask->start();
+}
+
 /**
   Updates the current menu action with the current value of the
   selection model
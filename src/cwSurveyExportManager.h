@@ -11,9 +11,11 @@
 //Qt includes
 #include <QObject>
 #include <QPointer>
+#include <QList>
 class QThread;
 
 //Our includes
+class cwTask;
 class cwCave;
 class cwTrip;
 class cwCavingRegion;
@@ -73,8 +75,9 @@ private:
     QPointer<cwCave> Cave; //!<
     QPointer<cwCavingRegion> CavingRegion; //!<
 
-    //The thread that the exporting runs on
-    QThread* ExportThread;
+    QList<cwTask*> ExportTasks; //!< The exports that haven't finished
+
+    void startExportTask(cwTask* exportTask);
 
     void updateCaveActions(const QModelIndex& index);
     void updateTripActions(const QModelIndex& index);
@@ -19,27 +19,23 @@
 
 //Qt includes
 #include <QFileDialog>
-#include <QThread>
 #include <QSettings>
 
 cwSurveyImportManager::cwSurveyImportManager(QObject *parent) :
     QObject(parent),
-    ImportThread(new QThread()),
     CavingRegion(nullptr),
     CompassImporter(new cwCompassImporter()),
     MessageListFont(QFontDatabase::systemFont(QFontDatabase::FixedFont))
 {
-    CompassImporter->setThread(ImportThread);
+    CompassImporter->setThread(cwTaskScheduler::Background);
     connect(CompassImporter, &cwCompassImporter::finished, this, &cwSurveyImportManager::compassImporterFinished);
     connect(CompassImporter, &cwCompassImporter::statusMessage, this, &cwSurveyImportManager::compassMessages);
 }
 
 cwSurveyImportManager::~cwSurveyImportManager()
 {
-    ImportThread->quit();
-    ImportThread->wait();
-    ImportThread->deleteLater();
-    CompassImporter->deleteLater();
+    CompassImporter->stopAndWait();
+    delete CompassImporter;
 }
 
 void cwSurveyImportManager::setCavingRegion(cwCavingRegion *region)
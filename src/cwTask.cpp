@@ -8,6 +8,7 @@
 //Our includes
 #include "cwTask.h"
 #include "cwDebug.h"
+#include "cwTaskTracer.h"
 
 //Qt includes
 #include <QMutexLocker>
@@ -26,8 +27,16 @@ cwTask::cwTask(QObject *parent) :
     CurrentStatus = Ready;
     ParentTask = nullptr;
     NeedsRestart = false;
+    QueuedTime = -1;
+    StartTime = -1;
+    AcquiredThread = nullptr;
+}
 
-
+cwTask::~cwTask()
+{
+    if(AcquiredThread != nullptr) {
+        cwTaskScheduler::instance()->releaseThread(AcquiredThread);
+    }
 }
 
 /**
@@ -67,11 +76,28 @@ void cwTask::setParentTask(cwTask* parentTask) {
   This will move the object to that thread using the meta object system
   */
 void cwTask::setThread(QThread* threadToRunOn, Qt::ConnectionType connectionType) {
+    if(AcquiredThread != nullptr) {
+        cwTaskScheduler::instance()->releaseThread(AcquiredThread);
+        AcquiredThread = nullptr;
+    }
+
     threadToRunOn->start();
     QMetaObject::invokeMethod(this, "changeThreads", connectionType,
                               Q_ARG(QThread*, threadToRunOn));
 }
 
+/**
+  \brief Runs the task on one of cwTaskScheduler's shared threads
+
+  The scheduler picks the least busy thread for priority. The thread is released
+  when the task is deleted or moved to another thread.
+  */
+void cwTask::setThread(cwTaskScheduler::Priority priority, Qt::ConnectionType connectionType) {
+    QThread* thread = cwTaskScheduler::instance()->acquireThread(priority);
+    setThread(thread, connectionType);
+    AcquiredThread = thread;
+}
+
 /**
   \brief Gets the number of steps for a task
 
@@ -143,6 +169,8 @@ void cwTask::start() {
 
         //Make sure we are preparing to start
         CurrentStatus = PreparingToStart;
+        QueuedTime = cwTaskTracer::instance()->timestamp();
+        StartTime = -1;
         emit preparingToStart();
     }
 
@@ -221,14 +249,17 @@ void cwTask::done() {
 
     //If the task is still running, this means that the task has finished, without error
     if(CurrentStatus == Restart) {
+        traceSpan("restarted");
         CurrentStatus = Ready;
         emit stopped();
         emit shouldRerun();
     } else if(CurrentStatus == Stopped) {
+        traceSpan("stopped");
         privateStop();
         CurrentStatus = Ready;
         emit stopped();
     } else if(CurrentStatus == Running) {
+        traceSpan("finished");
         CurrentStatus = Ready;
         emit finished();
     }
@@ -262,6 +293,7 @@ void cwTask::startOnCurrentThread() {
 
         //Make sure we are preparing to start
         CurrentStatus = Running;
+        StartTime = cwTaskTracer::instance()->timestamp();
 
         NeedsRestart = false;
     }
@@ -327,6 +359,37 @@ bool cwTask::needsRestart() const
     return NeedsRestart;
 }
 
+/**
+ * @brief cwTask::traceSpan
+ * @param status - How the task ended
+ *
+ * Records how long this task waited and ran into cwTaskTracer. This should only be
+ * called from done(), with the StatusLocker locked.
+ */
+void cwTask::traceSpan(QString status)
+{
+    cwTaskTracer* tracer = cwTaskTracer::instance();
+    if(!tracer->isEnabled()) { return; }
+
+    cwTaskTracer::Span span;
+    span.Name = name();
+    span.Status = status;
+    span.TaskId = reinterpret_cast<quintptr>(this);
+    if(ParentTask != nullptr) {
+        span.ParentTaskId = reinterpret_cast<quintptr>(ParentTask);
+        span.ParentName = ParentTask->name();
+    }
+    span.Thread = QThread::currentThread();
+    span.ThreadName = span.Thread->objectName();
+    span.QueuedTime = QueuedTime;
+    span.StartTime = StartTime;
+    span.EndTime = tracer->timestamp();
+    tracer->addSpan(span);
+
+    QueuedTime = -1;
+    StartTime = -1;
+}
+
 /**
 * @brief cwTask::setName
 * @param name - The new name of the task
@@ -369,6 +432,33 @@ void cwTask::waitToFinish(unsigned long time)
     Q_ASSERT(isReady());
 }
 
+/**
+ * @brief cwTask::stopAndWait
+ *
+ * Stops the task and blocks until the task's thread is no longer running it. The task is then
+ * moved to the calling thread, so it can be deleted there.
+ *
+ * Unlike waitToFinish(), this doesn't process events and doesn't wait for restarts. Managers
+ * call this from their destructors, because cwTaskScheduler's threads outlive them. Without
+ * it, a task could still be using the manager's data after the manager was deleted.
+ *
+ * The task must not have a QObject parent, otherwise it can't be moved.
+ */
+void cwTask::stopAndWait()
+{
+    stop();
+
+    QThread* taskThread = thread();
+    if(taskThread == QThread::currentThread() || !taskThread->isRunning()) {
+        //Nothing else can be running the task
+        return;
+    }
+
+    //This is queued after the task's own events, so runTask() has returned once this is called
+    QMetaObject::invokeMethod(this, "changeThreads", Qt::BlockingQueuedConnection,
+                              Q_ARG(QThread*, QThread::currentThread()));
+}
+
 /**
 * @brief cwTask::name
 * @return Return's the name of the task. If the task isn't named this returns the task's class name
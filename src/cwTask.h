@@ -17,6 +17,7 @@
 
 //Our includes
 #include "cwGlobals.h"
+#include "cwTaskScheduler.h"
 
 /**
   \brief A member functions in the class are thread safe
@@ -40,9 +41,11 @@ public:
     };
 
     explicit cwTask(QObject *parent = 0);
+    ~cwTask();
 
     void setParentTask(cwTask* parentTask);
     void setThread(QThread* threadToRunOn, Qt::ConnectionType connectionType = Qt::AutoConnection);
+    void setThread(cwTaskScheduler::Priority priority, Qt::ConnectionType connectionType = Qt::AutoConnection);
 
     int numberOfSteps() const;
     int progress() const;
@@ -55,6 +58,7 @@ public:
     void setName(QString name);
 
     void waitToFinish(unsigned long time = ULONG_MAX);
+    void stopAndWait();
 
 
     //Do not move this to a slot!!! You will break things
@@ -106,12 +110,20 @@ private:
 
     QString Name; //!< The name of the task
 
+    QThread* AcquiredThread; //!< The thread from cwTaskScheduler, released when the task is done with it
+
+    //For cwTaskTracer, in microseconds
+    qint64 QueuedTime; //!< When start() was called
+    qint64 StartTime; //!< When the task started running on it's thread
+
 
     void privateStop();
     bool isParentsRunning();
 
     bool needsRestart() const;
 
+    void traceSpan(QString status);
+
 private:
     Q_INVOKABLE void startOnCurrentThread();
     Q_INVOKABLE void changeThreads(QThread* thread);
@@ -8,10 +8,13 @@
 
 //Our includes
 #include "cwTaskManagerModel.h"
+#include "cwTaskTraceModel.h"
 
 //Qt includes
 #include "cwTask.h"
 #include "cwDebug.h"
+#include "cwTaskTracer.h"
+#include <QUrl>
 
 cwTaskManagerModel::cwTaskManagerModel(QObject *parent) :
     QAbstractListModel(parent),
@@ -21,7 +24,8 @@ cwTaskManagerModel::cwTaskManagerModel(QObject *parent) :
     TaskActiveMapper(new QSignalMapper(this)),
     TaskNameMapper(new QSignalMapper(this)),
     TaskProgressMapper(new QSignalMapper(this)),
-    TaskNumberOfStepsMapper(new QSignalMapper(this))
+    TaskNumberOfStepsMapper(new QSignalMapper(this)),
+    RecentTasks(new cwTaskTraceModel(this))
 {
     connect(TaskStartedMapper, SIGNAL(mapped(QObject*)), this, SLOT(taskHasStarted(QObject*)));
     connect(TaskStoppedMapper, SIGNAL(mapped(QObject*)), this, SLOT(taskHasStopped(QObject*)));
@@ -132,6 +136,22 @@ void cwTaskManagerModel::removeTask(cwTask *task)
 
 }
 
+/**
+ * @brief cwTaskManagerModel::saveTrace
+ * @param filename - Where the trace is written, this can be a local file url from a FileDialog
+ * @return True if the trace was written
+ *
+ * Writes the recent tasks as Chrome trace event json
+ */
+bool cwTaskManagerModel::saveTrace(QString filename) const
+{
+    QUrl url(filename);
+    if(url.isLocalFile()) {
+        filename = url.toLocalFile();
+    }
+    return cwTaskTracer::instance()->writeChromeTrace(filename);
+}
+
 /**
  * @brief cwTaskManagerModel::convertToTask
  * @param task
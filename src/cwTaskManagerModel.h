@@ -19,16 +19,23 @@
 
 //Our includes
 class cwTask;
+#include "cwTaskTraceModel.h"
 
 /**
  * @brief The cwTaskManagerModel class
  *
  * This class show active task. Tasks that take longer than 2 seconds are shown as
  * active tasks. This class allows the gui to visualize running task, stop, and stop them
+ *
+ * recentTasks() shows the timings of recently completed tasks, from cwTaskTracer's ring
+ * buffer. Use saveTrace() to export them for chrome://tracing.
  */
 class cwTaskManagerModel : public QAbstractListModel
 {
     Q_OBJECT
+
+    Q_PROPERTY(cwTaskTraceModel* recentTasks READ recentTasks CONSTANT)
+
 public:
     enum Roles {
         NameRole,
@@ -45,6 +52,9 @@ public:
     void addTask(cwTask* task);
     void removeTask(cwTask* task);
 
+    cwTaskTraceModel* recentTasks() const;
+    Q_INVOKABLE bool saveTrace(QString filename) const;
+
 signals:
 
 public slots:
@@ -62,6 +72,8 @@ private:
     QSignalMapper* TaskProgressMapper;
     QSignalMapper* TaskNumberOfStepsMapper;
 
+    cwTaskTraceModel* RecentTasks;
+
     cwTask* convertToTask(QObject* task);
     void removeActiveTask(cwTask* task);
     void addActiveTask(cwTask* task);
@@ -78,4 +90,12 @@ private slots:
     void updateTaskName(QObject* taskObject);
 };
 
+/**
+ * @brief cwTaskManagerModel::recentTasks
+ * @return The model of recently completed tasks, call refresh() on it to update it
+ */
+inline cwTaskTraceModel* cwTaskManagerModel::recentTasks() const {
+    return RecentTasks;
+}
+
 #endif // CWTASKMANAGERMODEL_H
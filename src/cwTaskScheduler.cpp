@@ -0,0 +1,218 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwTaskScheduler.h"
+
+//Qt includes
+#include <QThread>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+//This hold the singleton of the cwTaskScheduler
+cwTaskScheduler* cwTaskScheduler::Instance = new cwTaskScheduler();
+
+//The line plot, scrap triangulation, and project load and save threads
+const int cwTaskScheduler::MinimumInteractiveThreads = 3;
+
+cwTaskScheduler::cwTaskScheduler(QObject *parent) :
+    QObject(parent),
+    ShutDown(false)
+{
+}
+
+/**
+ * @brief cwTaskScheduler::instance
+ * @return The singleton instance of this class
+ */
+cwTaskScheduler *cwTaskScheduler::instance()
+{
+    return Instance;
+}
+
+/**
+ * @brief cwTaskScheduler::acquireThread
+ * @param priority - The priority of the task
+ * @return The thread, for priority, with the fewest tasks assigned to it
+ *
+ * The thread's assigned task count is incremented. Call releaseThread() once the task
+ * no longer uses the thread. The pool is created on the first call.
+ */
+QThread *cwTaskScheduler::acquireThread(cwTaskScheduler::Priority priority)
+{
+    QMutexLocker locker(&Mutex);
+
+    if(InteractiveThreads.isEmpty()) {
+        createThreads();
+    }
+
+    QThread* thread = nullptr;
+    switch(priority) {
+    case Interactive:
+        thread = leastAssigned(InteractiveThreads);
+        break;
+    case Background:
+        thread = leastAssigned(BackgroundThreads);
+        break;
+    }
+
+    Q_ASSERT(thread != nullptr);
+    AssignedTasks[thread]++;
+    return thread;
+}
+
+/**
+ * @brief cwTaskScheduler::releaseThread
+ * @param thread - A thread that was returned from acquireThread()
+ *
+ * Threads that aren't part of the pool are ignored
+ */
+void cwTaskScheduler::releaseThread(QThread *thread)
+{
+    QMutexLocker locker(&Mutex);
+    if(AssignedTasks.contains(thread)) {
+        AssignedTasks[thread] = qMax(0, AssignedTasks.value(thread) - 1);
+    }
+}
+
+/**
+ * @brief cwTaskScheduler::threadCount
+ * @return The number of threads in the pool, this is zero until the first thread is acquired
+ */
+int cwTaskScheduler::threadCount() const
+{
+    QMutexLocker locker(&Mutex);
+    return InteractiveThreads.size() + BackgroundThreads.size();
+}
+
+/**
+ * @brief cwTaskScheduler::threadCount
+ * @return The number of threads in the pool for priority, this is zero until the first thread is acquired
+ */
+int cwTaskScheduler::threadCount(cwTaskScheduler::Priority priority) const
+{
+    QMutexLocker locker(&Mutex);
+    switch(priority) {
+    case Interactive:
+        return InteractiveThreads.size();
+    case Background:
+        return BackgroundThreads.size();
+    }
+    return 0;
+}
+
+/**
+ * @brief cwTaskScheduler::assignedTasks
+ * @return The number of tasks that have been assigned to thread
+ */
+int cwTaskScheduler::assignedTasks(QThread *thread) const
+{
+    QMutexLocker locker(&Mutex);
+    return AssignedTasks.value(thread, 0);
+}
+
+/**
+ * @brief cwTaskScheduler::flush
+ * @param thread - A thread from the pool
+ *
+ * Blocks until thread has run everything that was queued on it before this call. Tasks that were
+ * started on thread, like project saves, are finished once this returns.
+ *
+ * This does nothing if it's called from thread, or if thread isn't running.
+ */
+void cwTaskScheduler::flush(QThread *thread)
+{
+    if(thread == nullptr || thread == QThread::currentThread() || !thread->isRunning()) {
+        return;
+    }
+
+    //The marker's event is queued behind everything else on the thread
+    QObject* marker = new QObject();
+    marker->moveToThread(thread);
+    QMetaObject::invokeMethod(marker, "deleteLater", Qt::BlockingQueuedConnection);
+}
+
+/**
+ * @brief cwTaskScheduler::shutdown
+ *
+ * Quits all the threads in the pool and waits for them to finish. This is called when
+ * the application is about to quit. Tasks should be stopped before this is called.
+ */
+void cwTaskScheduler::shutdown()
+{
+    QList<QThread*> threads;
+    {
+        QMutexLocker locker(&Mutex);
+        threads = InteractiveThreads + BackgroundThreads;
+        ShutDown = true;
+    }
+
+    foreach(QThread* thread, threads) {
+        thread->quit();
+    }
+
+    foreach(QThread* thread, threads) {
+        thread->wait();
+    }
+}
+
+/**
+ * @brief cwTaskScheduler::createThreads
+ *
+ * Creates about one thread per core. At least MinimumInteractiveThreads interactive threads
+ * and one background thread are created. This should only be called with Mutex locked.
+ */
+void cwTaskScheduler::createThreads()
+{
+    Q_ASSERT(!ShutDown);
+
+    int idealThreadCount = qMax(2, QThread::idealThreadCount());
+    int numberOfInteractive = qMax(MinimumInteractiveThreads, (idealThreadCount + 1) / 2);
+    int numberOfBackground = qMax(1, idealThreadCount / 2);
+    int numberOfThreads = numberOfInteractive + numberOfBackground;
+
+    for(int i = 0; i < numberOfThreads; i++) {
+        bool interactive = i < numberOfInteractive;
+
+        QThread* thread = new QThread();
+        thread->setObjectName(interactive ?
+                                  QString("InteractiveTaskThread %1").arg(i) :
+                                  QString("BackgroundTaskThread %1").arg(i - numberOfInteractive));
+        thread->start(interactive ? QThread::NormalPriority : QThread::LowPriority);
+
+        if(interactive) {
+            InteractiveThreads.append(thread);
+        } else {
+            BackgroundThreads.append(thread);
+        }
+
+        AssignedTasks.insert(thread, 0);
+    }
+
+    if(QCoreApplication::instance() != nullptr) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &cwTaskScheduler::shutdown, Qt::DirectConnection);
+    }
+}
+
+/**
+ * @brief cwTaskScheduler::leastAssigned
+ * @return The thread in threads with the fewest tasks, ties go to the first thread
+ */
+QThread *cwTaskScheduler::leastAssigned(const QList<QThread *> &threads) const
+{
+    QThread* bestThread = nullptr;
+    int bestCount = 0;
+    foreach(QThread* thread, threads) {
+        int count = AssignedTasks.value(thread);
+        if(bestThread == nullptr || count < bestCount) {
+            bestThread = thread;
+            bestCount = count;
+        }
+    }
+    return bestThread;
+}
@@ -0,0 +1,90 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWTASKSCHEDULER_H
+#define CWTASKSCHEDULER_H
+
+//Qt includes
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+class QThread;
+
+//Our includes
+#include "cwGlobals.h"
+
+/**
+ * @brief The cwTaskScheduler class
+ *
+ * This is a singleton class. To use the class use cwTaskScheduler::instance()
+ *
+ * The scheduler owns a shared pool of threads that cwTask's run on, instead of each manager
+ * owning its own QThread. The pool has about one thread per core, split into interactive and
+ * background threads. Interactive work, like the line plot and scrap triangulation, never queues
+ * up behind background work, like texture loading, because they don't share threads. Background
+ * threads run at a lower priority.
+ *
+ * There are always at least MinimumInteractiveThreads interactive threads. The line plot, scrap
+ * triangulation, and project loading and saving each hold on to an interactive thread for their
+ * lifetime, so even on a two core machine they run at the same time instead of one after another.
+ *
+ * Tasks are given a thread with cwTask::setThread(cwTaskScheduler::Priority). The scheduler
+ * hands out the thread, for that priority, that has the fewest tasks assigned to it. Child tasks
+ * always run on their parent's thread, so they aren't assigned separately. Tasks release their
+ * thread when they're deleted or moved to another thread.
+ *
+ * Cancellation still goes through cwTask::stop() and cwTask::restart(). Chained subtasks
+ * (cavern -> plotsauce -> geometry) are started from each other's finished() signals, so none
+ * of the pool's threads block waiting on another task.
+ *
+ * Managers call cwTask::stopAndWait() or flush() in their destructors, because the pool's threads
+ * outlive them. The threads are stopped when the application quits.
+ *
+ * All functions in this class are thread safe.
+ */
+class CAVEWHERE_LIB_EXPORT cwTaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Interactive,
+        Background
+    };
+
+    static cwTaskScheduler* instance();
+
+    QThread* acquireThread(Priority priority);
+    void releaseThread(QThread* thread);
+
+    int threadCount() const;
+    int threadCount(Priority priority) const;
+    int assignedTasks(QThread* thread) const;
+
+    void flush(QThread* thread);
+
+public slots:
+    void shutdown();
+
+private:
+    explicit cwTaskScheduler(QObject *parent = 0);
+
+    static cwTaskScheduler* Instance;
+    static const int MinimumInteractiveThreads;
+
+    mutable QMutex Mutex; //Protects the data below
+    QList<QThread*> InteractiveThreads;
+    QList<QThread*> BackgroundThreads;
+    QHash<QThread*, int> AssignedTasks;
+    bool ShutDown;
+
+    void createThreads();
+    QThread* leastAssigned(const QList<QThread*>& threads) const;
+};
+
+#endif // CWTASKSCHEDULER_H
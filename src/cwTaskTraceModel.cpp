@@ -0,0 +1,93 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwTaskTraceModel.h"
+
+cwTaskTraceModel::cwTaskTraceModel(QObject *parent) :
+    QAbstractListModel(parent)
+{
+}
+
+/**
+ * @brief cwTaskTraceModel::rowCount
+ * @param parent
+ * @return The number of spans from the last refresh()
+ */
+int cwTaskTraceModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return Spans.size();
+}
+
+/**
+ * @brief cwTaskTraceModel::data
+ * @param index
+ * @param role
+ * @return The span's data, times are in milliseconds
+ */
+QVariant cwTaskTraceModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid()) {
+        return QVariant();
+    }
+
+    const cwTaskTracer::Span& span = Spans.at(index.row());
+
+    switch(role) {
+    case NameRole:
+        return span.Name;
+    case ParentNameRole:
+        return span.ParentName;
+    case StatusRole:
+        return span.Status;
+    case ThreadNameRole:
+        return span.ThreadName;
+    case QueueWaitRole:
+        return span.queueWait() / 1000.0;
+    case RunTimeRole:
+        return span.runTime() / 1000.0;
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+/**
+ * @brief cwTaskTraceModel::roleNames
+ * @return
+ */
+QHash<int, QByteArray> cwTaskTraceModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(NameRole, "nameRole");
+    roles.insert(ParentNameRole, "parentNameRole");
+    roles.insert(StatusRole, "statusRole");
+    roles.insert(ThreadNameRole, "threadNameRole");
+    roles.insert(QueueWaitRole, "queueWaitRole");
+    roles.insert(RunTimeRole, "runTimeRole");
+    return roles;
+}
+
+/**
+ * @brief cwTaskTraceModel::refresh
+ *
+ * Copies the spans from cwTaskTracer, the newest span is the first row
+ */
+void cwTaskTraceModel::refresh()
+{
+    QList<cwTaskTracer::Span> spans = cwTaskTracer::instance()->spans();
+
+    beginResetModel();
+    Spans.clear();
+    Spans.reserve(spans.size());
+    for(int i = spans.size() - 1; i >= 0; i--) {
+        Spans.append(spans.at(i));
+    }
+    endResetModel();
+}
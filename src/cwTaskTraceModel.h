@@ -0,0 +1,51 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWTASKTRACEMODEL_H
+#define CWTASKTRACEMODEL_H
+
+//Our includes
+#include "cwTaskTracer.h"
+#include "cwGlobals.h"
+
+//Qt includes
+#include <QAbstractListModel>
+#include <QList>
+
+/**
+ * @brief The cwTaskTraceModel class
+ *
+ * Shows the spans in cwTaskTracer's ring buffer, newest first. The model doesn't watch the
+ * tracer, since every task would reset the model. Call refresh() to copy the tracer's
+ * current spans into the model.
+ */
+class CAVEWHERE_LIB_EXPORT cwTaskTraceModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Roles {
+        NameRole,
+        ParentNameRole,
+        StatusRole,
+        ThreadNameRole,
+        QueueWaitRole,
+        RunTimeRole
+    };
+
+    explicit cwTaskTraceModel(QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    Q_INVOKABLE void refresh();
+
+private:
+    QList<cwTaskTracer::Span> Spans;
+};
+
+#endif // CWTASKTRACEMODEL_H
@@ -0,0 +1,243 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwTaskTracer.h"
+#include "cwDebug.h"
+
+//Qt includes
+#include <QMutexLocker>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QCoreApplication>
+#include <QFile>
+
+//This hold the singleton of the cwTaskTracer
+cwTaskTracer* cwTaskTracer::Instance = new cwTaskTracer();
+
+const int cwTaskTracer::DefaultCapacity = 2048;
+
+cwTaskTracer::cwTaskTracer(QObject *parent) :
+    QObject(parent),
+    Enabled(true),
+    NextSpan(0),
+    SpanCount(0)
+{
+    Clock.start();
+    Spans.resize(DefaultCapacity);
+}
+
+/**
+ * @brief cwTaskTracer::instance
+ * @return The signalton instance of this class
+ */
+cwTaskTracer *cwTaskTracer::instance()
+{
+    return Instance;
+}
+
+/**
+ * @brief cwTaskTracer::timestamp
+ * @return Microseconds since the tracer was created. All span times use this clock
+ */
+qint64 cwTaskTracer::timestamp() const
+{
+    return Clock.nsecsElapsed() / 1000;
+}
+
+/**
+ * @brief cwTaskTracer::isEnabled
+ * @return True if spans are being recorded
+ */
+bool cwTaskTracer::isEnabled() const
+{
+    QMutexLocker locker(&Mutex);
+    return Enabled;
+}
+
+/**
+ * @brief cwTaskTracer::setEnabled
+ * @param enabled - If false, addSpan() does nothing
+ */
+void cwTaskTracer::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&Mutex);
+    Enabled = enabled;
+}
+
+/**
+ * @brief cwTaskTracer::capacity
+ * @return The maximum number of spans that are kept
+ */
+int cwTaskTracer::capacity() const
+{
+    QMutexLocker locker(&Mutex);
+    return Spans.size();
+}
+
+/**
+ * @brief cwTaskTracer::setCapacity
+ * @param capacity - The maximum number of spans that are kept
+ *
+ * This clears all the recorded spans
+ */
+void cwTaskTracer::setCapacity(int capacity)
+{
+    QMutexLocker locker(&Mutex);
+    Spans = QVector<Span>(qMax(1, capacity));
+    NextSpan = 0;
+    SpanCount = 0;
+}
+
+/**
+ * @brief cwTaskTracer::addSpan
+ * @param span - Added to the ring buffer, the oldest span is dropped if the buffer is full
+ */
+void cwTaskTracer::addSpan(const cwTaskTracer::Span &span)
+{
+    QMutexLocker locker(&Mutex);
+    if(!Enabled) { return; }
+
+    Spans[NextSpan] = span;
+    NextSpan = (NextSpan + 1) % Spans.size();
+    SpanCount = qMin(SpanCount + 1, Spans.size());
+}
+
+/**
+ * @brief cwTaskTracer::spans
+ * @return All the recorded spans, oldest first
+ */
+QList<cwTaskTracer::Span> cwTaskTracer::spans() const
+{
+    QMutexLocker locker(&Mutex);
+
+    QList<Span> spans;
+    spans.reserve(SpanCount);
+
+    int first = (NextSpan - SpanCount + Spans.size()) % Spans.size();
+    for(int i = 0; i < SpanCount; i++) {
+        spans.append(Spans.at((first + i) % Spans.size()));
+    }
+
+    return spans;
+}
+
+/**
+ * @brief cwTaskTracer::clear
+ *
+ * Removes all the recorded spans
+ */
+void cwTaskTracer::clear()
+{
+    QMutexLocker locker(&Mutex);
+    NextSpan = 0;
+    SpanCount = 0;
+}
+
+/**
+ * @brief cwTaskTracer::toChromeTrace
+ * @return The recorded spans in Chrome's trace event format
+ *
+ * Each span creates a complete event ("ph":"X") for the time the task ran. If the task
+ * waited in the event queue, an async begin and end pair ("ph":"b" and "e") in the "queue"
+ * category covers the wait. The wait overlaps whatever the thread was running before the task,
+ * so it can't be a complete event on the thread's track without breaking the nesting. Threads
+ * are named with metadata events, using the QThread's objectName().
+ */
+QByteArray cwTaskTracer::toChromeTrace() const
+{
+    QList<Span> allSpans = spans();
+
+    qint64 pid = QCoreApplication::applicationPid();
+    QHash<QThread*, int> threadIds;
+    QJsonArray events;
+    int queueId = 1; //Task ids can be reused after a task is deleted, so waits get their own ids
+
+    foreach(const Span& span, allSpans) {
+        if(!threadIds.contains(span.Thread)) {
+            int threadId = threadIds.size() + 1;
+            threadIds.insert(span.Thread, threadId);
+
+            QJsonObject threadName;
+            threadName.insert("name", QString("thread_name"));
+            threadName.insert("ph", QString("M"));
+            threadName.insert("pid", pid);
+            threadName.insert("tid", threadId);
+            QJsonObject args;
+            args.insert("name", span.ThreadName.isEmpty() ? QString("Thread %1").arg(threadId) : span.ThreadName);
+            threadName.insert("args", args);
+            events.append(threadName);
+        }
+
+        int threadId = threadIds.value(span.Thread);
+
+        QJsonObject args;
+        args.insert("status", span.Status);
+        args.insert("task", QString::number(span.TaskId, 16));
+        if(span.ParentTaskId != 0) {
+            args.insert("parent", span.ParentName);
+            args.insert("parentTask", QString::number(span.ParentTaskId, 16));
+        }
+        args.insert("queueWaitUs", span.queueWait());
+
+        if(span.queueWait() > 0) {
+            QJsonObject queueBegin;
+            queueBegin.insert("name", span.Name);
+            queueBegin.insert("cat", QString("queue"));
+            queueBegin.insert("ph", QString("b"));
+            queueBegin.insert("id", QString::number(queueId, 16));
+            queueBegin.insert("ts", span.QueuedTime);
+            queueBegin.insert("pid", pid);
+            queueBegin.insert("tid", threadId);
+
+            QJsonObject queueEnd = queueBegin;
+            queueEnd.insert("ph", QString("e"));
+            queueEnd.insert("ts", span.StartTime);
+
+            events.append(queueBegin);
+            events.append(queueEnd);
+            queueId++;
+        }
+
+        if(span.StartTime >= 0) {
+            QJsonObject runEvent;
+            runEvent.insert("name", span.Name);
+            runEvent.insert("cat", QString("task"));
+            runEvent.insert("ph", QString("X"));
+            runEvent.insert("ts", span.StartTime);
+            runEvent.insert("dur", span.runTime());
+            runEvent.insert("pid", pid);
+            runEvent.insert("tid", threadId);
+            runEvent.insert("args", args);
+            events.append(runEvent);
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", events);
+    trace.insert("displayTimeUnit", QString("ms"));
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief cwTaskTracer::writeChromeTrace
+ * @param filename - The file the trace is written to
+ * @return True if the trace was written, otherwise false
+ */
+bool cwTaskTracer::writeChromeTrace(QString filename) const
+{
+    QFile file(filename);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qDebug() << "Couldn't open" << filename << "to write the task trace" << file.errorString() << LOCATION;
+        return false;
+    }
+
+    file.write(toChromeTrace());
+    return true;
+}
@@ -0,0 +1,120 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWTASKTRACER_H
+#define CWTASKTRACER_H
+
+//Qt includes
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+class QThread;
+
+//Our includes
+#include "cwGlobals.h"
+
+/**
+ * @brief The cwTaskTracer class
+ *
+ * This is a singleton class. To use the class use cwTaskTracer::instance()
+ *
+ * cwTask records a Span into the tracer every time it finishes, stops, or restarts. A span holds
+ * how long the task waited in its thread's event queue, how long it ran, the thread it ran on,
+ * and its parent task. Spans are kept in a fixed sized ring buffer, so the oldest spans are
+ * dropped once the buffer is full.
+ *
+ * The spans can be exported as Chrome trace event json, and viewed with chrome://tracing. Child
+ * tasks run on their parent's thread, so they show up nested under the parent.
+ *
+ * All functions in this class are thread safe.
+ */
+class CAVEWHERE_LIB_EXPORT cwTaskTracer : public QObject
+{
+    Q_OBJECT
+
+public:
+    class Span {
+    public:
+        Span() :
+            TaskId(0),
+            ParentTaskId(0),
+            Thread(nullptr),
+            QueuedTime(-1),
+            StartTime(-1),
+            EndTime(-1)
+        {}
+
+        QString Name;
+        QString ParentName;
+        QString Status; //!< finished, stopped, or restarted
+        quintptr TaskId;
+        quintptr ParentTaskId;
+        QThread* Thread; //!< Only used as an id, may not exist anymore
+        QString ThreadName;
+        qint64 QueuedTime; //!< In microseconds, -1 if the task never started
+        qint64 StartTime; //!< In microseconds, -1 if the task never ran
+        qint64 EndTime; //!< In microseconds
+
+        qint64 queueWait() const;
+        qint64 runTime() const;
+    };
+
+    static cwTaskTracer* instance();
+
+    qint64 timestamp() const;
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    int capacity() const;
+    void setCapacity(int capacity);
+
+    void addSpan(const Span& span);
+    QList<Span> spans() const;
+    void clear();
+
+    QByteArray toChromeTrace() const;
+    bool writeChromeTrace(QString filename) const;
+
+private:
+    explicit cwTaskTracer(QObject *parent = 0);
+
+    static cwTaskTracer* Instance;
+    static const int DefaultCapacity;
+
+    QElapsedTimer Clock;
+
+    mutable QMutex Mutex; //Protects the data below
+    bool Enabled;
+    QVector<Span> Spans; //Ring buffer
+    int NextSpan; //Where the next span is written in Spans
+    int SpanCount;
+};
+
+/**
+ * @brief cwTaskTracer::Span::queueWait
+ * @return How long the task waited between start() and running, in microseconds
+ */
+inline qint64 cwTaskTracer::Span::queueWait() const
+{
+    if(QueuedTime < 0 || StartTime < 0) { return 0; }
+    return StartTime - QueuedTime;
+}
+
+/**
+ * @brief cwTaskTracer::Span::runTime
+ * @return How long the task ran, in microseconds. This includes waiting for it's child tasks
+ */
+inline qint64 cwTaskTracer::Span::runTime() const
+{
+    if(StartTime < 0) { return 0; }
+    return EndTime - StartTime;
+}
+
+#endif // CWTASKTRACER_H
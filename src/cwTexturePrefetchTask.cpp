@@ -0,0 +1,73 @@
+/**************************************************************************
+**
+**    Copyright (C) 2015 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwTexturePrefetchTask.h"
+#include "cwTextureUploadTask.h"
+#include "cwImageProvider.h"
+
+//Keeps the number of sql host parameters well below sqlite's limit of 999
+const int cwTexturePrefetchTask::BatchSize = 128;
+
+cwTexturePrefetchTask::cwTexturePrefetchTask(QObject *parent) :
+    cwTask(parent)
+{
+}
+
+/**
+ * @brief cwTexturePrefetchTask::runTask
+ *
+ * Goes through all the images, in priority order, and fetches the mipmaps
+ * that aren't already in the cache.
+ */
+void cwTexturePrefetchTask::runTask()
+{
+    setNumberOfSteps(Images.size());
+
+    QList<int> batch;
+    for(int i = 0; i < Images.size(); i++) {
+        if(!isRunning()) { break; }
+
+        foreach(int mipmapId, Images.at(i).mipmaps()) {
+            if(!cwTextureUploadTask::isCached(ProjectFilename, mipmapId)) {
+                batch.append(mipmapId);
+            }
+        }
+
+        if(batch.size() >= BatchSize) {
+            fetchBatch(batch);
+            batch.clear();
+            setProgress(i + 1);
+        }
+    }
+
+    if(isRunning() && !batch.isEmpty()) {
+        fetchBatch(batch);
+    }
+
+    if(isRunning()) {
+        setProgress(Images.size());
+    }
+
+    done();
+}
+
+/**
+ * @brief cwTexturePrefetchTask::fetchBatch
+ * @param mipmapIds - The mipmap levels to fetch with one query
+ */
+void cwTexturePrefetchTask::fetchBatch(const QList<int> &mipmapIds)
+{
+    cwImageProvider imageProvider;
+    imageProvider.setProjectPath(ProjectFilename);
+
+    QList<cwImageData> mipmaps = imageProvider.data(mipmapIds);
+    for(int i = 0; i < mipmaps.size(); i++) {
+        const cwImageData& data = mipmaps.at(i);
+        cwTextureUploadTask::insertIntoCache(ProjectFilename, mipmapIds.at(i), data.data(), data.size());
+    }
+}
@@ -0,0 +1,65 @@
+/**************************************************************************
+**
+**    Copyright (C) 2015 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWTEXTUREPREFETCHTASK_H
+#define CWTEXTUREPREFETCHTASK_H
+
+//Our includes
+#include "cwTask.h"
+#include "cwImage.h"
+
+/**
+ * @brief The cwTexturePrefetchTask class
+ *
+ * Bulk loads the mipmaps of many images into cwTextureUploadTask's cache. This is used
+ * after a project has been loaded, where every visible scrap needs its texture at once.
+ *
+ * The mipmap chains are fetched in batches, with one sql query per batch, and decompressed on
+ * the global thread pool. The images are fetched in the order they were set, so the first image
+ * should be the one with the highest priority. Images that are already cached are skipped.
+ */
+class cwTexturePrefetchTask : public cwTask
+{
+    Q_OBJECT
+public:
+    explicit cwTexturePrefetchTask(QObject *parent = 0);
+
+    //Inputs
+    void setImages(QList<cwImage> images);
+    void setProjectFilename(QString filename);
+
+    static const int BatchSize;
+
+protected:
+    void runTask();
+
+private:
+    QList<cwImage> Images;
+    QString ProjectFilename;
+
+    void fetchBatch(const QList<int>& mipmapIds);
+};
+
+/**
+ * @brief cwTexturePrefetchTask::setImages
+ * @param images - The images to prefetch, highest priority first
+ */
+inline void cwTexturePrefetchTask::setImages(QList<cwImage> images)
+{
+    Images = images;
+}
+
+/**
+ * @brief cwTexturePrefetchTask::setProjectFilename
+ * @param filename
+ */
+inline void cwTexturePrefetchTask::setProjectFilename(QString filename)
+{
+    ProjectFilename = filename;
+}
+
+#endif // CWTEXTUREPREFETCHTASK_H
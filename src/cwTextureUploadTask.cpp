@@ -16,10 +16,16 @@
 #include <QDebug>
 #include <QWindow>
 #include <QThread>
+#include <QMutexLocker>
 
 //Std includes
 #include <math.h>
 
+//256 MB of uncompressed dxt1 data
+const int cwTextureUploadTask::MaxCacheSizeKB = 256 * 1024;
+QCache<QString, QPair<QByteArray, QSize> > cwTextureUploadTask::MipmapCache(cwTextureUploadTask::MaxCacheSizeKB);
+QMutex cwTextureUploadTask::MipmapCacheMutex;
+
 cwTextureUploadTask::cwTextureUploadTask(QObject *parent) :
     cwTask(parent)
 {
@@ -53,41 +59,134 @@ void cwTextureUploadTask::loadMipmapsFromDisk()
     cwImageProvider imageProvidor;
     imageProvidor.setProjectPath(ProjectFilename);
 
-    QList< QPair< QByteArray, QSize > > mipmaps;
-
-    int firstLevel = Image.mipmaps().first();
-    QSize firstLevelSize = imageProvidor.data(firstLevel, true).size();
+    QList< QPair< QByteArray, QSize > > mipmaps = cachedMipmaps();
 
-    if(!isDivisibleBy4(firstLevelSize)) {
-        //Regenerate the mipmaps
-        cwAddImageTask addImageTask;
-        addImageTask.setDatabaseFilename(ProjectFilename);
-        addImageTask.regenerateMipmapsOn(Image);
-        addImageTask.start();
+    if(mipmaps.isEmpty()) {
+        QSize firstLevelSize = imageProvidor.data(Image.mipmaps().first(), true).size();
 
-        //Double check if it successful
-        int firstLevel = Image.mipmaps().first();
-        firstLevelSize = imageProvidor.data(firstLevel, true).size();
         if(!isDivisibleBy4(firstLevelSize)) {
-            //No original image, can regenerate image
-            return;
+            //Regenerate the mipmaps
+            cwAddImageTask addImageTask;
+            addImageTask.setDatabaseFilename(ProjectFilename);
+            addImageTask.regenerateMipmapsOn(Image);
+            addImageTask.start();
+
+            //Double check if it successful
+            firstLevelSize = imageProvidor.data(Image.mipmaps().first(), true).size();
+            if(!isDivisibleBy4(firstLevelSize)) {
+                //No original image, can regenerate image
+                return;
+            }
+        }
+
+        if(!isRunning()) { return; }
+
+        //Load all the mipmaps, with one query
+        QList<int> mipmapIds = Image.mipmaps();
+        QList<cwImageData> mipmapData = imageProvidor.data(mipmapIds);
+        for(int i = 0; i < mipmapData.size(); i++) {
+            const cwImageData& data = mipmapData.at(i);
+            mipmaps.append(QPair< QByteArray, QSize >(data.data(), data.size()));
+            insertIntoCache(ProjectFilename, mipmapIds.at(i), data.data(), data.size());
         }
     }
 
     ScaleTexCoords = imageProvidor.scaleTexCoords(Image);
 
-    QSize imageSize;
-    //Load all the mipmaps
+    Mipmaps = mipmaps;
+}
+
+/**
+ * @brief cwTextureUploadTask::cachedMipmaps
+ * @return All the mipmaps of Image from the cache. If any of the levels aren't in the cache, or the
+ * first level isn't divisible by 4, this returns an empty list.
+ */
+QList<QPair<QByteArray, QSize> > cwTextureUploadTask::cachedMipmaps() const
+{
+    QList< QPair< QByteArray, QSize > > mipmaps;
+
+    QMutexLocker locker(&MipmapCacheMutex);
     foreach(int imageId, Image.mipmaps()) {
-        if(!isRunning()) { return; }
-        imageProvidor.data(imageId, true);
+        QPair<QByteArray, QSize>* level = MipmapCache.object(cacheKey(ProjectFilename, imageId));
+        if(level == nullptr) {
+            return QList< QPair< QByteArray, QSize > >();
+        }
+        mipmaps.append(*level);
+    }
 
-        QByteArray imageData = imageProvidor.requestImageData(imageId, &imageSize);
-        mipmaps.append(QPair< QByteArray, QSize >(imageData, imageSize));
+    if(mipmaps.isEmpty() || !isDivisibleBy4(mipmaps.first().second)) {
+        return QList< QPair< QByteArray, QSize > >();
     }
 
-    Mipmaps = mipmaps;
+    return mipmaps;
+}
 
+/**
+ * @brief cwTextureUploadTask::insertIntoCache
+ * @param projectFilename - The project that imageId comes from
+ * @param imageId - The mipmap's image id
+ * @param data - The uncompressed dxt1 data
+ * @param size - The size of the mipmap level
+ *
+ * Adds a decoded mipmap level to the cache that's shared by all upload tasks. The least recently
+ * used levels are evicted when the cache is full. This function is thread safe.
+ */
+void cwTextureUploadTask::insertIntoCache(QString projectFilename, int imageId, QByteArray data, QSize size)
+{
+    if(data.isEmpty()) { return; }
+    int costKB = qMax(1, data.size() / 1024);
+    QMutexLocker locker(&MipmapCacheMutex);
+    MipmapCache.insert(cacheKey(projectFilename, imageId), new QPair<QByteArray, QSize>(data, size), costKB);
+}
+
+/**
+ * @brief cwTextureUploadTask::isCached
+ * @return True if the mipmap level imageId is in the cache. This function is thread safe.
+ */
+bool cwTextureUploadTask::isCached(QString projectFilename, int imageId)
+{
+    QMutexLocker locker(&MipmapCacheMutex);
+    return MipmapCache.contains(cacheKey(projectFilename, imageId));
+}
+
+/**
+ * @brief cwTextureUploadTask::clearCache
+ *
+ * Removes all the decoded mipmaps from the cache. This function is thread safe.
+ */
+void cwTextureUploadTask::clearCache()
+{
+    QMutexLocker locker(&MipmapCacheMutex);
+    MipmapCache.clear();
+}
+
+/**
+ * @brief cwTextureUploadTask::clearCache
+ * @param projectFilename - The project whose mipmaps are removed
+ *
+ * Removes only projectFilename's decoded mipmaps from the cache. cwProject calls this when it
+ * closes or moves to a different file. This function is thread safe.
+ */
+void cwTextureUploadTask::clearCache(QString projectFilename)
+{
+    //Matches the keys from cacheKey()
+    QString prefix = QString("%1:").arg(projectFilename);
+
+    QMutexLocker locker(&MipmapCacheMutex);
+    foreach(const QString& key, MipmapCache.keys()) {
+        if(key.startsWith(prefix)) {
+            MipmapCache.remove(key);
+        }
+    }
+}
+
+/**
+ * @brief cwTextureUploadTask::cacheKey
+ * @return The key into MipmapCache. Image ids are only unique within a project file.
+ */
+QString cwTextureUploadTask::cacheKey(QString projectFilename, int imageId)
+{
+    return QString("%1:%2").arg(projectFilename).arg(imageId);
 }
 
 /**
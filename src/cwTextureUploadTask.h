@@ -16,6 +16,8 @@
 #include <QOpenGLFunctions>
 #include <QOpenGLBuffer>
 #include <QVector2D>
+#include <QCache>
+#include <QMutex>
 class QOpenGLContext;
 class QSurface;
 
@@ -35,6 +37,11 @@ public:
 
     static bool isDivisibleBy4(QSize size);
 
+    static void insertIntoCache(QString projectFilename, int imageId, QByteArray data, QSize size);
+    static bool isCached(QString projectFilename, int imageId);
+    static void clearCache();
+    static void clearCache(QString projectFilename);
+
 protected:
     void runTask();
 
@@ -45,7 +52,15 @@ private:
     QList< QPair< QByteArray, QSize > > Mipmaps;
     QVector2D ScaleTexCoords;
 
+    //Decoded mipmap blobs shared between all upload tasks, filled by cwTexturePrefetchTask
+    static QCache<QString, QPair<QByteArray, QSize> > MipmapCache;
+    static QMutex MipmapCacheMutex;
+    static const int MaxCacheSizeKB;
+
     void loadMipmapsFromDisk();
+    QList< QPair< QByteArray, QSize > > cachedMipmaps() const;
+
+    static QString cacheKey(QString projectFilename, int imageId);
 
     void updateScaleTexCoords();
 
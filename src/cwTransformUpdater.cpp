@@ -8,11 +8,15 @@
 //Our includes
 #include "cwTransformUpdater.h"
 #include "cwDebug.h"
+#include "cwPositioner3D.h"
 
 //Qt includes
 #include <QDebug>
 #include <QSGTransformNode>
 
+const float cwTransformUpdater::CullingMargin = 100.0f;
+const float cwTransformUpdater::PositionThreshold = 0.05f;
+
 cwTransformUpdater::cwTransformUpdater(QObject *parent) :
     QObject(parent),
     Camera(nullptr)
@@ -57,27 +61,59 @@ void cwTransformUpdater::setModelMatrix(QMatrix4x4 matrix) {
 void cwTransformUpdater::addPointItem(QQuickItem *object) {
     if(object == nullptr) { return; }
 
-    if(PointItems.contains(object)) {
+    if(PointItemIndexes.contains(object)) {
         qDebug() << "Adding object twice in cwTransformUpdater " << LOCATION;
         return;
     }
 
-    PointItems.insert(object);
+    int index = PointItems.size();
+    PointItemIndexes.insert(object, index);
+    PointItems.append(object);
+    Positioners.append(qobject_cast<cwPositioner3D*>(object));
+    PositionX.append(0.0f);
+    PositionY.append(0.0f);
+    PositionZ.append(0.0f);
+    ScreenPositions.append(object->position());
+
     connect(object, SIGNAL(destroyed(QObject*)), SLOT(pointItemDeleted(QObject*)));
     connect(object, SIGNAL(position3DChanged()), SLOT(handlePointItemDataChanged()));
-    updatePoint(object);
+
+    readPosition(index);
+    updatePoint(index);
 }
 
 /**
   Removes a object from the transform updater
+
+  The last item is moved into the removed item's place, so this doesn't shift the arrays
   */
 void cwTransformUpdater::removePointItem(QQuickItem *object) {
     if(object == nullptr) { return; }
 
-    if(!PointItems.contains(object)) {
+    if(!PointItemIndexes.contains(object)) {
         qDebug() << (void*)object << " isn't in the cwTransformUpdater, can't remove it" << LOCATION;
+        return;
+    }
+
+    int index = PointItemIndexes.take(object);
+    int lastIndex = PointItems.size() - 1;
+
+    if(index != lastIndex) {
+        PointItems[index] = PointItems.at(lastIndex);
+        Positioners[index] = Positioners.at(lastIndex);
+        PositionX[index] = PositionX.at(lastIndex);
+        PositionY[index] = PositionY.at(lastIndex);
+        PositionZ[index] = PositionZ.at(lastIndex);
+        ScreenPositions[index] = ScreenPositions.at(lastIndex);
+        PointItemIndexes[PointItems.at(index)] = index;
     }
-    PointItems.remove(object);
+
+    PointItems.removeLast();
+    Positioners.removeLast();
+    PositionX.removeLast();
+    PositionY.removeLast();
+    PositionZ.removeLast();
+    ScreenPositions.removeLast();
 }
 
 
@@ -91,9 +127,29 @@ void cwTransformUpdater::update() {
     //Update transformation object
     updateTransformMatrix();
 
-    //Update all the point objects
-    foreach(QQuickItem* object, PointItems) {
-        updatePoint(object);
+    int numberOfItems = PointItems.size();
+    ScreenX.resize(numberOfItems);
+    ScreenY.resize(numberOfItems);
+
+    //Transform all the points. This loop has no branches or function calls, so the compiler can
+    //vectorize it
+    const float* m = TransformMatrix.constData(); //Column major
+    const float* x = PositionX.constData();
+    const float* y = PositionY.constData();
+    const float* z = PositionZ.constData();
+    float* screenX = ScreenX.data();
+    float* screenY = ScreenY.data();
+
+    for(int i = 0; i < numberOfItems; i++) {
+        float w = m[3] * x[i] + m[7] * y[i] + m[11] * z[i] + m[15];
+        float invW = w != 0.0f ? 1.0f / w : 1.0f;
+        screenX[i] = (m[0] * x[i] + m[4] * y[i] + m[8] * z[i] + m[12]) * invW;
+        screenY[i] = (m[1] * x[i] + m[5] * y[i] + m[9] * z[i] + m[13]) * invW;
+    }
+
+    //Only move the items that need it
+    for(int i = 0; i < numberOfItems; i++) {
+        moveItem(i, QPointF(screenX[i], screenY[i]));
     }
 
     emit updated();
@@ -104,10 +160,69 @@ void cwTransformUpdater::update() {
   position using setPos.  This doesn't scale the object like updateTransform does.  This is
   useful for billboarded points.
   */
-void cwTransformUpdater::updatePoint(QQuickItem *object) {
-    QVector3D position = object->property("position3D").value<QVector3D>();
+void cwTransformUpdater::updatePoint(int index) {
+    QVector3D position(PositionX.at(index), PositionY.at(index), PositionZ.at(index));
     QVector3D position2D = TransformMatrix * position;
-    object->setPosition(QPointF(position2D.x(), position2D.y()));
+    moveItem(index, position2D.toPointF());
+}
+
+/**
+ * @brief cwTransformUpdater::readPosition
+ * @param index - The index of the item
+ *
+ * Caches the item's position3D. A cwPositioner3D is read directly, other items go through the
+ * property system.
+ */
+void cwTransformUpdater::readPosition(int index)
+{
+    cwPositioner3D* positioner = Positioners.at(index);
+    QVector3D position = positioner != nullptr ?
+                positioner->position3D() :
+                PointItems.at(index)->property("position3D").value<QVector3D>();
+
+    PositionX[index] = position.x();
+    PositionY[index] = position.y();
+    PositionZ[index] = position.z();
+}
+
+/**
+ * @brief cwTransformUpdater::moveItem
+ * @param index - The index of the item
+ * @param screenPosition - The item's new position
+ *
+ * Moves the item, unless it moved less than PositionThreshold, or it was and still is outside of
+ * the viewport
+ */
+void cwTransformUpdater::moveItem(int index, const QPointF &screenPosition)
+{
+    const QPointF& oldPosition = ScreenPositions.at(index);
+    QPointF delta = screenPosition - oldPosition;
+
+    if(qAbs(delta.x()) <= PositionThreshold && qAbs(delta.y()) <= PositionThreshold) {
+        return;
+    }
+
+    if(isOutsideViewport(screenPosition) && isOutsideViewport(oldPosition)) {
+        return;
+    }
+
+    ScreenPositions[index] = screenPosition;
+    PointItems.at(index)->setPosition(screenPosition);
+}
+
+/**
+ * @brief cwTransformUpdater::isOutsideViewport
+ * @return True if the screen position is more than CullingMargin outside of the camera's viewport
+ */
+bool cwTransformUpdater::isOutsideViewport(const QPointF &screenPosition) const
+{
+    if(Camera == nullptr) { return false; }
+
+    QRectF viewport(-CullingMargin,
+                    -CullingMargin,
+                    Camera->viewport().width() + 2.0 * CullingMargin,
+                    Camera->viewport().height() + 2.0 * CullingMargin);
+    return !viewport.contains(screenPosition);
 }
 
 /**
@@ -134,7 +249,9 @@ void cwTransformUpdater::updateTransformMatrix() {
   This will remove the object from the transformUpdater
   */
 void cwTransformUpdater::pointItemDeleted(QObject* object) {
-   QQuickItem* graphicsObject = qobject_cast<QQuickItem*>(object);
+   //The item is already partly destroyed, so qobject_cast can't be used. The pointer is only
+   //used as a key.
+   QQuickItem* graphicsObject = static_cast<QQuickItem*>(object);
    removePointItem(graphicsObject);
 }
 
@@ -145,8 +262,10 @@ void cwTransformUpdater::pointItemDeleted(QObject* object) {
   */
 void cwTransformUpdater::handlePointItemDataChanged() {
     QQuickItem* item = qobject_cast<QQuickItem*>(sender());
-    if(PointItems.contains(item)) {
-        updatePoint(item);
+    int index = PointItemIndexes.value(item, -1);
+    if(index >= 0) {
+        readPosition(index);
+        updatePoint(index);
     }
 }
 
@@ -12,9 +12,12 @@
 #include <QObject>
 #include <QMatrix4x4>
 #include <QQuickItem>
+#include <QVector>
+#include <QHash>
 
 //Our includes
 #include "cwCamera.h"
+class cwPositioner3D;
 
 /**
   \brief This class will watch a cwCamera
@@ -25,6 +28,11 @@
   2D qt view coordinates.  This class will automatically, update the child graphics object positions.
 
   All items that are added to the transform need to have "position" property that's QVector3D.
+
+  The items' 3d positions are cached in contiguous arrays, and are only read from the item when it
+  emits position3DChanged(). update() transforms all the cached positions in one pass, and only
+  moves the items whose screen position changed by more than PositionThreshold. Items that stay
+  outside of the viewport aren't moved.
   */
 class cwTransformUpdater : public QObject
 {
@@ -65,13 +73,34 @@ private slots:
     void handlePointItemDataChanged();
 
 private:
-    QSet<QQuickItem*> PointItems;
+    //Items that stay this far outside of the viewport, in pixels, aren't moved
+    static const float CullingMargin;
+
+    //Items aren't moved if their screen position changes less than this, in pixels
+    static const float PositionThreshold;
+
+    //The point items and their positions, in parallel arrays
+    QVector<QQuickItem*> PointItems;
+    QVector<cwPositioner3D*> Positioners; //!< nullptr if the item isn't a cwPositioner3D
+    QVector<float> PositionX;
+    QVector<float> PositionY;
+    QVector<float> PositionZ;
+    QVector<QPointF> ScreenPositions; //!< The position that the item was last moved to
+    QHash<QQuickItem*, int> PointItemIndexes;
+
+    //Scratch space for update()
+    QVector<float> ScreenX;
+    QVector<float> ScreenY;
+
     cwCamera* Camera;
     QMatrix4x4 ModelMatrix;
 
     QMatrix4x4 TransformMatrix; //!< The total matrix that converts a object's position into qt coordinates
 
-    void updatePoint(QQuickItem* object);
+    void updatePoint(int index);
+    void readPosition(int index);
+    void moveItem(int index, const QPointF& screenPosition);
+    bool isOutsideViewport(const QPointF& screenPosition) const;
 
     void updateTransformMatrix();
 
@@ -5,11 +5,52 @@
 **
 **************************************************************************/
 
+//Our includes
 #include "cwTriangulateInData.h"
 
+//Qt includes
+#include <QCryptographicHash>
+#include <QDataStream>
+
+//Bump this when cwTriangulateTask's output changes, so meshes from older versions aren't reused
+static const qint32 HashVersion = 1;
+
 cwTriangulateInData::cwTriangulateInData() :
     Data(new PrivateData())
 {
 }
 
+/**
+ * @brief cwTriangulateInData::hash
+ * @return A content hash of the scrap's input to cwTriangulateTask
+ *
+ * If two cwTriangulateInData have the same hash, the task creates the same cropped image and
+ * mesh for both, with the same task settings. cwTriangulateTask::inputHash() adds the settings.
+ */
+QByteArray cwTriangulateInData::hash() const
+{
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream << HashVersion;
+    stream << (qint32)Data->NoteImage.original() << Data->NoteImage.origianlSize();
+    stream << Data->DotPerMeter;
+    stream << Data->Outline;
+    stream << Data->NoteTransform.matrix() << Data->NoteTransform.scale();
 
+    stream << (qint32)Data->Stations.size();
+    foreach(const cwTriangulateStation& station, Data->Stations) {
+        stream << station.name() << station.notePosition() << station.position();
+    }
+
+    stream << (qint32)Data->Leads.size();
+    foreach(const cwLead& lead, Data->Leads) {
+        stream << lead.positionOnNote();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(content);
+    return hash.result();
+}
@@ -11,6 +11,7 @@
 //Qt includes
 #include <QSharedData>
 #include <QPolygonF>
+#include <QByteArray>
 
 //Our includes
 #include "cwImage.h"
@@ -41,6 +42,8 @@ public:
     QList<cwLead> leads() const;
     void setLeads(QList<cwLead> leads);
 
+    QByteArray hash() const;
+
 private:
     class PrivateData : public QSharedData {
     public:
@@ -9,6 +9,7 @@
 #include "cwTriangulateTask.h"
 #include "cwCropImageTask.h"
 #include "cwDebug.h"
+#include "cwVertexWelder.h"
 #include "utils/cwTriangulate.h"
 
 //Utils includes
@@ -16,9 +17,29 @@
 
 //Qt includes
 #include <QDebug>
+#include <QCryptographicHash>
+#include <QDataStream>
+
+//Std includes
+#include <cmath>
+#include <limits>
+
+//The most coarser meshes that are created for a scrap
+static const int MaxLevelsOfDetail = 3;
+
+//A coarser mesh is only kept if it has at most this ratio of the last mesh's indices
+static const double MaxLevelOfDetailIndexRatio = 0.75;
+
+/**
+  The bucket that value falls in, clamped to the buckets
+  */
+static int bucket(double start, double bucketSize, int numberOfBuckets, double value) {
+    return qBound(0, (int)((value - start) / bucketSize), numberOfBuckets - 1);
+}
 
 cwTriangulateTask::cwTriangulateTask(QObject *parent) :
     cwTask(parent),
+    DistanceBetweenPoints(5.0),
     CropTask(new cwCropImageTask(this))
 {
     CropTask->setParentTask(this);
@@ -52,6 +73,48 @@ QList<cwTriangulatedData> cwTriangulateTask::triangulatedScrapData() const {
     return QList<cwTriangulatedData>();
 }
 
+/**
+ * @brief cwTriangulateTask::setDistanceBetweenPoints
+ * @param meters - The distance between the grid points of the full detail mesh, in meters
+ * in the cave. This is 5.0 by default.
+ */
+void cwTriangulateTask::setDistanceBetweenPoints(double meters)
+{
+    Q_ASSERT(meters > 0.0);
+    DistanceBetweenPoints = meters;
+}
+
+/**
+ * @brief cwTriangulateTask::distanceBetweenPoints
+ * @return The distance between the grid points of the full detail mesh, in meters in the cave
+ */
+double cwTriangulateTask::distanceBetweenPoints() const
+{
+    return DistanceBetweenPoints;
+}
+
+/**
+ * @brief cwTriangulateTask::inputHash
+ * @param scrapData - The input for one scrap
+ * @return A hash of scrapData and the task's settings
+ *
+ * The mesh also depends on the grid spacing and the level of detail settings, so a mesh is only
+ * reused by cwScrapManager if this matches the mesh's cwTriangulatedData::inputHash().
+ */
+QByteArray cwTriangulateTask::inputHash(const cwTriangulateInData &scrapData) const
+{
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream << scrapData.hash();
+    stream << DistanceBetweenPoints;
+    stream << (qint32)MaxLevelsOfDetail << MaxLevelOfDetailIndexRatio;
+
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+}
+
 /**
   \brief Does the triangulation
   */
@@ -104,35 +167,55 @@ void cwTriangulateTask::triangulateScraps() {
 
 /**
     \brief triangulate the scrap data
+
+    Besides the full detail mesh, this creates up to MaxLevelsOfDetail coarser meshes, each
+    with double the distance between grid points of the last one. The coarser meshes share
+    the full detail mesh's points and texture coordinates, their points are appended.
   */
 void cwTriangulateTask::triangulateScrap(int index) {
     cwTriangulateInData& scrapData = Scraps[index];
     QRectF bounds = scrapData.outline().boundingRect();
     cwImage croppedImage = TriangulatedScraps[index].croppedImage();
 
-    //Create the regualar mesh that covers the croppedImage
-    PointGrid pointGrid = createPointGrid(bounds, scrapData);
-
-    //Find all the points in the regualar mesh that are in the scrap's polygon
-    QSet<int> gridPointsInScrap = pointsInPolygon(pointGrid, scrapData.outline());
+    //Triangulate the scrap at full detail
+    cwTriangulatedData triangleData = triangulateGrid(bounds, scrapData, DistanceBetweenPoints);
+    QVector<QVector3D> notePoints = triangleData.points();
+    int numberOfFullDetailPoints = notePoints.size();
+
+    //Triangulate the coarser meshes, until they stop saving triangles
+    QList< QVector<uint> > levelIndices;
+    int lastNumberOfIndices = triangleData.indices().size();
+    double distanceBetweenPoints = DistanceBetweenPoints;
+    for(int i = 0; i < MaxLevelsOfDetail; i++) {
+        distanceBetweenPoints *= 2.0;
+        cwTriangulatedData levelData = triangulateGrid(bounds, scrapData, distanceBetweenPoints);
+
+        QVector<uint> indices = levelData.indices();
+        if(indices.isEmpty() || indices.size() > lastNumberOfIndices * MaxLevelOfDetailIndexRatio) {
+            break;
+        }
 
-    //Creates list of quads that are on the edges or in the scrap
-    QuadDatabase quads = createQuads(pointGrid, scrapData.outline());
+        uint offset = (uint)notePoints.size();
+        for(int j = 0; j < indices.size(); j++) {
+            indices[j] += offset;
+        }
+        notePoints += levelData.points();
 
-    //Triangulate the quads (this will update the outputs data)
-    cwTriangulatedData triangleData = createTriangles(pointGrid, gridPointsInScrap, quads, scrapData);
+        levelIndices.append(indices);
+        lastNumberOfIndices = indices.size();
+    }
 
     //Create the matrix that converts the normalized coords to the normalized coords
     QMatrix4x4 toLocal = localNormalizedCoordinates(bounds);
 
     //Convert the normalized points to local note points
-    QVector<QVector3D> localNotePoints = mapToLocalNoteCoordinates(toLocal, triangleData.points());
+    QVector<QVector3D> localNotePoints = mapToLocalNoteCoordinates(toLocal, notePoints);
 
     //Create the texture coordinates
     QVector<QVector2D> texCoords = mapTexCoordinates(localNotePoints);
 
     //Morph the points for the scrap
-    QVector<QVector3D> points = morphPoints(triangleData.points(), scrapData, toLocal, croppedImage);
+    QVector<QVector3D> points = morphPoints(notePoints, scrapData, toLocal, croppedImage);
 
     //Morph the lead points for the scrap
     QVector<QVector3D> leadPoints = morphPoints(leadPositionToVector3D(scrapData.leads()),
@@ -140,12 +223,52 @@ void cwTriangulateTask::triangulateScrap(int index) {
                                                  toLocal,
                                                  croppedImage);
 
+    //Measure how far each coarser mesh is from the full detail mesh, once morphed. The
+    //error never shrinks for coarser meshes, so the renderer can stop at the first level
+    //that's too coarse.
+    QList<cwTriangulatedData::LevelOfDetail> levels;
+    double lastError = 0.0;
+    foreach(const QVector<uint>& indices, levelIndices) {
+        double error = qMax(lastError, levelOfDetailError(notePoints, points, numberOfFullDetailPoints, indices));
+        levels.append(cwTriangulatedData::LevelOfDetail(indices, error));
+        lastError = error;
+    }
+
     //For testing
     cwTriangulatedData& outScrapData = TriangulatedScraps[index];
     outScrapData.setIndices(triangleData.indices());
     outScrapData.setPoints(points);
     outScrapData.setTexCoords(texCoords);
     outScrapData.setLeadPoints(leadPoints);
+    outScrapData.setLevelsOfDetail(levels);
+    outScrapData.setInputHash(inputHash(scrapData));
+}
+
+/**
+    \brief Triangulates the scrap with a grid
+
+    \param distanceBetweenPoints - The distance between the grid's points, in meters in the cave
+
+    This returns the points, in normalized note coordinates, and the indices of the triangles
+  */
+cwTriangulatedData cwTriangulateTask::triangulateGrid(QRectF bounds,
+                                                      const cwTriangulateInData &scrapData,
+                                                      double distanceBetweenPoints)
+{
+    //Create the regualar mesh that covers the croppedImage
+    PointGrid pointGrid = createPointGrid(bounds, scrapData, distanceBetweenPoints);
+
+    //Label the points and quads of the mesh as inside, outside or on the scrap's outline
+    cwPolygonGridClassifier classifier(pointGrid.Points, pointGrid.GridSize, scrapData.outline());
+
+    //Find all the points in the regualar mesh that are in the scrap's polygon
+    QSet<int> gridPointsInScrap = pointsInPolygon(pointGrid, classifier);
+
+    //Creates list of quads that are on the edges or in the scrap
+    QuadDatabase quads = createQuads(pointGrid, classifier);
+
+    //Triangulate the quads
+    return createTriangles(pointGrid, gridPointsInScrap, quads, classifier);
 }
 
 /**
@@ -155,10 +278,13 @@ void cwTriangulateTask::triangulateScrap(int index) {
 
     \param PointGridSize is the size in normalize note coordinates of the grid.
     \param scrapImage is used to get the original size and dotPerMeter
+    \param distanceBetweenPoints is the grid's resolution, in meters in the cave
 
     This returns a regualar grid.
 */
-cwTriangulateTask::PointGrid cwTriangulateTask::createPointGrid(QRectF bounds, const cwTriangulateInData& scrapData) const {
+cwTriangulateTask::PointGrid cwTriangulateTask::createPointGrid(QRectF bounds,
+                                                                const cwTriangulateInData& scrapData,
+                                                                double distanceBetweenPoints) const {
     PointGrid grid;
 
     cwNoteTranformation noteTransform = scrapData.noteTransform();
@@ -167,8 +293,6 @@ cwTriangulateTask::PointGrid cwTriangulateTask::createPointGrid(QRectF bounds, c
     double sizeOnPaperX = scrapImageSize.width() / scrapData.noteImageResolution(); //in meters
     double sizeOnPaperY = scrapImageSize.height() / scrapData.noteImageResolution(); //in meters
 
-    //TODO: Make distance between points an option that can be adjusted
-    double distanceBetweenPoints = 5.0; //In meters
     double pointsPerMeter = 1.0 / distanceBetweenPoints; //Grid resolution
     double scale = noteTransform.scale(); //scale for the notes
 
@@ -231,15 +355,12 @@ int cwTriangulateTask::PointGrid::index(QPointF point) const
 
     This returns a set of indices that are within the polygon.
 */
-QSet<int> cwTriangulateTask::pointsInPolygon(const cwTriangulateTask::PointGrid &grid, const QPolygonF &polygon) const {
+QSet<int> cwTriangulateTask::pointsInPolygon(const cwTriangulateTask::PointGrid &grid, const cwPolygonGridClassifier& classifier) const {
     QSet<int> inPolygon;
 
     //Go through all the grid points
     for(int i = 0; i < grid.Points.size(); i++) {
-        const QPointF& point = grid.Points[i];
-
-        //See if the grid point containts point
-        if(polygon.containsPoint(point, Qt::OddEvenFill)) {
+        if(classifier.point(i) == cwPolygonGridClassifier::Inside) {
             inPolygon.insert(i);
         }
     }
@@ -256,24 +377,26 @@ QSet<int> cwTriangulateTask::pointsInPolygon(const cwTriangulateTask::PointGrid
   Quads that are outside of the scrap's outline aren't stored in the database, and simply discarded.
   */
 cwTriangulateTask::QuadDatabase cwTriangulateTask::createQuads(const cwTriangulateTask::PointGrid &grid,
-//                                                               const QSet<int> &pointsInScrap,
-                                                               const QPolygonF& polygon) {
+                                                               const cwPolygonGridClassifier& classifier) {
     //The valid grid size, crop out the last band of points
     int width = grid.GridSize.width() - 1;
     int height = grid.GridSize.height() - 1;
 
     QuadDatabase quadDatabase;
 
-    //TODO: Optimization - this loop can be replace by iterating over the pointsInScrap
     for(int y = 0; y < height; y++) {
         for(int x = 0; x < width; x++) {
             int index = grid.index(x, y);
-            Quad quad = grid.quad(index);
 
-            if(grid.intersects(quad, polygon)) {
-                quadDatabase.PartialQuads.append(quad);
-            } else if(grid.quadContainInsideOfPolygon(quad, polygon)) {
-                quadDatabase.FullQuads.append(quad);
+            switch(classifier.cell(index)) {
+            case cwPolygonGridClassifier::Boundary:
+                quadDatabase.PartialQuads.append(grid.quad(index));
+                break;
+            case cwPolygonGridClassifier::Inside:
+                quadDatabase.FullQuads.append(grid.quad(index));
+                break;
+            case cwPolygonGridClassifier::Outside:
+                break;
             }
         }
     }
@@ -292,7 +415,7 @@ cwTriangulateTask::QuadDatabase cwTriangulateTask::createQuads(const cwTriangula
 cwTriangulatedData cwTriangulateTask::createTriangles(const cwTriangulateTask::PointGrid &grid,
                                         const QSet<int> pointsContainedInOutline,
                                         const cwTriangulateTask::QuadDatabase &database,
-                                        const cwTriangulateInData &inScrapData) {
+                                        const cwPolygonGridClassifier& classifier) {
 
     //Resize the outputScrapData to have all points contained in the scrap outline
     QVector<QVector3D> points;
@@ -309,7 +432,7 @@ cwTriangulatedData cwTriangulateTask::createTriangles(const cwTriangulateTask::P
 
     //Do triangulation
     QVector<uint> fullTriangleIndices = createTrianglesFull(database, mapGridToOutputIndices);
-    QVector<QPointF> partialTriangles = createTrianglesPartial(grid, database, inScrapData.outline());
+    QVector<QPointF> partialTriangles = createTrianglesPartial(database, classifier);
 
     //Get the final triangle set
     mergeFullAndPartialTriangles(points, fullTriangleIndices, partialTriangles);
@@ -371,52 +494,20 @@ QVector<uint> cwTriangulateTask::createTrianglesFull(const cwTriangulateTask::Qu
     return triangles;
 }
 
-bool distanceLessThan(const QPair<QPointF, double> &d1, const QPair<QPointF, double> &d2)
-{
-    return d1.second < d2.second;
-}
-
 /**
   This function calculates the edge condition where there are partial boxes
 
-  This function will create a small polygon that's the intersection between the full outline
-  and partial quad.
+  This function will create small polygons that are the intersection between the outline
+  and partial quad.  Only the outline's edges that overlap the quad are used, see
+  cwPolygonGridClassifier::clipCell()
   */
-QVector<QPointF> cwTriangulateTask::createTrianglesPartial(const cwTriangulateTask::PointGrid& grid,
-                                                             const cwTriangulateTask::QuadDatabase &database,
-                                                             const QPolygonF& scrapOutline) {
+QVector<QPointF> cwTriangulateTask::createTrianglesPartial(const cwTriangulateTask::QuadDatabase &database,
+                                                           const cwPolygonGridClassifier& classifier) {
 
     QVector<QPointF> allTriangles;
 
     foreach(const Quad& quad, database.PartialQuads) {
-        QPointF topLeft = grid.Points[quad.topLeft()];
-        QPointF topRight = grid.Points[quad.topRight()];
-        QPointF bottomLeft = grid.Points[quad.bottomLeft()];
-        QPointF bottomRight = grid.Points[quad.bottomRight()];
-
-        QPolygonF quadPolygon;
-        quadPolygon.reserve(5);
-        quadPolygon.append(topLeft);
-        quadPolygon.append(topRight);
-        quadPolygon.append(bottomRight);
-        quadPolygon.append(bottomLeft);
-        quadPolygon.append(topLeft);
-
-        //Find the intersection
-        QPolygonF intesection = scrapOutline.intersected(quadPolygon);
-
-        if(intesection.isEmpty()) {
-            qDebug() << "This is a bug! intesection is empty" << LOCATION;
-            continue;
-        }
-
-        //Close the polygon
-        if(!intesection.isClosed()) {
-            intesection.append(intesection.first());
-        }
-
-        QPolygonF realIntersectionPolygon = addPointsOnOverlapingEdges(intesection);
-        QList<QPolygonF> simplePolygons = createSimplePolygons(realIntersectionPolygon);
+        QList<QPolygonF> simplePolygons = classifier.clipCell(quad.topLeft());
 
         foreach(QPolygonF simplePolygon, simplePolygons) {
             //Triangluate polygon!
@@ -429,10 +520,6 @@ QVector<QPointF> cwTriangulateTask::createTrianglesPartial(const cwTriangulateTa
                 foreach(QPointF point, simplePolygon) {
                     qDebug() << point.x() << point.y();
                 }
-                qDebug() << "**Is closed**:" << simplePolygon.isClosed();
-                foreach(QPointF point, intesection) {
-                    qDebug() << point.x() << point.y();
-                }
                 qDebug() << "-------------------------------";
             }
 
@@ -444,164 +531,129 @@ QVector<QPointF> cwTriangulateTask::createTrianglesPartial(const cwTriangulateTa
 }
 
 /**
- * @brief cwTriangulateTask::fixOverlapingPolygon
- * @param polygon - the polygon that's generated by Qt's intersected
- * @return A polygon that has points on all the overlapping edges
- *
- * This will add points to the polygon where internal axis align edges overlap.
- * This will add points at the begin of the overlapping edges.  This will allow
- * create simplePolygons() to run correctly.
- */
-QPolygonF cwTriangulateTask::addPointsOnOverlapingEdges(QPolygonF polygon) const
-{        //Generate the real polygon
-    QPolygonF realIntersectionPolygon;
-
-    //First go through the intersection and find overlapping points
-    for(int i = 0; i < polygon.size() - 1; i++) {
-        QLineF line(polygon.at(i), polygon.at(i+1));
-
-        realIntersectionPolygon.append(line.p1());
-
-        QList< QPair<QPointF, double> > newPoints; //The new point, distance to p1
-
-        //Go through all the points in the intesection, and see if the point lays on the line
-        //This loop will ignore the points that are already in the line
-        int endIndex = i;
-        int current = (i + 2) % (polygon.size() - 1); //loop around
-        while(current != endIndex) {
-            QPointF point = polygon.at(current);
-
-            //If point lays on the line, then add it to the realIntersectionPolygon
-            //This only checks axis align bits
-            if(line.dx() == 0.0) {
-                if(point.x() == line.p1().x()) {
-                    double minY = qMin(line.p1().y(), line.p2().y());
-                    double maxY = qMax(line.p1().y(), line.p2().y());
-                    if(minY <= point.y() && point.y() <= maxY) {
-                        //Add point to realIntersectionPolygon
-                        double distance = QLineF(point, line.p1()).length();
-                        newPoints.append(QPair<QPointF, double>(point, distance));
-
-                    }
-                }
-            }
-
-            if(line.dy() == 0.0) {
-                if(point.y() == line.p1().y()) {
-                    double minX = qMin(line.p1().x(), line.p2().x());
-                    double maxX = qMax(line.p1().x(), line.p2().x());
-                    if(minX <= point.x() && point.x() <= maxX) {
-                        //Add point to realIntersectionPolygon
-                        double distance = QLineF(point, line.p1()).length();
-                        newPoints.append(QPair<QPointF, double>(point, distance));
-                    }
-                }
-            }
-
-            current = (current + 1) % (polygon.size() - 1); //loop around
-        }
+    This function will add the unAddTriangles into indices.  It will also add triangle's points into
+    points.  This function will attemp to reuse points such all of pointSet's points are unique.
 
+    This function assumes that the points in pointSet are already unique before calling this functions.
+  */
+void cwTriangulateTask::mergeFullAndPartialTriangles(QVector<QVector3D> &pointSet,
+                                                     QVector<uint> &indices,
+                                                     const QVector<QPointF>& unAddedTriangles)
+{
+    static const float PointTolerance = 0.000001f;
 
-        if(!newPoints.isEmpty()) {
-            //Sort new points by distance to line.p1()
-            qStableSort(newPoints.begin(), newPoints.end(), distanceLessThan);
+    //Search for the points in the point set, with a spatial hash of the pointSet
+    cwVertexWelder welder(&pointSet, PointTolerance);
 
-            //Add the sorted points into realIntersectionPolygon
-            for(int ii = 0; ii < newPoints.size(); ii++) {
-                realIntersectionPolygon.append(newPoints.at(ii).first);
-            }
-        }
-    }
-
-    //Close it
-    if(!realIntersectionPolygon.isClosed()) {
-        realIntersectionPolygon.append(realIntersectionPolygon.first());
+    indices.reserve(indices.size() + unAddedTriangles.size());
+    foreach(QPointF unAddedPoint, unAddedTriangles) {
+        //If the point isn't found, it's added to the pointSet
+        indices.append(welder.weld(unAddedPoint));
     }
-
-    return realIntersectionPolygon;
 }
 
 /**
- * @brief cwTriangulateTask::createSimplePolygons
- * @param polygon - A complex polygon, that may contain overlapping axis aligned edges
- * @return A list of simple polygons
- */
-QList<QPolygonF> cwTriangulateTask::createSimplePolygons(QPolygonF polygon) const {
-    //Find polygons from the polygon
-    QList<QPolygonF> simplePolygons;
-    QPolygonF currentSimplePolygon;
-    for(int i = 0; i < polygon.size(); i++) {
-        QPointF point = polygon.at(i);
-        int index = currentSimplePolygon.indexOf(point);
-
-        //Index found?
-        if(index >= 0) {
-            //Create a simple polygon
-            QPolygonF simplePolygon;
-            for(int ii = index; ii < currentSimplePolygon.size(); ii++) {
-                simplePolygon.append(currentSimplePolygon.at(ii));
-            }
-            simplePolygon.append(point);
+    \brief Measures how far a coarser mesh is from the full detail mesh
 
-            if(simplePolygon.isClosed()) {
-                simplePolygon.pop_back();
-            }
+    \param notePoints - All the points, in normalized note coordinates
+    \param points - All the points, morphed into the cave
+    \param numberOfFullDetailPoints - The full detail mesh's points are the first points
+    \param levelIndices - The coarser mesh's triangles
 
-            if(simplePolygon.size() > 2) {
-                simplePolygons.append(simplePolygon);
-            }
+    Each full detail point is found in the coarser mesh's triangles, in note coordinates. The
+    morphed triangle is interpolated there and compared with the morphed point. This returns
+    the largest difference, in meters.
+  */
+double cwTriangulateTask::levelOfDetailError(const QVector<QVector3D> &notePoints,
+                                             const QVector<QVector3D> &points,
+                                             int numberOfFullDetailPoints,
+                                             const QVector<uint> &levelIndices) const
+{
+    int numberOfTriangles = levelIndices.size() / 3;
+    if(numberOfTriangles == 0) { return 0.0; }
+
+    //Bucket the triangles so each point is only tested against the triangles near it
+    QRectF bounds(notePoints.at(levelIndices.first()).toPointF(), QSizeF());
+    foreach(uint index, levelIndices) {
+        QPointF point = notePoints.at(index).toPointF();
+        bounds.setLeft(qMin(bounds.left(), point.x()));
+        bounds.setRight(qMax(bounds.right(), point.x()));
+        bounds.setTop(qMin(bounds.top(), point.y()));
+        bounds.setBottom(qMax(bounds.bottom(), point.y()));
+    }
 
-            //Remove all the points to and including the index
-            currentSimplePolygon.remove(index, currentSimplePolygon.size() - index);
+    int bucketsPerSide = qMax(1, (int)sqrt((double)numberOfTriangles));
+    double bucketWidth = qMax(bounds.width() / bucketsPerSide, 1e-12);
+    double bucketHeight = qMax(bounds.height() / bucketsPerSide, 1e-12);
+
+    QVector< QVector<int> > buckets(bucketsPerSide * bucketsPerSide);
+    for(int i = 0; i < numberOfTriangles; i++) {
+        QPointF p1 = notePoints.at(levelIndices.at(i * 3)).toPointF();
+        QPointF p2 = notePoints.at(levelIndices.at(i * 3 + 1)).toPointF();
+        QPointF p3 = notePoints.at(levelIndices.at(i * 3 + 2)).toPointF();
+        int left = bucket(bounds.left(), bucketWidth, bucketsPerSide, qMin(p1.x(), qMin(p2.x(), p3.x())));
+        int right = bucket(bounds.left(), bucketWidth, bucketsPerSide, qMax(p1.x(), qMax(p2.x(), p3.x())));
+        int top = bucket(bounds.top(), bucketHeight, bucketsPerSide, qMin(p1.y(), qMin(p2.y(), p3.y())));
+        int bottom = bucket(bounds.top(), bucketHeight, bucketsPerSide, qMax(p1.y(), qMax(p2.y(), p3.y())));
+        for(int y = top; y <= bottom; y++) {
+            for(int x = left; x <= right; x++) {
+                buckets[y * bucketsPerSide + x].append(i);
+            }
         }
-
-        currentSimplePolygon.append(point);
     }
 
-    return simplePolygons;
-}
-/**
-    This function will add the unAddTriangles into indices.  It will also add triangle's points into
-    points.  This function will attemp to reuse points such all of pointSet's points are unique.
-
-    This function assumes that the points in pointSet are already unique before calling this functions.
-  */
-void cwTriangulateTask::mergeFullAndPartialTriangles(QVector<QVector3D> &pointSet,
-                                                     QVector<uint> &indices,
-                                                     const QVector<QPointF>& unAddedTriangles)
-{
-    static const float PointTolerance = 0.000001f;
+    double maxError = 0.0;
+    for(int i = 0; i < numberOfFullDetailPoints; i++) {
+        QPointF point = notePoints.at(i).toPointF();
+        int bucketIndex = bucket(bounds.top(), bucketHeight, bucketsPerSide, point.y()) * bucketsPerSide +
+                bucket(bounds.left(), bucketWidth, bucketsPerSide, point.x());
+
+        //Find the triangle that the point is in, or the closest one, if the point is on
+        //the outline and round off puts it a bit outside
+        int bestTriangle = -1;
+        double bestWeights[3] = {0.0, 0.0, 0.0};
+        double bestMinWeight = -std::numeric_limits<double>::max();
+        foreach(int triangle, buckets.at(bucketIndex)) {
+            QPointF p1 = notePoints.at(levelIndices.at(triangle * 3)).toPointF();
+            QPointF p2 = notePoints.at(levelIndices.at(triangle * 3 + 1)).toPointF();
+            QPointF p3 = notePoints.at(levelIndices.at(triangle * 3 + 2)).toPointF();
+
+            double area = (p2.x() - p1.x()) * (p3.y() - p1.y()) - (p2.y() - p1.y()) * (p3.x() - p1.x());
+            if(area == 0.0) { continue; }
+
+            double w1 = ((p2.x() - point.x()) * (p3.y() - point.y()) - (p2.y() - point.y()) * (p3.x() - point.x())) / area;
+            double w2 = ((p3.x() - point.x()) * (p1.y() - point.y()) - (p3.y() - point.y()) * (p1.x() - point.x())) / area;
+            double w3 = 1.0 - w1 - w2;
+            double minWeight = qMin(w1, qMin(w2, w3));
+
+            if(minWeight > bestMinWeight) {
+                bestTriangle = triangle;
+                bestMinWeight = minWeight;
+                bestWeights[0] = w1;
+                bestWeights[1] = w2;
+                bestWeights[2] = w3;
+                if(minWeight >= 0.0) { break; }
+            }
+        }
 
-    foreach(QPointF unAddedPoint, unAddedTriangles) {
+        if(bestTriangle == -1) { continue; }
 
-        bool foundExistIndex = false;
-        uint index;
-
-        //Search for the point in the point set
-        //This is a slow linear search, could be replace with a kd-tree of the pointSet
-        //Good enough for now...
-        for(int i = 0; i < pointSet.size(); i++) {
-            const QVector3D& point = pointSet[i];
-            float xDelta = fabs((float)unAddedPoint.x() - point.x());
-            float yDelta = fabs((float)unAddedPoint.y() - point.y());
-
-            if(xDelta <= PointTolerance && yDelta <= PointTolerance) {
-                //Hey we found the point
-                index = (uint)i;
-                foundExistIndex = true;
-                break;
-            }
+        //Clamp to the triangle
+        double sum = 0.0;
+        for(int j = 0; j < 3; j++) {
+            bestWeights[j] = qMax(0.0, bestWeights[j]);
+            sum += bestWeights[j];
         }
 
-        //If we didn't find the index this is a new point, so add it to the pointSet
-        if(!foundExistIndex) {
-            index = (uint)pointSet.size(); //The last index
-            pointSet.append(QVector3D(unAddedPoint));
+        QVector3D interpolated;
+        for(int j = 0; j < 3; j++) {
+            interpolated += points.at(levelIndices.at(bestTriangle * 3 + j)) * (float)(bestWeights[j] / sum);
         }
 
-        //The next index for the triangles
-        indices.append(index);
+        maxError = qMax(maxError, (double)(interpolated - points.at(i)).length());
     }
+
+    return maxError;
 }
 
 /**
@@ -931,55 +983,3 @@ cwTriangulateTask::Quad cwTriangulateTask::PointGrid::quad(int origin) const {
 
     return cwTriangulateTask::Quad(topLeft, topRight, bottomLeft, bottomRight);
 }
-
-/**
- * @brief cwTriangulateTask::PointGrid::intersects
- * @param polygon
- * @return True if the edges of the quad intersects with the edges of the polygon
- */
-bool cwTriangulateTask::PointGrid::intersects(const cwTriangulateTask::Quad& quad, const QPolygonF &polygon) const
-{
-    if(polygon.size() < 2) { return false; }
-
-    QVector<QLineF> edges;
-    edges.reserve(4);
-    edges.append(QLineF(Points.at(quad.topLeft()), Points.at(quad.topRight())));
-    edges.append(QLineF(Points.at(quad.topRight()), Points.at(quad.bottomRight())));
-    edges.append(QLineF(Points.at(quad.bottomRight()), Points.at(quad.bottomLeft())));
-    edges.append(QLineF(Points.at(quad.bottomLeft()), Points.at(quad.topLeft())));
-
-    QPointF intersectionPoint;
-
-    for(int i = 0; i < polygon.size() - 1; i++) {
-        QLineF polygonEdge(polygon.at(i), polygon.at(i + 1));
-        foreach(QLineF edge, edges) {
-            if(polygonEdge.intersect(edge, &intersectionPoint) == QLineF::BoundedIntersection) {
-                return true;
-            }
-        }
-    }
-
-    if(!polygon.isClosed()) {
-        QLineF polygonEdge(polygon.first(), polygon.last());
-        foreach(QLineF edge, edges) {
-            if(polygonEdge.intersect(edge, &intersectionPoint) == QLineF::BoundedIntersection) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
-/**
- * @brief cwTriangulateTask::PointGrid::containInsideOf
- * @param polygon
- * @return True if the quad is completely inside of the polygon
- */
-bool cwTriangulateTask::PointGrid::quadContainInsideOfPolygon(const cwTriangulateTask::Quad& quad, const QPolygonF &polygon) const
-{
-    return polygon.containsPoint(Points.at(quad.topLeft()), Qt::OddEvenFill) &&
-            polygon.containsPoint(Points.at(quad.topRight()), Qt::OddEvenFill) &&
-            polygon.containsPoint(Points.at(quad.bottomLeft()), Qt::OddEvenFill) &&
-            polygon.containsPoint(Points.at(quad.bottomRight()), Qt::OddEvenFill);
-}
-
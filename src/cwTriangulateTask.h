@@ -14,6 +14,7 @@
 #include "cwTriangulatedData.h"
 #include "cwImage.h"
 #include "cwNoteTranformation.h"
+#include "cwPolygonGridClassifier.h"
 class cwCropImageTask;
 
 //Qt include
@@ -33,6 +34,11 @@ public:
     void setScrapData(QList<cwTriangulateInData> scraps);
     void setProjectFilename(QString filename);
 
+    void setDistanceBetweenPoints(double meters);
+    double distanceBetweenPoints() const;
+
+    QByteArray inputHash(const cwTriangulateInData& scrapData) const;
+
     //Outputs of the task
     QList<cwTriangulatedData> triangulatedScrapData() const;
 
@@ -84,9 +90,6 @@ private:
         QVector<QPointF> Points;
         QSizeF GridDeltaSize; //In PointsPerMeter
 
-        bool intersects(const Quad& quad, const QPolygonF &polygon) const;
-        bool quadContainInsideOfPolygon(const Quad& quad, const QPolygonF& polygon) const;
-
         Quad quad(int origin) const;
         int index(int x, int y) const;
         int index(QPointF point) const;
@@ -123,6 +126,7 @@ private:
     //Inputs
     QList<cwTriangulateInData> Scraps;
     QString ProjectFilename;
+    double DistanceBetweenPoints; //!< For the full detail mesh, in meters in the cave
 
     //Outputs
     QList<cwTriangulatedData> TriangulatedScraps;
@@ -134,16 +138,15 @@ private:
 
     void triangulateScraps();
     void triangulateScrap(int index);
-    PointGrid createPointGrid(QRectF bounds, const cwTriangulateInData& scrapData) const;
-    QSet<int> pointsInPolygon(const PointGrid& grid, const QPolygonF& polygon) const;
-    QuadDatabase createQuads(const PointGrid& grid, const QPolygonF& polygon);
+    cwTriangulatedData triangulateGrid(QRectF bounds, const cwTriangulateInData& scrapData, double distanceBetweenPoints);
+    PointGrid createPointGrid(QRectF bounds, const cwTriangulateInData& scrapData, double distanceBetweenPoints) const;
+    QSet<int> pointsInPolygon(const PointGrid& grid, const cwPolygonGridClassifier& classifier) const;
+    QuadDatabase createQuads(const PointGrid& grid, const cwPolygonGridClassifier& classifier);
 
     //For triangulation
-    cwTriangulatedData createTriangles(const PointGrid& grid, const QSet<int> pointsInOutline, const QuadDatabase& database, const cwTriangulateInData& inScrapData);
+    cwTriangulatedData createTriangles(const PointGrid& grid, const QSet<int> pointsInOutline, const QuadDatabase& database, const cwPolygonGridClassifier& classifier);
     QVector<uint> createTrianglesFull(const QuadDatabase& database, const QHash<int, int>& mapGridToOut);
-    QVector<QPointF> createTrianglesPartial(const PointGrid& grid, const QuadDatabase &database, const QPolygonF& scrapOutline);
-    QPolygonF addPointsOnOverlapingEdges(QPolygonF polygon) const;
-    QList<QPolygonF> createSimplePolygons(QPolygonF polygon) const;
+    QVector<QPointF> createTrianglesPartial(const QuadDatabase &database, const cwPolygonGridClassifier& classifier);
     void mergeFullAndPartialTriangles(QVector<QVector3D>& pointSet, QVector<uint>& indices, const QVector<QPointF>& unAddedTriangles);
 
     //For transformation from note coords to local note coords
@@ -152,6 +155,12 @@ private:
     QVector<QVector2D> mapTexCoordinates(const QVector<QVector3D>& normalizeNoteCoords) const;
     QVector<QVector2D> scaleTexCoordinates(const cwImage& image, QVector<QVector2D> texCoords) const;
 
+    //For levels of detail
+    double levelOfDetailError(const QVector<QVector3D>& notePoints,
+                              const QVector<QVector3D>& points,
+                              int numberOfFullDetailPoints,
+                              const QVector<uint>& levelIndices) const;
+
     //For morphing
     QVector<QVector3D> morphPoints(const QVector<QVector3D> &notePoints, const cwTriangulateInData &scrapData, const QMatrix4x4& toLocal, const cwImage& croppedImage);
     QList<cwTriangulateStation> stationsVisibleToPoint(const QVector3D& point, const QList<cwTriangulateStation>& stations, const QPolygonF& scrapOutline) const;
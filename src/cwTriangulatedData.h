@@ -16,10 +16,35 @@
 #include <QVector>
 #include <QVector3D>
 #include <QVector2D>
+#include <QList>
+#include <QByteArray>
 
 class cwTriangulatedData
 {
 public:
+    /**
+     * @brief The LevelOfDetail class
+     *
+     * A coarser mesh of the scrap. Its indices point into the same points and texCoords
+     * as the full detail mesh. The error is the furthest, in meters, that the coarser
+     * mesh is from the full detail mesh.
+     */
+    class LevelOfDetail {
+    public:
+        LevelOfDetail() : Error(0.0) {}
+        LevelOfDetail(QVector<uint> indices, double error) :
+            Indices(indices),
+            Error(error)
+        {}
+
+        QVector<uint> indices() const { return Indices; }
+        double error() const { return Error; }
+
+    private:
+        QVector<uint> Indices;
+        double Error;
+    };
+
     cwTriangulatedData();
 
     cwImage croppedImage() const;
@@ -37,6 +62,12 @@ public:
     QVector<QVector3D> leadPoints() const;
     void setLeadPoints(QVector<QVector3D> points);
 
+    QList<LevelOfDetail> levelsOfDetail() const;
+    void setLevelsOfDetail(QList<LevelOfDetail> levels);
+
+    QByteArray inputHash() const;
+    void setInputHash(QByteArray hash);
+
     bool isStale() const;
     void setStale(bool isStale);
 
@@ -54,6 +85,8 @@ private:
         QVector<QVector2D> texCoords;
         QVector<uint> indices;
         QVector<QVector3D> leadPoints;
+        QList<LevelOfDetail> levelsOfDetail;
+        QByteArray inputHash;
         bool Stale;
     };
 
@@ -136,6 +169,50 @@ inline void cwTriangulatedData::setLeadPoints(QVector<QVector3D> points)
     Data->leadPoints = points;
 }
 
+/**
+ * @brief cwTriangulatedData::levelsOfDetail
+ * @return The coarser meshes of the scrap, from the finest to the coarsest
+ *
+ * indices() is always the full detail mesh. This is empty if the scrap is too small to
+ * have coarser meshes, or if it was triangulated before they were added.
+ */
+inline QList<cwTriangulatedData::LevelOfDetail> cwTriangulatedData::levelsOfDetail() const
+{
+    return Data->levelsOfDetail;
+}
+
+/**
+ * @brief cwTriangulatedData::setLevelsOfDetail
+ * @param levels - The coarser meshes, from the finest to the coarsest
+ *
+ * This should only be set by the cwTriangulateTask
+ */
+inline void cwTriangulatedData::setLevelsOfDetail(QList<LevelOfDetail> levels)
+{
+    Data->levelsOfDetail = levels;
+}
+
+/**
+ * @brief cwTriangulatedData::inputHash
+ * @return The cwTriangulateTask::inputHash() of the input that this data was created from
+ *
+ * This is empty for data that was triangulated before the hash was added.
+ */
+inline QByteArray cwTriangulatedData::inputHash() const
+{
+    return Data->inputHash;
+}
+
+/**
+ * @brief cwTriangulatedData::setInputHash
+ * @param hash - The cwTriangulateTask::inputHash() of the input
+ *
+ * This should only be set by the cwTriangulateTask
+ */
+inline void cwTriangulatedData::setInputHash(QByteArray hash)
+{
+    Data->inputHash = hash;
+}
 
 /**
  * @brief cwTriangulatedData::stale
@@ -5,10 +5,511 @@
 **
 **************************************************************************/
 
+//Our includes
 #include "cwTripStatistics.h"
+#include "cwTrip.h"
+#include "cwTripCalibration.h"
 
-//cwTripStatistics::cwTripStatistics(QObject *parent) :
-//    cwTask(parent)
-//{
+//Qt includes
+#include <QSet>
 
-//}
+cwTripStatistics::cwTripStatistics(QObject *parent) :
+    QObject(parent),
+    Distance(0),
+    ShotCount(0),
+    StationCount(0),
+    Length(0.0)
+{
+}
+
+/**
+ * @brief cwTripStatistics::setTrip
+ * @param trip - The trip that statistics are kept for
+ *
+ * This counts the trip's chunks once. After that, the totals are only updated for the cells that
+ * change.
+ */
+void cwTripStatistics::setTrip(cwTrip *trip)
+{
+    if(Trip != trip) {
+        double oldLength = Length;
+        int oldShotCount = ShotCount;
+        int oldStationCount = StationCount;
+
+        disconnectTrip();
+
+        Trip = trip;
+
+        if(!Trip.isNull()) {
+            connect(Trip, SIGNAL(destroyed()), SLOT(tripDestroyed()));
+            connect(Trip, SIGNAL(chunksInserted(int,int)), SLOT(chunksInserted(int,int)));
+            connect(Trip, SIGNAL(chunksRemoved(int,int)), SLOT(chunksRemoved()));
+            connect(Trip->calibrations(), SIGNAL(tapeCalibrationChanged(double)), SLOT(tapeCalibrationChanged()));
+
+            foreach(cwSurveyChunk* chunk, Trip->chunks()) {
+                addChunk(chunk);
+            }
+        }
+
+        updateLength();
+        emitChanges(oldLength, oldShotCount, oldStationCount);
+        emit tripChanged();
+    }
+}
+
+/**
+ * @brief cwTripStatistics::chunkLength
+ * @return The length of the chunk without the tape calibration
+ */
+double cwTripStatistics::chunkLength(cwSurveyChunk *chunk) const
+{
+    return fromFixedPoint(Chunks.value(chunk).Distance);
+}
+
+/**
+ * @brief cwTripStatistics::chunkShotCount
+ * @return The number of shots in the chunk that are included in the length
+ */
+int cwTripStatistics::chunkShotCount(cwSurveyChunk *chunk) const
+{
+    return Chunks.value(chunk).ShotCount;
+}
+
+/**
+ * @brief cwTripStatistics::chunkStationCount
+ * @return The number of named stations in the chunk
+ */
+int cwTripStatistics::chunkStationCount(cwSurveyChunk *chunk) const
+{
+    return Chunks.value(chunk).StationCount;
+}
+
+void cwTripStatistics::chunksInserted(int begin, int end)
+{
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    for(int i = begin; i <= end; i++) {
+        addChunk(Trip->chunk(i));
+    }
+
+    updateLength();
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+/**
+ * @brief cwTripStatistics::chunksRemoved
+ *
+ * Removes the statistics for all the chunks that are no longer in the trip
+ */
+void cwTripStatistics::chunksRemoved()
+{
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    QSet<cwSurveyChunk*> tripChunks = Trip->chunks().toSet();
+    foreach(cwSurveyChunk* chunk, Chunks.keys()) {
+        if(!tripChunks.contains(chunk)) {
+            removeChunk(chunk);
+        }
+    }
+
+    updateLength();
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+/**
+ * @brief cwTripStatistics::chunkDestroyed
+ *
+ * The chunk is already partially destroyed, so this only drops its statistics
+ */
+void cwTripStatistics::chunkDestroyed(QObject *chunk)
+{
+    cwSurveyChunk* key = static_cast<cwSurveyChunk*>(chunk);
+    if(!Chunks.contains(key)) {
+        return;
+    }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    addTotals(Chunks.value(key), -1);
+    Chunks.remove(key);
+
+    updateLength();
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+void cwTripStatistics::shotsAdded(int begin, int end)
+{
+    cwSurveyChunk* chunk = static_cast<cwSurveyChunk*>(sender());
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    if(stats->ShotDistances.size() + (end - begin + 1) != chunk->shotCount()) {
+        recountChunk(chunk);
+    } else {
+        for(int i = begin; i <= end; i++) {
+            stats->ShotDistances.insert(i, 0);
+            stats->ShotCounted.insert(i, false);
+            setShot(*stats, chunk, i);
+        }
+    }
+
+    updateLength();
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+void cwTripStatistics::shotsRemoved(int begin, int end)
+{
+    cwSurveyChunk* chunk = static_cast<cwSurveyChunk*>(sender());
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    if(stats->ShotDistances.size() - (end - begin + 1) != chunk->shotCount()) {
+        recountChunk(chunk);
+    } else {
+        for(int i = begin; i <= end; i++) {
+            ShotCount -= stats->ShotCounted.at(i);
+            stats->ShotCount -= stats->ShotCounted.at(i);
+            Distance -= stats->ShotDistances.at(i);
+            stats->Distance -= stats->ShotDistances.at(i);
+        }
+        stats->ShotDistances.remove(begin, end - begin + 1);
+        stats->ShotCounted.remove(begin, end - begin + 1);
+    }
+
+    updateLength();
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+void cwTripStatistics::stationsAdded(int begin, int end)
+{
+    cwSurveyChunk* chunk = static_cast<cwSurveyChunk*>(sender());
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    if(stats->StationCounted.size() + (end - begin + 1) != chunk->stationCount()) {
+        recountChunk(chunk);
+    } else {
+        for(int i = begin; i <= end; i++) {
+            stats->StationCounted.insert(i, false);
+            setStation(*stats, chunk, i);
+        }
+    }
+
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+void cwTripStatistics::stationsRemoved(int begin, int end)
+{
+    cwSurveyChunk* chunk = static_cast<cwSurveyChunk*>(sender());
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    if(stats->StationCounted.size() - (end - begin + 1) != chunk->stationCount()) {
+        recountChunk(chunk);
+    } else {
+        for(int i = begin; i <= end; i++) {
+            StationCount -= stats->StationCounted.at(i);
+            stats->StationCount -= stats->StationCounted.at(i);
+        }
+        stats->StationCounted.remove(begin, end - begin + 1);
+    }
+
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+/**
+ * @brief cwTripStatistics::chunkDataChanged
+ *
+ * Only the station name, shot distance and the included flag change the totals
+ */
+void cwTripStatistics::chunkDataChanged(cwSurveyChunk::DataRole role, int index)
+{
+    if(role != cwSurveyChunk::StationNameRole &&
+            role != cwSurveyChunk::ShotDistanceRole &&
+            role != cwSurveyChunk::ShotDistanceIncludedRole)
+    {
+        return;
+    }
+
+    cwSurveyChunk* chunk = static_cast<cwSurveyChunk*>(sender());
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    if(role == cwSurveyChunk::StationNameRole) {
+        if(index >= 0 && index < stats->StationCounted.size()) {
+            setStation(*stats, chunk, index);
+        }
+    } else {
+        if(index >= 0 && index < stats->ShotDistances.size()) {
+            setShot(*stats, chunk, index);
+        }
+        updateLength();
+    }
+
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+}
+
+void cwTripStatistics::tapeCalibrationChanged()
+{
+    double oldLength = Length;
+    updateLength();
+    emitChanges(oldLength, ShotCount, StationCount);
+}
+
+/**
+ * @brief cwTripStatistics::updateLength
+ *
+ * Applies the tape calibration to the distance
+ */
+void cwTripStatistics::updateLength()
+{
+    double tapeCalibration = Trip.isNull() ? 0.0 : Trip->calibrations()->tapeCalibration();
+    Length = fromFixedPoint(Distance) + tapeCalibration * (double)ShotCount;
+}
+
+/**
+ * @brief cwTripStatistics::tripDestroyed
+ *
+ * Resets all the totals to zero
+ */
+void cwTripStatistics::tripDestroyed()
+{
+    double oldLength = Length;
+    int oldShotCount = ShotCount;
+    int oldStationCount = StationCount;
+
+    disconnectTrip();
+    updateLength();
+
+    emitChanges(oldLength, oldShotCount, oldStationCount);
+    emit tripChanged();
+}
+
+/**
+ * @brief cwTripStatistics::disconnectTrip
+ *
+ * Disconnects from the trip and all its chunks, and clears the totals
+ */
+void cwTripStatistics::disconnectTrip()
+{
+    if(!Trip.isNull()) {
+        disconnect(Trip, nullptr, this, nullptr);
+        disconnect(Trip->calibrations(), nullptr, this, nullptr);
+
+        foreach(cwSurveyChunk* chunk, Chunks.keys()) {
+            disconnect(chunk, nullptr, this, nullptr);
+        }
+    }
+
+    Trip = nullptr;
+    clear();
+}
+
+/**
+ * @brief cwTripStatistics::addChunk
+ *
+ * Counts the chunk and starts listening to its changes
+ */
+void cwTripStatistics::addChunk(cwSurveyChunk *chunk)
+{
+    if(chunk == nullptr || Chunks.contains(chunk)) { return; }
+
+    connect(chunk, SIGNAL(destroyed(QObject*)), SLOT(chunkDestroyed(QObject*)));
+    connect(chunk, SIGNAL(shotsAdded(int,int)), SLOT(shotsAdded(int,int)));
+    connect(chunk, SIGNAL(shotsRemoved(int,int)), SLOT(shotsRemoved(int,int)));
+    connect(chunk, SIGNAL(stationsAdded(int,int)), SLOT(stationsAdded(int,int)));
+    connect(chunk, SIGNAL(stationsRemoved(int,int)), SLOT(stationsRemoved(int,int)));
+    connect(chunk, SIGNAL(dataChanged(cwSurveyChunk::DataRole,int)), SLOT(chunkDataChanged(cwSurveyChunk::DataRole,int)));
+
+    Chunks.insert(chunk, ChunkStatistics());
+    recountChunk(chunk);
+}
+
+/**
+ * @brief cwTripStatistics::removeChunk
+ *
+ * Subtracts the chunk from the totals and stops listening to it
+ */
+void cwTripStatistics::removeChunk(cwSurveyChunk *chunk)
+{
+    if(!Chunks.contains(chunk)) { return; }
+
+    disconnect(chunk, nullptr, this, nullptr);
+    addTotals(Chunks.value(chunk), -1);
+    Chunks.remove(chunk);
+}
+
+/**
+ * @brief cwTripStatistics::recountChunk
+ *
+ * Counts every shot and station in the chunk. This is only used when the chunk is first added, or
+ * if the chunk was changed without the signals that are used to keep the totals.
+ */
+void cwTripStatistics::recountChunk(cwSurveyChunk *chunk)
+{
+    ChunkStatistics* stats = chunkStatistics(chunk);
+    if(stats == nullptr) { return; }
+
+    addTotals(*stats, -1);
+
+    //Stream over the chunk's columns, instead of creating a cwShot and cwStation for each one
+    const cwSurveyChunkColumns& columns = chunk->columns();
+    const double* distances = columns.distance().constData();
+    const quint8* distanceStates = columns.distanceStates().constData();
+    const quint8* distanceIncluded = columns.distanceIncluded().constData();
+
+    ChunkStatistics newStats;
+    newStats.ShotDistances.resize(columns.shotCount());
+    newStats.ShotCounted.resize(columns.shotCount());
+    newStats.StationCounted.resize(columns.stationCount());
+
+    for(int i = 0; i < columns.shotCount(); i++) {
+        bool counted = distanceStates[i] == cwDistanceStates::Valid && distanceIncluded[i];
+        newStats.ShotCounted[i] = counted;
+        newStats.ShotDistances[i] = counted ? toFixedPoint(distances[i]) : 0;
+        newStats.ShotCount += counted;
+        newStats.Distance += newStats.ShotDistances.at(i);
+    }
+
+    for(int i = 0; i < columns.stationCount(); i++) {
+        bool counted = !columns.name(i).isEmpty();
+        newStats.StationCounted[i] = counted;
+        newStats.StationCount += counted;
+    }
+
+    *stats = newStats;
+    addTotals(*stats, 1);
+}
+
+/**
+ * @brief cwTripStatistics::clear
+ *
+ * Clears all the chunks and totals, without emitting
+ */
+void cwTripStatistics::clear()
+{
+    Chunks.clear();
+    Distance = 0;
+    ShotCount = 0;
+    StationCount = 0;
+}
+
+/**
+ * @brief cwTripStatistics::chunkStatistics
+ * @return The statistics for chunk, or nullptr if the chunk isn't part of the trip
+ */
+cwTripStatistics::ChunkStatistics *cwTripStatistics::chunkStatistics(QObject *chunk)
+{
+    QHash<cwSurveyChunk*, ChunkStatistics>::iterator iter = Chunks.find(static_cast<cwSurveyChunk*>(chunk));
+    if(iter == Chunks.end()) {
+        return nullptr;
+    }
+    return &(iter.value());
+}
+
+/**
+ * @brief cwTripStatistics::setShot
+ *
+ * Replaces the shot's old distance with the chunk's current one. Only the difference is applied
+ * to the chunk's and the trip's totals.
+ */
+void cwTripStatistics::setShot(ChunkStatistics &stats, const cwSurveyChunk *chunk, int index)
+{
+    const cwSurveyChunkColumns& columns = chunk->columns();
+    bool counted = columns.distanceStates().at(index) == cwDistanceStates::Valid &&
+            columns.distanceIncluded().at(index);
+    int countDelta = (int)counted - (int)stats.ShotCounted.at(index);
+
+    qint64 distance = counted ? toFixedPoint(columns.distance().at(index)) : 0;
+    qint64 distanceDelta = distance - stats.ShotDistances.at(index);
+
+    stats.ShotDistances[index] = distance;
+    stats.ShotCounted[index] = counted;
+
+    stats.ShotCount += countDelta;
+    ShotCount += countDelta;
+
+    stats.Distance += distanceDelta;
+    Distance += distanceDelta;
+}
+
+/**
+ * @brief cwTripStatistics::setStation
+ *
+ * Updates if the station at index is counted
+ */
+void cwTripStatistics::setStation(ChunkStatistics &stats, const cwSurveyChunk *chunk, int index)
+{
+    bool counted = !chunk->columns().name(index).isEmpty();
+    int countDelta = (int)counted - (int)stats.StationCounted.at(index);
+
+    stats.StationCounted[index] = counted;
+    stats.StationCount += countDelta;
+    StationCount += countDelta;
+}
+
+/**
+ * @brief cwTripStatistics::addTotals
+ * @param sign - 1 to add the chunk's totals to the trip's totals, -1 to subtract them
+ */
+void cwTripStatistics::addTotals(const ChunkStatistics &stats, int sign)
+{
+    Distance += sign * stats.Distance;
+    ShotCount += sign * stats.ShotCount;
+    StationCount += sign * stats.StationCount;
+}
+
+/**
+ * @brief cwTripStatistics::emitChanges
+ *
+ * Emits the notify signals for the totals that are different from the old values
+ */
+void cwTripStatistics::emitChanges(double oldLength, int oldShotCount, int oldStationCount)
+{
+    bool changed = false;
+
+    if(oldLength != Length) {
+        emit lengthChanged();
+        changed = true;
+    }
+
+    if(oldShotCount != ShotCount) {
+        emit shotCountChanged();
+        changed = true;
+    }
+
+    if(oldStationCount != StationCount) {
+        emit stationCountChanged();
+        changed = true;
+    }
+
+    if(changed) {
+        emit statisticsChanged();
+    }
+}
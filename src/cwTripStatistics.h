@@ -8,25 +8,169 @@
 #ifndef CWTRIPSTATISTICS_H
 #define CWTRIPSTATISTICS_H
 
+//Our includes
+#include "cwGlobals.h"
+#include "cwSurveyChunk.h"
+class cwTrip;
 
-//class cwTripStatistics : public cwTask
-//{
-//    Q_OBJECT
-//public:
-//    explicit cwTripStatistics(QObject *parent = 0);
+//Qt includes
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QVector>
 
-//    void setTrip(cwTrip* trip);
+/**
+ * @brief The cwTripStatistics class
+ *
+ * Keeps a trip's length, shot count and station count up to date.
+ *
+ * Each chunk's shot distances are cached, so an edit to a single cell only reads that cell from
+ * the chunk, and only the difference is applied to the chunk's and the trip's totals. Distances
+ * are kept as integer millionths of the trip's distance unit, so the running totals are exact and
+ * don't drift over many edits. The totals are up to date as soon as the chunk emits its change
+ * signals, without rescanning the trip in a background task.
+ *
+ * The length includes the trip's tape calibration. Only valid distances that are included in the
+ * length are counted as shots.
+ */
+class CAVEWHERE_LIB_EXPORT cwTripStatistics : public QObject
+{
+    Q_OBJECT
 
-//    int numberOfStations();
-//    int numberOfShots();
+    Q_PROPERTY(cwTrip* trip READ trip WRITE setTrip NOTIFY tripChanged)
+    Q_PROPERTY(double length READ length NOTIFY lengthChanged)
+    Q_PROPERTY(int shotCount READ shotCount NOTIFY shotCountChanged)
+    Q_PROPERTY(int stationCount READ stationCount NOTIFY stationCountChanged)
 
-//signals:
+public:
+    explicit cwTripStatistics(QObject *parent = 0);
 
-//public slots:
+    cwTrip* trip() const;
+    void setTrip(cwTrip* trip);
 
-//    int NumberOfStations;
-//    int NumberOfShots;
+    double length() const;
+    int shotCount() const;
+    int stationCount() const;
 
-//};
+    Q_INVOKABLE double chunkLength(cwSurveyChunk* chunk) const;
+    Q_INVOKABLE int chunkShotCount(cwSurveyChunk* chunk) const;
+    Q_INVOKABLE int chunkStationCount(cwSurveyChunk* chunk) const;
+
+signals:
+    void tripChanged();
+    void lengthChanged();
+    void shotCountChanged();
+    void stationCountChanged();
+
+    /**
+     * Emitted once after any of the totals change
+     */
+    void statisticsChanged();
+
+private slots:
+    void chunksInserted(int begin, int end);
+    void chunksRemoved();
+    void chunkDestroyed(QObject* chunk);
+
+    void shotsAdded(int begin, int end);
+    void shotsRemoved(int begin, int end);
+    void stationsAdded(int begin, int end);
+    void stationsRemoved(int begin, int end);
+    void chunkDataChanged(cwSurveyChunk::DataRole role, int index);
+
+    void tapeCalibrationChanged();
+    void tripDestroyed();
+
+private:
+    class ChunkStatistics {
+    public:
+        ChunkStatistics() : Distance(0), ShotCount(0), StationCount(0) {}
+
+        QVector<qint64> ShotDistances; //!< See toFixedPoint(), 0 for shots that aren't counted
+        QVector<quint8> ShotCounted;
+        QVector<quint8> StationCounted;
+
+        qint64 Distance;
+        int ShotCount;
+        int StationCount;
+    };
+
+    QPointer<cwTrip> Trip;
+    QHash<cwSurveyChunk*, ChunkStatistics> Chunks;
+
+    //Totals over all the chunks
+    qint64 Distance; //!< See toFixedPoint()
+    int ShotCount;
+    int StationCount;
+
+    double Length; //!< Distance plus the tape calibration
+
+    void addChunk(cwSurveyChunk* chunk);
+    void removeChunk(cwSurveyChunk* chunk);
+    void recountChunk(cwSurveyChunk* chunk);
+    void disconnectTrip();
+    void clear();
+    void updateLength();
+
+    ChunkStatistics* chunkStatistics(QObject* chunk);
+    void setShot(ChunkStatistics& stats, const cwSurveyChunk* chunk, int index);
+    void setStation(ChunkStatistics& stats, const cwSurveyChunk* chunk, int index);
+    void addTotals(const ChunkStatistics& stats, int sign);
+
+    void emitChanges(double oldLength, int oldShotCount, int oldStationCount);
+
+    static qint64 toFixedPoint(double distance);
+    static double fromFixedPoint(qint64 distance);
+};
+
+/**
+ * @brief cwTripStatistics::trip
+ * @return The trip that the statistics are computed for
+ */
+inline cwTrip* cwTripStatistics::trip() const {
+    return Trip;
+}
+
+/**
+ * @brief cwTripStatistics::length
+ * @return The length of the trip, including the tape calibration
+ */
+inline double cwTripStatistics::length() const {
+    return Length;
+}
+
+/**
+ * @brief cwTripStatistics::shotCount
+ * @return The number of shots that are included in the length
+ */
+inline int cwTripStatistics::shotCount() const {
+    return ShotCount;
+}
+
+/**
+ * @brief cwTripStatistics::stationCount
+ * @return The number of named stations in the trip's chunks. A station that ends one chunk and
+ * starts the next is counted in both.
+ */
+inline int cwTripStatistics::stationCount() const {
+    return StationCount;
+}
+
+/**
+ * @brief cwTripStatistics::toFixedPoint
+ * @return The distance in millionths of the trip's distance unit. Survey distances are never
+ * entered that precisely, so this doesn't lose anything, and adding and subtracting is exact.
+ */
+inline qint64 cwTripStatistics::toFixedPoint(double distance) {
+    return qRound64(distance * 1e6);
+}
+
+/**
+ * @brief cwTripStatistics::fromFixedPoint
+ * @return The distance from toFixedPoint() in the trip's distance unit
+ */
+inline double cwTripStatistics::fromFixedPoint(qint64 distance) {
+    return distance / 1e6;
+}
 
 #endif // CWTRIPSTATISTICS_H
@@ -18,8 +18,7 @@
 cwUsedStationTaskManager::cwUsedStationTaskManager(QObject *parent) :
     QObject(parent),
     Cave(nullptr),
-    Threaded(false),
-    Thread(nullptr)
+    Threaded(false)
 
 {
     Task = new cwUsedStationsTask();
@@ -28,13 +27,7 @@ cwUsedStationTaskManager::cwUsedStationTaskManager(QObject *parent) :
 }
 
 cwUsedStationTaskManager::~cwUsedStationTaskManager() {
-    Task->stop();
-
-    if(threaded()) {
-        Thread->quit(); //Quit the event loop
-        Thread->wait(); //wait to finish
-    }
-
+    Task->stopAndWait();
     delete Task;
 }
 
@@ -337,20 +330,9 @@ void cwUsedStationTaskManager::setThreaded(bool threaded) {
         Threaded = threaded;
 
         if(Threaded) {
-            //Creating the thread
-            Q_ASSERT(Thread == nullptr);
-            Thread = new QThread(this);
-            Thread->start();
-
-            Task->setThread(Thread);
+            Task->setThread(cwTaskScheduler::Background);
         } else {
             Task->setThread(QThread::currentThread());
-
-            Thread->quit();
-            Thread->wait();
-
-            Thread->deleteLater();
-            Thread = nullptr;
         }
 
         emit threadedChanged();
@@ -113,7 +113,6 @@ private:
     cwUsedStationsTask::Settings TaskSettings;
 
     bool Threaded; //!<
-    QThread* Thread; //The thread that the task will use
 
     QList<QString> uoallCaveStationNames() const;
     void hookupCaveToTask();
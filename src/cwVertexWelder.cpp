@@ -0,0 +1,95 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Our includes
+#include "cwVertexWelder.h"
+
+//Std includes
+#include <cmath>
+
+/**
+ * @brief cwVertexWelder::cwVertexWelder
+ * @param pointSet - The points to weld to, these should already be unique. New points are
+ * appended to it by weld()
+ * @param tolerance - How far apart, in x and y, two points can be and still be the same point
+ */
+cwVertexWelder::cwVertexWelder(QVector<QVector3D> *pointSet, float tolerance) :
+    PointSet(pointSet),
+    Tolerance(tolerance),
+    BucketSize(2.0 * tolerance)
+{
+    Q_ASSERT(tolerance > 0.0f);
+
+    BucketHeads.reserve(PointSet->size());
+    NextInBucket.reserve(PointSet->size());
+    for(int i = 0; i < PointSet->size(); i++) {
+        addToBucket(i);
+    }
+}
+
+/**
+ * @brief cwVertexWelder::weld
+ * @param point - The point that's looked up
+ * @return The index of the point in the point set. If there's no point within the tolerance, the
+ * point is appended to the point set, and its new index is returned.
+ */
+uint cwVertexWelder::weld(const QPointF &point)
+{
+    float x = (float)point.x();
+    float y = (float)point.y();
+
+    BucketKey key = bucket(x, y);
+
+    int found = -1;
+    for(qint64 bucketY = key.second - 1; bucketY <= key.second + 1; bucketY++) {
+        for(qint64 bucketX = key.first - 1; bucketX <= key.first + 1; bucketX++) {
+            int current = BucketHeads.value(BucketKey(bucketX, bucketY), -1);
+            while(current != -1) {
+                const QVector3D& existing = PointSet->at(current);
+                float xDelta = fabs(x - existing.x());
+                float yDelta = fabs(y - existing.y());
+
+                if(xDelta <= Tolerance && yDelta <= Tolerance && (found == -1 || current < found)) {
+                    found = current;
+                }
+
+                current = NextInBucket.at(current);
+            }
+        }
+    }
+
+    if(found != -1) {
+        return (uint)found;
+    }
+
+    PointSet->append(QVector3D(point));
+    addToBucket(PointSet->size() - 1);
+    return (uint)(PointSet->size() - 1);
+}
+
+/**
+ * @brief cwVertexWelder::bucket
+ * @return The bucket that x and y are in
+ */
+cwVertexWelder::BucketKey cwVertexWelder::bucket(float x, float y) const
+{
+    return BucketKey((qint64)floor(x / BucketSize), (qint64)floor(y / BucketSize));
+}
+
+/**
+ * @brief cwVertexWelder::addToBucket
+ * @param index - The index of the point in the point set
+ */
+void cwVertexWelder::addToBucket(int index)
+{
+    const QVector3D& point = PointSet->at(index);
+    BucketKey key = bucket(point.x(), point.y());
+
+    Q_ASSERT(NextInBucket.size() == index);
+    NextInBucket.append(BucketHeads.value(key, -1));
+    BucketHeads.insert(key, index);
+}
@@ -0,0 +1,56 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+#ifndef CWVERTEXWELDER_H
+#define CWVERTEXWELDER_H
+
+//Our includes
+#include "cwGlobals.h"
+
+//Qt includes
+#include <QVector>
+#include <QVector3D>
+#include <QPointF>
+#include <QPair>
+#include <QHash>
+
+/**
+ * @brief The cwVertexWelder class
+ *
+ * Finds the index of a point in a point set, within a tolerance, and adds it if it isn't there.
+ * cwTriangulateTask uses this to weld the partial quad triangles to the full quad points.
+ *
+ * The points are hashed into square buckets that are twice the tolerance wide, so a point that's
+ * within the tolerance is always in the bucket of the point, or one of its eight neighbors. When
+ * more than one point is within the tolerance, the point with the lowest index is used, which is
+ * what a linear search of the point set would find.
+ *
+ * Points are compared like cwTriangulateTask always has, in float, with the tolerance applied to x
+ * and y separately. The z of the point set isn't used.
+ */
+class CAVEWHERE_LIB_EXPORT cwVertexWelder
+{
+public:
+    cwVertexWelder(QVector<QVector3D>* pointSet, float tolerance);
+
+    uint weld(const QPointF& point);
+
+private:
+    typedef QPair<qint64, qint64> BucketKey;
+
+    QVector<QVector3D>* PointSet;
+    float Tolerance;
+    double BucketSize;
+
+    QHash<BucketKey, int> BucketHeads; //!< The most recently added point of each bucket
+    QVector<int> NextInBucket; //!< The next point in the same bucket, or -1, indexed by point
+
+    BucketKey bucket(float x, float y) const;
+    void addToBucket(int index);
+};
+
+#endif // CWVERTEXWELDER_H
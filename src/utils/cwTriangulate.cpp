@@ -3,15 +3,15 @@
 #include "cwTriangulate.h"
 
 //Qt includes
+#include <QPair>
 #include <QPolygonF>
 
 //Std includes
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <assert.h>
-
-static const double EPSILON=0.00000000001;
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <set>
+#include <vector>
 
 double cwTriangulate::Area(const QVector<QPointF> &contour)
 {
@@ -54,97 +54,745 @@ bool cwTriangulate::InsideTriangle(double Ax, double Ay,
   return ((aCROSSbp >= 0.0) && (bCROSScp >= 0.0) && (cCROSSap >= 0.0));
 }
 
-bool cwTriangulate::Snip(const QVector<QPointF> &contour,int u,int v,int w,int n,int *V)
-{
-  int p;
-  double Ax, Ay, Bx, By, Cx, Cy, Px, Py;
 
-  Ax = contour[V[u]].x();
-  Ay = contour[V[u]].y();
+namespace {
 
-  Bx = contour[V[v]].x();
-  By = contour[V[v]].y();
+/*
+  Exact orientation test, from Shewchuk's "Adaptive Precision Floating-Point
+  Arithmetic and Fast Robust Geometric Predicates". The determinant is computed
+  in double, and only when it's too close to zero for its sign to be trusted, it's
+  recomputed exactly as a sum of error free products.
+*/
+const double HalfEpsilon = std::numeric_limits<double>::epsilon() * 0.5;
+const double OrientationErrorBound = (3.0 + 16.0 * HalfEpsilon) * HalfEpsilon;
 
-  Cx = contour[V[w]].x();
-  Cy = contour[V[w]].y();
+void twoSum(double a, double b, double& sum, double& error)
+{
+    sum = a + b;
+    double bVirtual = sum - a;
+    double aVirtual = sum - bVirtual;
+    error = (a - aVirtual) + (b - bVirtual);
+}
 
-  if ( EPSILON > (((Bx-Ax)*(Cy-Ay)) - ((By-Ay)*(Cx-Ax))) ) return false;
+/*
+  Adds value to the expansion, a sum of non-overlapping doubles in increasing
+  magnitude, without any round off
+*/
+void growExpansion(std::vector<double>& expansion, double value)
+{
+    for(size_t i = 0; i < expansion.size(); i++) {
+        double sum;
+        twoSum(value, expansion[i], sum, expansion[i]);
+        value = sum;
+    }
+    expansion.push_back(value);
+}
 
-  for (p=0;p<n;p++)
-  {
-    if( (p == u) || (p == v) || (p == w) ) continue;
-    Px = contour[V[p]].x();
-    Py = contour[V[p]].y();
-    if (InsideTriangle(Ax,Ay,Bx,By,Cx,Cy,Px,Py)) return false;
-  }
+void addProduct(std::vector<double>& expansion, double a, double b)
+{
+    double product = a * b;
+    growExpansion(expansion, std::fma(a, b, -product));
+    growExpansion(expansion, product);
+}
 
-  return true;
+int exactOrientation(const QPointF& a, const QPointF& b, const QPointF& c)
+{
+    //(a - c) x (b - c), expanded so that no subtraction rounds
+    std::vector<double> expansion;
+    expansion.reserve(13);
+    addProduct(expansion, a.x(), b.y());
+    addProduct(expansion, -a.x(), c.y());
+    addProduct(expansion, -c.x(), b.y());
+    addProduct(expansion, -a.y(), b.x());
+    addProduct(expansion, a.y(), c.x());
+    addProduct(expansion, c.y(), b.x());
+
+    //The largest non-zero component has the sign of the sum
+    for(int i = (int)expansion.size() - 1; i >= 0; i--) {
+        if(expansion[i] > 0.0) { return 1; }
+        if(expansion[i] < 0.0) { return -1; }
+    }
+    return 0;
 }
 
-bool cwTriangulate::Process(const QVector<QPointF> &contour,QVector<QPointF> &result)
+/*
+  1 if a, b, c turn counter-clockwise, -1 if they turn clockwise, and 0 if they're collinear
+*/
+int orientation(const QPointF& a, const QPointF& b, const QPointF& c)
 {
-    QPolygonF polygon(contour);
-    while(polygon.isClosed()) {
-        //Remove the last item
-        polygon.pop_back();
+    double detLeft = (a.x() - c.x()) * (b.y() - c.y());
+    double detRight = (a.y() - c.y()) * (b.x() - c.x());
+    double det = detLeft - detRight;
+
+    double detSum;
+    if(detLeft > 0.0) {
+        if(detRight <= 0.0) { return det > 0.0 ? 1 : (det < 0.0 ? -1 : 0); }
+        detSum = detLeft + detRight;
+    } else if(detLeft < 0.0) {
+        if(detRight >= 0.0) { return det > 0.0 ? 1 : (det < 0.0 ? -1 : 0); }
+        detSum = -detLeft - detRight;
+    } else {
+        return det > 0.0 ? 1 : (det < 0.0 ? -1 : 0);
     }
 
-  /* allocate and initialize list of Vertices in polygon */
+    double errorBound = OrientationErrorBound * detSum;
+    if(det >= errorBound || -det >= errorBound) {
+        return det > 0.0 ? 1 : -1;
+    }
+    return exactOrientation(a, b, c);
+}
+
+int sign(double value)
+{
+    return value > 0.0 ? 1 : (value < 0.0 ? -1 : 0);
+}
 
-  int n = polygon.size();
-  if ( n < 3 ) return false;
+bool samePoint(const QPointF& a, const QPointF& b)
+{
+    return a.x() == b.x() && a.y() == b.y();
+}
+
+/*
+  For collinear points, true if a and b are in the same direction from center
+*/
+bool sameDirection(const QPointF& center, const QPointF& a, const QPointF& b)
+{
+    return sign(a.x() - center.x()) == sign(b.x() - center.x()) &&
+            sign(a.y() - center.y()) == sign(b.y() - center.y());
+}
 
-  int *V = new int[n];
+/*
+  The sweep order. Points with the same y are ordered by x, as if the plane was
+  rotated a tiny bit, so no two distinct points are ever level with each other.
+*/
+bool above(const QPointF& a, const QPointF& b)
+{
+    return a.y() > b.y() || (a.y() == b.y() && a.x() < b.x());
+}
 
-  /* we want a counter-clockwise polygon in V */
+class AboveIndex {
+public:
+    AboveIndex(const QVector<QPointF>& points) : Points(points) {}
+    bool operator()(int a, int b) const { return above(Points.at(a), Points.at(b)); }
 
-  if ( 0.0 < Area(polygon) )
-    for (int v=0; v<n; v++) V[v] = v;
-  else
-    for(int v=0; v<n; v++) V[v] = (n-1)-v;
+private:
+    const QVector<QPointF>& Points;
+};
 
-  int nv = n;
+/*
+  Removes duplicate points, and spikes, points where the contour turns back on
+  itself. Both have no area and would confuse the vertex classification.
+*/
+QVector<QPointF> removeDegeneracies(const QVector<QPointF>& contour)
+{
+    int n = contour.size();
+    QVector<int> previous(n);
+    QVector<int> next(n);
+    QVector<bool> removed(n, false);
+    QVector<int> toCheck;
+    toCheck.reserve(n);
+    for(int i = 0; i < n; i++) {
+        previous[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+        toCheck.append(n - 1 - i);
+    }
 
-  /*  remove nv-2 Vertices, creating 1 triangle every time */
-  int count = 2*nv;   /* error detection */
+    int remaining = n;
+    while(!toCheck.isEmpty() && remaining >= 3) {
+        int i = toCheck.takeLast();
+        if(removed.at(i)) { continue; }
+
+        const QPointF& point = contour.at(i);
+        const QPointF& previousPoint = contour.at(previous.at(i));
+        const QPointF& nextPoint = contour.at(next.at(i));
+
+        bool duplicate = samePoint(point, nextPoint);
+        bool spike = !duplicate &&
+                orientation(previousPoint, point, nextPoint) == 0 &&
+                sameDirection(point, previousPoint, nextPoint);
+
+        if(duplicate || spike) {
+            removed[i] = true;
+            remaining--;
+            next[previous.at(i)] = next.at(i);
+            previous[next.at(i)] = previous.at(i);
+            toCheck.append(previous.at(i));
+            toCheck.append(next.at(i));
+        }
+    }
 
-  for(int m=0, v=nv-1; nv>2; )
-  {
-    /* if we loop, it is probably a non-simple polygon */
-    if (0 >= (count--))
-    {
-      //** Triangulate: ERROR - probable bad polygon!
-      return false;
+    QVector<QPointF> points;
+    if(remaining < 3) {
+        return points;
     }
 
-    /* three consecutive vertices in current polygon, <u,v,w> */
-    int u = v  ; if (nv <= u) u = 0;     /* previous */
-    v = u+1; if (nv <= v) v = 0;     /* new v    */
-    int w = v+1; if (nv <= w) w = 0;     /* next     */
+    int first = removed.indexOf(false);
+    points.reserve(remaining);
+    int current = first;
+    do {
+        points.append(contour.at(current));
+        current = next.at(current);
+    } while(current != first);
+    return points;
+}
 
-    if ( Snip(polygon,u,v,w,nv,V) )
+/*
+  Splits a counter-clockwise polygon into y-monotone polygons with a sweep line,
+  from de Berg et al., "Computational Geometry", chapter 3. Edge i goes from point
+  i to point i + 1. Only the edges that have the polygon on their right are kept
+  in the sweep status, ordered from left to right.
+*/
+class MonotonePartition {
+public:
+    MonotonePartition(const QVector<QPointF>& points) :
+        Points(points),
+        Status(EdgeLess(&Points, &QueryPoint))
     {
-      int a,b,c,s,t;
+    }
+
+    bool diagonals(QVector<QPair<int, int> >* diagonals);
+
+private:
+    enum VertexType {
+        StartVertex,
+        EndVertex,
+        SplitVertex,
+        MergeVertex,
+        RegularVertex
+    };
+
+    enum { QueryEdge = -1 };
+
+    /*
+      Left to right order of the edges that cross the sweep line. The query edge
+      is QueryPoint, it's used to find the edge directly left of a point.
+    */
+    class EdgeLess {
+    public:
+        EdgeLess(const QVector<QPointF>* points, const QPointF* queryPoint) :
+            Points(points),
+            QueryPoint(queryPoint)
+        {}
+
+        bool operator()(int a, int b) const {
+            if(a == b) { return false; }
+            const QPointF& aUpper = upper(a);
+            const QPointF& bUpper = upper(b);
+            if(above(bUpper, aUpper)) {
+                //a was reached later by the sweep, so test a's top against b
+                return orientation(bUpper, lower(b), aUpper) < 0;
+            }
+            return orientation(aUpper, lower(a), bUpper) > 0;
+        }
+
+    private:
+        const QVector<QPointF>* Points;
+        const QPointF* QueryPoint;
+
+        const QPointF& upper(int edge) const {
+            return edge == QueryEdge ? *QueryPoint : Points->at(edge);
+        }
+
+        const QPointF& lower(int edge) const {
+            return edge == QueryEdge ? *QueryPoint : Points->at((edge + 1) % Points->size());
+        }
+    };
+
+    typedef std::set<int, EdgeLess> EdgeSet;
+
+    const QVector<QPointF>& Points;
+    QPointF QueryPoint;
+    EdgeSet Status;
+    std::vector<EdgeSet::iterator> StatusEdges;
+    QVector<bool> InStatus;
+    QVector<int> Helpers;
+    QVector<VertexType> Types;
+    QVector<QPair<int, int> >* Diagonals;
+
+    VertexType vertexType(int index) const;
+    void addEdge(int edge);
+    bool removeEdge(int edge, int vertex);
+    int edgeLeftOf(int vertex);
+    void connectToMergeHelper(int edge, int vertex);
+};
+
+bool MonotonePartition::diagonals(QVector<QPair<int, int> >* diagonals)
+{
+    int n = Points.size();
+    Diagonals = diagonals;
+    StatusEdges.assign(n, Status.end());
+    InStatus.fill(false, n);
+    Helpers.fill(-1, n);
+    Types.resize(n);
+
+    QVector<int> events(n);
+    for(int i = 0; i < n; i++) {
+        Types[i] = vertexType(i);
+        events[i] = i;
+    }
+    std::sort(events.begin(), events.end(), AboveIndex(Points));
+
+    foreach(int vertex, events) {
+        int previousEdge = (vertex + n - 1) % n;
+        int leftEdge;
+
+        switch(Types.at(vertex)) {
+        case StartVertex:
+            addEdge(vertex);
+            break;
+        case EndVertex:
+            if(!removeEdge(previousEdge, vertex)) { return false; }
+            break;
+        case SplitVertex:
+            leftEdge = edgeLeftOf(vertex);
+            if(leftEdge == QueryEdge) { return false; }
+            Diagonals->append(qMakePair(vertex, Helpers.at(leftEdge)));
+            Helpers[leftEdge] = vertex;
+            addEdge(vertex);
+            break;
+        case MergeVertex:
+            if(!removeEdge(previousEdge, vertex)) { return false; }
+            leftEdge = edgeLeftOf(vertex);
+            if(leftEdge == QueryEdge) { return false; }
+            connectToMergeHelper(leftEdge, vertex);
+            Helpers[leftEdge] = vertex;
+            break;
+        case RegularVertex:
+            if(above(Points.at(previousEdge), Points.at(vertex))) {
+                //The polygon is on the right
+                if(!removeEdge(previousEdge, vertex)) { return false; }
+                addEdge(vertex);
+            } else {
+                leftEdge = edgeLeftOf(vertex);
+                if(leftEdge == QueryEdge) { return false; }
+                connectToMergeHelper(leftEdge, vertex);
+                Helpers[leftEdge] = vertex;
+            }
+            break;
+        }
+    }
 
-      /* true names of the vertices */
-      a = V[u]; b = V[v]; c = V[w];
+    return true;
+}
+
+MonotonePartition::VertexType MonotonePartition::vertexType(int index) const
+{
+    int n = Points.size();
+    const QPointF& point = Points.at(index);
+    const QPointF& previous = Points.at((index + n - 1) % n);
+    const QPointF& next = Points.at((index + 1) % n);
+
+    bool previousBelow = above(point, previous);
+    bool nextBelow = above(point, next);
+    if(previousBelow != nextBelow) {
+        return RegularVertex;
+    }
 
-      /* output Triangle */
-      result.push_back( polygon[a] );
-      result.push_back( polygon[b] );
-      result.push_back( polygon[c] );
+    //Spikes have been removed, so the turn is never straight
+    bool convex = orientation(previous, point, next) > 0;
+    if(previousBelow) {
+        return convex ? StartVertex : SplitVertex;
+    }
+    return convex ? EndVertex : MergeVertex;
+}
 
-      m++;
+void MonotonePartition::addEdge(int edge)
+{
+    std::pair<EdgeSet::iterator, bool> inserted = Status.insert(edge);
+    StatusEdges[edge] = inserted.first;
+    InStatus[edge] = inserted.second;
+    Helpers[edge] = edge;
+}
 
-      /* remove v from remaining polygon */
-      for(s=v,t=v+1;t<nv;s++,t++) V[s] = V[t]; nv--;
+bool MonotonePartition::removeEdge(int edge, int vertex)
+{
+    if(!InStatus.at(edge)) {
+        //Only happens if the polygon isn't simple
+        return false;
+    }
+    connectToMergeHelper(edge, vertex);
+    Status.erase(StatusEdges[edge]);
+    InStatus[edge] = false;
+    return true;
+}
 
-      /* resest error detection counter */
-      count = 2*nv;
+/*
+  Returns the edge directly left of the vertex, or QueryEdge if there isn't one
+*/
+int MonotonePartition::edgeLeftOf(int vertex)
+{
+    QueryPoint = Points.at(vertex);
+    EdgeSet::iterator right = Status.lower_bound(QueryEdge);
+    if(right == Status.begin()) {
+        return QueryEdge;
+    }
+    --right;
+    return *right;
+}
+
+void MonotonePartition::connectToMergeHelper(int edge, int vertex)
+{
+    int helper = Helpers.at(edge);
+    if(Types.at(helper) == MergeVertex) {
+        Diagonals->append(qMakePair(vertex, helper));
+    }
+}
+
+/*
+  The clockwise angle from reference to point, around center, as a rank that
+  can be compared: 0 is less than 180 degrees, 1 is 180, 2 is more than 180, and 3
+  is 360, pointing the same way as reference
+*/
+int clockwiseRank(const QPointF& center, const QPointF& reference, const QPointF& point)
+{
+    int side = orientation(center, reference, point);
+    if(side < 0) { return 0; }
+    if(side > 0) { return 2; }
+    return sameDirection(center, reference, point) ? 3 : 1;
+}
+
+bool clockwiseBefore(const QPointF& center, const QPointF& reference, const QPointF& a, const QPointF& b)
+{
+    int aRank = clockwiseRank(center, reference, a);
+    int bRank = clockwiseRank(center, reference, b);
+    if(aRank != bRank) {
+        return aRank < bRank;
+    }
+    if(aRank == 0 || aRank == 2) {
+        return orientation(center, a, b) < 0;
+    }
+    return false;
+}
+
+/*
+  Cuts the polygon along the diagonals and returns the pieces, as point indices in
+  counter-clockwise order. The pieces are traced by always taking the sharpest left
+  turn at each point.
+*/
+bool splitAlongDiagonals(const QVector<QPointF>& points,
+                         const QVector<QPair<int, int> >& diagonals,
+                         QVector<QVector<int> >* polygons)
+{
+    int n = points.size();
+    if(diagonals.isEmpty()) {
+        QVector<int> polygon(n);
+        for(int i = 0; i < n; i++) {
+            polygon[i] = i;
+        }
+        polygons->append(polygon);
+        return true;
+    }
+
+    //Half edges, the polygon's edges and both directions of each diagonal
+    QVector<int> from;
+    QVector<int> to;
+    from.reserve(n + diagonals.size() * 2);
+    to.reserve(n + diagonals.size() * 2);
+    for(int i = 0; i < n; i++) {
+        from.append(i);
+        to.append((i + 1) % n);
+    }
+    typedef QPair<int, int> Diagonal;
+    foreach(Diagonal diagonal, diagonals) {
+        from.append(diagonal.first);
+        to.append(diagonal.second);
+        from.append(diagonal.second);
+        to.append(diagonal.first);
+    }
+
+    QVector<QVector<int> > outgoing(n);
+    for(int i = 0; i < from.size(); i++) {
+        outgoing[from.at(i)].append(i);
+    }
+
+    QVector<bool> visited(from.size(), false);
+    for(int first = 0; first < from.size(); first++) {
+        if(visited.at(first)) { continue; }
+
+        QVector<int> polygon;
+        int halfEdge = first;
+        do {
+            if(visited.at(halfEdge) || polygon.size() > n) {
+                //Only happens if the polygon isn't simple
+                return false;
+            }
+            visited[halfEdge] = true;
+            polygon.append(from.at(halfEdge));
+
+            int center = to.at(halfEdge);
+            int reference = from.at(halfEdge);
+            int next = -1;
+            foreach(int candidate, outgoing.at(center)) {
+                if(to.at(candidate) == reference) { continue; }
+                if(next == -1 || clockwiseBefore(points.at(center), points.at(reference),
+                                                 points.at(to.at(candidate)), points.at(to.at(next))))
+                {
+                    next = candidate;
+                }
+            }
+
+            if(next == -1) { return false; }
+            halfEdge = next;
+        } while(halfEdge != first);
+
+        polygons->append(polygon);
+    }
+    return true;
+}
+
+void addTriangle(const QVector<QPointF>& points, int a, int b, int c, QVector<QPointF>& result)
+{
+    int turn = orientation(points.at(a), points.at(b), points.at(c));
+    if(turn == 0) {
+        return;
+    }
+    if(turn < 0) {
+        qSwap(b, c);
+    }
+    result.append(points.at(a));
+    result.append(points.at(b));
+    result.append(points.at(c));
+}
+
+/*
+  Triangulates a y-monotone polygon in linear time, from de Berg et al. The points
+  are visited from top to bottom, and the points that can't be cut off yet are
+  kept on a stack, they always form a reflex chain.
+*/
+bool triangulateMonotone(const QVector<QPointF>& points, const QVector<int>& polygon, QVector<QPointF>& result)
+{
+    int k = polygon.size();
+    if(k < 3) {
+        return false;
+    }
+    if(k == 3) {
+        addTriangle(points, polygon.at(0), polygon.at(1), polygon.at(2), result);
+        return true;
+    }
+
+    int top = 0;
+    int bottom = 0;
+    for(int i = 1; i < k; i++) {
+        if(above(points.at(polygon.at(i)), points.at(polygon.at(top)))) { top = i; }
+        if(above(points.at(polygon.at(bottom)), points.at(polygon.at(i)))) { bottom = i; }
     }
-  }
 
-  delete V;
+    //Merge the left chain, counter-clockwise from the top, with the right chain
+    QVector<int> sorted;
+    QVector<bool> onLeftChain;
+    sorted.reserve(k);
+    onLeftChain.reserve(k);
+    sorted.append(polygon.at(top));
+    onLeftChain.append(true);
+
+    int left = (top + 1) % k;
+    int right = (top + k - 1) % k;
+    int lastLeft = polygon.at(top);
+    int lastRight = polygon.at(top);
+    while(left != bottom || right != bottom) {
+        bool takeLeft = right == bottom ||
+                (left != bottom && above(points.at(polygon.at(left)), points.at(polygon.at(right))));
+        int index = takeLeft ? polygon.at(left) : polygon.at(right);
+        int& lastOnChain = takeLeft ? lastLeft : lastRight;
+        if(!above(points.at(lastOnChain), points.at(index))) {
+            //The chain isn't monotone, only happens if the polygon isn't simple
+            return false;
+        }
+        lastOnChain = index;
+
+        sorted.append(index);
+        onLeftChain.append(takeLeft);
+        if(takeLeft) {
+            left = (left + 1) % k;
+        } else {
+            right = (right + k - 1) % k;
+        }
+    }
+    sorted.append(polygon.at(bottom));
+    onLeftChain.append(false);
+
+    QVector<int> stack;
+    stack.reserve(k);
+    stack.append(0);
+    stack.append(1);
+    for(int j = 2; j < k - 1; j++) {
+        int current = sorted.at(j);
+        if(onLeftChain.at(j) != onLeftChain.at(stack.last())) {
+            //Fan to the whole stack, the previous point is the new reflex chain
+            while(stack.size() > 1) {
+                int popped = stack.takeLast();
+                addTriangle(points, current, sorted.at(popped), sorted.at(stack.last()), result);
+            }
+            stack.clear();
+            stack.append(j - 1);
+            stack.append(j);
+        } else {
+            //Cut off points while the diagonal from current is inside the polygon
+            int last = stack.takeLast();
+            while(!stack.isEmpty()) {
+                int turn = orientation(points.at(sorted.at(stack.last())), points.at(sorted.at(last)), points.at(current));
+                bool inside = onLeftChain.at(j) ? turn > 0 : turn < 0;
+                if(!inside) {
+                    break;
+                }
+                addTriangle(points, current, sorted.at(last), sorted.at(stack.last()), result);
+                last = stack.takeLast();
+            }
+            stack.append(last);
+            stack.append(j);
+        }
+    }
+
+    int current = sorted.at(k - 1);
+    while(stack.size() > 1) {
+        int popped = stack.takeLast();
+        addTriangle(points, current, sorted.at(popped), sorted.at(stack.last()), result);
+    }
+
+    return true;
+}
+
+/*
+  True if the triangle u, v, w of the remaining polygon V is an ear: it turns
+  counter-clockwise and no other point of the polygon is inside of it
+*/
+bool snip(const QVector<QPointF>& contour, int u, int v, int w, int n, const QVector<int>& V)
+{
+    const double epsilon = 0.00000000001;
+
+    double Ax = contour[V[u]].x();
+    double Ay = contour[V[u]].y();
+
+    double Bx = contour[V[v]].x();
+    double By = contour[V[v]].y();
+
+    double Cx = contour[V[w]].x();
+    double Cy = contour[V[w]].y();
+
+    if(epsilon > (((Bx - Ax) * (Cy - Ay)) - ((By - Ay) * (Cx - Ax)))) { return false; }
+
+    for(int p = 0; p < n; p++) {
+        if((p == u) || (p == v) || (p == w)) { continue; }
+        double Px = contour[V[p]].x();
+        double Py = contour[V[p]].y();
+        if(cwTriangulate::InsideTriangle(Ax, Ay, Bx, By, Cx, Cy, Px, Py)) { return false; }
+    }
+
+    return true;
+}
+
+}
+
+/*
+  Triangulates a simple polygon in O(n log n). The polygon is split into y-monotone
+  polygons with a sweep line, and then each of them is triangulated in linear time.
+  All the geometric tests are exact, so nearly collinear points are handled. Duplicate
+  points and spikes are removed first. The triangles are counter-clockwise and are
+  appended to result. Returns false if the polygon has less than three points, no
+  area, or isn't simple.
+*/
+bool cwTriangulate::Process(const QVector<QPointF> &contour,QVector<QPointF> &result)
+{
+    QVector<QPointF> points = removeDegeneracies(contour);
+    int n = points.size();
+    if(n < 3) {
+        return false;
+    }
+
+    //We want a counter-clockwise polygon. The lowest point is always convex, so
+    //its turn gives the orientation.
+    int lowest = 0;
+    for(int i = 1; i < n; i++) {
+        if(above(points.at(lowest), points.at(i))) {
+            lowest = i;
+        }
+    }
+    int turn = orientation(points.at((lowest + n - 1) % n), points.at(lowest), points.at((lowest + 1) % n));
+    if(turn == 0) {
+        return false;
+    }
+    if(turn < 0) {
+        std::reverse(points.begin(), points.end());
+    }
+
+    QVector<QPair<int, int> > diagonals;
+    MonotonePartition partition(points);
+    if(!partition.diagonals(&diagonals)) {
+        return false;
+    }
+
+    QVector<QVector<int> > polygons;
+    if(!splitAlongDiagonals(points, diagonals, &polygons)) {
+        return false;
+    }
+
+    result.reserve(result.size() + (n - 2) * 3);
+    foreach(const QVector<int>& polygon, polygons) {
+        if(!triangulateMonotone(points, polygon, result)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+  Triangulates the polygon by clipping ears, O(n^2). This was used before the
+  sweep line in Process(). Unlike Process(), it keeps the triangles that it found
+  before giving up on a polygon that isn't simple, so it's useful as a fallback for
+  drawing an outline that crosses itself. Returns false if the polygon isn't simple.
+*/
+bool cwTriangulate::EarClip(const QVector<QPointF> &contour, QVector<QPointF> &result)
+{
+    QPolygonF polygon(contour);
+    while(polygon.isClosed()) {
+        //Remove the last item
+        polygon.pop_back();
+    }
+
+    int n = polygon.size();
+    if(n < 3) {
+        return false;
+    }
+
+    //We want a counter-clockwise polygon in V
+    QVector<int> V(n);
+    if(0.0 < Area(polygon)) {
+        for(int v = 0; v < n; v++) { V[v] = v; }
+    } else {
+        for(int v = 0; v < n; v++) { V[v] = (n - 1) - v; }
+    }
+
+    int nv = n;
+
+    //Remove nv-2 vertices, creating 1 triangle every time
+    int count = 2 * nv; //Error detection
+
+    for(int v = nv - 1; nv > 2; ) {
+        //If we loop, it is probably a non-simple polygon
+        if(0 >= (count--)) {
+            return false;
+        }
+
+        //Three consecutive vertices in current polygon, <u,v,w>
+        int u = v; if(nv <= u) { u = 0; } //Previous
+        v = u + 1; if(nv <= v) { v = 0; } //New v
+        int w = v + 1; if(nv <= w) { w = 0; } //Next
+
+        if(snip(polygon, u, v, w, nv, V)) {
+            //Output the triangle
+            result.push_back(polygon[V[u]]);
+            result.push_back(polygon[V[v]]);
+            result.push_back(polygon[V[w]]);
+
+            //Remove v from remaining polygon
+            V.remove(v);
+            nv--;
+
+            //Reset error detection counter
+            count = 2 * nv;
+        }
+    }
 
-  return true;
+    return true;
 }
@@ -1,18 +1,28 @@
 #ifndef CWTRIANGULATE_H
 #define CWTRIANGULATE_H
 
+//Our includes
+#include "cwGlobals.h"
+
 //Qt includes
 #include <QVector>
 #include <QPointF>
 
-class cwTriangulate
+class CAVEWHERE_LIB_EXPORT cwTriangulate
 {
 public:
-    // triangulate a contour/polygon, places results in STL vector
-    // as series of triangles.
+    // triangulate a simple contour/polygon, appends the results to result
+    // as series of counter-clockwise triangles. This is a sweep line
+    // monotone triangulation, O(n log n), with exact geometric tests.
     static bool Process(const QVector<QPointF> &contour,
                         QVector<QPointF> &result);
 
+    // triangulate by clipping ears, O(n^2). On a contour that isn't
+    // simple, this returns false but keeps the triangles it found, so
+    // it's used as a fallback when Process() fails.
+    static bool EarClip(const QVector<QPointF> &contour,
+                        QVector<QPointF> &result);
+
     // compute area of a contour/polygon
     static double Area(const QVector<QPointF> &contour);
 
@@ -22,10 +32,6 @@ public:
                         double Bx, double By,
                         double Cx, double Cy,
                         double Px, double Py);
-
-
-  private:
-    static bool Snip(const QVector<QPointF> &contour,int u,int v,int w,int n,int *V);
 };
 
 #endif // CWTRIANGULATE_H
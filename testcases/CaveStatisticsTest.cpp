@@ -0,0 +1,103 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwCaveStatistics.h"
+#include "cwTripStatistics.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyChunk.h"
+#include "cwTripCalibration.h"
+#include "cwStationPositionLookup.h"
+#include "cwLength.h"
+
+//Qt includes
+#include <QSignalSpy>
+
+static cwSurveyChunk* addChunk(cwTrip* trip, QString from, QString to, QString distance) {
+    cwSurveyChunk* chunk = new cwSurveyChunk();
+    chunk->appendNewShot();
+    trip->addChunk(chunk);
+
+    chunk->setData(cwSurveyChunk::StationNameRole, 0, from);
+    chunk->setData(cwSurveyChunk::StationNameRole, 1, to);
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, distance);
+    return chunk;
+}
+
+TEST_CASE("Cave statistics add up the trips", "[CaveStatistics]") {
+    cwCave cave;
+    cwCaveStatistics* statistics = cave.statistics();
+    REQUIRE(statistics != nullptr);
+    CHECK(statistics->cave() == &cave);
+
+    cwTrip* trip1 = new cwTrip();
+    cave.addTrip(trip1);
+    cwSurveyChunk* chunk = addChunk(trip1, "a1", "a2", "10");
+
+    cwTrip* trip2 = new cwTrip();
+    cave.addTrip(trip2);
+    addChunk(trip2, "a2", "a3", "5.5");
+
+    CHECK(statistics->length() == 15.5);
+    CHECK(statistics->shotCount() == 2);
+    CHECK(statistics->stationCount() == 4);
+    CHECK(statistics->tripStatistics(trip1)->length() == 10.0);
+    CHECK(cave.length()->value() == 15.5);
+
+    QSignalSpy changedSpy(statistics, SIGNAL(statisticsChanged()));
+
+    SECTION("An edited cell only changes the cave by the difference") {
+        chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, "12");
+        CHECK(statistics->length() == 17.5);
+        CHECK(cave.length()->value() == 17.5);
+        CHECK(changedSpy.count() == 1);
+
+        chunk->setData(cwSurveyChunk::ShotDistanceIncludedRole, 0, false);
+        CHECK(statistics->length() == 5.5);
+        CHECK(statistics->shotCount() == 1);
+    }
+
+    SECTION("Trips in feet are added up in meters") {
+        trip2->calibrations()->setDistanceUnit(cwUnits::Feet);
+        CHECK(statistics->length() == Approx(10.0 + 5.5 * 0.3048));
+        CHECK(statistics->tripStatistics(trip2)->length() == 5.5);
+    }
+
+    SECTION("Removing a trip subtracts it") {
+        cave.removeTrip(1);
+        CHECK(statistics->length() == 10.0);
+        CHECK(statistics->shotCount() == 1);
+        CHECK(statistics->stationCount() == 2);
+    }
+
+    SECTION("Depth comes from the station positions") {
+        CHECK(statistics->depth() == 0.0);
+
+        cwStationPositionLookup positions;
+        positions.setPosition("a1", QVector3D(0.0, 0.0, 0.0));
+        positions.setPosition("a2", QVector3D(0.0, 8.0, -6.0));
+        positions.setPosition("a3", QVector3D(0.0, 8.0, 2.0));
+        cave.setStationPositionLookup(positions);
+
+        CHECK(statistics->lowestElevation() == -6.0);
+        CHECK(statistics->highestElevation() == 2.0);
+        CHECK(statistics->depth() == 8.0);
+        CHECK(cave.depth()->value() == 8.0);
+    }
+
+    SECTION("A copy of the cave has the same statistics") {
+        cwCave copy(cave);
+        CHECK(copy.statistics()->cave() == &copy);
+        CHECK(copy.statistics()->length() == 15.5);
+        CHECK(copy.statistics()->shotCount() == 2);
+        CHECK(copy.length()->value() == 15.5);
+    }
+}
@@ -0,0 +1,63 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwChangeJournal.h"
+
+//Qt includes
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+TEST_CASE("Change journal coalesces changes into one batch", "[ChangeJournal]") {
+    cwChangeJournal journal;
+    QSignalSpy changedSpy(&journal, SIGNAL(changed()));
+
+    for(int i = 0; i < 500; i++) {
+        journal.markChanged();
+    }
+
+    CHECK(journal.hasPendingChanges());
+    CHECK(changedSpy.count() == 0);
+
+    journal.flush();
+
+    CHECK(!journal.hasPendingChanges());
+    CHECK(changedSpy.count() == 1);
+    CHECK(journal.coalescedCount() == 499);
+    CHECK(journal.executedCount() == 1);
+
+    //Nothing is pending, so flushing again does nothing
+    journal.flush();
+    CHECK(changedSpy.count() == 1);
+
+    journal.resetCounts();
+    CHECK(journal.coalescedCount() == 0);
+    CHECK(journal.executedCount() == 0);
+}
+
+TEST_CASE("Change journal emits after the latency", "[ChangeJournal]") {
+    cwChangeJournal journal;
+    journal.setLatency(0);
+    QSignalSpy changedSpy(&journal, SIGNAL(changed()));
+
+    journal.markChanged();
+    journal.markChanged();
+
+    QElapsedTimer timer;
+    timer.start();
+    while(changedSpy.isEmpty() && timer.elapsed() < 1000) {
+        QCoreApplication::processEvents();
+    }
+
+    CHECK(changedSpy.count() == 1);
+    CHECK(journal.coalescedCount() == 1);
+    CHECK(!journal.hasPendingChanges());
+}
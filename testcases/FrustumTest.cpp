@@ -0,0 +1,114 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwFrustum.h"
+
+//Std includes
+#include <random>
+
+/**
+ * True if the point is inside of the clipping volume, tested in clip space
+ */
+static bool insideClipSpace(const QMatrix4x4& viewProjection, const QVector3D& point) {
+    QVector4D clip = viewProjection * QVector4D(point, 1.0f);
+    return clip.x() >= -clip.w() && clip.x() <= clip.w() &&
+            clip.y() >= -clip.w() && clip.y() <= clip.w() &&
+            clip.z() >= -clip.w() && clip.z() <= clip.w();
+}
+
+static QMatrix4x4 perspectiveCamera() {
+    QMatrix4x4 projection;
+    projection.perspective(55.0f, 1.5f, 1.0f, 100.0f);
+
+    QMatrix4x4 view;
+    view.lookAt(QVector3D(10.0f, -20.0f, 5.0f), QVector3D(0.0f, 0.0f, 0.0f), QVector3D(0.0f, 0.0f, 1.0f));
+
+    return projection * view;
+}
+
+static QMatrix4x4 orthoCamera() {
+    QMatrix4x4 projection;
+    projection.ortho(-30.0f, 30.0f, -20.0f, 20.0f, -50.0f, 50.0f);
+
+    QMatrix4x4 view;
+    view.lookAt(QVector3D(0.0f, 0.0f, 10.0f), QVector3D(0.0f, 0.0f, 0.0f), QVector3D(0.0f, 1.0f, 0.0f));
+
+    return projection * view;
+}
+
+TEST_CASE("Frustum matches the clip space test for points", "[Frustum]") {
+    QMatrix4x4 viewProjection;
+
+    SECTION("Perspective") {
+        viewProjection = perspectiveCamera();
+    }
+
+    SECTION("Ortho") {
+        viewProjection = orthoCamera();
+    }
+
+    cwFrustum frustum(viewProjection);
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+
+    int numberInside = 0;
+    for(int i = 0; i < 20000; i++) {
+        QVector3D point(position(generator), position(generator), position(generator));
+        bool inside = insideClipSpace(viewProjection, point);
+        numberInside += inside;
+
+        //Points very close to a plane may go either way
+        bool nearPlane = false;
+        for(int j = 0; j < 3 && !nearPlane; j++) {
+            QVector3D offset(j == 0 ? 0.01f : 0.0f, j == 1 ? 0.01f : 0.0f, j == 2 ? 0.01f : 0.0f);
+            nearPlane = insideClipSpace(viewProjection, point + offset) != inside ||
+                    insideClipSpace(viewProjection, point - offset) != inside;
+        }
+
+        if(!nearPlane) {
+            CHECK(frustum.intersects(point, 0.0f) == inside);
+        }
+    }
+
+    CHECK(numberInside > 0);
+}
+
+TEST_CASE("Frustum tests spheres and boxes", "[Frustum]") {
+    cwFrustum frustum(perspectiveCamera());
+
+    QVector3D target(0.0f, 0.0f, 0.0f);
+    QVector3D behindCamera(20.0f, -40.0f, 10.0f);
+    QVector3D radius(2.0f, 2.0f, 2.0f);
+
+    CHECK(frustum.intersects(target, 1.0f));
+    CHECK(!frustum.intersects(behindCamera, 1.0f));
+
+    //Outside of the frustum, but close enough that the sphere overlaps it
+    QVector3D nearCamera(10.0f, -20.0f, 5.0f);
+    CHECK(!frustum.intersects(nearCamera, 0.5f));
+    CHECK(frustum.intersects(nearCamera, 2.0f));
+
+    CHECK(frustum.intersects(QBox3D(target - radius, target + radius)));
+    CHECK(!frustum.intersects(QBox3D(behindCamera - radius, behindCamera + radius)));
+
+    //A box that's much bigger than the frustum
+    CHECK(frustum.intersects(QBox3D(QVector3D(-500.0f, -500.0f, -500.0f), QVector3D(500.0f, 500.0f, 500.0f))));
+
+    QBox3D infiniteBox;
+    infiniteBox.setToInfinite();
+    CHECK(frustum.intersects(infiniteBox));
+    CHECK(!frustum.intersects(QBox3D()));
+
+    //The default frustum contains everything
+    CHECK(cwFrustum().intersects(behindCamera, 0.0f));
+    CHECK(cwFrustum().intersects(QBox3D(behindCamera - radius, behindCamera + radius)));
+}
@@ -0,0 +1,213 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwGeometryItersecter.h"
+
+//Std includes
+#include <random>
+#include <algorithm>
+#include <limits>
+
+/**
+ * Intersects the ray with the triangle's plane, then checks that the point is inside of the
+ * triangle. Returns infinity if the ray misses.
+ */
+static double bruteForceHit(const QRay3D& ray, const QVector3D& p1, const QVector3D& p2, const QVector3D& p3) {
+    QVector3D normal = QVector3D::crossProduct(p2 - p1, p3 - p1);
+    double denominator = QVector3D::dotProduct(normal, ray.direction());
+    if(denominator == 0.0) { return std::numeric_limits<double>::infinity(); }
+
+    double t = QVector3D::dotProduct(normal, p1 - ray.origin()) / denominator;
+    if(t < 0.0) { return std::numeric_limits<double>::infinity(); }
+
+    QVector3D point = ray.origin() + ray.direction() * t;
+    double s1 = QVector3D::dotProduct(QVector3D::crossProduct(p2 - p1, point - p1), normal);
+    double s2 = QVector3D::dotProduct(QVector3D::crossProduct(p3 - p2, point - p2), normal);
+    double s3 = QVector3D::dotProduct(QVector3D::crossProduct(p1 - p3, point - p3), normal);
+    if(s1 < 0.0 || s2 < 0.0 || s3 < 0.0) { return std::numeric_limits<double>::infinity(); }
+
+    return t;
+}
+
+/**
+ * Small random triangles, like scrap geometry, in a 100 meter cube
+ */
+static cwGeometryItersecter::Object createTriangles(int numberOfTriangles, std::mt19937* generator) {
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+
+    QVector<QVector3D> points;
+    QVector<uint> indexes;
+    for(int i = 0; i < numberOfTriangles; i++) {
+        QVector3D center(position(*generator), position(*generator), position(*generator));
+        for(int j = 0; j < 3; j++) {
+            indexes.append(points.size());
+            points.append(center + QVector3D(offset(*generator), offset(*generator), offset(*generator)));
+        }
+    }
+
+    return cwGeometryItersecter::Object(nullptr, 0, points, indexes, cwGeometryItersecter::Triangles);
+}
+
+static QRay3D createRay(std::mt19937* generator) {
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    QVector3D origin(position(*generator), position(*generator), -20.0f);
+    QVector3D target(position(*generator), position(*generator), 120.0f);
+    return QRay3D(origin, target - origin);
+}
+
+TEST_CASE("Closest hit matches a brute force search", "[GeometryItersecter]") {
+    std::mt19937 generator(11);
+
+    cwGeometryItersecter::Object object = createTriangles(3000, &generator);
+    cwGeometryItersecter intersecter;
+    intersecter.addObject(object);
+
+    int numberOfHits = 0;
+    for(int i = 0; i < 500; i++) {
+        QRay3D ray = createRay(&generator);
+
+        double bestT = std::numeric_limits<double>::infinity();
+        for(int j = 0; j < object.indexes().size(); j += 3) {
+            bestT = std::min(bestT, bruteForceHit(ray,
+                                                  object.points().at(object.indexes().at(j)),
+                                                  object.points().at(object.indexes().at(j + 1)),
+                                                  object.points().at(object.indexes().at(j + 2))));
+        }
+
+        cwGeometryItersecter::Hit hit = intersecter.closestHit(ray);
+        CHECK(hit.isValid() == (bestT != std::numeric_limits<double>::infinity()));
+
+        if(hit.isValid()) {
+            numberOfHits++;
+            CHECK(hit.t() == Approx(bestT).epsilon(0.0001));
+            CHECK(hit.type() == cwGeometryItersecter::Triangles);
+
+            //The barycentric point is the hit point
+            QVector3D barycentric = hit.barycentric();
+            CHECK(barycentric.x() + barycentric.y() + barycentric.z() == Approx(1.0));
+            CHECK((hit.point() - ray.point(hit.t())).length() < 0.001);
+        }
+    }
+
+    CHECK(numberOfHits > 0);
+}
+
+TEST_CASE("Nearest stations match a brute force search", "[GeometryItersecter]") {
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+
+    //A line plot, where each station is connected to the next
+    QVector<QVector3D> points;
+    QVector<uint> indexes;
+    for(int i = 0; i < 2000; i++) {
+        points.append(QVector3D(position(generator), position(generator), position(generator)));
+        if(i > 0) {
+            indexes.append(i - 1);
+            indexes.append(i);
+        }
+    }
+
+    cwGeometryItersecter intersecter;
+    intersecter.addObject(cwGeometryItersecter::Object(nullptr, 3, points, indexes, cwGeometryItersecter::Lines));
+
+    const int count = 5;
+    for(int i = 0; i < 200; i++) {
+        QRay3D ray = createRay(&generator);
+
+        QVector<double> distances;
+        foreach(const QVector3D& point, points) {
+            if(QVector3D::dotProduct(point - ray.origin(), ray.direction()) > 0.0) {
+                distances.append(ray.distance(point));
+            }
+        }
+        std::sort(distances.begin(), distances.end());
+
+        QList<cwGeometryItersecter::Hit> stations = intersecter.nearestStations(ray, count);
+        REQUIRE(stations.size() == count);
+
+        for(int j = 0; j < count; j++) {
+            const cwGeometryItersecter::Hit& station = stations.at(j);
+            CHECK(station.distance() == Approx(distances.at(j)));
+            CHECK(station.id() == 3u);
+            CHECK(station.point() == points.at(station.primitiveIndex()));
+            CHECK((ray.point(station.t()) - station.point()).length() == Approx(station.distance()).epsilon(0.001));
+        }
+    }
+
+    //Removing the object removes its stations
+    intersecter.removeObject(nullptr, 3);
+    CHECK(intersecter.nearestStations(createRay(&generator), count).isEmpty());
+}
+
+TEST_CASE("Primitives within a screen radius", "[GeometryItersecter]") {
+    QRect viewport(0, 0, 100, 100);
+
+    QVector<QVector3D> linePoints;
+    linePoints << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(10.0f, 0.0f, 0.0f);
+    QVector<uint> lineIndexes;
+    lineIndexes << 0 << 1;
+
+    QVector<QVector3D> trianglePoints;
+    trianglePoints << QVector3D(20.0f, 20.0f, 0.0f) << QVector3D(30.0f, 20.0f, 5.0f) << QVector3D(20.0f, 30.0f, -5.0f);
+    QVector<uint> triangleIndexes;
+    triangleIndexes << 0 << 1 << 2;
+
+    cwGeometryItersecter intersecter;
+    intersecter.addObject(cwGeometryItersecter::Object(nullptr, 0, linePoints, lineIndexes, cwGeometryItersecter::Lines));
+    intersecter.addObject(cwGeometryItersecter::Object(nullptr, 1, trianglePoints, triangleIndexes, cwGeometryItersecter::Triangles));
+
+    SECTION("Ortho") {
+        //One pixel per meter, looking down
+        QMatrix4x4 viewProjection;
+        viewProjection.ortho(-50.0f, 50.0f, -50.0f, 50.0f, -100.0f, 100.0f);
+
+        QList<cwGeometryItersecter::Hit> hits = intersecter.primitivesWithin(viewProjection, viewport, QPointF(55.0, 53.0), 5.0);
+        REQUIRE(hits.size() == 1);
+        CHECK(hits.first().id() == 0u);
+        CHECK(hits.first().distance() == Approx(3.0));
+        CHECK((hits.first().point() - QVector3D(5.0f, 0.0f, 0.0f)).length() < 0.001);
+
+        CHECK(intersecter.primitivesWithin(viewProjection, viewport, QPointF(55.0, 53.0), 2.0).isEmpty());
+
+        //Inside of the triangle
+        hits = intersecter.primitivesWithin(viewProjection, viewport, QPointF(72.0, 73.0), 1.0);
+        REQUIRE(hits.size() == 1);
+        CHECK(hits.first().id() == 1u);
+        CHECK(hits.first().primitiveIndex() == 0);
+        CHECK(hits.first().distance() == Approx(0.0));
+        CHECK((hits.first().point() - QVector3D(22.0f, 23.0f, -0.5f)).length() < 0.001);
+
+        //Both, closest first
+        hits = intersecter.primitivesWithin(viewProjection, viewport, QPointF(60.0, 60.0), 100.0);
+        REQUIRE(hits.size() == 2);
+        CHECK(hits.at(0).distance() <= hits.at(1).distance());
+    }
+
+    SECTION("Perspective") {
+        QMatrix4x4 viewProjection;
+        viewProjection.perspective(60.0f, 1.0f, 1.0f, 500.0f);
+        QMatrix4x4 view;
+        view.lookAt(QVector3D(-30.0f, -40.0f, 60.0f), QVector3D(20.0f, 20.0f, 0.0f), QVector3D(0.0f, 0.0f, 1.0f));
+        viewProjection = viewProjection * view;
+
+        //A point on the triangle, projected on to the screen
+        QVector3D worldPoint = trianglePoints.at(0) * 0.2f + trianglePoints.at(1) * 0.5f + trianglePoints.at(2) * 0.3f;
+        QVector4D clip = viewProjection * QVector4D(worldPoint, 1.0f);
+        QPointF screenPoint((clip.x() / clip.w() + 1.0) * 50.0, (clip.y() / clip.w() + 1.0) * 50.0);
+
+        QList<cwGeometryItersecter::Hit> hits = intersecter.primitivesWithin(viewProjection, viewport, screenPoint, 0.5);
+        REQUIRE(hits.size() == 1);
+        CHECK(hits.first().id() == 1u);
+        CHECK((hits.first().point() - worldPoint).length() < 0.01);
+        CHECK(hits.first().barycentric().y() == Approx(0.5).epsilon(0.001));
+    }
+}
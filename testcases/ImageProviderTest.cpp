@@ -0,0 +1,53 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwImageProvider.h"
+#include "cwImageData.h"
+
+//Qt includes
+#include <QImage>
+#include <QBuffer>
+#include <QPainter>
+
+TEST_CASE("Image provider decodes only the clip rect", "[ImageProvider]") {
+    QImage original(64, 48, QImage::Format_RGB32);
+    original.fill(Qt::white);
+    QPainter painter(&original);
+    painter.fillRect(QRect(10, 20, 16, 8), Qt::red);
+    painter.end();
+
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    REQUIRE(original.save(&buffer, "png"));
+
+    cwImageData imageData(original.size(), 0, "png", png);
+
+    QRect clip(8, 18, 20, 12);
+    QImage cropped = cwImageProvider::decodeImage(imageData, clip);
+    REQUIRE(cropped.size() == clip.size());
+    CHECK(cropped.convertToFormat(QImage::Format_RGB32) == original.copy(clip));
+
+    //Clips outside of the image are padded with 0, like QImage::copy()
+    QRect outsideClip(50, 40, 100, 100);
+    QImage padded = cwImageProvider::decodeImage(imageData, outsideClip);
+    REQUIRE(padded.size() == outsideClip.size());
+    CHECK(padded.convertToFormat(QImage::Format_RGB32) == original.copy(outsideClip).convertToFormat(QImage::Format_RGB32));
+    CHECK(padded.pixel(0, 0) == original.pixel(50, 40));
+
+    QRect beforeClip(-4, -2, 8, 4);
+    QImage paddedBefore = cwImageProvider::decodeImage(imageData, beforeClip);
+    REQUIRE(paddedBefore.size() == beforeClip.size());
+    CHECK(paddedBefore.pixel(4, 2) == original.pixel(0, 0));
+
+    QImage thumbnail = cwImageProvider::decodeImage(imageData, QRect(), QSize(16, 12));
+    CHECK(thumbnail.size() == QSize(16, 12));
+}
@@ -0,0 +1,117 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwLeadView.h"
+#include "cwScrapLeadView.h"
+#include "cwProject.h"
+#include "cwCavingRegion.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyNoteModel.h"
+#include "cwNote.h"
+#include "cwScrap.h"
+#include "cwLead.h"
+#include "cwRegionTreeModel.h"
+#include "cwRegionSaveTask.h"
+
+//Qt includes
+#include <QQmlEngine>
+#include <QQmlContext>
+#include <QDir>
+#include <QFile>
+
+/**
+ * The scraps that the lead view is showing. Views that have been removed no longer have a scrap,
+ * but may not be deleted yet.
+ */
+static QList<cwScrap*> shownScraps(cwLeadView* leadView) {
+    QList<cwScrap*> scraps;
+    foreach(cwScrapLeadView* view, leadView->findChildren<cwScrapLeadView*>()) {
+        if(view->scrap() != nullptr) {
+            scraps.append(view->scrap());
+        }
+    }
+    return scraps;
+}
+
+TEST_CASE("Lead view shows the leads of a loaded project", "[LeadView]") {
+    //Save a project with one scrap that has two leads
+    QString filename = QDir::tempPath() + "/cavewhere-leadViewTest.cw";
+    QFile::remove(filename);
+
+    {
+        cwCavingRegion region;
+        cwCave* cave = new cwCave();
+        cave->setName("Lead cave");
+        region.addCave(cave);
+
+        cwTrip* trip = new cwTrip();
+        cave->addTrip(trip);
+
+        cwNote* note = new cwNote();
+        trip->notes()->addNotes(QList<cwNote*>() << note);
+
+        cwScrap* scrap = new cwScrap();
+        note->addScrap(scrap);
+
+        cwLead lead;
+        lead.setDescription("Going passage");
+        scrap->addLead(lead);
+        lead.setDescription("Crawl");
+        scrap->addLead(lead);
+
+        cwRegionSaveTask saveTask;
+        saveTask.setCavingRegion(region);
+        saveTask.setDatabaseFilename(filename);
+        saveTask.start();
+        saveTask.waitToFinish();
+    }
+
+    QQmlEngine engine;
+
+    cwProject project;
+    cwRegionTreeModel regionModel;
+    regionModel.setCavingRegion(project.cavingRegion());
+
+    cwLeadView leadView;
+    QQmlEngine::setContextForObject(&leadView, engine.rootContext());
+    leadView.setRegionModel(&regionModel);
+    CHECK(shownScraps(&leadView).isEmpty());
+
+    project.loadFile(filename);
+    project.waitToFinish();
+
+    REQUIRE(project.cavingRegion()->caveCount() == 1);
+    cwCave* loadedCave = project.cavingRegion()->cave(0);
+    REQUIRE(loadedCave->tripCount() == 1);
+    REQUIRE(loadedCave->trip(0)->notes()->notes().size() == 1);
+    cwScrap* loadedScrap = loadedCave->trip(0)->notes()->notes().first()->scraps().first();
+
+    QList<cwScrap*> scraps = shownScraps(&leadView);
+    REQUIRE(scraps.size() == 1);
+    CHECK(scraps.first() == loadedScrap);
+    CHECK(scraps.first()->numberOfLeads() == 2);
+
+    SECTION("Loading again replaces the old scraps") {
+        project.loadFile(filename);
+        project.waitToFinish();
+
+        cwScrap* reloadedScrap = project.cavingRegion()->cave(0)->trip(0)->notes()->notes().first()->scraps().first();
+
+        scraps = shownScraps(&leadView);
+        REQUIRE(scraps.size() == 1);
+        CHECK(scraps.first() == reloadedScrap);
+        CHECK(scraps.first()->numberOfLeads() == 2);
+    }
+
+    leadView.setRegionModel(nullptr);
+    CHECK(shownScraps(&leadView).isEmpty());
+}
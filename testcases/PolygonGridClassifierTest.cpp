@@ -0,0 +1,247 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwPolygonGridClassifier.h"
+
+//Qt includes
+#include <QPolygonF>
+#include <QLineF>
+#include <QtMath>
+
+//Std includes
+#include <random>
+
+/**
+ * Creates the grid points the same way cwTriangulateTask::createPointGrid() does
+ */
+static QVector<QPointF> createGrid(QPointF topLeft, QSize gridSize, double delta) {
+    QVector<QPointF> points;
+    points.reserve(gridSize.width() * gridSize.height());
+    for(int y = 0; y < gridSize.height(); y++) {
+        for(int x = 0; x < gridSize.width(); x++) {
+            points.append(topLeft + QPointF(x * delta, y * delta));
+        }
+    }
+    return points;
+}
+
+/**
+ * The brute force test that cwTriangulateTask used, every quad edge against every polygon edge
+ */
+static bool quadIntersects(const QVector<QPointF>& points, int origin, int width, const QPolygonF& polygon) {
+    if(polygon.size() < 2) { return false; }
+
+    QVector<QLineF> edges;
+    edges.append(QLineF(points.at(origin), points.at(origin + 1)));
+    edges.append(QLineF(points.at(origin + 1), points.at(origin + width + 1)));
+    edges.append(QLineF(points.at(origin + width + 1), points.at(origin + width)));
+    edges.append(QLineF(points.at(origin + width), points.at(origin)));
+
+    QVector<QLineF> polygonEdges;
+    for(int i = 0; i < polygon.size() - 1; i++) {
+        polygonEdges.append(QLineF(polygon.at(i), polygon.at(i + 1)));
+    }
+    if(!polygon.isClosed()) {
+        polygonEdges.append(QLineF(polygon.first(), polygon.last()));
+    }
+
+    QPointF intersectionPoint;
+    foreach(QLineF polygonEdge, polygonEdges) {
+        foreach(QLineF edge, edges) {
+            if(polygonEdge.intersect(edge, &intersectionPoint) == QLineF::BoundedIntersection) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void checkAgainstBruteForce(const QVector<QPointF>& points, QSize gridSize, const QPolygonF& polygon) {
+    cwPolygonGridClassifier classifier(points, gridSize, polygon);
+    int width = gridSize.width();
+
+    int pointMismatches = 0;
+    for(int i = 0; i < points.size(); i++) {
+        bool inside = polygon.containsPoint(points.at(i), Qt::OddEvenFill);
+        if(inside != (classifier.point(i) == cwPolygonGridClassifier::Inside)) {
+            pointMismatches++;
+        }
+    }
+    CHECK(pointMismatches == 0);
+
+    int cellMismatches = 0;
+    int missingEdges = 0;
+    for(int y = 0; y < gridSize.height() - 1; y++) {
+        for(int x = 0; x < width - 1; x++) {
+            int origin = y * width + x;
+
+            cwPolygonGridClassifier::Classification expected = cwPolygonGridClassifier::Outside;
+            if(quadIntersects(points, origin, width, polygon)) {
+                expected = cwPolygonGridClassifier::Boundary;
+            } else if(polygon.containsPoint(points.at(origin), Qt::OddEvenFill) &&
+                      polygon.containsPoint(points.at(origin + 1), Qt::OddEvenFill) &&
+                      polygon.containsPoint(points.at(origin + width), Qt::OddEvenFill) &&
+                      polygon.containsPoint(points.at(origin + width + 1), Qt::OddEvenFill))
+            {
+                expected = cwPolygonGridClassifier::Inside;
+            }
+
+            if(classifier.cell(origin) != expected) {
+                cellMismatches++;
+            }
+
+            if(expected == cwPolygonGridClassifier::Boundary && classifier.cellEdges(origin).isEmpty()) {
+                missingEdges++;
+            }
+        }
+    }
+    CHECK(cellMismatches == 0);
+    CHECK(missingEdges == 0);
+}
+
+TEST_CASE("Polygon grid classification matches the brute force tests", "[PolygonGridClassifier]") {
+    const QSize gridSize(41, 31);
+    const double delta = 0.5;
+    const QPointF topLeft(-10.0, -7.5);
+    QVector<QPointF> points = createGrid(topLeft, gridSize, delta);
+
+    SECTION("Random star shaped polygons") {
+        std::mt19937 generator(1986);
+        std::uniform_real_distribution<double> radius(2.0, 7.0);
+
+        for(int i = 0; i < 50; i++) {
+            QPolygonF polygon;
+            int numberOfPoints = 3 + i % 20;
+            for(int j = 0; j < numberOfPoints; j++) {
+                double angle = 2.0 * M_PI * j / numberOfPoints;
+                double r = radius(generator);
+                polygon.append(QPointF(r * cos(angle), r * sin(angle)));
+            }
+
+            //Half of the polygons are closed, like scrap outlines
+            if(i % 2 == 0) {
+                polygon.append(polygon.first());
+            }
+
+            checkAgainstBruteForce(points, gridSize, polygon);
+        }
+    }
+
+    SECTION("Polygons that lie on the grid lines") {
+        QPolygonF square;
+        square << QPointF(-5.0, -5.0) << QPointF(5.0, -5.0) << QPointF(5.0, 5.0) << QPointF(-5.0, 5.0);
+        checkAgainstBruteForce(points, gridSize, square);
+
+        square.append(square.first());
+        checkAgainstBruteForce(points, gridSize, square);
+
+        QPolygonF stairs;
+        stairs << QPointF(-4.0, -4.0) << QPointF(0.0, -4.0) << QPointF(0.0, -1.5)
+               << QPointF(2.5, -1.5) << QPointF(2.5, 3.0) << QPointF(-4.0, 3.0);
+        checkAgainstBruteForce(points, gridSize, stairs);
+
+        QPolygonF diamond;
+        diamond << QPointF(0.0, -6.0) << QPointF(6.0, 0.0) << QPointF(0.0, 6.0) << QPointF(-6.0, 0.0);
+        checkAgainstBruteForce(points, gridSize, diamond);
+    }
+
+    SECTION("Polygons that leave the grid") {
+        QPolygonF triangle;
+        triangle << QPointF(-20.0, -20.0) << QPointF(20.0, -3.3) << QPointF(1.7, 20.0);
+        checkAgainstBruteForce(points, gridSize, triangle);
+    }
+
+    SECTION("Degenerate polygons") {
+        checkAgainstBruteForce(points, gridSize, QPolygonF());
+
+        QPolygonF line;
+        line << QPointF(-3.0, -3.0) << QPointF(3.0, 2.0);
+        checkAgainstBruteForce(points, gridSize, line);
+    }
+}
+
+static double area(const QPolygonF& polygon) {
+    double area = 0.0;
+    for(int i = 0; i < polygon.size(); i++) {
+        const QPointF& p1 = polygon.at(i);
+        const QPointF& p2 = polygon.at((i + 1) % polygon.size());
+        area += p1.x() * p2.y() - p2.x() * p1.y();
+    }
+    return fabs(area * 0.5);
+}
+
+/**
+ * The clipped cells of a simple polygon should add up to the polygon's area
+ */
+static void checkClippedArea(const QVector<QPointF>& points, QSize gridSize, const QPolygonF& polygon) {
+    cwPolygonGridClassifier classifier(points, gridSize, polygon);
+    int width = gridSize.width();
+    double cellArea = (points.at(1).x() - points.at(0).x()) * (points.at(width).y() - points.at(0).y());
+
+    double clippedArea = 0.0;
+    int oversizedCells = 0;
+    for(int y = 0; y < gridSize.height() - 1; y++) {
+        for(int x = 0; x < width - 1; x++) {
+            double cellClippedArea = 0.0;
+            foreach(const QPolygonF& clipped, classifier.clipCell(y * width + x)) {
+                cellClippedArea += area(clipped);
+            }
+
+            if(cellClippedArea > cellArea * (1.0 + 1e-9)) {
+                oversizedCells++;
+            }
+            clippedArea += cellClippedArea;
+        }
+    }
+
+    CHECK(oversizedCells == 0);
+    CHECK(clippedArea == Approx(area(polygon)).epsilon(1e-9));
+}
+
+TEST_CASE("Clipped cells add up to the polygon", "[PolygonGridClassifier]") {
+    const QSize gridSize(41, 31);
+    const double delta = 0.5;
+    QVector<QPointF> points = createGrid(QPointF(-10.0, -7.5), gridSize, delta);
+
+    SECTION("Random star shaped polygons") {
+        std::mt19937 generator(2016);
+        std::uniform_real_distribution<double> radius(2.0, 7.0);
+
+        for(int i = 0; i < 50; i++) {
+            QPolygonF polygon;
+            int numberOfPoints = 3 + i * 3;
+            for(int j = 0; j < numberOfPoints; j++) {
+                double angle = 2.0 * M_PI * j / numberOfPoints;
+                double r = radius(generator);
+                polygon.append(QPointF(r * cos(angle), r * sin(angle)));
+            }
+            checkClippedArea(points, gridSize, polygon);
+        }
+    }
+
+    SECTION("Polygons that lie on the grid lines") {
+        QPolygonF stairs;
+        stairs << QPointF(-4.0, -4.0) << QPointF(0.0, -4.0) << QPointF(0.0, -1.5)
+               << QPointF(2.5, -1.5) << QPointF(2.5, 3.0) << QPointF(-4.0, 3.0) << QPointF(-4.0, -4.0);
+        checkClippedArea(points, gridSize, stairs);
+
+        QPolygonF diamond;
+        diamond << QPointF(0.0, -6.0) << QPointF(6.0, 0.0) << QPointF(0.0, 6.0) << QPointF(-6.0, 0.0);
+        checkClippedArea(points, gridSize, diamond);
+
+        //Notches that are thinner than a cell, and touch the grid's corners
+        QPolygonF comb;
+        comb << QPointF(-5.0, -5.0) << QPointF(-4.75, -2.0) << QPointF(-4.5, -5.0)
+             << QPointF(-4.0, -5.0) << QPointF(-3.5, -3.0) << QPointF(-3.0, -5.0)
+             << QPointF(3.0, -5.0) << QPointF(3.0, 5.0) << QPointF(-5.0, 5.0);
+        checkClippedArea(points, gridSize, comb);
+    }
+}
@@ -0,0 +1,70 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwProject.h"
+#include "cwImageData.h"
+#include "cwImage.h"
+
+//Qt includes
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+static int imageRowCount(const QSqlDatabase& database) {
+    QSqlQuery query("SELECT count(*) FROM Images", database);
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+TEST_CASE("Identical images are stored once and reference counted", "[Project]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "ProjectImageTest");
+        database.setDatabaseName(dir.path() + "/images.cw");
+        REQUIRE(database.open());
+
+        cwProject::createDefaultSchema(database);
+
+        cwImageData page(QSize(4, 4), 0, "png", QByteArray("scanned page"));
+        cwImageData otherPage(QSize(4, 4), 0, "png", QByteArray("another page"));
+
+        int firstId = cwProject::addImage(database, page);
+        int secondId = cwProject::addImage(database, page);
+        int otherId = cwProject::addImage(database, otherPage);
+
+        CHECK(firstId != -1);
+        CHECK(firstId == secondId);
+        CHECK(otherId != firstId);
+        CHECK(imageRowCount(database) == 2);
+
+        //Derived images are found by their source, before they're created
+        QByteArray iconHash = cwProject::derivedImageHash(cwProject::imageHash(page), "icon", QSize(2, 2));
+        CHECK(cwProject::reuseImage(database, iconHash) == -1);
+        int iconId = cwProject::addImage(database, cwImageData(QSize(2, 2), 0, "jpg", QByteArray("icon")), iconHash);
+        CHECK(cwProject::reuseImage(database, iconHash) == iconId);
+
+        cwImage image;
+        image.setOriginal(firstId);
+        image.setIcon(iconId);
+
+        //Both the first and second image hold a reference
+        CHECK(cwProject::removeImage(database, image));
+        CHECK(imageRowCount(database) == 3);
+
+        CHECK(cwProject::removeImage(database, image));
+        CHECK(imageRowCount(database) == 1);
+
+        database.close();
+    }
+
+    QSqlDatabase::removeDatabase("ProjectImageTest");
+}
@@ -0,0 +1,187 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwSQLManager.h"
+#include "cwProject.h"
+
+//Qt includes
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QThread>
+#include <QSignalSpy>
+#include <QFile>
+#include <QFileInfo>
+
+//Std includes
+#include <thread>
+#include <vector>
+
+/**
+ * Runs function with a connection to databaseName that's only used by the calling thread. Catch
+ * assertions aren't thread safe, so this returns false if the connection couldn't be opened.
+ */
+template<typename Function>
+static bool withConnection(QString databaseName, QString connectionName, Function function) {
+    bool opened;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(databaseName);
+        opened = database.open();
+        if(opened) {
+            cwSQLManager::instance()->configureConnection(database);
+            function(database);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return opened;
+}
+
+static int rowCount(const QSqlDatabase& database) {
+    QSqlQuery query("SELECT count(*) FROM Data", database);
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+static void insertRow(const QSqlDatabase& database) {
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO Data (value) VALUES (?)");
+    query.bindValue(0, QByteArray(4096, 'x'));
+    query.exec();
+}
+
+static QString createDatabase(const QTemporaryDir& dir) {
+    QString databaseName = dir.path() + "/contention.cw";
+    bool opened = withConnection(databaseName, "SQLManagerTestSetup", [](QSqlDatabase& database) {
+        QSqlQuery query(database);
+        REQUIRE(query.exec("CREATE TABLE Data (id INTEGER PRIMARY KEY AUTOINCREMENT, value BLOB)"));
+        REQUIRE(cwSQLManager::instance()->enableWriteAheadLog(database));
+        CHECK(cwSQLManager::instance()->journalMode(database) == cwSQLManager::WriteAheadLog);
+
+        cwSQLManager::Transaction transaction(&database);
+        for(int i = 0; i < 100; i++) {
+            insertRow(database);
+        }
+    });
+    REQUIRE(opened);
+    return databaseName;
+}
+
+TEST_CASE("Readers run while a writer holds a WAL transaction", "[SQLManager]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    QString databaseName = createDatabase(dir);
+
+    const int numberOfReaders = 4;
+    QAtomicInt writerStarted;
+    QAtomicInt readersFinished;
+    QAtomicInt readersSawSnapshot;
+
+    std::thread writer([&]() {
+        bool opened = withConnection(databaseName, "SQLManagerTestWriter", [&](QSqlDatabase& database) {
+            cwSQLManager::Transaction transaction(&database);
+            insertRow(database);
+            writerStarted.store(1);
+
+            //Hold the transaction until the readers are done, or give up
+            QElapsedTimer timer;
+            timer.start();
+            while(readersFinished.load() < numberOfReaders && timer.elapsed() < 5000) {
+                QThread::msleep(1);
+            }
+        });
+
+        if(!opened) {
+            writerStarted.store(1);
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for(int i = 0; i < numberOfReaders; i++) {
+        readers.emplace_back([&, i]() {
+            while(writerStarted.load() == 0) {
+                QThread::msleep(1);
+            }
+
+            withConnection(databaseName, QString("SQLManagerTestReader%1").arg(i), [&](QSqlDatabase& database) {
+                cwSQLManager::Transaction transaction(&database, cwSQLManager::ReadOnly);
+                if(rowCount(database) == 100) {
+                    readersSawSnapshot.fetchAndAddOrdered(1);
+                }
+            });
+            readersFinished.fetchAndAddOrdered(1);
+        });
+    }
+
+    for(auto& reader : readers) {
+        reader.join();
+    }
+    writer.join();
+
+    //The readers finished before the writer committed, and only saw the committed rows
+    CHECK(readersSawSnapshot.load() == numberOfReaders);
+
+    bool opened = withConnection(databaseName, "SQLManagerTestCheck", [](QSqlDatabase& database) {
+        CHECK(rowCount(database) == 101);
+        CHECK(cwSQLManager::instance()->checkpoint(database));
+    });
+    CHECK(opened);
+}
+
+TEST_CASE("Save as stops when the project's journal can't be checkpointed", "[SQLManager]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    int oldBusyTimeout = cwSQLManager::instance()->busyTimeout();
+    cwSQLManager::instance()->setBusyTimeout(100);
+
+    cwProject project;
+    QSignalSpy failedSpy(&project, SIGNAL(saveAsFailed(QString)));
+
+    //A file that's already at the new location
+    QString newFilename = dir.path() + "/savedAs.cw";
+    {
+        QFile file(newFilename);
+        REQUIRE(file.open(QFile::WriteOnly));
+        file.write("existing");
+    }
+
+    //An open read transaction keeps the checkpoint from emptying the journal
+    bool opened = withConnection(project.filename(), "SQLManagerTestSaveAsReader", [&](QSqlDatabase& database) {
+        QSqlQuery query(database);
+        REQUIRE(query.exec("BEGIN"));
+        REQUIRE(query.exec("SELECT count(*) FROM sqlite_master"));
+        REQUIRE(query.next());
+
+        CHECK(!project.saveAs(newFilename));
+        CHECK(failedSpy.count() == 1);
+        CHECK(project.filename() != newFilename);
+        CHECK(project.isTemporaryProject());
+
+        //The existing file wasn't removed
+        CHECK(QFileInfo(newFilename).size() == 8);
+
+        query.finish();
+        REQUIRE(query.exec("COMMIT"));
+    });
+    REQUIRE(opened);
+
+    //Without the reader, save as works
+    CHECK(project.saveAs(newFilename));
+    CHECK(failedSpy.count() == 1);
+    CHECK(project.filename() == newFilename);
+    CHECK(!project.isTemporaryProject());
+    project.waitToFinish();
+
+    cwSQLManager::instance()->setBusyTimeout(oldBusyTimeout);
+}
@@ -0,0 +1,169 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwScrapManager.h"
+#include "cwProject.h"
+#include "cwCavingRegion.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyNoteModel.h"
+#include "cwNote.h"
+#include "cwScrap.h"
+#include "cwNoteStation.h"
+#include "cwStationPositionLookup.h"
+#include "cwRegionTreeModel.h"
+#include "cwGLScraps.h"
+#include "cwImageData.h"
+#include "cwTriangulateTask.h"
+#include "cwTriangulateInData.h"
+
+//Qt includes
+#include <QImage>
+#include <QBuffer>
+#include <QSqlDatabase>
+
+/**
+ * Adds a blank png note page to the project's database
+ */
+static cwImage addNoteImage(const cwProject& project) {
+    QImage page(64, 64, QImage::Format_RGB32);
+    page.fill(Qt::white);
+
+    QByteArray pngData;
+    QBuffer buffer(&pngData);
+    buffer.open(QIODevice::WriteOnly);
+    page.save(&buffer, "png");
+
+    cwImage image;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "ScrapManagerTest");
+        database.setDatabaseName(project.filename());
+        REQUIRE(database.open());
+
+        image.setOriginal(cwProject::addImage(database, cwImageData(page.size(), 2000, "png", pngData)));
+        image.setOriginalSize(page.size());
+        image.setOriginalDotsPerMeter(2000);
+
+        database.close();
+    }
+    QSqlDatabase::removeDatabase("ScrapManagerTest");
+
+    REQUIRE(image.original() != -1);
+    return image;
+}
+
+TEST_CASE("Scrap manager only triangulates scraps whose input changed", "[ScrapManager]") {
+    cwProject project;
+    cwRegionTreeModel regionModel;
+    regionModel.setCavingRegion(project.cavingRegion());
+
+    cwGLScraps glScraps;
+    cwScrapManager manager;
+    manager.setProject(&project);
+    manager.setRegionTreeModel(&regionModel);
+    manager.setGLScraps(&glScraps);
+
+    cwCave* cave = new cwCave();
+    project.cavingRegion()->addCave(cave);
+
+    cwStationPositionLookup positions;
+    positions.setPosition("a1", QVector3D(0.0, 0.0, 0.0));
+    cave->setStationPositionLookup(positions);
+
+    cwTrip* trip = new cwTrip();
+    cave->addTrip(trip);
+
+    cwNote* note = new cwNote();
+    note->setImage(addNoteImage(project));
+    trip->notes()->addNotes(QList<cwNote*>() << note);
+
+    cwScrap* scrap = new cwScrap();
+    scrap->addPoint(QPointF(0.1, 0.1));
+    scrap->addPoint(QPointF(0.9, 0.1));
+    scrap->addPoint(QPointF(0.9, 0.9));
+    scrap->addPoint(QPointF(0.1, 0.9));
+
+    cwNoteStation station;
+    station.setName("a1");
+    station.setPositionOnNote(QPointF(0.5, 0.5));
+    scrap->addStation(station);
+
+    note->addScrap(scrap);
+    manager.waitToFinish();
+
+    cwTriangulatedData firstData = scrap->triangulationData();
+    REQUIRE(!firstData.isNull());
+    CHECK(!firstData.isStale());
+    CHECK(!firstData.inputHash().isEmpty());
+
+    SECTION("An edit that's undone in the same batch skips the triangulation") {
+        scrap->setPoint(0, QPointF(0.2, 0.2));
+        scrap->setPoint(0, QPointF(0.1, 0.1));
+        CHECK(scrap->triangulationData().isStale());
+
+        //The task isn't started, so the scrap is up to date right away
+        manager.changeJournal()->flush();
+        CHECK(!scrap->triangulationData().isStale());
+        CHECK(scrap->triangulationData().inputHash() == firstData.inputHash());
+        CHECK(scrap->triangulationData().points() == firstData.points());
+    }
+
+    SECTION("A changed scrap is triangulated again") {
+        scrap->setPoint(0, QPointF(0.2, 0.2));
+
+        //The scrap is stale until the task finishes
+        manager.changeJournal()->flush();
+        CHECK(scrap->triangulationData().isStale());
+
+        manager.waitToFinish();
+        CHECK(!scrap->triangulationData().isStale());
+        CHECK(scrap->triangulationData().inputHash() != firstData.inputHash());
+
+        //The replaced mesh is kept by the scrap, so it's saved with the project
+        REQUIRE(scrap->recentTriangulations().size() == 1);
+        CHECK(scrap->recentTriangulations().first().inputHash() == firstData.inputHash());
+
+        cwTriangulatedData secondData = scrap->triangulationData();
+
+        SECTION("Moving it back reuses the cached mesh") {
+            scrap->setPoint(0, QPointF(0.1, 0.1));
+            manager.changeJournal()->flush();
+            CHECK(!scrap->triangulationData().isStale());
+            CHECK(scrap->triangulationData().inputHash() == firstData.inputHash());
+
+            //The meshes are swapped
+            REQUIRE(scrap->recentTriangulations().size() == 1);
+            CHECK(scrap->recentTriangulations().first().inputHash() == secondData.inputHash());
+        }
+
+        SECTION("A copy of the scrap, like the one that's saved, has the cached mesh") {
+            cwScrap copy(*scrap);
+            REQUIRE(copy.recentTriangulations().size() == 1);
+            CHECK(copy.recentTriangulations().first().inputHash() == firstData.inputHash());
+        }
+    }
+}
+
+TEST_CASE("Triangulation input hash includes the task settings", "[ScrapManager]") {
+    cwTriangulateInData data;
+    data.setOutline(QPolygonF() << QPointF(0.1, 0.1) << QPointF(0.9, 0.1) << QPointF(0.9, 0.9));
+    data.setNoteImageResolution(2000.0);
+
+    cwTriangulateTask task;
+    QByteArray defaultHash = task.inputHash(data);
+    CHECK(task.inputHash(data) == defaultHash);
+
+    task.setDistanceBetweenPoints(task.distanceBetweenPoints() * 0.5);
+    CHECK(task.inputHash(data) != defaultHash);
+
+    data.setNoteImageResolution(1000.0);
+    CHECK(task.inputHash(data) != defaultHash);
+}
@@ -566,3 +566,132 @@ TEST_CASE("Checks cwSurveyChunk errors")
     }
 }
 
+
+TEST_CASE("cwSurveyChunk error counts follow the edited cells", "[SurveyChunk]") {
+    cwSurveyChunk chunk;
+    chunk.appendNewShot();
+    chunk.setData(cwSurveyChunk::StationNameRole, 0, "a1");
+    chunk.setData(cwSurveyChunk::StationNameRole, 1, "a2");
+
+    CHECK(chunk.errorModel()->fatalCount() == 5); //Full shot data
+    CHECK(chunk.errorModel()->warningCount() == 8); //2 x LRUD
+
+    //Showing a cell moves its errors into a cell model, the chunk's counts don't change
+    cwErrorModel* distanceModel = chunk.errorsAt(0, cwSurveyChunk::ShotDistanceRole);
+    REQUIRE(distanceModel != nullptr);
+    CHECK(distanceModel->fatalCount() == 1);
+    CHECK(chunk.errorsAt(0, cwSurveyChunk::ShotDistanceRole) == distanceModel);
+    CHECK(chunk.errorModel()->fatalCount() == 5);
+    CHECK(chunk.errorModel()->warningCount() == 8);
+
+    //Fixing a shown cell
+    chunk.setData(cwSurveyChunk::ShotDistanceRole, 0, 10);
+    CHECK(chunk.errorsAt(0, cwSurveyChunk::ShotDistanceRole) == nullptr);
+    CHECK(chunk.errorModel()->fatalCount() == 4);
+    CHECK(chunk.errorModel()->warningCount() == 8);
+
+    //Fixing cells that aren't shown
+    chunk.setData(cwSurveyChunk::StationLeftRole, 0, 1.0);
+    chunk.setData(cwSurveyChunk::StationLeftRole, 1, 2.0);
+    CHECK(chunk.errorModel()->fatalCount() == 4);
+    CHECK(chunk.errorModel()->warningCount() == 6);
+
+    //Breaking a cell that was fixed
+    chunk.setData(cwSurveyChunk::StationLeftRole, 1, "");
+    CHECK(chunk.errorModel()->warningCount() == 7);
+    chunk.setData(cwSurveyChunk::StationLeftRole, 1, 2.0);
+    CHECK(chunk.errorModel()->warningCount() == 6);
+
+    SECTION("Adding and removing a shot") {
+        chunk.appendNewShot();
+        CHECK(chunk.errorModel()->fatalCount() == 4);
+        CHECK(chunk.errorModel()->warningCount() == 6);
+
+        chunk.setData(cwSurveyChunk::StationNameRole, 2, "a3");
+        CHECK(chunk.errorModel()->fatalCount() == 9);
+        CHECK(chunk.errorModel()->warningCount() == 10);
+
+        REQUIRE(chunk.errorsAt(1, cwSurveyChunk::ShotCompassRole) != nullptr);
+        CHECK(chunk.errorModel()->fatalCount() == 9);
+
+        REQUIRE(chunk.canRemoveShot(1, cwSurveyChunk::Below));
+        chunk.removeShot(1, cwSurveyChunk::Below);
+        CHECK(chunk.errorModel()->fatalCount() == 4);
+        CHECK(chunk.errorModel()->warningCount() == 6);
+    }
+}
+
+TEST_CASE("cwSurveyChunk stores its data in columns", "[SurveyChunk]") {
+    cwSurveyChunk chunk;
+    chunk.appendNewShot();
+    chunk.appendNewShot();
+
+    chunk.setData(cwSurveyChunk::StationNameRole, 0, "a1");
+    chunk.setData(cwSurveyChunk::StationNameRole, 1, "a2");
+    chunk.setData(cwSurveyChunk::StationNameRole, 2, "a1");
+    chunk.setData(cwSurveyChunk::StationLeftRole, 1, "2.5");
+    chunk.setData(cwSurveyChunk::ShotDistanceRole, 0, "10");
+    chunk.setData(cwSurveyChunk::ShotDistanceRole, 1, "5");
+    chunk.setData(cwSurveyChunk::ShotCompassRole, 1, "90");
+    chunk.setData(cwSurveyChunk::ShotClinoRole, 1, "up");
+
+    const cwSurveyChunkColumns& columns = chunk.columns();
+    REQUIRE(columns.stationCount() == 3);
+    REQUIRE(columns.shotCount() == 2);
+
+    //Station names are shared
+    CHECK(columns.nameIds().at(0) == columns.nameIds().at(2));
+    CHECK(columns.name(1).toStdString() == "a2");
+
+    CHECK(columns.left().at(1) == 2.5);
+    CHECK(columns.leftStates().at(1) == cwDistanceStates::Valid);
+    CHECK(columns.leftStates().at(0) == cwDistanceStates::Empty);
+    CHECK(columns.compass().at(1) == 90.0);
+    CHECK(columns.clinoStates().at(1) == cwClinoStates::Up);
+
+    //The data roles read the same values back
+    CHECK(chunk.data(cwSurveyChunk::StationLeftRole, 1).toString().toStdString() == "2.5");
+    CHECK(chunk.data(cwSurveyChunk::StationLeftRole, 0).isNull());
+    CHECK(chunk.data(cwSurveyChunk::ShotClinoRole, 1).toString().toStdString() == "Up");
+    CHECK(chunk.station(1).left() == 2.5);
+    CHECK(chunk.shot(1).compass() == 90.0);
+
+    int numberOfShots = 0;
+    CHECK(columns.includedDistance(&numberOfShots) == 15.0);
+    CHECK(numberOfShots == 2);
+
+    SECTION("Invalid edits are rejected by the station and shot") {
+        chunk.setData(cwSurveyChunk::StationLeftRole, 1, "-1");
+        chunk.setData(cwSurveyChunk::ShotCompassRole, 1, "400");
+        CHECK(columns.left().at(1) == 2.5);
+        CHECK(columns.compass().at(1) == 90.0);
+    }
+
+    SECTION("Excluding a shot updates the columns") {
+        chunk.setData(cwSurveyChunk::ShotDistanceIncludedRole, 1, false);
+        CHECK(columns.includedDistance(&numberOfShots) == 10.0);
+        CHECK(numberOfShots == 1);
+    }
+
+    SECTION("Splitting keeps the columns the same size") {
+        cwSurveyChunk* newChunk = chunk.splitAtStation(1);
+        REQUIRE(newChunk != nullptr);
+
+        CHECK(chunk.columns().stationCount() == 1);
+        CHECK(chunk.columns().shotCount() == 0);
+        CHECK(newChunk->columns().stationCount() == 3);
+        CHECK(newChunk->columns().shotCount() == 2);
+        CHECK(newChunk->columns().name(1).toStdString() == "a2");
+        CHECK(newChunk->columns().left().at(1) == 2.5);
+        CHECK(newChunk->columns().distance().at(1) == 5.0);
+    }
+
+    SECTION("Removing keeps the stations and shots lined up") {
+        chunk.removeStation(1, cwSurveyChunk::Below);
+        REQUIRE(columns.stationCount() == 2);
+        REQUIRE(columns.shotCount() == 1);
+        CHECK(columns.name(0).toStdString() == "a1");
+        CHECK(columns.name(1).toStdString() == "a1");
+        CHECK(columns.distance().at(0) == 10.0);
+    }
+}
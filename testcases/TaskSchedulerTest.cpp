@@ -0,0 +1,214 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwTaskScheduler.h"
+#include "cwTask.h"
+
+//Qt includes
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QPair>
+
+TEST_CASE("Task scheduler keeps interactive and background threads separate", "[TaskScheduler]") {
+    cwTaskScheduler* scheduler = cwTaskScheduler::instance();
+
+    QThread* interactive = scheduler->acquireThread(cwTaskScheduler::Interactive);
+    QThread* background = scheduler->acquireThread(cwTaskScheduler::Background);
+
+    REQUIRE(interactive != nullptr);
+    REQUIRE(background != nullptr);
+    CHECK(interactive != background);
+    CHECK(interactive->isRunning());
+    CHECK(background->isRunning());
+    CHECK(scheduler->threadCount() >= 2);
+
+    scheduler->releaseThread(interactive);
+    scheduler->releaseThread(background);
+}
+
+TEST_CASE("Task scheduler hands out the least assigned thread", "[TaskScheduler]") {
+    cwTaskScheduler* scheduler = cwTaskScheduler::instance();
+
+    QThread* first = scheduler->acquireThread(cwTaskScheduler::Interactive);
+    int firstCount = scheduler->assignedTasks(first);
+    CHECK(firstCount >= 1);
+
+    QThread* second = scheduler->acquireThread(cwTaskScheduler::Interactive);
+    CHECK(scheduler->assignedTasks(second) <= firstCount + 1);
+
+    scheduler->releaseThread(second);
+    scheduler->releaseThread(first);
+    CHECK(scheduler->assignedTasks(first) == firstCount - 1);
+}
+
+/**
+ * Appends its id to a shared list when it runs. If a rendezvous is set, the task waits for
+ * its partner task to be running at the same time.
+ */
+class SchedulerTestTask : public cwTask {
+public:
+    SchedulerTestTask(int id, QList<int>* runOrder, QMutex* mutex) :
+        Id(id),
+        RunOrder(runOrder),
+        Mutex(mutex),
+        Arrived(nullptr),
+        PartnerArrived(nullptr),
+        MetPartner(false)
+    {}
+
+    void setRendezvous(QSemaphore* arrived, QSemaphore* partnerArrived) {
+        Arrived = arrived;
+        PartnerArrived = partnerArrived;
+    }
+
+    bool metPartner() const { return MetPartner; }
+
+protected:
+    void runTask() {
+        {
+            QMutexLocker locker(Mutex);
+            RunOrder->append(Id);
+        }
+
+        if(Arrived != nullptr) {
+            Arrived->release();
+
+            //Gives up after 5 seconds, or when the task is stopped
+            for(int i = 0; i < 500 && isRunning() && !MetPartner; i++) {
+                MetPartner = PartnerArrived->tryAcquire(1, 10);
+            }
+        }
+
+        done();
+    }
+
+private:
+    int Id;
+    QList<int>* RunOrder;
+    QMutex* Mutex;
+    QSemaphore* Arrived;
+    QSemaphore* PartnerArrived;
+    bool MetPartner;
+};
+
+TEST_CASE("Task scheduler runs tasks on one thread in order, and on different threads at the same time", "[TaskScheduler]") {
+    cwTaskScheduler* scheduler = cwTaskScheduler::instance();
+
+    //The line plot, triangulation, and load/save each get their own interactive thread
+    scheduler->releaseThread(scheduler->acquireThread(cwTaskScheduler::Interactive));
+    CHECK(scheduler->threadCount(cwTaskScheduler::Interactive) >= 3);
+    CHECK(scheduler->threadCount(cwTaskScheduler::Background) >= 1);
+
+    QMutex mutex;
+    QList<int> runOrder;
+
+    SECTION("In order on one thread") {
+        QThread* thread = scheduler->acquireThread(cwTaskScheduler::Interactive);
+
+        QList<SchedulerTestTask*> tasks;
+        for(int i = 0; i < 20; i++) {
+            SchedulerTestTask* task = new SchedulerTestTask(i, &runOrder, &mutex);
+            task->setThread(thread);
+            tasks.append(task);
+        }
+
+        foreach(SchedulerTestTask* task, tasks) {
+            task->start();
+        }
+
+        scheduler->flush(thread);
+
+        QList<int> expectedOrder;
+        for(int i = 0; i < tasks.size(); i++) {
+            expectedOrder.append(i);
+        }
+        CHECK(runOrder == expectedOrder);
+
+        foreach(SchedulerTestTask* task, tasks) {
+            task->stopAndWait();
+            delete task;
+        }
+
+        scheduler->releaseThread(thread);
+    }
+
+    SECTION("At the same time on different threads") {
+        //Other tests may have left tasks assigned to threads, so keep acquiring until there's a different thread
+        QList<QThread*> acquired;
+        acquired.append(scheduler->acquireThread(cwTaskScheduler::Interactive));
+        while(acquired.last() == acquired.first() && acquired.size() < 100) {
+            acquired.append(scheduler->acquireThread(cwTaskScheduler::Interactive));
+        }
+
+        QThread* first = acquired.first();
+        QThread* second = acquired.last();
+        QThread* background = scheduler->acquireThread(cwTaskScheduler::Background);
+        REQUIRE(first != second);
+
+        //Each pair only finishes quickly if both tasks are running at the same time
+        QList<QPair<QThread*, QThread*> > pairs;
+        pairs.append(qMakePair(first, second));
+        pairs.append(qMakePair(first, background));
+
+        for(int i = 0; i < pairs.size(); i++) {
+            QSemaphore firstArrived;
+            QSemaphore secondArrived;
+
+            SchedulerTestTask firstTask(0, &runOrder, &mutex);
+            SchedulerTestTask secondTask(1, &runOrder, &mutex);
+            firstTask.setRendezvous(&firstArrived, &secondArrived);
+            secondTask.setRendezvous(&secondArrived, &firstArrived);
+            firstTask.setThread(pairs.at(i).first);
+            secondTask.setThread(pairs.at(i).second);
+
+            firstTask.start();
+            secondTask.start();
+
+            scheduler->flush(pairs.at(i).first);
+            scheduler->flush(pairs.at(i).second);
+
+            CHECK(firstTask.metPartner());
+            CHECK(secondTask.metPartner());
+
+            firstTask.stopAndWait();
+            secondTask.stopAndWait();
+        }
+
+        scheduler->releaseThread(background);
+        foreach(QThread* thread, acquired) {
+            scheduler->releaseThread(thread);
+        }
+    }
+}
+
+TEST_CASE("Stop and wait blocks until the task has left its thread", "[TaskScheduler]") {
+    QMutex mutex;
+    QList<int> runOrder;
+
+    QSemaphore arrived;
+    QSemaphore neverReleased;
+
+    SchedulerTestTask* task = new SchedulerTestTask(0, &runOrder, &mutex);
+    task->setRendezvous(&arrived, &neverReleased);
+    task->setThread(cwTaskScheduler::Background);
+    task->start();
+
+    //The task is running, and is blocked waiting for a partner that never comes
+    REQUIRE(arrived.tryAcquire(1, 5000));
+
+    task->stopAndWait();
+    CHECK(task->thread() == QThread::currentThread());
+    CHECK(!task->metPartner());
+    CHECK(task->isReady());
+    delete task;
+}
@@ -0,0 +1,95 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwTaskTracer.h"
+#include "cwTaskTraceModel.h"
+
+//Qt includes
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+
+TEST_CASE("Task tracer keeps the newest spans in a ring buffer", "[TaskTracer]") {
+    cwTaskTracer* tracer = cwTaskTracer::instance();
+    int oldCapacity = tracer->capacity();
+
+    tracer->setCapacity(3);
+
+    for(int i = 0; i < 5; i++) {
+        cwTaskTracer::Span span;
+        span.Name = QString("Task %1").arg(i);
+        span.Status = "finished";
+        span.QueuedTime = i * 100;
+        span.StartTime = i * 100 + 10;
+        span.EndTime = i * 100 + 50;
+        tracer->addSpan(span);
+    }
+
+    QList<cwTaskTracer::Span> spans = tracer->spans();
+    REQUIRE(spans.size() == 3);
+    CHECK(spans.at(0).Name.toStdString() == "Task 2");
+    CHECK(spans.at(1).Name.toStdString() == "Task 3");
+    CHECK(spans.at(2).Name.toStdString() == "Task 4");
+    CHECK(spans.at(0).queueWait() == 10);
+    CHECK(spans.at(0).runTime() == 40);
+
+    SECTION("Export as chrome trace events") {
+        QJsonDocument document = QJsonDocument::fromJson(tracer->toChromeTrace());
+        REQUIRE(document.isObject());
+
+        QJsonArray events = document.object().value("traceEvents").toArray();
+
+        //One thread name, and a queue begin, queue end and run event for each span
+        CHECK(events.size() == 1 + 3 * 3);
+
+        //Only the run events are complete events on the thread's track, waiting is async
+        int numberOfRunEvents = 0;
+        QHash<QString, int> queueEvents;
+        foreach(const QJsonValue& value, events) {
+            QJsonObject event = value.toObject();
+            QString phase = event.value("ph").toString();
+            if(phase == "X") {
+                CHECK(event.value("cat").toString().toStdString() == "task");
+                numberOfRunEvents++;
+            } else if(phase == "b" || phase == "e") {
+                CHECK(event.value("cat").toString().toStdString() == "queue");
+                queueEvents[event.value("id").toString()]++;
+            }
+        }
+
+        CHECK(numberOfRunEvents == 3);
+        CHECK(queueEvents.size() == 3);
+        foreach(int count, queueEvents) {
+            CHECK(count == 2);
+        }
+    }
+
+    SECTION("The trace model only changes when it's refreshed") {
+        cwTaskTraceModel model;
+        CHECK(model.rowCount() == 0);
+
+        model.refresh();
+        REQUIRE(model.rowCount() == 3);
+        CHECK(model.data(model.index(0), cwTaskTraceModel::NameRole).toString().toStdString() == "Task 4");
+        CHECK(model.data(model.index(2), cwTaskTraceModel::NameRole).toString().toStdString() == "Task 2");
+        CHECK(model.data(model.index(0), cwTaskTraceModel::QueueWaitRole).toDouble() == 0.01);
+        CHECK(model.data(model.index(0), cwTaskTraceModel::RunTimeRole).toDouble() == 0.04);
+
+        tracer->clear();
+        CHECK(model.rowCount() == 3);
+
+        model.refresh();
+        CHECK(model.rowCount() == 0);
+    }
+
+    tracer->setCapacity(oldCapacity);
+}
@@ -0,0 +1,189 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwTriangulate.h"
+
+//Qt includes
+#include <QtMath>
+
+//Std includes
+#include <random>
+
+static double triangleArea(const QPointF& a, const QPointF& b, const QPointF& c) {
+    return ((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x())) * 0.5;
+}
+
+/**
+ * The triangles should be counter-clockwise, only use the polygon's points, and cover the polygon
+ */
+static void checkTriangulation(const QVector<QPointF>& polygon) {
+    QVector<QPointF> triangles;
+    CHECK(cwTriangulate::Process(polygon, triangles));
+    REQUIRE(triangles.size() % 3 == 0);
+    CHECK(triangles.size() / 3 <= polygon.size() - 2);
+
+    double area = 0.0;
+    int clockwiseTriangles = 0;
+    int unknownPoints = 0;
+    for(int i = 0; i < triangles.size(); i += 3) {
+        double current = triangleArea(triangles.at(i), triangles.at(i + 1), triangles.at(i + 2));
+        if(current < 0.0) {
+            clockwiseTriangles++;
+        }
+        area += current;
+
+        for(int j = i; j < i + 3; j++) {
+            if(!polygon.contains(triangles.at(j))) {
+                unknownPoints++;
+            }
+        }
+    }
+
+    CHECK(clockwiseTriangles == 0);
+    CHECK(unknownPoints == 0);
+    CHECK(area == Approx(fabs(cwTriangulate::Area(polygon))).epsilon(1e-9));
+}
+
+static QVector<QPointF> randomStar(std::mt19937& generator, int numberOfPoints, double minRadius, double maxRadius) {
+    std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+    QVector<QPointF> polygon;
+    for(int i = 0; i < numberOfPoints; i++) {
+        double angle = 2.0 * M_PI * i / numberOfPoints;
+        double r = radius(generator);
+        polygon.append(QPointF(r * cos(angle), r * sin(angle)));
+    }
+    return polygon;
+}
+
+TEST_CASE("Triangulate random polygons", "[Triangulate]") {
+    std::mt19937 generator(2016);
+
+    SECTION("Star shaped polygons") {
+        for(int i = 0; i < 200; i++) {
+            QVector<QPointF> polygon = randomStar(generator, 3 + i, 1.0, 10.0);
+            checkTriangulation(polygon);
+
+            //Clockwise
+            std::reverse(polygon.begin(), polygon.end());
+            checkTriangulation(polygon);
+        }
+    }
+
+    SECTION("Points on a coarse grid, with collinear, level and duplicate points") {
+        std::uniform_int_distribution<int> duplicate(0, 4);
+        for(int i = 0; i < 200; i++) {
+            QVector<QPointF> star = randomStar(generator, 8 + i % 60, 50.0, 100.0);
+            QVector<QPointF> polygon;
+            foreach(QPointF point, star) {
+                QPointF snapped(qRound(point.x() / 8.0) * 8.0, qRound(point.y() / 8.0) * 8.0);
+                if(!polygon.isEmpty() && polygon.last() == snapped) {
+                    continue;
+                }
+                polygon.append(snapped);
+                if(duplicate(generator) == 0) {
+                    polygon.append(snapped);
+                }
+            }
+
+            //Closed, like a scrap outline
+            polygon.append(polygon.first());
+            checkTriangulation(polygon);
+        }
+    }
+
+    SECTION("Nearly collinear points") {
+        //Points a tiny bit off a long line, the sign of each turn is only right if it's exact
+        for(int i = 0; i < 50; i++) {
+            QVector<QPointF> polygon;
+            int numberOfPoints = 10 + i;
+            for(int j = 0; j <= numberOfPoints; j++) {
+                double x = 0.1 + 1000.0 * j / numberOfPoints;
+                double offset = (j % 2 == 0 ? 1.0 : -1.0) * x * 1e-15;
+                polygon.append(QPointF(x, x * 0.3 + offset));
+            }
+            polygon.append(QPointF(1000.0, 1000.0));
+            checkTriangulation(polygon);
+        }
+    }
+
+    SECTION("Combs and spirals") {
+        //Teeth from the top and bottom make lots of split and merge points
+        QVector<QPointF> comb;
+        int teeth = 100;
+        for(int i = 0; i < teeth; i++) {
+            comb.append(QPointF(i * 2.0, 0.0));
+            comb.append(QPointF(i * 2.0 + 1.0, 0.0));
+            comb.append(QPointF(i * 2.0 + 1.5, 10.0));
+        }
+        comb.append(QPointF(teeth * 2.0, 0.0));
+        comb.append(QPointF(teeth * 2.0, 25.0));
+        for(int i = teeth; i > 0; i--) {
+            comb.append(QPointF(i * 2.0, 25.0));
+            comb.append(QPointF(i * 2.0 - 0.5, 15.0));
+            comb.append(QPointF(i * 2.0 - 1.0, 25.0));
+        }
+        comb.append(QPointF(0.0, 25.0));
+        checkTriangulation(comb);
+
+        QVector<QPointF> spiral;
+        QVector<QPointF> innerSpiral;
+        int numberOfPoints = 500;
+        for(int i = 0; i < numberOfPoints; i++) {
+            double angle = 0.1 * i;
+            double radius = 1.0 + angle;
+            spiral.append(QPointF(radius * cos(angle), radius * sin(angle)));
+            innerSpiral.prepend(QPointF((radius - 0.5) * cos(angle), (radius - 0.5) * sin(angle)));
+        }
+        spiral += innerSpiral;
+        checkTriangulation(spiral);
+    }
+}
+
+TEST_CASE("Triangulate degenerate polygons", "[Triangulate]") {
+    QVector<QPointF> triangles;
+
+    CHECK(!cwTriangulate::Process(QVector<QPointF>(), triangles));
+
+    QVector<QPointF> line;
+    line << QPointF(0.0, 0.0) << QPointF(1.0, 1.0) << QPointF(2.0, 2.0);
+    CHECK(!cwTriangulate::Process(line, triangles));
+
+    QVector<QPointF> duplicates;
+    duplicates << QPointF(0.0, 0.0) << QPointF(0.0, 0.0) << QPointF(1.0, 0.0) << QPointF(1.0, 0.0);
+    CHECK(!cwTriangulate::Process(duplicates, triangles));
+    CHECK(triangles.isEmpty());
+
+    //A square with a spike, and points on its sides
+    QVector<QPointF> square;
+    square << QPointF(0.0, 0.0) << QPointF(1.0, 0.0) << QPointF(2.0, 0.0) << QPointF(2.0, 2.0)
+           << QPointF(3.0, 3.0) << QPointF(2.0, 2.0) << QPointF(0.0, 2.0) << QPointF(0.0, 1.0);
+    checkTriangulation(square);
+}
+
+TEST_CASE("Ear clipping fills outlines that cross themselves", "[Triangulate]") {
+    QVector<QPointF> bowtie;
+    bowtie << QPointF(0.0, 0.0) << QPointF(2.0, 2.0) << QPointF(2.0, 0.0) << QPointF(0.0, 2.0);
+
+    QVector<QPointF> triangles;
+    CHECK(!cwTriangulate::Process(bowtie, triangles));
+
+    triangles.clear();
+    CHECK(!cwTriangulate::EarClip(bowtie, triangles));
+    CHECK(!triangles.isEmpty());
+    CHECK(triangles.size() % 3 == 0);
+
+    //Simple polygons are fully triangulated
+    QVector<QPointF> square;
+    square << QPointF(0.0, 0.0) << QPointF(1.0, 0.0) << QPointF(1.0, 1.0) << QPointF(0.0, 1.0) << QPointF(0.0, 0.0);
+    triangles.clear();
+    CHECK(cwTriangulate::EarClip(square, triangles));
+    CHECK(triangles.size() == 6);
+}
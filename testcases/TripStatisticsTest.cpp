@@ -0,0 +1,103 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwTripStatistics.h"
+#include "cwCave.h"
+#include "cwTrip.h"
+#include "cwSurveyChunk.h"
+#include "cwTripCalibration.h"
+
+//Qt includes
+#include <QSignalSpy>
+
+TEST_CASE("Trip statistics follow edits to the survey", "[TripStatistics]") {
+    cwCave cave;
+    cwTrip* trip = new cwTrip();
+    cave.addTrip(trip);
+
+    cwTripStatistics tripStatistics;
+    tripStatistics.setTrip(trip);
+    QSignalSpy lengthSpy(&tripStatistics, SIGNAL(lengthChanged()));
+
+    CHECK(tripStatistics.length() == 0.0);
+    CHECK(tripStatistics.shotCount() == 0);
+
+    cwSurveyChunk* chunk = new cwSurveyChunk();
+    chunk->appendNewShot();
+    trip->addChunk(chunk);
+
+    chunk->setData(cwSurveyChunk::StationNameRole, 0, "a1");
+    chunk->setData(cwSurveyChunk::StationNameRole, 1, "a2");
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, "10");
+    CHECK(tripStatistics.length() == 10.0);
+    CHECK(tripStatistics.shotCount() == 1);
+    CHECK(tripStatistics.stationCount() == 2);
+    CHECK(lengthSpy.count() == 1);
+
+    chunk->appendNewShot();
+    chunk->setData(cwSurveyChunk::StationNameRole, 2, "a3");
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 1, "5");
+    CHECK(tripStatistics.length() == 15.0);
+    CHECK(tripStatistics.shotCount() == 2);
+    CHECK(tripStatistics.stationCount() == 3);
+    CHECK(tripStatistics.chunkLength(chunk) == 15.0);
+
+    //Replacing a distance only changes the total by the difference
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, "12");
+    CHECK(tripStatistics.length() == 17.0);
+
+    chunk->setData(cwSurveyChunk::ShotDistanceIncludedRole, 1, false);
+    CHECK(tripStatistics.length() == 12.0);
+    CHECK(tripStatistics.shotCount() == 1);
+
+    trip->calibrations()->setTapeCalibration(1.0);
+    CHECK(tripStatistics.length() == 13.0);
+
+    chunk->removeShot(1, cwSurveyChunk::Below);
+    CHECK(tripStatistics.stationCount() == 2);
+    CHECK(tripStatistics.length() == 13.0);
+
+    trip->removeChunks(0, 0);
+    CHECK(tripStatistics.length() == 0.0);
+    CHECK(tripStatistics.shotCount() == 0);
+}
+
+TEST_CASE("Trip length doesn't drift after many edits", "[TripStatistics]") {
+    cwCave cave;
+    cwTrip* trip = new cwTrip();
+    cave.addTrip(trip);
+
+    cwSurveyChunk* chunk = new cwSurveyChunk();
+    chunk->appendNewShot();
+    chunk->appendNewShot();
+    trip->addChunk(chunk);
+
+    cwTripStatistics tripStatistics;
+    tripStatistics.setTrip(trip);
+
+    chunk->setData(cwSurveyChunk::StationNameRole, 0, "a1");
+    chunk->setData(cwSurveyChunk::StationNameRole, 1, "a2");
+    chunk->setData(cwSurveyChunk::StationNameRole, 2, "a3");
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 1, "3.3");
+
+    //Values that can't be stored exactly as doubles
+    for(int i = 0; i < 1000; i++) {
+        chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, QString::number(0.1 + i * 0.7));
+    }
+    chunk->setData(cwSurveyChunk::ShotDistanceRole, 0, "0.1");
+
+    //The same as counting the trip from scratch
+    cwTripStatistics freshStatistics;
+    freshStatistics.setTrip(trip);
+    CHECK(tripStatistics.length() == freshStatistics.length());
+    CHECK(tripStatistics.length() == 3.4);
+    CHECK(tripStatistics.shotCount() == 2);
+}
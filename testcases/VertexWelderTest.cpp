@@ -0,0 +1,106 @@
+/**************************************************************************
+**
+**    Copyright (C) 2016 by Philip Schuchardt
+**    www.cavewhere.com
+**
+**************************************************************************/
+
+//Catch includes
+#include "catch.hpp"
+
+//Cavewhere includes
+#include "cwVertexWelder.h"
+
+//Std includes
+#include <random>
+#include <cmath>
+
+static const float PointTolerance = 0.000001f;
+
+/**
+ * The linear search that cwTriangulateTask::mergeFullAndPartialTriangles() used
+ */
+static void linearWeld(QVector<QVector3D>& pointSet, QVector<uint>& indices, const QVector<QPointF>& points) {
+    foreach(QPointF unAddedPoint, points) {
+        bool found = false;
+        uint index = 0;
+        for(int i = 0; i < pointSet.size(); i++) {
+            const QVector3D& point = pointSet[i];
+            float xDelta = fabs((float)unAddedPoint.x() - point.x());
+            float yDelta = fabs((float)unAddedPoint.y() - point.y());
+
+            if(xDelta <= PointTolerance && yDelta <= PointTolerance) {
+                index = (uint)i;
+                found = true;
+                break;
+            }
+        }
+
+        if(!found) {
+            index = (uint)pointSet.size();
+            pointSet.append(QVector3D(unAddedPoint));
+        }
+        indices.append(index);
+    }
+}
+
+static void hashWeld(QVector<QVector3D>& pointSet, QVector<uint>& indices, const QVector<QPointF>& points) {
+    cwVertexWelder welder(&pointSet, PointTolerance);
+    foreach(QPointF point, points) {
+        indices.append(welder.weld(point));
+    }
+}
+
+/**
+ * A grid of points, like the full quads, and points on and around the grid, like the partial
+ * quads. Some of the points are within the tolerance of the grid and each other.
+ */
+static void createPoints(int gridSize, int numberOfPoints, QVector<QVector3D>* grid, QVector<QPointF>* points) {
+    double delta = 1.0 / gridSize;
+    for(int y = 0; y < gridSize; y++) {
+        for(int x = 0; x < gridSize; x++) {
+            grid->append(QVector3D(x * delta, y * delta, 0.0));
+        }
+    }
+
+    std::mt19937 generator(43);
+    std::uniform_int_distribution<int> gridIndex(0, gridSize * gridSize - 1);
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    std::uniform_real_distribution<double> jitter(-2.0 * PointTolerance, 2.0 * PointTolerance);
+
+    for(int i = 0; i < numberOfPoints; i++) {
+        switch(i % 3) {
+        case 0: {
+            //Near a grid point
+            QVector3D gridPoint = grid->at(gridIndex(generator));
+            points->append(QPointF(gridPoint.x() + jitter(generator), gridPoint.y() + jitter(generator)));
+            break;
+        }
+        case 1:
+            points->append(QPointF(position(generator), position(generator)));
+            break;
+        case 2:
+            //Near a point that was already added
+            points->append(points->at(i / 2) + QPointF(jitter(generator), jitter(generator)));
+            break;
+        }
+    }
+}
+
+TEST_CASE("Vertex welding matches the linear search", "[VertexWelder]") {
+    QVector<QVector3D> grid;
+    QVector<QPointF> points;
+    createPoints(50, 6000, &grid, &points);
+
+    QVector<QVector3D> linearPoints = grid;
+    QVector<uint> linearIndices;
+    linearWeld(linearPoints, linearIndices, points);
+
+    QVector<QVector3D> hashPoints = grid;
+    QVector<uint> hashIndices;
+    hashWeld(hashPoints, hashIndices, points);
+
+    CHECK(linearPoints.size() > grid.size());
+    CHECK(linearPoints == hashPoints);
+    CHECK(linearIndices == hashIndices);
+}